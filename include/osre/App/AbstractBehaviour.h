@@ -11,10 +11,26 @@ public:
         // empty
     }
 
+    /// @brief  Called serially before the update phase, use this to read shared state.
+    virtual bool preUpdate(Time dt) {
+        return onPreUpdate(dt);
+    }
+
     virtual bool update(Time dt ) {
         return onUpdate(dt);
     }
 
+    /// @brief  Called serially after the update phase, use this to write back to shared state.
+    virtual bool postUpdate(Time dt) {
+        return onPostUpdate(dt);
+    }
+
+    /// @brief  Returns true, when onUpdate only touches state owned by its entity. The update of
+    /// thread-safe behaviours may run in parallel on worker threads.
+    virtual bool isThreadSafe() const {
+        return false;
+    }
+
     virtual bool mouseDown() {
         return onMouseDown();
     }
@@ -36,10 +52,18 @@ protected:
         // empty
     }
 
+    virtual bool onPreUpdate(Time) {
+        return true;
+    }
+
     virtual bool onUpdate(Time ) {
         return true;
     }
 
+    virtual bool onPostUpdate(Time) {
+        return true;
+    }
+
     virtual bool onMouseDown() {
         return true;
     }
@@ -49,6 +49,10 @@ namespace UI {
     class UiRenderer;
 }
 
+namespace Threading {
+    class JobScheduler;
+}
+
 namespace App {
 
 class World;
@@ -164,6 +168,10 @@ public:
 
     virtual Common::Ids *getIdContainer() const;
 
+    /// @brief  Will return the job scheduler shared by all worlds.
+    /// @return A pointer showing to the job scheduler.
+    virtual Threading::JobScheduler *getJobScheduler() const;
+
     /// @brief  Will create the default pipeline for rendering.
     /// @return The default pipeline.
     static RenderBackend::Pipeline *createDefaultPipeline();
@@ -211,6 +219,7 @@ private:
     MouseEventListener *m_mouseEvListener;
     KeyboardEventListener *m_keyboardEvListener;
     Common::Ids *m_ids;
+    Threading::JobScheduler *m_jobScheduler;
     bool m_shutdownRequested;
 };
 
@@ -80,6 +80,18 @@ public:
     AssimpWrapper(Common::Ids &ids, World *world);
     ~AssimpWrapper();
     bool importAsset( const IO::Uri &file, ui32 flags );
+
+    /// @brief  Will read and decode the asset file only, this can be done on a worker thread.
+    /// @param  file    [in] The uri of the asset.
+    /// @param  flags   [in] The import flags, 0 for the default ones.
+    /// @return true if successful, false in case of an error.
+    bool readAsset( const IO::Uri &file, ui32 flags );
+
+    /// @brief  Will create the materials, meshes and the entity from the read asset. Must be called
+    /// on the main thread.
+    /// @return The new entity or nullptr in case of an error.
+    Entity *convertAsset();
+
     Entity *getEntity() const;
 
 protected:
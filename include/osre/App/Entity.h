@@ -56,7 +56,10 @@ public:
     virtual void setNode( Scene::Node *node );
     virtual Scene::Node *getNode() const;
     virtual bool preprocess();
+    virtual bool preUpdate( Time dt );
     virtual bool update( Time dt );
+    virtual bool postUpdate( Time dt );
+    virtual bool isThreadSafe() const;
     virtual bool render( RenderBackend::RenderBackendService *rbSrv );
     virtual bool postprocess();
     virtual Component *getComponent(ComponentType type) const;
@@ -30,6 +30,11 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <cppcore/Container/THashMap.h>
 
 namespace OSRE {
+
+namespace Threading {
+    class JobScheduler;
+}
+
 namespace App {
 
 class Entity;
@@ -87,7 +92,20 @@ public:
     void setSceneRoot(Scene::Node *root);
     Scene::Node *getRootNode() const;
 
+    /// @brief  Will set the job scheduler used for the parallel update phase.
+    /// @param  scheduler   [in] The job scheduler, nullptr to update all entities serially.
+    void setJobScheduler( Threading::JobScheduler *scheduler );
+
+    /// @brief  Will return the job scheduler.
+    /// @return The job scheduler or nullptr, if none was set.
+    Threading::JobScheduler *getJobScheduler() const;
+
     /// @brief  Will update the world.
+    ///
+    /// The entities will be updated in three phases: the pre-update and post-update phase run
+    /// serially, the update of thread-safe entities will run in parallel chunks on the job
+    /// scheduler. Afterwards the node hierarchies of the entities are updated once from their
+    /// root nodes.
     /// @param  dt      [in] The current delta time-tick.
     void update( Time dt );
 
@@ -107,6 +125,9 @@ private:
     CPPCore::TArray<Scene::Camera*> m_views;
     CPPCore::THashMap<ui32, Scene::Camera*> m_lookupViews;
     CPPCore::TArray<Entity*> m_entities;
+    CPPCore::TArray<Entity*> m_parallelEntities;
+    CPPCore::TArray<Scene::Node*> m_rootNodes;
+    Threading::JobScheduler *m_jobScheduler;
     Scene::Camera *m_activeCamera;
     Scene::Node *mRoot;
     Common::Ids m_ids;
@@ -44,6 +44,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <cstring>
 #include <cmath>
 #include <cstddef>
+#include <atomic>
 #include <sstream>
 #include <string>
 
@@ -804,15 +805,26 @@ struct Version {
     }
 };
 
+//-------------------------------------------------------------------------------------------------
+///	@ingroup	Engine
+///
+///	@brief  Counts the heap allocations done by the global new operator. The counters are only
+/// updated in debug builds. They are updated from all threads, so they are atomic.
+//-------------------------------------------------------------------------------------------------
 class OSRE_EXPORT MemoryStatistics {
 public:
-    static size_t sAllocated;
-    static size_t sNumNew;
-    static size_t sActiveAllocs;
+    static std::atomic<size_t> sAllocated;
+    static std::atomic<size_t> sNumNew;
+    static std::atomic<size_t> sActiveAllocs;
 
     static void addAllocated(size_t allocSize);
     static void releaseAlloc();
     static void showStatistics();
+
+    /// @brief  Returns the number of allocations since the start, use the difference of two
+    /// calls to get the allocations of a frame.
+    /// @return The number of allocations.
+    static size_t getNumAllocs();
 };
 
 } // Namespace OSRE
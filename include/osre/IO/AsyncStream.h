@@ -0,0 +1,59 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2015-2020 OSRE ( Open Source Render Engine ) by Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#pragma once
+
+#include <osre/IO/Stream.h>
+#include <osre/Threading/TTask.h>
+
+namespace OSRE {
+namespace IO {
+
+class Uri;
+
+//-------------------------------------------------------------------------------------------------
+///	@ingroup	Engine
+///
+///	@brief  This class offers asynchronous wrappers for stream reads, the reads will be done on
+/// the job scheduler. Poll the returned task from the main loop or chain the processing of the
+/// data with TTask::then.
+//-------------------------------------------------------------------------------------------------
+class OSRE_EXPORT AsyncStream {
+public:
+    /// @brief  Reads from the stream asynchronously. The stream and the buffer must stay valid
+    /// and must not be used otherwise until the task is done.
+    /// @param  scheduler   [in] The job scheduler, nullptr to read directly.
+    /// @param  stream      [in] The stream to read from.
+    /// @param  buffer      [in] The buffer to read in.
+    /// @param  size        [in] The number of bytes to read.
+    /// @return The task, its result is the number of read bytes.
+    static Threading::TTask<ui32> read(Threading::JobScheduler *scheduler, Stream *stream, void *buffer, ui32 size);
+
+    /// @brief  Opens the file by the IOService, reads its whole content and closes it again.
+    /// @param  scheduler   [in] The job scheduler, nullptr to read directly.
+    /// @param  file        [in] The file to read.
+    /// @return The task, its result is the file content, empty in case of an error.
+    static Threading::TTask<MemoryBuffer> readFile(Threading::JobScheduler *scheduler, const Uri &file);
+};
+
+} // Namespace IO
+} // Namespace OSRE
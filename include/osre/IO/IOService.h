@@ -25,6 +25,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <osre/IO/IOCommon.h>
 #include <osre/Common/AbstractService.h>
 #include <osre/IO/Stream.h>
+#include <osre/Platform/Threading.h>
 
 #include <map>
 
@@ -74,7 +75,8 @@ public:
     ///	@param	pFileSystem	[in] A pointer showing to the mounted file system instance.
     void umountFileSystem( const String &name, AbstractFileSystem *pFileSystem );
 
-    /// @brief  A new stream will be opened, the corresponding file system will be used.
+    /// @brief  A new stream will be opened, the corresponding file system will be used. Streams
+    /// can be opened and closed from any thread.
     /// @param  file        [in] The file name as an Uri.
     /// @param  mode        [in] The access mode.
     /// @return A pointer showing to the stream or nullptr in case of an error.
@@ -102,6 +104,7 @@ public:
 private:
     using MountedMap = std::map<String, AbstractFileSystem*> ;
     MountedMap m_mountedMap;
+    Platform::CriticalSection m_streamLock;
 };
 
 } // Namespace IO
@@ -32,30 +32,39 @@ namespace Platform {
 ///
 ///	@brief This class declares the abstract interface for timer implementations.
 ///
-///	A timer offers
-///	the milliseconds, which are past since starting the application. You can use it as a way to
-///	synchronize your application.
+///	A timer offers the time, which is past since starting the application. It is based on a
+///	monotonic clock with nanosecond resolution, so you can use it to measure single render stages
+///	or to drive a fixed-timestep loop.
 ///
 ///	@remark	If you are implementing your own timer be careful with the resolution of your selected
-///	timer interface.
+///	timer interface. getNanoCurrentSeconds must be thread-safe, the render thread reads the same
+///	timer as the application.
 //-------------------------------------------------------------------------------------------------
 class OSRE_EXPORT AbstractTimer : public Common::Object {
 public:
     ///	@brief	Destructor, virtual.
     virtual ~AbstractTimer();
 
+    ///	@brief	Returns the nano-seconds since starting the application from a monotonic clock.
+    ///	@return	Nano-seconds past since starting the application.
+    virtual i64 getNanoCurrentSeconds() = 0;
+
     ///	@brief	Returns the milli-seconds since starting the application.
-    ///	@return	Seconds past since starting the application.
-    virtual i64 getMilliCurrentSeconds() = 0;
+    ///	@return	Milli-seconds past since starting the application.
+    virtual i64 getMilliCurrentSeconds();
 
-    ///	@brief	Returns the difference since the last call of getTimeDiff.
+    ///	@brief	Returns the difference in milli-seconds since the last call of getTimeDiff.
     ///	@return	The time difference.
-    virtual i64 getTimeDiff() = 0;
+    virtual i64 getTimeDiff();
+
+    ///	@brief	Returns the time since the last call of getDeltaTime with sub-millisecond precision.
+    ///	@return	The time difference, gaps longer than a second are replaced by the requested time-step.
+    virtual Time getDeltaTime();
 
 protected:
     ///	@brief	The constructor with the name of the timer instance.
     ///	@param	name        [in] The name for the timer instance.
-    /// @param  reqTimeStep [in] The time-step for the target FPS-value.
+    /// @param  reqTimeStep [in] The time-step for the target FPS-value in milli-seconds.
     AbstractTimer( const String &name, i64 reqTimeStep = 1000L/60L );
 
     /// @brief  Will return the target time slice for 
@@ -63,12 +72,19 @@ protected:
 
 private:
     i64 m_reqTimeSlice;
+    i64 m_lastDiffTick;
+    i64 m_lastDeltaTick;
 };
 
+static const i64 NanoPerMicro = 1000L;
+static const i64 NanoPerMilli = 1000000L;
+
 inline
 AbstractTimer::AbstractTimer( const String &name, i64 reqTimeSlice )
 : Object( name )
-, m_reqTimeSlice( reqTimeSlice ) {
+, m_reqTimeSlice( reqTimeSlice )
+, m_lastDiffTick( -1 )
+, m_lastDeltaTick( -1 ) {
     // empty
 }
 
@@ -77,6 +93,48 @@ AbstractTimer::~AbstractTimer() {
     // empty
 }
 
+inline
+i64 AbstractTimer::getMilliCurrentSeconds() {
+    return getNanoCurrentSeconds() / NanoPerMilli;
+}
+
+inline
+i64 AbstractTimer::getTimeDiff() {
+    const i64 now = getNanoCurrentSeconds();
+    if ( m_lastDiffTick < 0 ) {
+        m_lastDiffTick = now;
+        return 0L;
+    }
+
+    // Keep the remainder, so the truncated differences do not drift
+    i64 diff( ( now - m_lastDiffTick ) / NanoPerMilli );
+    m_lastDiffTick += diff * NanoPerMilli;
+    if ( diff > 1000L ) {
+        diff = getRequestedTimeStep();
+        m_lastDiffTick = now;
+    }
+
+    return diff;
+}
+
+inline
+Time AbstractTimer::getDeltaTime() {
+    const i64 now = getNanoCurrentSeconds();
+    if ( m_lastDeltaTick < 0 ) {
+        m_lastDeltaTick = now;
+        return Time();
+    }
+
+    i64 diff( ( now - m_lastDeltaTick ) / NanoPerMicro );
+    m_lastDeltaTick += diff * NanoPerMicro;
+    if ( diff > 1000000L ) {
+        diff = getRequestedTimeStep() * 1000L;
+        m_lastDeltaTick = now;
+    }
+
+    return Time( diff );
+}
+
 inline
 i64 AbstractTimer::getRequestedTimeStep() const {
     return m_reqTimeSlice;
@@ -44,10 +44,19 @@ enum CPUProp {
 //-------------------------------------------------------------------------------------------------
 ///	@ingroup	Engine
 ///
-///	@brief 
+///	@brief	Describes the CPUs of the target system.
+///
+///	Beside the number of logical CPUs the topology will be detected: which logical CPUs share a 
+///	physical core (SMT siblings) and which ones share the last level cache. On Linux the topology 
+///	is read from sysfs, on all other platforms each logical CPU is treated as an own core. Based 
+///	on the topology one physical core is reserved for the render thread, the worker threads 
+///	will be placed on the remaining ones.
 //-------------------------------------------------------------------------------------------------
 class OSRE_EXPORT CPUInfo {
 public:
+	///	The max. number of logical CPUs which can be described by an affinity mask.
+	static const ui32 MaxCPUs = 64;
+
 	///	@brief	The class default constructor.
 	CPUInfo();
 
@@ -62,6 +71,37 @@ public:
 	///	@return	Flag with the detected properties.
 	i32 getCPUProperties() const;
 
+	///	@brief	Returns the number of physical cores, SMT siblings are counted once.
+	///	@return	The number of physical cores.
+	ui32 getNumPhysicalCores() const;
+
+	///	@brief	Returns the number of cache domains, CPUs in one domain share the last level cache.
+	///	@return	The number of cache domains.
+	ui32 getNumCacheDomains() const;
+
+	///	@brief	Returns the index of the physical core a logical CPU belongs to.
+	///	@param	cpu		[in] The logical CPU index.
+	///	@return	The physical core index.
+	ui32 getPhysicalCore( ui32 cpu ) const;
+
+	///	@brief	Returns the index of the cache domain a logical CPU belongs to.
+	///	@param	cpu		[in] The logical CPU index.
+	///	@return	The cache domain index.
+	ui32 getCacheDomain( ui32 cpu ) const;
+
+	///	@brief	Returns the affinity mask of all logical CPUs of a physical core.
+	///	@param	core	[in] The physical core index.
+	///	@return	The affinity mask, 0 for an invalid core.
+	ui64 getPhysicalCoreMask( ui32 core ) const;
+
+	///	@brief	Returns the affinity mask reserved for the render thread.
+	///	@return	The affinity mask, 0 if there are not enough cores to reserve one.
+	ui64 getRenderThreadMask() const;
+
+	///	@brief	Returns the affinity mask for worker threads, the render core is excluded.
+	///	@return	The affinity mask, 0 if the workers shall not be restricted.
+	ui64 getWorkerThreadMask() const;
+
 	///	@brief	Returns true, if the CPUInfo was already initiated, false if not.
 	///	@return	The init state of the CPU info data.
 	static bool isInited();
@@ -70,13 +110,25 @@ public:
 	///	@return	true, if init was called at first, false if the CPU was not detected.
 	static bool init();
 
+	///	@brief	Detects the CPU topology, will be called by init.
+	///	@param	sysfsCPURoot	[in] The sysfs folder describing the CPUs, used on Linux only.
+	///	@return	true, if the topology was read, false if the fallback was used.
+	static bool initTopology( const String &sysfsCPURoot );
+
 protected:
 	static bool initCPUProperties();
+	static void initPlacement();
 
 private:
 	static bool m_IsInited;
 	static i32 m_CPUFlags;
 	static ui32 m_NumCPUs;
+	static ui32 m_NumPhysicalCores;
+	static ui32 m_NumCacheDomains;
+	static ui32 m_PhysicalCore[ MaxCPUs ];
+	static ui32 m_CacheDomain[ MaxCPUs ];
+	static ui64 m_RenderMask;
+	static ui64 m_WorkerMask;
 };
 
 } // Namespace System
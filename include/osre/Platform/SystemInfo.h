@@ -33,6 +33,22 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 namespace OSRE {
 namespace Platform {
 
+///	@brief	Describes where a thread was placed, used for diagnostics.
+struct ThreadPlacement {
+    String m_name;                  ///< The thread name.
+    Thread::Priority m_prio;        ///< The requested prio.
+    bool m_prioGranted;             ///< false, if the OS refused the requested prio.
+    ui64 m_affinityMask;            ///< The applied affinity mask, 0 for no restriction.
+
+    ThreadPlacement() :
+            m_name(),
+            m_prio(Thread::Priority::Normal),
+            m_prioGranted(true),
+            m_affinityMask(0) {
+        // empty
+    }
+};
+
 //-------------------------------------------------------------------------------------------------
 ///	@ingroup	Engine
 ///
@@ -72,6 +88,21 @@ public:
     static String getThreadName( const ThreadId &id );
     static String getCurrentThreadName();
 
+    ///	@brief	Stores the placement of a thread, will be removed by unregisterThreadName.
+    ///	@param	id			[in] The thread id.
+    ///	@param	placement	[in] The placement decision.
+    static void registerThreadPlacement( const ThreadId &id, const ThreadPlacement &placement );
+
+    ///	@brief	Returns the placement of a thread.
+    ///	@param	id			[in] The thread id.
+    ///	@param	placement	[out] The placement decision.
+    ///	@return	true, if the thread has registered a placement, false if not.
+    static bool getThreadPlacement( const ThreadId &id, ThreadPlacement &placement );
+
+    ///	@brief	Returns a human-readable description of the CPU topology and all thread placements.
+    ///	@return	The placement report.
+    static String getPlacementInfo();
+
 protected:
     static bool init();
 
@@ -89,6 +120,13 @@ private:
     typedef std::map<ui32, String> ThreadNameMap;
 #endif
     static ThreadNameMap s_threadNames;
+
+#ifdef OSRE_WINDOWS
+    typedef std::map<DWORD, ThreadPlacement> ThreadPlacementMap;
+#else
+    typedef std::map<ui32, ThreadPlacement> ThreadPlacementMap;
+#endif
+    static ThreadPlacementMap s_threadPlacements;
 };
 
 } // Namespace Platform
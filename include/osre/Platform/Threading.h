@@ -23,6 +23,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #pragma once
 
 #include <osre/Platform/PlatformCommon.h>
+#include <atomic>
 #ifdef OSRE_WINDOWS
 #   include <osre/Platform/Windows/MinWindows.h>
 #else
@@ -41,6 +42,10 @@ namespace Platform {
 ///
 ///	@brief  This abstract class declares the interface for critical sections. Override this for
 /// your own implementation.
+///
+/// With OSRE_USE_FUTEX on Linux the critical section is an adaptive mutex: a contended enter spins
+/// for a while and parks the thread on a futex afterwards, the spin budget follows how long the
+/// lock was held in the past. Otherwise a SDL spinlock is used.
 //-------------------------------------------------------------------------------------------------
 class OSRE_EXPORT CriticalSection {
 public:
@@ -59,14 +64,35 @@ public:
     ///	@brief	The critical section will be leaved.
     void leave();
 
+    ///	@brief	Returns how often enter found the critical section taken.
+    ///	@return	The number of contended enters.
+    ui32 getNumContended() const;
+
+    ///	@brief	Returns how often enter had to park the calling thread, only the futex version parks.
+    ///	@return	The number of parked enters.
+    ui32 getNumParked() const;
+
 private:
 #ifdef OSRE_WINDOWS
     CRITICAL_SECTION m_CriticalSection;
+#elif defined(OSRE_USE_FUTEX)
+    std::atomic<i32> m_state;
+    std::atomic<i32> m_spinEstimate;
 #else
     SDL_SpinLock m_spinlock;
 #endif
+    std::atomic<ui32> m_numContended;
+    std::atomic<ui32> m_numParked;
 };
 
+inline ui32 CriticalSection::getNumContended() const {
+    return m_numContended.load(std::memory_order_relaxed);
+}
+
+inline ui32 CriticalSection::getNumParked() const {
+    return m_numParked.load(std::memory_order_relaxed);
+}
+
 /// @brief  Manages platform-independent thread id
 struct ThreadId {
     unsigned long Id;
@@ -102,7 +128,8 @@ public:
     enum class Priority {
         Low, ///< Low prio thread.
         Normal, ///< Normal prio thread.
-        High ///< High prio thread.
+        High, ///< High prio thread.
+        Critical ///< Time-critical thread, real-time scheduling if granted, else High.
     };
 
     ///	@enum	ThreadState
@@ -171,6 +198,15 @@ public:
     ///	@return	The current thread prio.
     Priority getPriority() const;
 
+    ///	@brief	Assigns the logical CPUs the thread is allowed to run on.
+    ///	@param	mask	[in] One bit per logical CPU, 0 for no restriction.
+    ///	@return	true, if the mask was applied or will be applied on start, false if not supported.
+    bool setAffinity(ui64 mask);
+
+    ///	@brief	Returns the affinity mask of the thread.
+    ///	@return	The affinity mask, 0 for no restriction.
+    ui64 getAffinity() const;
+
     ///	@brief	The assigned name of the thread will be returned.
     ///	@return	The assigned name of the thread.
     const String &getThreadName() const;
@@ -211,12 +247,16 @@ protected:
     ///	Will assign a thread name.
     static void setThreadName(const c8 *pName);
 
+    ///	Applies priority and affinity to the calling thread, returns false if the prio was not granted.
+    static bool applyPlacement(Thread *thread);
+
 private:
     ThreadState m_threadState;
     ThreadId m_id;
     ui32 m_stacksize;
     String mThreadName;
     Priority m_Prio;
+    ui64 m_affinity;
 
 #ifdef OSRE_WINDOWS
     HANDLE m_ThreadHandle;
@@ -313,6 +353,9 @@ public:
 private:
 #ifdef OSRE_WINDOWS
     HANDLE m_EventHandle;
+#elif defined(OSRE_USE_FUTEX)
+    std::atomic<i32> m_state;
+    std::atomic<i32> m_numWaiters;
 #else
     i32 m_bool;
     SDL_mutex *m_lock;
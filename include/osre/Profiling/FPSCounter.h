@@ -52,7 +52,7 @@ public:
 
 private:
     Common::TObjPtr<Platform::AbstractTimer>  m_timerPtr;
-    i64 m_timeDiff, m_lastTime;
+    i64 m_lastTick, m_elapsed;
     ui32 m_fps, m_lastFPS;
 };
 
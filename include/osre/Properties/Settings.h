@@ -68,6 +68,11 @@ public:
         PollingMode,            ///< Polling mode, true for polling requested.
         DefaultFont,            ///< The default font for rendering.
         RenderMode,             ///> The requested render mode ( 2D or 3D, default 3D ).
+        FramesInFlight,         ///< Number of frames the render thread may lag behind ( 1 - 3, default 2 ).
+        StaticBatching,         ///< Meshes with the same vertex layout share their buffers ( default false ).
+        ShaderCacheDir,         ///< Directory for cached shader program binaries ( default empty, no cache ).
+        AsyncShaderCompile,     ///< Programs are linked in the background, draws wait for them ( default false ).
+        TextureUploadBudget,    ///< Bytes of streamed texture data uploaded per frame, 0 loads them directly ( default 4 MB ).
         MaxKonfigKey			///< The upper limit.
     };
 
@@ -0,0 +1,66 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2015-2020 OSRE ( Open Source Render Engine ) by Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#pragma once
+
+#include <osre/Common/osre_common.h>
+#include <osre/RenderBackend/RenderCommon.h>
+
+namespace OSRE {
+namespace RenderBackend {
+
+//-------------------------------------------------------------------------------------------------
+///	@ingroup	Engine
+///
+///	@brief  A simple BC1 / BC3 encoder to bake textures offline.
+///
+/// The endpoints are the corners of the bounding box of the block colors along their main
+/// diagonal, which is fast and good enough for color maps. Normal maps or HDR data shall be
+/// compressed with a dedicated tool.
+//-------------------------------------------------------------------------------------------------
+class OSRE_EXPORT BlockCompressor {
+public:
+    /// @brief  Compresses one level.
+    /// @param  format      [in] BC1 or BC3.
+    /// @param  pixels      [in] The pixels, rows are tightly packed.
+    /// @param  width       [in] The width of the level.
+    /// @param  height      [in] The height of the level.
+    /// @param  channels    [in] The number of channels, 1 to 4.
+    /// @param  buffer      [out] The blocks will be appended.
+    /// @return false, if the format or the number of channels is not supported.
+    static bool compress(TextureFormatType format, const uc8 *pixels, ui32 width, ui32 height, ui32 channels,
+            MemoryBuffer &buffer);
+    /// @brief  Compresses a block of 4x4 RGBA pixels into 8 bytes of BC1.
+    static void compressBlockBC1(const uc8 *rgba, uc8 *block);
+    /// @brief  Compresses a block of 4x4 RGBA pixels into 16 bytes of BC3.
+    static void compressBlockBC3(const uc8 *rgba, uc8 *block);
+    /// @brief  Halves the size of an image with a box filter, for the next mip level.
+    /// @param  pixels      [in] The pixels of the level.
+    /// @param  width       [in] The width of the level.
+    /// @param  height      [in] The height of the level.
+    /// @param  channels    [in] The number of channels.
+    /// @param  buffer      [out] The pixels of the next level.
+    static void downsample(const uc8 *pixels, ui32 width, ui32 height, ui32 channels, MemoryBuffer &buffer);
+};
+
+} // Namespace RenderBackend
+} // Namespace OSRE
@@ -31,6 +31,8 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #include <glm/gtc/type_ptr.hpp>
 
+#include <atomic>
+
 namespace OSRE {
 
 // Forward declarations
@@ -48,6 +50,7 @@ class Widget;
 
 namespace Threading {
 class SystemTask;
+class JobScheduler;
 }
 
 namespace RenderBackend {
@@ -83,13 +86,18 @@ DECL_EVENT(OnResizeEvent);
 //-------------------------------------------------------------------------------------------------
 struct OSRE_EXPORT CreateRendererEventData : public Common::EventData {
     CreateRendererEventData(Platform::AbstractWindow *pSurface) :
-            EventData(OnCreateRendererEvent, nullptr), m_activeSurface(pSurface), m_defaultFont(""), m_pipeline(nullptr) {
+            EventData(OnCreateRendererEvent, nullptr), m_activeSurface(pSurface), m_defaultFont(""), m_pipeline(nullptr), m_staticBatching(false), m_shaderCacheDir(), m_asyncShaderCompile(false), m_jobScheduler(nullptr), m_textureUploadBudget(0) {
         // empty
     }
 
     Platform::AbstractWindow *m_activeSurface;
     String m_defaultFont;
     Pipeline *m_pipeline;
+    bool m_staticBatching;  ///< Meshes with read-only vertices will share their buffers.
+    String m_shaderCacheDir;    ///< Directory for linked program binaries, empty to disable the cache.
+    bool m_asyncShaderCompile;  ///< Draws are skipped until their program is linked.
+    Threading::JobScheduler *m_jobScheduler;    ///< Decodes the streamed textures.
+    ui32 m_textureUploadBudget; ///< Bytes of texture data uploaded per frame, 0 to load textures directly.
 };
 
 //-------------------------------------------------------------------------------------------------
@@ -135,14 +143,57 @@ struct OSRE_EXPORT CommitFrameEventData : Common::EventData {
 //-------------------------------------------------------------------------------------------------
 ///	@ingroup	Engine
 ///
-///	@brief
+///	@brief  Describes the frame to render, the render thread will retire its fence afterwards.
+//-------------------------------------------------------------------------------------------------
+struct OSRE_EXPORT RenderFrameEventData : Common::EventData {
+    RenderFrameEventData() :
+            EventData(OnRenderFrameEvent, nullptr), m_frame(nullptr) {
+        // empty
+    }
+
+    Frame *m_frame;
+};
+
+//-------------------------------------------------------------------------------------------------
+///	@ingroup	Engine
+///
+///	@brief  Describes the new size of the render target. The size is published by a sequence lock,
+/// so the sender can update it while the render thread reads it.
 //-------------------------------------------------------------------------------------------------
 struct OSRE_EXPORT ResizeEventData : Common::EventData {
     ResizeEventData(ui32 x, ui32 y, ui32 w, ui32 h) :
-            EventData(OnResizeEvent, nullptr), m_x(x), m_y(y), m_w(w), m_h(h) {
+            EventData(OnResizeEvent, nullptr), m_sequence(0), m_x(x), m_y(y), m_w(w), m_h(h) {
         // empty
     }
-    ui32 m_x, m_y, m_w, m_h;
+
+    /// @brief  Publishes a new size, only one thread may write.
+    void set(ui32 x, ui32 y, ui32 w, ui32 h) {
+        const ui32 sequence = m_sequence.load(std::memory_order_relaxed);
+        m_sequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        m_x.store(x, std::memory_order_relaxed);
+        m_y.store(y, std::memory_order_relaxed);
+        m_w.store(w, std::memory_order_relaxed);
+        m_h.store(h, std::memory_order_relaxed);
+        m_sequence.store(sequence + 2, std::memory_order_release);
+    }
+
+    /// @brief  Reads the size, retries until no write was in progress.
+    void get(ui32 &x, ui32 &y, ui32 &w, ui32 &h) const {
+        ui32 sequence(0);
+        do {
+            sequence = m_sequence.load(std::memory_order_acquire);
+            x = m_x.load(std::memory_order_relaxed);
+            y = m_y.load(std::memory_order_relaxed);
+            w = m_w.load(std::memory_order_relaxed);
+            h = m_h.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+        } while (0 != (sequence & 1) || sequence != m_sequence.load(std::memory_order_relaxed));
+    }
+
+private:
+    std::atomic<ui32> m_sequence;
+    std::atomic<ui32> m_x, m_y, m_w, m_h;
 };
 
 //-------------------------------------------------------------------------------------------------
@@ -156,6 +207,9 @@ struct OSRE_EXPORT ResizeEventData : Common::EventData {
 //-------------------------------------------------------------------------------------------------
 class OSRE_EXPORT RenderBackendService : public Common::AbstractService {
 public:
+    /// The upper limit for frames in flight.
+    static const ui32 MaxFramesInFlight = 3;
+
     /// @brief  The class constructor.
     RenderBackendService();
 
@@ -194,6 +248,11 @@ public:
 
     void addMesh(const CPPCore::TArray<Mesh *> &geoArray, ui32 numInstances);
 
+    ///	@brief  Adds an instanced mesh, every instance gets its own transform and color.
+    ///	@param  geo             [in] The mesh to draw.
+    ///	@param  instanceData    [in] The per-instance data, must stay valid as long as the mesh.
+    void addInstancedMesh(Mesh *geo, GeoInstanceData *instanceData);
+
     void updateMesh(Mesh *mesh);
 
     bool endRenderBatch();
@@ -214,6 +273,25 @@ public:
 
     void setUiScreen(UI::Widget *screen);
 
+    /// @brief  Returns the number of heap allocations of the last frame, only counted in debug
+    /// builds.
+    /// @return The number of allocations.
+    size_t getNumFrameAllocs() const;
+
+    /// @brief  Will set the number of frames the render thread may lag behind the submitting thread.
+    /// One frame in flight will render in lockstep with the update.
+    /// @param  numFrames   [in] The number of frames in flight, will be clamped to 1 - MaxFramesInFlight.
+    void setFramesInFlight(ui32 numFrames);
+
+    /// @brief  Returns the number of frames in flight.
+    /// @return The number of frames in flight.
+    ui32 getFramesInFlight() const;
+
+    /// @brief  Will enable the storage of small submit command payloads in the commands, all
+    /// other payloads are taken from the payload arena of the frame.
+    /// @param  enabled     [in] true for inlined payloads, the default.
+    void setInlinePayloads(bool enabled);
+
 protected:
     /// @brief  The open callback.
     virtual bool onOpen();
@@ -229,14 +307,24 @@ protected:
     /// @brief  Will apply all used parameters
     void commitNextFrame();
 
+    /// @brief  Blocks until all frames in flight were rendered.
+    void waitForFrames();
+
 private:
     Threading::SystemTaskPtr m_renderTaskPtr;
     const Properties::Settings *m_settings;
     bool m_ownsSettingsConfig;
     bool m_frameCreated;
-    Frame m_frames[2];
-    Frame *m_renderFrame;
+    Frame m_frames[MaxFramesInFlight];
+    ui32 m_numFramesInFlight;
+    ui32 m_frameIdx;
     Frame *m_submitFrame;
+    // The event data is owned by the service and reused, the render thread only reads it
+    InitPassesEventData m_initPassesEventData;
+    CommitFrameEventData m_commitFrameEventData[MaxFramesInFlight];
+    RenderFrameEventData m_renderFrameEventData[MaxFramesInFlight];
+    ResizeEventData m_resizeEventData;
+    size_t m_numFrameAllocs;
     UI::Widget *m_screen;
     bool m_dirty;
     CPPCore::TArray<PassData *> m_passes;
@@ -253,5 +341,19 @@ inline void RenderBackendService::setUiScreen(UI::Widget *screen) {
     m_screen = screen;
 }
 
+inline size_t RenderBackendService::getNumFrameAllocs() const {
+    return m_numFrameAllocs;
+}
+
+inline ui32 RenderBackendService::getFramesInFlight() const {
+    return m_numFramesInFlight;
+}
+
+inline void RenderBackendService::setInlinePayloads(bool enabled) {
+    for (ui32 i = 0; i < MaxFramesInFlight; ++i) {
+        m_frames[i].m_inlinePayloads = enabled;
+    }
+}
+
 } // Namespace RenderBackend
 } // Namespace OSRE
@@ -25,6 +25,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <osre/Common/TResource.h>
 #include <osre/Common/osre_common.h>
 #include <osre/IO/Uri.h>
+#include <osre/Platform/Threading.h>
 
 #include <cppcore/Container/TArray.h>
 #include <cppcore/Container/THashMap.h>
@@ -33,6 +34,8 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #include <glm/glm.hpp>
 
+#include <atomic>
+
 namespace OSRE {
 namespace RenderBackend {
 
@@ -77,6 +80,17 @@ enum class BufferAccessType {
 enum class TextureFormatType {
     R8G8B8,
     R8G8B8A8,
+    BC1,    ///< Block compressed RGB, 8 bytes per 4x4 block ( DXT1 ).
+    BC2,    ///< Block compressed RGBA with explicit alpha, 16 bytes per block ( DXT3 ).
+    BC3,    ///< Block compressed RGBA with interpolated alpha, 16 bytes per block ( DXT5 ).
+    BC4,    ///< Block compressed single channel, 8 bytes per block.
+    BC5,    ///< Block compressed two channels like normal maps, 16 bytes per block.
+    BC6H,   ///< Block compressed HDR RGB, 16 bytes per block.
+    BC7,    ///< Block compressed high quality RGBA, 16 bytes per block.
+    BC1_SRGB, ///< BC1 with sRGB encoded color.
+    BC2_SRGB, ///< BC2 with sRGB encoded color.
+    BC3_SRGB, ///< BC3 with sRGB encoded color.
+    BC7_SRGB, ///< BC7 with sRGB encoded color.
     InvaliTextureType
 };
 
@@ -94,6 +108,7 @@ enum class TextureTargetType {
     Texture1D = 0, ///< 1D-textures, used for simple arrays in shaders.
     Texture2D, ///< 2D-textures, used for images and render targets.
     Texture3D, ///< 3D-textures, used for volume rendering.
+    Texture2DArray, ///< Layers of 2D-textures, used for texture atlases.
     NumTextureTargetTypes, ///< Number of enums.
 
     InvalidTextureTargetType ///< Enum for invalid enum.
@@ -295,6 +310,24 @@ struct OSRE_EXPORT RenderVert {
     static const String *getAttributes();
 };
 
+///	@brief  This struct declares the per-instance data for instanced draws. The model transform is
+///	stored as the first three rows of an affine matrix, so one instance fits into four attributes.
+struct OSRE_EXPORT InstanceVert {
+    glm::vec4 transform[3]; ///< The rows of the model transform
+    glm::vec4 color0; ///< The instance color ( r|g|b|a )
+
+    InstanceVert();
+    ~InstanceVert();
+    void setTransform(const glm::mat4 &m);
+    void getTransform(glm::mat4 &m) const;
+
+    /// @brief  Returns the number of attributes.
+    static size_t getNumAttributes();
+
+    /// @brief  Returns the attribute array.
+    static const String *getAttributes();
+};
+
 OSRE_EXPORT const String &getVertCompName(VertexAttribute attrib);
 
 ///	@brief  Utility function for calculate the vertex format size.
@@ -429,16 +462,36 @@ struct OSRE_EXPORT PrimitiveGroup {
     OSRE_NON_COPYABLE(PrimitiveGroup)
 };
 
+///	@brief  The part of a texture array used by a material, see TextureAtlas.
+///
+/// The region is folded into the texture coordinates: u is moved by the layer index, so the
+/// integer part selects the layer and the fraction is the u inside of the layer. Meshes of all
+/// regions share the material key of the array and can be drawn in one batch.
+struct OSRE_EXPORT TextureRegion {
+    ui32 m_layer;       ///< The layer of the array texture.
+    glm::vec4 m_uvRect; ///< The offset of the region in xy, the extent in zw.
+
+    TextureRegion();
+    TextureRegion(ui32 layer, const glm::vec4 &uvRect);
+    /// @brief  Maps a texture coordinate of the image into the array.
+    glm::vec2 map(const glm::vec2 &uv) const;
+    /// @brief  Maps the texture coordinates of the vertices, must be called once per vertex buffer.
+    void apply(RenderVert *vertices, size_t numVertices) const;
+};
+
 ///	@brief
 struct OSRE_EXPORT Texture {
     String m_textureName;
     IO::Uri m_loc;
     TextureTargetType m_targetType;
+    TextureFormatType m_format;     ///< Block compressed textures keep the whole container in m_data.
     ui32 m_size;
     uc8 *m_data;
     ui32 m_width;
     ui32 m_height;
     ui32 m_channels;
+    ui32 m_layers;                  ///< The number of layers of a Texture2DArray, stored one after the other.
+    ui32 m_numMipLevels;            ///< The number of mip levels to generate, 0 for the whole chain.
     Handle m_texHandle;
 
     Texture();
@@ -455,6 +508,17 @@ public:
     size_t load(const IO::Uri &uri, Texture *tex);
     bool unload(Texture *tex);
     static RenderBackend::Texture *getDefaultTexture();
+    /// @brief  When enabled, images are only located and m_loc points to the file. The render
+    /// backend decodes them on its scheduler while the textures are streamed in.
+    static void setDeferredDecoding(bool enabled);
+    static bool isDeferredDecoding();
+
+private:
+    size_t loadContainer(const String &path, Texture *tex);
+    size_t locateImage(const String &path, Texture *tex);
+
+private:
+    static std::atomic<bool> s_deferredDecoding;
 };
 
 ///	@brief
@@ -497,6 +561,7 @@ struct OSRE_EXPORT Material {
     f32 mShineness;
     f32 mShinenessStrength; 
     IO::Uri m_uri;
+    TextureRegion m_region;     ///< The region of a texture array, the whole first layer by default.
 
     Material(const String &name);
     Material(const String &name, const IO::Uri &uri);
@@ -508,12 +573,16 @@ struct OSRE_EXPORT Material {
     OSRE_NON_COPYABLE(Material)
 };
 
-///	@brief
+///	@brief  The per-instance data of an instanced mesh, one InstanceVert per instance.
 struct OSRE_EXPORT GeoInstanceData {
     BufferData *m_data;
+    ui32 m_numInstances;
 
     GeoInstanceData();
     ~GeoInstanceData();
+    void alloc(ui32 numInstances, BufferAccessType access);
+    void setInstance(ui32 idx, const glm::mat4 &transform, const glm::vec4 &color);
+    InstanceVert *getInstances() const;
 
     OSRE_NON_COPYABLE(GeoInstanceData)
 };
@@ -716,6 +785,15 @@ struct MeshEntry {
     ui32 numInstances;
     bool m_isDirty;
     CPPCore::TArray<Mesh *> m_geo;
+    GeoInstanceData *m_instanceData;
+
+    MeshEntry() :
+            numInstances(0),
+            m_isDirty(true),
+            m_geo(),
+            m_instanceData(nullptr) {
+        // empty
+    }
 };
 
 struct RenderBatchData {
@@ -778,6 +856,7 @@ struct OSRE_EXPORT UniformDataBlob {
 
 struct OSRE_EXPORT UniformVar {
     String m_name;
+    HashId m_hash; ///< The interned name, see StringUtils::hashName
     ParameterType m_type;
     ui32 m_numItems;
     UniformDataBlob m_data;
@@ -802,21 +881,31 @@ struct FrameSubmitCmd {
         UpdateUniforms = 8
     };
 
+    /// Payloads up to this size can be stored in the command itself
+    static const size_t InlineSize = 64;
+
     ui32 m_meshId;
     const c8 *m_passId;
     const c8 *m_batchId;
     ui32 m_updateFlags;
     size_t m_size;
     c8 *m_data;
+    c8 m_inline[InlineSize];
 
     FrameSubmitCmd() :
             m_meshId(999999), m_passId(nullptr), m_batchId(nullptr), m_updateFlags(0), m_size(0), m_data(nullptr) {
         // empty
     }
+
+    bool isInlined() const {
+        return m_data == m_inline;
+    }
 };
 
 using FrameSubmitCmdAllocator = CPPCore::TPoolAllocator<FrameSubmitCmd>;
 
+///	@brief  Serializes uniform variables as hash, name and data records. The submitting thread writes
+/// the changed variables of a frame, the render thread reads them back in the same order.
 struct UniformBuffer {
     UniformBuffer() :
             m_numvars(0),
@@ -840,6 +929,7 @@ struct UniformBuffer {
     }
 
     void reset() {
+        m_numvars = 0;
         m_pos = 0;
     }
 
@@ -864,12 +954,64 @@ struct UniformBuffer {
         ++m_numvars;
         ui32 varInfo = encode((ui16)var->m_name.size(), (ui16)var->m_data.m_size);
         write((c8 *)&varInfo, sizeof(ui32));
+        write((c8 *)&var->m_hash, sizeof(HashId));
+        write((c8 *)var->m_name.c_str(), var->m_name.size());
         write((c8 *)var->m_data.getData(), var->m_data.m_size);
     }
 
+    /// @brief  Reads the next variable without copying its data.
+    /// @param  name    [out] The name of the variable.
+    /// @param  size    [out] The size of the data.
+    /// @return Pointer to the data in the buffer, nullptr if the buffer was read completely.
+    const c8 *readVar(String &name, size_t &size) {
+        HashId hash(0);
+        const c8 *nameData(nullptr);
+        const c8 *data = readRecord(hash, nameData, size);
+        if (nullptr == data) {
+            return nullptr;
+        }
+        name.assign(nameData, data - nameData);
+
+        return data;
+    }
+
+    /// @brief  Reads the next variable by its interned name, the name itself will be skipped.
+    /// @param  hash    [out] The hashed name of the variable.
+    /// @param  size    [out] The size of the data.
+    /// @return Pointer to the data in the buffer, nullptr if the buffer was read completely.
+    const c8 *readVar(HashId &hash, size_t &size) {
+        const c8 *nameData(nullptr);
+        return readRecord(hash, nameData, size);
+    }
+
+    /// @brief  Reads the next record, name points to the not terminated name in the buffer.
+    const c8 *readRecord(HashId &hash, const c8 *&name, size_t &size) {
+        ui32 varInfo = 0;
+        if ((m_pos + sizeof(ui32) + sizeof(HashId)) > m_buffer.size()) {
+            return nullptr;
+        }
+        read((c8 *)&varInfo, sizeof(ui32));
+        read((c8 *)&hash, sizeof(HashId));
+        ui16 nameLen(0), dataLen(0);
+        decode(varInfo, nameLen, dataLen);
+        if ((m_pos + nameLen + dataLen) > m_buffer.size()) {
+            return nullptr;
+        }
+
+        name = &m_buffer[m_pos];
+        m_pos += nameLen;
+        const c8 *data = &m_buffer[m_pos];
+        size = dataLen;
+        m_pos += dataLen;
+
+        return data;
+    }
+
     void readVar(c8 *id, size_t &size, c8 *data) {
         ui32 varInfo = 0;
+        HashId hash(0);
         read((c8 *)&varInfo, sizeof(ui32));
+        read((c8 *)&hash, sizeof(HashId));
         ui16 nameLen(0), dataLen(0);
         decode(varInfo, nameLen, dataLen);
         read(id, nameLen);
@@ -887,10 +1029,15 @@ struct UniformBuffer {
     }
 
     void write(c8 *data, size_t size) {
-        if (0 == size || (m_pos + size) > m_buffer.size()) {
+        if (0 == size) {
             return;
         }
 
+        if ((m_pos + size) > m_buffer.size()) {
+            const size_t newSize = m_buffer.size() * 2;
+            m_buffer.resize(newSize > (m_pos + size) ? newSize : (m_pos + size));
+        }
+
         ::memcpy(&m_buffer[m_pos], data, size);
         m_pos += size;
     }
@@ -900,17 +1047,95 @@ struct UniformBuffer {
     MemoryBuffer m_buffer;
 };
 
+//-------------------------------------------------------------------------------------------------
+///	@ingroup	Engine
+///
+///	@brief  A linear allocator for the payloads of the submit commands of one frame. Allocations
+/// are bumped from the current block, when a block is full a new one will be chained. All memory
+/// is released in one step by reset, which also merges the blocks, so a frame of the same size
+/// will not allocate again.
+//-------------------------------------------------------------------------------------------------
+struct FrameArena {
+    static const size_t DefaultAlign = 16;
+
+    FrameArena();
+    ~FrameArena();
+    /// @brief  Will allocate the first block.
+    void create(size_t size);
+    /// @brief  Releases all blocks.
+    void destroy();
+    /// @brief  Returns aligned memory, valid until the next reset.
+    c8 *alloc(size_t size, size_t align = DefaultAlign);
+    /// @brief  Releases all allocations at once.
+    void reset();
+    /// @brief  Returns the number of bytes allocated since the last reset.
+    size_t getUsed() const;
+    /// @brief  Returns the size of all blocks.
+    size_t getCapacity() const;
+    /// @brief  Returns the number of chained blocks.
+    size_t getNumBlocks() const;
+
+    FrameArena(const FrameArena &) = delete;
+    FrameArena &operator=(const FrameArena &) = delete;
+
+private:
+    struct Block {
+        c8 *m_data;
+        size_t m_size;
+    };
+
+    void addBlock(size_t size);
+
+    ::CPPCore::TArray<Block> m_blocks;
+    size_t m_pos;
+    size_t m_used;
+};
+
+//-------------------------------------------------------------------------------------------------
+///	@ingroup	Engine
+///
+///	@brief  A fence to synchronize the reuse of a frame between the submitting thread and the
+/// render thread. The submitting thread marks the frame as pending when it was handed over to the
+/// render thread, the render thread retires it after the frame was rendered.
+//-------------------------------------------------------------------------------------------------
+struct FrameFence {
+    Platform::AtomicInt m_pending;
+    Platform::ThreadEvent m_retiredEvent;
+
+    FrameFence();
+    ~FrameFence();
+    /// @brief  Marks the frame as handed over to the render thread.
+    void submit();
+    /// @brief  Marks the frame as rendered, will wake up a waiting submitter.
+    void retire();
+    /// @brief  Blocks until the frame was retired by the render thread.
+    void wait();
+    /// @brief  Returns true, when the frame is still used by the render thread.
+    bool isPending();
+
+    FrameFence(const FrameFence &) = delete;
+    FrameFence &operator=(const FrameFence &) = delete;
+};
+
 struct Frame {
     ::CPPCore::TArray<PassData *> m_newPasses;
     ::CPPCore::TArray<FrameSubmitCmd *> m_submitCmds;
     FrameSubmitCmdAllocator m_submitCmdAllocator;
-    UniformBuffer *m_uniforBuffers;
+    UniformBuffer m_uniformBuffer;
+    FrameArena m_payloadArena;
+    bool m_inlinePayloads;
     Pipeline *m_pipeline;
+    FrameFence m_fence;
 
     Frame();
     ~Frame();
     void init(::CPPCore::TArray<PassData *> &newPasses);
     FrameSubmitCmd *enqueue();
+    /// @brief  Returns the payload storage for the command, small payloads will be stored in the
+    /// command when inlining is enabled, all others in the payload arena.
+    c8 *allocPayload(FrameSubmitCmd *cmd, size_t size);
+    /// @brief  Releases all submit commands and their payloads, called when they were consumed.
+    void releaseSubmitCmds();
 
     Frame(const Frame &) = delete;
     Frame(Frame &&) = delete;
@@ -29,8 +29,19 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 namespace OSRE {
 namespace RenderBackend {
 
+/// @brief  The features of a shader variant, a variant key combines them bit coded.
+enum class ShaderFeatureType : ui32 {
+    Textured = 1 << 0,      ///< Samples the texture of stage 0.
+    VertexColor = 1 << 1,   ///< Uses the per-vertex colour.
+    Instanced = 1 << 2,     ///< Reads the transform and the colour per instance.
+    Skinned = 1 << 3,       ///< Blends the position of up to four bones.
+    Lit = 1 << 4,           ///< Applies a fixed directional light.
+    TextureArray = 1 << 5   ///< Samples the layer of a texture array, which is selected by the texture coordinate.
+};
+
 class OSRE_EXPORT Shader {
 public:
+    String                   m_name;    ///< Materials with the same shader name share one program.
     CPPCore::TArray<String>  m_parameters;
     CPPCore::TArray<String>  m_attributes;
     String                   m_src[MaxShaderTypes];
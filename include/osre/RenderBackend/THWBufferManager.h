@@ -29,6 +29,8 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <cppcore/Container/TArray.h>
 #include <cppcore/Container/THashMap.h>
 
+#include <map>
+
 namespace OSRE {
 namespace RenderBackend {
 
@@ -37,10 +39,79 @@ struct VertexLayout;
 const c8 *getVertexCompShortCut(VertexAttribute &attrib);
 const c8 *getAccessShortCut(BufferAccessType access);
 
-template <class TBuffer>
+//-------------------------------------------------------------------------------------------------
+///	@ingroup	Engine
+///
+///	@brief  Manages the free ranges of a buffer. The first fitting range will be used, released
+/// ranges are merged with their neighbours.
+//-------------------------------------------------------------------------------------------------
+class OSRE_EXPORT OffsetAllocator {
+public:
+    static const size_t InvalidOffset = ~static_cast<size_t>(0);
+
+    OffsetAllocator();
+    ~OffsetAllocator();
+    /// @brief  Will reset the allocator to one free range of the given capacity.
+    void init(size_t capacity);
+    /// @brief  Returns the offset of the new range, InvalidOffset if no free range is large enough.
+    /// @param  size        [in] The size of the range.
+    /// @param  align       [in] The offset will be a multiple of it, need not be a power of two.
+    size_t alloc(size_t size, size_t align = 1);
+    /// @brief  Releases a range returned by alloc.
+    void release(size_t offset, size_t size);
+    size_t getCapacity() const;
+    size_t getUsed() const;
+    size_t getNumFreeRanges() const;
+
+private:
+    struct Range {
+        size_t m_offset;
+        size_t m_size;
+    };
+
+    void addFreeRange(size_t offset, size_t size);
+
+    CPPCore::TArray<Range> m_freeRanges;
+    size_t m_capacity;
+    size_t m_used;
+};
+
+///	@brief  A pair of shared vertex and index buffers for one vertex layout, including the vertex
+/// array describing it.
+template <class TBuffer, class TVertexArray>
+struct HWBufferPool {
+    ui64 m_key;
+    TBuffer *m_vertexBuffer;
+    TBuffer *m_indexBuffer;
+    TVertexArray *m_vertexArray;
+    OffsetAllocator m_vertexAllocator;
+    OffsetAllocator m_indexAllocator;
+};
+
+///	@brief  The ranges of one mesh inside of a buffer pool. The vertex offset is a multiple of
+/// the vertex size, so it can be used as the base vertex.
+template <class TBuffer, class TVertexArray>
+struct HWBufferRange {
+    HWBufferPool<TBuffer, TVertexArray> *m_pool;
+    size_t m_vertexOffset;
+    size_t m_vertexSize;
+    size_t m_indexOffset;
+    size_t m_indexSize;
+};
+
+//-------------------------------------------------------------------------------------------------
+///	@ingroup	Engine
+///
+///	@brief  Manages the hardware buffers by their vertex layout. Meshes with the same layout can
+/// be sub-allocated in shared buffer pools, so they can be drawn without switching the buffers.
+/// The pools do not own the buffers, they are created and released by the render backend.
+//-------------------------------------------------------------------------------------------------
+template <class TBuffer, class TVertexArray>
 class HWBufferManager {
 public:
     using BufferDict = CPPCore::THashMap<ui32, TBuffer*>;
+    using Pool = HWBufferPool<TBuffer, TVertexArray>;
+    using Range = HWBufferRange<TBuffer, TVertexArray>;
 
     HWBufferManager();
     ~HWBufferManager();
@@ -48,9 +119,27 @@ public:
     TBuffer *getBufferByDesc(VertexLayout vertexLayout, BufferAccessType access);
     void clear();
 
+    /// @brief  Will add a new pool for the layout key.
+    Pool *addPool(ui64 key, TBuffer *vertexBuffer, size_t vertexCapacity, TBuffer *indexBuffer,
+            size_t indexCapacity, TVertexArray *vertexArray);
+    /// @brief  Allocates the ranges for a mesh in the first pool of the layout with enough space.
+    /// @return true, if a pool was found.
+    bool allocRange(ui64 meshId, ui64 key, size_t vertexSize, size_t vertexAlign, size_t indexSize,
+            size_t indexAlign, Range &range);
+    /// @brief  Returns the ranges of a mesh, nullptr if the mesh is not stored in a pool.
+    const Range *getRange(ui64 meshId) const;
+    /// @brief  Releases the ranges of a mesh.
+    void releaseRange(ui64 meshId);
+    size_t getNumPools() const;
+    Pool *getPoolAt(size_t index) const;
+    /// @brief  Removes all pools and ranges.
+    void clearPools();
+
 private:
     CPPCore::TArray<TBuffer*> m_buffers;
     BufferDict m_bufferDict;
+    CPPCore::TArray<Pool*> m_pools;
+    std::map<ui64, Range> m_ranges;
 };
 
 inline void getBufferKey(const VertexLayout &vertexLayout, BufferAccessType access, ui32 &hash) {
@@ -63,20 +152,29 @@ inline void getBufferKey(const VertexLayout &vertexLayout, BufferAccessType acce
     hash = Common::StringUtils::hashName(key);
 }
 
-template <class TBuffer>
-inline HWBufferManager<TBuffer>::HWBufferManager() :
+///	@brief  The pool key for meshes, the index type is part of it because the indices of a pool
+/// share one type. The vertex array of a pool takes its attribute locations from the program,
+/// so the program id is kept in a field of its own.
+inline void getBufferKey(VertexType vertexType, IndexType indexType, ui32 programId, ui64 &key) {
+    key = (static_cast<ui64>(programId) << 32) | (static_cast<ui64>(vertexType) << 16) | static_cast<ui64>(indexType);
+}
+
+template <class TBuffer, class TVertexArray>
+inline HWBufferManager<TBuffer, TVertexArray>::HWBufferManager() :
         m_buffers(),
-        m_bufferDict() {
+        m_bufferDict(),
+        m_pools(),
+        m_ranges() {
     // empty
 }
 
-template <class TBuffer>
-inline HWBufferManager<TBuffer>::~HWBufferManager() {
-    // empty
+template <class TBuffer, class TVertexArray>
+inline HWBufferManager<TBuffer, TVertexArray>::~HWBufferManager() {
+    clearPools();
 }
 
-template <class TBuffer>
-TBuffer *HWBufferManager<TBuffer>::createBuffer(const VertexLayout &vertexLayout, BufferAccessType access) {
+template <class TBuffer, class TVertexArray>
+TBuffer *HWBufferManager<TBuffer, TVertexArray>::createBuffer(const VertexLayout &vertexLayout, BufferAccessType access) {
     TBuffer *buffer = new TBuffer();
 
     ui32 hash = 0;
@@ -89,8 +187,8 @@ TBuffer *HWBufferManager<TBuffer>::createBuffer(const VertexLayout &vertexLayout
     return buffer;
 }
 
-template <class TBuffer>
-inline TBuffer *HWBufferManager<TBuffer>::getBufferByDesc(VertexLayout vertexLayout, BufferAccessType access) {
+template <class TBuffer, class TVertexArray>
+inline TBuffer *HWBufferManager<TBuffer, TVertexArray>::getBufferByDesc(VertexLayout vertexLayout, BufferAccessType access) {
     if (m_buffers.isEmpty()) {
         return nullptr;
     }
@@ -105,8 +203,8 @@ inline TBuffer *HWBufferManager<TBuffer>::getBufferByDesc(VertexLayout vertexLay
     return buffer;
 }
 
-template <class TBuffer>
-inline void HWBufferManager<TBuffer>::clear() {
+template <class TBuffer, class TVertexArray>
+inline void HWBufferManager<TBuffer, TVertexArray>::clear() {
     for (ui32 i = 0; i < m_buffers.size(); ++i) {
         delete m_buffers[i];
     }
@@ -114,5 +212,100 @@ inline void HWBufferManager<TBuffer>::clear() {
     m_bufferDict.clear();
 }
 
+template <class TBuffer, class TVertexArray>
+inline HWBufferPool<TBuffer, TVertexArray> *HWBufferManager<TBuffer, TVertexArray>::addPool(ui64 key,
+        TBuffer *vertexBuffer, size_t vertexCapacity, TBuffer *indexBuffer, size_t indexCapacity,
+        TVertexArray *vertexArray) {
+    Pool *pool = new Pool;
+    pool->m_key = key;
+    pool->m_vertexBuffer = vertexBuffer;
+    pool->m_indexBuffer = indexBuffer;
+    pool->m_vertexArray = vertexArray;
+    pool->m_vertexAllocator.init(vertexCapacity);
+    pool->m_indexAllocator.init(indexCapacity);
+    m_pools.add(pool);
+
+    return pool;
+}
+
+template <class TBuffer, class TVertexArray>
+inline bool HWBufferManager<TBuffer, TVertexArray>::allocRange(ui64 meshId, ui64 key, size_t vertexSize,
+        size_t vertexAlign, size_t indexSize, size_t indexAlign, Range &range) {
+    for (ui32 i = 0; i < m_pools.size(); ++i) {
+        Pool *pool = m_pools[i];
+        if (key != pool->m_key) {
+            continue;
+        }
+
+        const size_t vertexOffset = pool->m_vertexAllocator.alloc(vertexSize, vertexAlign);
+        if (OffsetAllocator::InvalidOffset == vertexOffset) {
+            continue;
+        }
+        const size_t indexOffset = pool->m_indexAllocator.alloc(indexSize, indexAlign);
+        if (OffsetAllocator::InvalidOffset == indexOffset) {
+            pool->m_vertexAllocator.release(vertexOffset, vertexSize);
+            continue;
+        }
+
+        range.m_pool = pool;
+        range.m_vertexOffset = vertexOffset;
+        range.m_vertexSize = vertexSize;
+        range.m_indexOffset = indexOffset;
+        range.m_indexSize = indexSize;
+        releaseRange(meshId);
+        m_ranges[meshId] = range;
+
+        return true;
+    }
+
+    return false;
+}
+
+template <class TBuffer, class TVertexArray>
+inline const HWBufferRange<TBuffer, TVertexArray> *HWBufferManager<TBuffer, TVertexArray>::getRange(ui64 meshId) const {
+    typename std::map<ui64, Range>::const_iterator it = m_ranges.find(meshId);
+    if (it == m_ranges.end()) {
+        return nullptr;
+    }
+
+    return &it->second;
+}
+
+template <class TBuffer, class TVertexArray>
+inline void HWBufferManager<TBuffer, TVertexArray>::releaseRange(ui64 meshId) {
+    typename std::map<ui64, Range>::iterator it = m_ranges.find(meshId);
+    if (it == m_ranges.end()) {
+        return;
+    }
+
+    Range &range = it->second;
+    range.m_pool->m_vertexAllocator.release(range.m_vertexOffset, range.m_vertexSize);
+    range.m_pool->m_indexAllocator.release(range.m_indexOffset, range.m_indexSize);
+    m_ranges.erase(it);
+}
+
+template <class TBuffer, class TVertexArray>
+inline size_t HWBufferManager<TBuffer, TVertexArray>::getNumPools() const {
+    return m_pools.size();
+}
+
+template <class TBuffer, class TVertexArray>
+inline HWBufferPool<TBuffer, TVertexArray> *HWBufferManager<TBuffer, TVertexArray>::getPoolAt(size_t index) const {
+    if (index >= m_pools.size()) {
+        return nullptr;
+    }
+
+    return m_pools[index];
+}
+
+template <class TBuffer, class TVertexArray>
+inline void HWBufferManager<TBuffer, TVertexArray>::clearPools() {
+    for (ui32 i = 0; i < m_pools.size(); ++i) {
+        delete m_pools[i];
+    }
+    m_pools.clear();
+    m_ranges.clear();
+}
+
 } // namespace RenderBackend
 } // namespace OSRE
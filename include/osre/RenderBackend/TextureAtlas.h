@@ -0,0 +1,134 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2015-2020 OSRE ( Open Source Render Engine ) by Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#pragma once
+
+#include <osre/Common/osre_common.h>
+#include <osre/RenderBackend/RenderCommon.h>
+
+#include <map>
+
+namespace OSRE {
+namespace RenderBackend {
+
+//-------------------------------------------------------------------------------------------------
+///	@ingroup	Engine
+///
+///	@brief  Packs small images into the layers of a texture array.
+///
+/// The images are placed on shelves, a new layer is started when an image does not fit into the
+/// current ones. Adding the images sorted by height gives the best packing. Each image gets a
+/// border of padding pixels, which repeats its edge pixels. So neighbours do not bleed into it
+/// while filtering, up to the mip level where the border shrinks to one pixel. The texture
+/// created by the atlas stops at this level. The layers are stored as RGBA, the first row of an
+/// image maps to v = 0.
+//-------------------------------------------------------------------------------------------------
+class OSRE_EXPORT TextureAtlas {
+public:
+    /// The default border around each image, is safe for two mip levels.
+    static const ui32 DefaultPadding = 4;
+    /// The atlas stores RGBA pixels.
+    static const ui32 NumChannels = 4;
+
+    TextureAtlas();
+    ~TextureAtlas();
+    /// @brief  Creates the atlas.
+    /// @param  width       [in] The width of a layer.
+    /// @param  height      [in] The height of a layer.
+    /// @param  maxLayers   [in] The maximal number of layers.
+    /// @param  padding     [in] The border around each image in pixels, at least one.
+    /// @return false, if the atlas is already created or the size is invalid.
+    bool create(ui32 width, ui32 height, ui32 maxLayers, ui32 padding = DefaultPadding);
+    /// @brief  Releases all layers.
+    void destroy();
+    /// @brief  Adds an image.
+    /// @param  name        [in] The name to look up the region.
+    /// @param  pixels      [in] The pixels, rows are tightly packed.
+    /// @param  width       [in] The width of the image.
+    /// @param  height      [in] The height of the image.
+    /// @param  channels    [in] The number of channels, 1 to 4. Grey images get an opaque alpha.
+    /// @param  region      [out] The region of the image.
+    /// @return false, if the image does not fit into the remaining space. An image with a known
+    /// name is not added again, its region is returned.
+    bool add(const String &name, const uc8 *pixels, ui32 width, ui32 height, ui32 channels, TextureRegion &region);
+    /// @brief  Looks up the region of an image added before.
+    bool findRegion(const String &name, TextureRegion &region) const;
+    /// @brief  Creates a Texture2DArray with a copy of all layers, the caller owns it.
+    Texture *createTexture(const String &name) const;
+    /// @brief  Returns the pixels of a layer or nullptr.
+    const uc8 *getLayerData(ui32 layer) const;
+    ui32 getWidth() const;
+    ui32 getHeight() const;
+    ui32 getPadding() const;
+    /// @brief  Returns the last mip level, which is not bled into by the neighbours.
+    ui32 getMaxMipLevel() const;
+    ui32 getNumLayers() const;
+    ui32 getNumImages() const;
+
+private:
+    struct Shelf {
+        ui32 m_y;
+        ui32 m_height;
+        ui32 m_x;
+    };
+
+    struct Layer {
+        MemoryBuffer m_pixels;
+        CPPCore::TArray<Shelf> m_shelves;
+        ui32 m_top;
+    };
+
+    bool allocate(ui32 width, ui32 height, ui32 &layer, ui32 &x, ui32 &y);
+    bool allocateInLayer(Layer *layer, ui32 width, ui32 height, ui32 &x, ui32 &y);
+    void copy(Layer *layer, ui32 x, ui32 y, const uc8 *pixels, ui32 width, ui32 height, ui32 channels);
+
+private:
+    ui32 m_width;
+    ui32 m_height;
+    ui32 m_maxLayers;
+    ui32 m_padding;
+    CPPCore::TArray<Layer *> m_layers;
+    std::map<String, TextureRegion> m_regions;
+};
+
+inline ui32 TextureAtlas::getWidth() const {
+    return m_width;
+}
+
+inline ui32 TextureAtlas::getHeight() const {
+    return m_height;
+}
+
+inline ui32 TextureAtlas::getPadding() const {
+    return m_padding;
+}
+
+inline ui32 TextureAtlas::getNumLayers() const {
+    return static_cast<ui32>(m_layers.size());
+}
+
+inline ui32 TextureAtlas::getNumImages() const {
+    return static_cast<ui32>(m_regions.size());
+}
+
+} // Namespace RenderBackend
+} // Namespace OSRE
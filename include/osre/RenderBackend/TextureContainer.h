@@ -0,0 +1,133 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2015-2020 OSRE ( Open Source Render Engine ) by Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#pragma once
+
+#include <osre/Common/osre_common.h>
+#include <osre/RenderBackend/RenderCommon.h>
+#include <cppcore/Container/TArray.h>
+
+namespace OSRE {
+namespace RenderBackend {
+
+/// @brief  One mip level stored in a texture container.
+struct TextureMipLevel {
+    ui32 m_width;
+    ui32 m_height;
+    size_t m_offset;    ///< The offset of the pixel data in the container.
+    size_t m_size;      ///< The size of the pixel data in bytes.
+};
+
+//-------------------------------------------------------------------------------------------------
+///	@ingroup	Engine
+///
+///	@brief  Reads block compressed textures with their prebuilt mip chain from DDS and KTX2
+/// containers, the levels can be uploaded as they are.
+///
+/// Only 2D textures without supercompression are supported. The container does not copy the
+/// data, it has to stay valid as long as the levels are used.
+//-------------------------------------------------------------------------------------------------
+class OSRE_EXPORT TextureContainer {
+public:
+    /// @brief  The default class constructor.
+    TextureContainer();
+    /// @brief  The class destructor.
+    ~TextureContainer();
+    /// @brief  Returns true, if the data starts with the identifier of a DDS or KTX2 file.
+    static bool isContainer(const uc8 *data, size_t size);
+    /// @brief  Returns true, if the file extension is one of a supported container.
+    static bool isContainerFile(const String &filename);
+    /// @brief  Returns true for the block compressed formats.
+    static bool isCompressed(TextureFormatType format);
+    /// @brief  Returns the size of one 4x4 block in bytes, 0 for uncompressed formats.
+    static ui32 getBlockSize(TextureFormatType format);
+    /// @brief  Returns the size of one compressed level in bytes.
+    static size_t getLevelSize(TextureFormatType format, ui32 width, ui32 height);
+    /// @brief  Parses the header and the level table.
+    /// @param  data    [in] The file content.
+    /// @param  size    [in] The size of the file content.
+    /// @return false, if the container is broken or its format is not supported.
+    bool parse(const uc8 *data, size_t size);
+    /// @brief  Writes a DDS file.
+    /// @param  format      [in] The block compressed format.
+    /// @param  width       [in] The width of the first level.
+    /// @param  height      [in] The height of the first level.
+    /// @param  numLevels   [in] The number of levels.
+    /// @param  levels      [in] The levels, tightly packed from the largest to the smallest.
+    /// @param  size        [in] The size of all levels.
+    /// @param  buffer      [out] The file content.
+    /// @return false, if the size does not match the levels.
+    static bool writeDDS(TextureFormatType format, ui32 width, ui32 height, ui32 numLevels, const uc8 *levels,
+            size_t size, MemoryBuffer &buffer);
+    /// @brief  Returns the format of the levels.
+    TextureFormatType getFormat() const;
+    /// @brief  Returns the width of the first level.
+    ui32 getWidth() const;
+    /// @brief  Returns the height of the first level.
+    ui32 getHeight() const;
+    /// @brief  Returns the number of levels.
+    ui32 getNumLevels() const;
+    /// @brief  Returns a level, 0 is the largest one.
+    const TextureMipLevel &getLevel(ui32 level) const;
+    /// @brief  Returns the pixel data of a level.
+    const uc8 *getLevelData(ui32 level) const;
+
+private:
+    bool parseDDS();
+    bool parseKTX2();
+    bool addLevels(size_t offset, ui32 numLevels);
+
+private:
+    const uc8 *m_data;
+    size_t m_size;
+    TextureFormatType m_format;
+    ui32 m_width;
+    ui32 m_height;
+    CPPCore::TArray<TextureMipLevel> m_levels;
+};
+
+inline TextureFormatType TextureContainer::getFormat() const {
+    return m_format;
+}
+
+inline ui32 TextureContainer::getWidth() const {
+    return m_width;
+}
+
+inline ui32 TextureContainer::getHeight() const {
+    return m_height;
+}
+
+inline ui32 TextureContainer::getNumLevels() const {
+    return static_cast<ui32>(m_levels.size());
+}
+
+inline const TextureMipLevel &TextureContainer::getLevel(ui32 level) const {
+    return m_levels[level];
+}
+
+inline const uc8 *TextureContainer::getLevelData(ui32 level) const {
+    return &m_data[m_levels[level].m_offset];
+}
+
+} // Namespace RenderBackend
+} // Namespace OSRE
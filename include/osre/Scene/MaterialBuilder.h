@@ -32,14 +32,38 @@ namespace Scene {
 //-------------------------------------------------------------------------------------------------
 ///	@ingroup	Engine
 ///
-///	@brief  
+///	@brief  Creates the build-in materials. The shaders are generated from one source with a
+/// define per ShaderFeatureType. All materials requesting the same features use the same
+/// shader variant, so the program is compiled once and shared.
 //-------------------------------------------------------------------------------------------------
 class OSRE_EXPORT MaterialBuilder {
 public:
     static void create();
     static void destroy();
+    /// @brief  Returns the material for a shader variant.
+    /// @param  matName     [in] The name of the material.
+    /// @param  features    [in] The ShaderFeatureType values of the variant, bit coded.
+    /// @param  type        [in] The vertex type of the meshes using the material.
+    /// @return The material or nullptr, if the variant is not supported for the vertex type.
+    static RenderBackend::Material *createVariantMaterial( const String &matName, ui32 features, RenderBackend::VertexType type );
+    /// @brief  Returns the name of the program shared by all materials of a variant.
+    static String getVariantName( ui32 features );
+    /// @brief  Returns the defines, which select the features of a variant.
+    static String getVariantDefines( ui32 features );
+    /// @brief  Generates the shader sources of a variant.
+    static void getVariantSources( ui32 features, RenderBackend::ShaderSourceArray &sources );
     static RenderBackend::Material *createBuildinMaterial( RenderBackend::VertexType type );
     static RenderBackend::Material *createBuildinUiMaterial();
+    static RenderBackend::Material *createBuildinInstancedMaterial();
+    /// @brief  Returns a material for a region of a texture atlas. All materials of one atlas share
+    /// the texture and the program, so their meshes are drawn in one batch. The texture coordinates
+    /// of the meshes must be mapped by TextureRegion::apply.
+    /// @param  matName         [in] The name of the material.
+    /// @param  atlasTexture    [in] The texture array, see TextureAtlas::createTexture.
+    /// @param  region          [in] The region of the image in the atlas.
+    /// @return The material or nullptr, if the texture is not an array.
+    static RenderBackend::Material *createAtlasMaterial( const String &matName, RenderBackend::Texture *atlasTexture,
+            const RenderBackend::TextureRegion &region );
     static RenderBackend::Material* createTexturedMaterial(const String& matName, RenderBackend::TextureResourceArray& texResArray, 
         RenderBackend::VertexType type );
     static RenderBackend::Material* createTexturedMaterial(const String& matName, RenderBackend::TextureResourceArray& texResArray, 
@@ -48,6 +72,7 @@ public:
 private:
     MaterialBuilder();
     ~MaterialBuilder();
+    static void setupVariantShader( RenderBackend::Material *mat, ui32 features, RenderBackend::VertexType type );
 
 private:
     using MaterialFactory = Common::TResourceFactory<RenderBackend::Material>;
@@ -0,0 +1,289 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2015-2020 OSRE ( Open Source Render Engine ) by Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#pragma once
+
+#include <osre/Common/osre_common.h>
+#include <osre/Platform/Threading.h>
+#include <osre/Debugging/osre_debugging.h>
+
+#include <cppcore/Container/TArray.h>
+
+namespace OSRE {
+namespace Threading {
+
+class JobWorkerThread;
+class JobDeque;
+
+/// @brief  The function signature for a job entry point.
+typedef void (*JobFunc)(void *data);
+
+//-------------------------------------------------------------------------------------------------
+///	@ingroup	Engine
+///
+///	@brief  A job counter works as a fence for a group of jobs. Each job which was started with
+/// the counter will decrement it when it is done, so a counter with zero pending jobs means that
+/// the whole group is finished.
+//-------------------------------------------------------------------------------------------------
+class OSRE_EXPORT JobCounter {
+public:
+    /// @brief  The class default constructor.
+    JobCounter();
+
+    /// @brief  The class destructor.
+    ~JobCounter();
+
+    /// @brief  Returns the number of pending jobs.
+    /// @return The number of pending jobs.
+    i32 getPending();
+
+    /// @brief  Returns true, when all assigned jobs are done.
+    /// @return true for all jobs done, false if not.
+    bool isDone();
+
+    /// No copying.
+    JobCounter(const JobCounter &) = delete;
+    JobCounter &operator = (const JobCounter &) = delete;
+
+private:
+    friend class JobScheduler;
+
+    Platform::AtomicInt m_pending;
+};
+
+inline JobCounter::JobCounter() :
+        m_pending(0) {
+    // empty
+}
+
+inline JobCounter::~JobCounter() {
+    // empty
+}
+
+inline i32 JobCounter::getPending() {
+    return m_pending.getValue();
+}
+
+inline bool JobCounter::isDone() {
+    return 0 == m_pending.getValue();
+}
+
+//-------------------------------------------------------------------------------------------------
+///	@ingroup	Engine
+///
+///	@brief  Describes one job: the function to call, the user data and the counter to signal.
+//-------------------------------------------------------------------------------------------------
+struct Job {
+    JobFunc m_func;
+    void *m_data;
+    JobCounter *m_counter;
+
+    Job() :
+            m_func(nullptr),
+            m_data(nullptr),
+            m_counter(nullptr) {
+        // empty
+    }
+
+    Job(JobFunc func, void *data, JobCounter *counter) :
+            m_func(func),
+            m_data(data),
+            m_counter(counter) {
+        // empty
+    }
+};
+
+//-------------------------------------------------------------------------------------------------
+///	@ingroup	Engine
+///
+///	@brief  This class implements a work-stealing job scheduler.
+///
+/// The scheduler owns one worker thread per core. Each worker has its own job deque: the owner
+/// pushes and pops at the bottom, idle workers steal from the top of the other deques. Jobs which
+/// were started from a non-worker thread go into the shared injection deque. A thread waiting for
+/// a counter will help executing jobs instead of blocking, so nested jobs cannot deadlock.
+///
+/// Use this for short, data-parallel work like scene updates or mesh processing. Long-running
+/// services with their own event loop shall still use a SystemTask.
+///
+/// The workers are bound to the worker mask of the CPUInfo, so they never share the physical core
+/// reserved for the render thread.
+//-------------------------------------------------------------------------------------------------
+class OSRE_EXPORT JobScheduler {
+public:
+    ///	@brief	The factory method, creates a new scheduler and starts the workers.
+    /// @param  numWorkers  [in] The number of worker threads, 0 to use one per CPU of the worker
+    ///                          mask except the calling one.
+    /// @return The new scheduler instance.
+    static JobScheduler *create(ui32 numWorkers = 0);
+
+    ///	@brief	The class destructor, will stop and release all workers.
+    ~JobScheduler();
+
+    /// @brief  Starts one job.
+    /// @param  func        [in] The job function.
+    /// @param  data        [in] The user data passed to the job function.
+    /// @param  counter     [in] The counter to signal when done, may be nullptr.
+    void run(JobFunc func, void *data, JobCounter *counter);
+
+    /// @brief  Starts a group of jobs.
+    /// @param  jobs        [in] The jobs to start.
+    /// @param  numJobs     [in] The number of jobs.
+    /// @param  counter     [in] The counter to signal when done, may be nullptr.
+    void run(const Job *jobs, ui32 numJobs, JobCounter *counter);
+
+    /// @brief  Waits until all jobs assigned to the counter are done. The calling thread will
+    /// execute pending jobs meanwhile.
+    /// @param  counter     [in] The counter to wait for.
+    void wait(JobCounter *counter);
+
+    /// @brief  Executes one pending job on the calling thread, use this to help instead of
+    /// blocking while waiting for a result.
+    /// @return true, if a job was executed, false if no job was pending.
+    bool executePendingJob();
+
+    /// @brief  Calls the functor for each item in the array, the items are split into chunks
+    /// which will be processed in parallel. Returns when all items were processed.
+    /// @param  items       [in] The items to process.
+    /// @param  func        [in] The functor, called with the item and its index.
+    /// @param  chunkSize   [in] The number of items per job, 0 to select one.
+    template<class T, class TFunc>
+    void parallelFor(CPPCore::TArray<T> &items, TFunc func, ui32 chunkSize = 0);
+
+    /// @brief  Returns the number of worker threads.
+    /// @return The number of worker threads.
+    ui32 getNumWorkers() const;
+
+    /// @brief  Returns the number of executed jobs since creation.
+    /// @return The number of executed jobs.
+    i32 getNumExecutedJobs();
+
+    /// @brief  Returns the number of jobs taken from another deque.
+    /// @return The number of stolen jobs.
+    i32 getNumStolenJobs();
+
+    /// No copying.
+    JobScheduler(const JobScheduler &) = delete;
+    JobScheduler &operator = (const JobScheduler &) = delete;
+
+protected:
+    /// @brief  The class constructor.
+    /// @param  numWorkers  [in] The number of worker threads.
+    explicit JobScheduler(ui32 numWorkers);
+
+    /// @brief  Will try to fetch a job, first from the own deque, then from the others.
+    /// @param  workerIdx   [in] The index of the calling worker or the injection deque.
+    /// @param  job         [out] The fetched job.
+    /// @return true, if a job was fetched.
+    bool fetchJob(ui32 workerIdx, Job &job);
+
+    /// @brief  Executes the job and signals its counter.
+    /// @param  job         [in] The job to execute.
+    void execute(const Job &job);
+
+private:
+    friend class JobWorkerThread;
+
+    template<class T, class TFunc>
+    struct ParallelForChunk {
+        CPPCore::TArray<T> *m_items;
+        TFunc *m_func;
+        ui32 m_start;
+        ui32 m_end;
+
+        ParallelForChunk() :
+                m_items(nullptr),
+                m_func(nullptr),
+                m_start(0),
+                m_end(0) {
+            // empty
+        }
+
+        static void execute(void *data) {
+            ParallelForChunk *chunk = reinterpret_cast<ParallelForChunk *>(data);
+            CPPCore::TArray<T> &items = *chunk->m_items;
+            for (ui32 i = chunk->m_start; i < chunk->m_end; ++i) {
+                (*chunk->m_func)(items[i], i);
+            }
+        }
+    };
+
+    ui32 m_numWorkers;
+    CPPCore::TArray<JobWorkerThread *> m_workers;
+    CPPCore::TArray<JobDeque *> m_deques;
+    Platform::AtomicInt m_running;
+    Platform::AtomicInt m_numExecuted;
+    Platform::AtomicInt m_numStolen;
+};
+
+inline ui32 JobScheduler::getNumWorkers() const {
+    return m_numWorkers;
+}
+
+inline i32 JobScheduler::getNumExecutedJobs() {
+    return m_numExecuted.getValue();
+}
+
+inline i32 JobScheduler::getNumStolenJobs() {
+    return m_numStolen.getValue();
+}
+
+template<class T, class TFunc>
+inline void JobScheduler::parallelFor(CPPCore::TArray<T> &items, TFunc func, ui32 chunkSize) {
+    const ui32 numItems = static_cast<ui32>(items.size());
+    if (0 == numItems) {
+        return;
+    }
+
+    if (0 == chunkSize) {
+        // Some more chunks than threads to give the stealing a chance to balance the load
+        const ui32 numChunks = (m_numWorkers + 1) * 4;
+        chunkSize = numItems / numChunks;
+        if (0 == chunkSize) {
+            chunkSize = 1;
+        }
+    }
+
+    const ui32 numChunks = (numItems + chunkSize - 1) / chunkSize;
+    CPPCore::TArray<ParallelForChunk<T, TFunc>> chunks;
+    chunks.resize(numChunks);
+    CPPCore::TArray<Job> jobs;
+    jobs.resize(numChunks);
+    for (ui32 i = 0; i < numChunks; ++i) {
+        ParallelForChunk<T, TFunc> &chunk = chunks[i];
+        chunk.m_items = &items;
+        chunk.m_func = &func;
+        chunk.m_start = i * chunkSize;
+        chunk.m_end = chunk.m_start + chunkSize;
+        if (chunk.m_end > numItems) {
+            chunk.m_end = numItems;
+        }
+        jobs[i] = Job(&ParallelForChunk<T, TFunc>::execute, &chunk, nullptr);
+    }
+
+    JobCounter counter;
+    run(&jobs[0], numChunks, &counter);
+    wait(&counter);
+}
+
+} // Namespace Threading
+} // Namespace OSRE
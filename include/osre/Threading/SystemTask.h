@@ -22,8 +22,9 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 -----------------------------------------------------------------------------------------------*/
 #pragma once
 
+#include <osre/Platform/Threading.h>
 #include <osre/Threading/AbstractTask.h>
-#include <osre/Threading/TAsyncQueue.h>
+#include <osre/Threading/TMPSCQueue.h>
 #include <osre/Common/TObjPtr.h>
 
 namespace OSRE {
@@ -58,6 +59,11 @@ public:
     virtual void setBufferMode( BufferMode buffermode );
     virtual BufferMode getBufferMode() const;
 
+    ///	@brief	Sets prio and affinity of the task thread, must be called before start.
+    ///	@param	prio		[in] The thread prio.
+    ///	@param	affinityMask	[in] The affinity mask, 0 for no restriction.
+    void setThreadPlacement( Platform::Thread::Priority prio, ui64 affinityMask );
+
     ///	@brief	Overwritten, @see AbstractTask.
     virtual bool start( Platform::Thread *pThread );
 
@@ -114,7 +120,9 @@ private:
     WorkingMode m_workingMode;
     BufferMode m_buffermode;
     SystemTaskThread *m_taskThread;
-    typedef Threading::TAsyncQueue<const TaskJob*> TaskQueue;
+    Platform::Thread::Priority m_threadPrio;
+    ui64 m_threadAffinity;
+    typedef Threading::TMPSCQueue<TaskJob> TaskQueue;
     TaskQueue *m_asyncQueue;
 };
 
@@ -0,0 +1,256 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2015-2020 OSRE ( Open Source Render Engine ) by Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#pragma once
+
+#include <osre/Platform/Threading.h>
+#include <osre/Platform/SystemUtils.h>
+#include <osre/Debugging/osre_debugging.h>
+
+#include <cppcore/Container/TArray.h>
+
+#include <atomic>
+#include <cstdint>
+
+namespace OSRE {
+namespace Threading {
+
+//-------------------------------------------------------------------------------------------------
+///	@ingroup	Engine
+///
+///	@brief	This template class implements a bounded lock-free multi-producer/single-consumer
+/// queue.
+///
+/// The queue is a ring of slots, each slot stores a sequence number which tells the producers and
+/// the consumer who owns the slot. Producers claim a slot with one compare-and-swap, the consumer
+/// does not need any atomic read-modify-write at all. The consumer will only block on the event
+/// when the queue is empty, producers only signal when the consumer is sleeping.
+///
+/// Only one thread is allowed to call the dequeue-methods.
+//-------------------------------------------------------------------------------------------------
+template<class T>
+class TMPSCQueue {
+public:
+    ///	@brief	The class constructor.
+    ///	@param	capacity    [in] The max. number of items, will be rounded up to a power of two.
+    explicit TMPSCQueue(size_t capacity = 1024);
+
+    ///	@brief	The class destructor.
+    ~TMPSCQueue();
+
+    ///	@brief	Tries to enqueue a new item, can be called from any thread.
+    ///	@param	item	[in] The item to enqueue.
+    ///	@return	true, if the item was enqueued, false if the queue is full.
+    bool tryEnqueue(const T &item);
+
+    ///	@brief	Enqueues a new item, will wait while the queue is full.
+    ///	@param	item	[in] The item to enqueue.
+    void enqueue(const T &item);
+
+    ///	@brief	Tries to dequeue the next item, consumer only.
+    ///	@param	item	[out] The dequeued item.
+    ///	@return	true, if an item was dequeued, false if the queue is empty.
+    bool tryDequeue(T &item);
+
+    ///	@brief	Dequeues all items which are currently in the queue in one pass, consumer only.
+    ///	The order of the items will not be changed.
+    ///	@param	items	[out] The dequeued items, will be cleared before.
+    ///	@return	The number of dequeued items.
+    size_t dequeueAll(CPPCore::TArray<T> &items);
+
+    ///	@brief	Blocks until the queue contains at least one item, consumer only.
+    void awaitEnqueuedItem();
+
+    ///	@brief	Wakes up the consumer, even when nothing was enqueued.
+    void signalEnqueuedItem();
+
+    ///	@brief	Returns the number of enqueued items, only a snapshot.
+    ///	@return	The number of enqueued items.
+    size_t size() const;
+
+    ///	@brief	Returns true, if the queue is empty, consumer only.
+    ///	@return	true, if no item was enqueued.
+    bool isEmpty() const;
+
+    ///	@brief	Returns the capacity of the queue.
+    ///	@return	The capacity.
+    size_t capacity() const;
+
+    /// Copying is not allowed.
+    TMPSCQueue(const TMPSCQueue<T> &) = delete;
+    TMPSCQueue &operator = (const TMPSCQueue<T> &) = delete;
+
+private:
+    struct Slot {
+        std::atomic<size_t> m_sequence;
+        T m_item;
+    };
+
+    enum {
+        CacheLineSize = 64
+    };
+
+    Slot *m_slots;
+    size_t m_mask;
+    Platform::ThreadEvent *m_enqueueEvent;
+    c8 m_pad0[CacheLineSize];
+    std::atomic<size_t> m_enqueuePos;
+    c8 m_pad1[CacheLineSize];
+    std::atomic<size_t> m_dequeuePos;
+    std::atomic<i32> m_consumerWaiting;
+};
+
+template<class T>
+inline TMPSCQueue<T>::TMPSCQueue(size_t capacity) :
+        m_slots(nullptr),
+        m_mask(0),
+        m_enqueueEvent(nullptr),
+        m_enqueuePos(0),
+        m_dequeuePos(0),
+        m_consumerWaiting(0) {
+    size_t size = 2;
+    while (size < capacity) {
+        size <<= 1;
+    }
+    m_mask = size - 1;
+    m_slots = new Slot[size];
+    for (size_t i = 0; i < size; ++i) {
+        m_slots[i].m_sequence.store(i, std::memory_order_relaxed);
+    }
+    m_enqueueEvent = new Platform::ThreadEvent;
+}
+
+template<class T>
+inline TMPSCQueue<T>::~TMPSCQueue() {
+    delete m_enqueueEvent;
+    delete[] m_slots;
+}
+
+template<class T>
+inline bool TMPSCQueue<T>::tryEnqueue(const T &item) {
+    Slot *slot = nullptr;
+    size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+    for (;;) {
+        slot = &m_slots[pos & m_mask];
+        const size_t seq = slot->m_sequence.load(std::memory_order_acquire);
+        const intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+        if (0 == diff) {
+            if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            // The consumer did not free this slot yet, so the queue is full
+            return false;
+        } else {
+            pos = m_enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+
+    slot->m_item = item;
+    slot->m_sequence.store(pos + 1, std::memory_order_release);
+
+    // Pairs with the fence in awaitEnqueuedItem, only wake the consumer when it sleeps
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (0 != m_consumerWaiting.load(std::memory_order_relaxed)) {
+        m_enqueueEvent->signal();
+    }
+
+    return true;
+}
+
+template<class T>
+inline void TMPSCQueue<T>::enqueue(const T &item) {
+    while (!tryEnqueue(item)) {
+        m_enqueueEvent->signal();
+        System::SystemUtils::sleep(1);
+    }
+}
+
+template<class T>
+inline bool TMPSCQueue<T>::tryDequeue(T &item) {
+    const size_t pos = m_dequeuePos.load(std::memory_order_relaxed);
+    Slot &slot = m_slots[pos & m_mask];
+    const size_t seq = slot.m_sequence.load(std::memory_order_acquire);
+    if (seq != pos + 1) {
+        return false;
+    }
+
+    item = slot.m_item;
+    slot.m_sequence.store(pos + m_mask + 1, std::memory_order_release);
+    m_dequeuePos.store(pos + 1, std::memory_order_relaxed);
+
+    return true;
+}
+
+template<class T>
+inline size_t TMPSCQueue<T>::dequeueAll(CPPCore::TArray<T> &items) {
+    items.resize(0);
+    T item;
+    while (tryDequeue(item)) {
+        items.add(item);
+    }
+
+    return items.size();
+}
+
+template<class T>
+inline void TMPSCQueue<T>::awaitEnqueuedItem() {
+    if (!isEmpty()) {
+        return;
+    }
+
+    m_consumerWaiting.store(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    while (isEmpty()) {
+        m_enqueueEvent->waitForOne();
+    }
+    m_consumerWaiting.store(0, std::memory_order_relaxed);
+}
+
+template<class T>
+inline void TMPSCQueue<T>::signalEnqueuedItem() {
+    m_enqueueEvent->signal();
+}
+
+template<class T>
+inline size_t TMPSCQueue<T>::size() const {
+    const size_t enqueuePos = m_enqueuePos.load(std::memory_order_acquire);
+    const size_t dequeuePos = m_dequeuePos.load(std::memory_order_relaxed);
+
+    return enqueuePos > dequeuePos ? enqueuePos - dequeuePos : 0;
+}
+
+template<class T>
+inline bool TMPSCQueue<T>::isEmpty() const {
+    const size_t pos = m_dequeuePos.load(std::memory_order_relaxed);
+    const Slot &slot = m_slots[pos & m_mask];
+
+    return slot.m_sequence.load(std::memory_order_acquire) != pos + 1;
+}
+
+template<class T>
+inline size_t TMPSCQueue<T>::capacity() const {
+    return m_mask + 1;
+}
+
+} // Namespace Threading
+} // Namespace OSRE
@@ -0,0 +1,245 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2015-2020 OSRE ( Open Source Render Engine ) by Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#pragma once
+
+#include <osre/Threading/JobScheduler.h>
+#include <osre/Platform/Threading.h>
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <utility>
+
+namespace OSRE {
+namespace Threading {
+
+//-------------------------------------------------------------------------------------------------
+///	@ingroup	Engine
+///
+///	@brief  This template class implements an asynchronous task with a result, executed on the
+/// job scheduler.
+///
+/// A task is a lightweight handle to a shared state, so it can be copied. Use isReady to poll the
+/// result from the main loop without blocking, or then to chain a continuation which will be
+/// started on the scheduler as soon as the result is available. get will wait for the result and
+/// helps executing pending jobs meanwhile.
+///
+/// Without a scheduler the work will be done directly on the calling thread.
+//-------------------------------------------------------------------------------------------------
+template<class T>
+class TTask {
+public:
+    /// The function signature for the work to do.
+    using WorkFunc = std::function<T()>;
+
+    /// @brief  The default class constructor, creates an invalid task.
+    TTask();
+
+    /// @brief  The class destructor.
+    ~TTask();
+
+    /// @brief  Starts a new task.
+    /// @param  scheduler   [in] The scheduler to use, nullptr to do the work directly.
+    /// @param  func        [in] The work to do, returns the result.
+    /// @return The new task.
+    static TTask<T> run(JobScheduler *scheduler, WorkFunc func);
+
+    /// @brief  Creates a task which is already done.
+    /// @param  value       [in] The result.
+    /// @return The new task.
+    static TTask<T> fromValue(const T &value);
+
+    /// @brief  Returns true, if the task was started.
+    /// @return true, if valid.
+    bool isValid() const;
+
+    /// @brief  Returns true, if the result is available.
+    /// @return true, if the task is done.
+    bool isReady() const;
+
+    /// @brief  Waits until the task is done and returns the result.
+    /// @return The result.
+    const T &get() const;
+
+    /// @brief  Will chain a continuation, which gets the result of this task.
+    /// @param  func        [in] The continuation, called with the result.
+    /// @return The task of the continuation.
+    template<class TFunc>
+    auto then(TFunc func) const -> TTask<decltype(func(std::declval<const T &>()))>;
+
+private:
+    template<class U>
+    friend class TTask;
+
+    struct State {
+        JobScheduler *m_scheduler;
+        WorkFunc m_func;
+        T m_value;
+        std::atomic<bool> m_ready;
+        Platform::CriticalSection m_lock;
+        CPPCore::TArray<std::function<void()>> m_continuations;
+
+        explicit State(JobScheduler *scheduler) :
+                m_scheduler(scheduler),
+                m_func(),
+                m_value(),
+                m_ready(false),
+                m_lock(),
+                m_continuations() {
+            // empty
+        }
+
+        void complete(const T &value) {
+            m_value = value;
+            m_lock.enter();
+            m_ready = true;
+            CPPCore::TArray<std::function<void()>> continuations(m_continuations);
+            m_continuations.clear();
+            m_lock.leave();
+
+            for (ui32 i = 0; i < continuations.size(); ++i) {
+                continuations[i]();
+            }
+        }
+
+        void addContinuation(const std::function<void()> &continuation) {
+            m_lock.enter();
+            if (!m_ready) {
+                m_continuations.add(continuation);
+                m_lock.leave();
+                return;
+            }
+            m_lock.leave();
+            continuation();
+        }
+    };
+
+    using StatePtr = std::shared_ptr<State>;
+
+    explicit TTask(const StatePtr &state);
+    static void start(const StatePtr &state);
+    static void execute(void *data);
+
+    StatePtr m_state;
+};
+
+template<class T>
+inline TTask<T>::TTask() :
+        m_state() {
+    // empty
+}
+
+template<class T>
+inline TTask<T>::TTask(const StatePtr &state) :
+        m_state(state) {
+    // empty
+}
+
+template<class T>
+inline TTask<T>::~TTask() {
+    // empty
+}
+
+template<class T>
+inline TTask<T> TTask<T>::run(JobScheduler *scheduler, WorkFunc func) {
+    StatePtr state(new State(scheduler));
+    state->m_func = func;
+    start(state);
+
+    return TTask<T>(state);
+}
+
+template<class T>
+inline TTask<T> TTask<T>::fromValue(const T &value) {
+    StatePtr state(new State(nullptr));
+    state->complete(value);
+
+    return TTask<T>(state);
+}
+
+template<class T>
+inline bool TTask<T>::isValid() const {
+    return nullptr != m_state;
+}
+
+template<class T>
+inline bool TTask<T>::isReady() const {
+    OSRE_ASSERT(isValid());
+    return m_state->m_ready;
+}
+
+template<class T>
+inline const T &TTask<T>::get() const {
+    OSRE_ASSERT(isValid());
+    while (!m_state->m_ready) {
+        JobScheduler *scheduler = m_state->m_scheduler;
+        if (nullptr == scheduler || !scheduler->executePendingJob()) {
+            std::this_thread::yield();
+        }
+    }
+
+    return m_state->m_value;
+}
+
+template<class T>
+template<class TFunc>
+inline auto TTask<T>::then(TFunc func) const -> TTask<decltype(func(std::declval<const T &>()))> {
+    OSRE_ASSERT(isValid());
+    using U = decltype(func(std::declval<const T &>()));
+
+    StatePtr source(m_state);
+    typename TTask<U>::StatePtr state(new typename TTask<U>::State(source->m_scheduler));
+    state->m_func = [source, func]() {
+        return func(source->m_value);
+    };
+    source->addContinuation([state]() {
+        TTask<U>::start(state);
+    });
+
+    return TTask<U>(state);
+}
+
+template<class T>
+inline void TTask<T>::start(const StatePtr &state) {
+    if (nullptr == state->m_scheduler) {
+        state->complete(state->m_func());
+        return;
+    }
+
+    // The job owns one reference to the state until the work is done
+    state->m_scheduler->run(&TTask<T>::execute, new StatePtr(state), nullptr);
+}
+
+template<class T>
+inline void TTask<T>::execute(void *data) {
+    StatePtr *holder = reinterpret_cast<StatePtr *>(data);
+    StatePtr state(*holder);
+    delete holder;
+
+    state->complete(state->m_func());
+    state->m_func = nullptr;
+}
+
+} // Namespace Threading
+} // Namespace OSRE
@@ -0,0 +1,170 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2015-2020 OSRE ( Open Source Render Engine ) by Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#pragma once
+
+#include <osre/Threading/AbstractTask.h>
+#include <osre/Threading/JobScheduler.h>
+
+#include <cppcore/Container/TArray.h>
+
+namespace OSRE {
+namespace Threading {
+
+//-------------------------------------------------------------------------------------------------
+///	@ingroup	Engine
+///
+///	@brief  A task which calls a job function, use this to build graphs from plain functions.
+/// The task runs in the context of the thread which executes the graph.
+//-------------------------------------------------------------------------------------------------
+class OSRE_EXPORT GraphTask : public AbstractTask {
+public:
+    /// @brief  The class constructor.
+    /// @param  taskName    [in] The task name.
+    /// @param  func        [in] The function to call on execution.
+    /// @param  data        [in] The user data passed to the function.
+    GraphTask(const String &taskName, JobFunc func, void *data);
+
+    /// @brief  The class destructor, virtual.
+    virtual ~GraphTask();
+
+    void setWorkingMode(WorkingMode mode) override;
+    WorkingMode getWorkingMode() const override;
+    void setBufferMode(BufferMode buffermode) override;
+    BufferMode getBufferMode() const override;
+    bool execute() override;
+    void setThreadInstance(Platform::Thread *pThreadInstance) override;
+    void onUpdate() override;
+    void awaitUpdate() override;
+    void awaitStop() override;
+
+private:
+    JobFunc m_func;
+    void *m_data;
+};
+
+//-------------------------------------------------------------------------------------------------
+///	@ingroup	Engine
+///
+///	@brief  This class implements a dependency graph executor for tasks.
+///
+/// Each task declares its predecessors, either by addDependency or by the child tasks enqueued
+/// with AbstractTask::enqueue. A task becomes ready when all of its predecessors are done, ready
+/// tasks will be executed on the job scheduler. The graph is compiled once and can be executed
+/// each frame, for instance input -> update -> cull -> record -> submit.
+///
+/// After each execution the time spent in each task and the critical path, the chain of tasks
+/// which bounds the execution time of the whole graph, are available.
+//-------------------------------------------------------------------------------------------------
+class OSRE_EXPORT TaskGraph {
+public:
+    /// @brief  The class constructor.
+    TaskGraph();
+
+    /// @brief  The class destructor.
+    ~TaskGraph();
+
+    /// @brief  Will add a new task, the graph does not take the ownership.
+    /// @param  task        [in] The task to add.
+    /// @return true, if the task was added, false if it is nullptr or already part of the graph.
+    bool addTask(AbstractTask *task);
+
+    /// @brief  Declares that the task shall run after its predecessor, unknown tasks will be added.
+    /// @param  task        [in] The task.
+    /// @param  predecessor [in] The task which must be done before.
+    /// @return true, if the dependency was added.
+    bool addDependency(AbstractTask *task, AbstractTask *predecessor);
+
+    /// @brief  Will sort the tasks, execute will call this when the graph was changed.
+    /// @return true, if successful, false if the graph contains a cycle.
+    bool compile();
+
+    /// @brief  Executes all tasks and returns when all of them are done.
+    /// @param  scheduler   [in] The job scheduler, nullptr to execute the tasks in sequence.
+    /// @return true, if successful, false if the graph cannot be compiled.
+    bool execute(JobScheduler *scheduler);
+
+    /// @brief  Removes all tasks.
+    void clear();
+
+    /// @brief  Returns the number of tasks.
+    /// @return The number of tasks.
+    size_t getNumTasks() const;
+
+    /// @brief  Returns the time spent by the task during the last execution.
+    /// @param  task        [in] The task.
+    /// @return The time spent in the task.
+    Time getTaskTime(AbstractTask *task) const;
+
+    /// @brief  Returns the wall time of the last execution.
+    /// @return The wall time.
+    Time getExecutionTime() const;
+
+    /// @brief  Returns the summed up task time along the critical path of the last execution.
+    /// @return The critical path time.
+    Time getCriticalPathTime() const;
+
+    /// @brief  Returns the tasks along the critical path of the last execution, in order.
+    /// @return The tasks of the critical path.
+    const CPPCore::TArray<AbstractTask *> &getCriticalPath() const;
+
+    /// No copying.
+    TaskGraph(const TaskGraph &) = delete;
+    TaskGraph &operator = (const TaskGraph &) = delete;
+
+private:
+    struct Node;
+
+    i32 findNode(AbstractTask *task) const;
+    void runNode(Node *node);
+    void updateCriticalPath();
+    static void executeNode(void *data);
+
+private:
+    CPPCore::TArray<Node *> m_nodes;
+    CPPCore::TArray<Node *> m_sorted;
+    CPPCore::TArray<AbstractTask *> m_criticalPath;
+    JobScheduler *m_scheduler;
+    JobCounter *m_counter;
+    Time m_executionTime;
+    Time m_criticalPathTime;
+    bool m_dirty;
+};
+
+inline size_t TaskGraph::getNumTasks() const {
+    return m_nodes.size();
+}
+
+inline Time TaskGraph::getExecutionTime() const {
+    return m_executionTime;
+}
+
+inline Time TaskGraph::getCriticalPathTime() const {
+    return m_criticalPathTime;
+}
+
+inline const CPPCore::TArray<AbstractTask *> &TaskGraph::getCriticalPath() const {
+    return m_criticalPath;
+}
+
+} // Namespace Threading
+} // Namespace OSRE
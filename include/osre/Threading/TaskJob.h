@@ -39,9 +39,16 @@ namespace Threading {
 ///
 ///	@brief This class implements a simple container for events as ids and the assigned data, which 
 ///	are implemented as subclasses from the Common::EventData class ( @see Common::EventData ).
+///
+/// Task jobs are stored by value in the event queue of a system task, so sending an event will
+/// not allocate any memory. The event data is owned by the sender and must stay valid until the
+/// task has handled the event.
 //-------------------------------------------------------------------------------------------------
 class OSRE_EXPORT TaskJob {
 public:
+    ///	@brief	The default class constructor, creates an empty job.
+    TaskJob();
+
     ///	@brief	The class constructor with the event and the event data.
     ///	@param	pEvent		[in] A pointer showing to the event.
     ///	@param	pEventData	[in] A pointer showing to the event data.
@@ -66,16 +73,18 @@ public:
     ///	@brief	Clears the TaskJob-instance.
     void clear();
 
-private:
-    TaskJob();
-    TaskJob( const TaskJob & );
-    TaskJob &operator = ( const TaskJob & );
-
 private:
     const Common::Event *m_event;
     const Common::EventData *m_eventData;
 };
 
+inline
+TaskJob::TaskJob()
+: m_event( nullptr )
+, m_eventData( nullptr ) {
+    // empty
+}
+
 inline
 TaskJob::TaskJob( const Common::Event *pEvent, const Common::EventData *pEventData ) 
 : m_event( pEvent )
@@ -31,9 +31,11 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <osre/Math/BaseMath.h>
 #include <osre/Platform/AbstractWindow.h>
 #include <osre/Properties/Settings.h>
+#include <osre/RenderBackend/Mesh.h>
 #include <osre/RenderBackend/RenderBackendService.h>
 #include <osre/RenderBackend/RenderCommon.h>
 #include <osre/Scene/DbgRenderer.h>
+#include <osre/Scene/MaterialBuilder.h>
 #include <osre/Scene/MeshBuilder.h>
 #include <osre/Scene/MeshProcessor.h>
 #include <osre/Scene/Node.h>
@@ -48,21 +50,33 @@ using namespace ::OSRE::Scene;
 // To identify local log entries
 static const c8 *Tag = "InstancingApp";
 
-/// The example application, will create the render environment and render a simple triangle onto it
+// The instances are placed on a grid of 50 x 50 x 40 cubes
+static const ui32 GridX = 50;
+static const ui32 GridY = 50;
+static const ui32 GridZ = 40;
+static const ui32 NumInstances = GridX * GridY * GridZ;
+static const f32 CubeSize = 1.0f;
+static const f32 CubeSpacing = 2.0f;
+
+/// The example application, will render 100k cubes with one instanced draw call
 class InstancingApp : public App::AppBase {
-    App::Entity *mEntity;
     Scene::Camera *mCamera;
+    RenderBackend::Mesh *mMesh;
+    RenderBackend::GeoInstanceData *mInstanceData;
+    bool mInstancesAdded;
 
 public:
     InstancingApp(int argc, char *argv[]) :
             AppBase(argc, (const char **)argv, "api:model", "The render API:The model to load"),
-            mEntity(nullptr),
-            mCamera(nullptr) {
+            mCamera(nullptr),
+            mMesh(nullptr),
+            mInstanceData(nullptr),
+            mInstancesAdded(false) {
         // empty
     }
 
     virtual ~InstancingApp() {
-        // empty
+        delete mInstanceData;
     }
 
 protected:
@@ -91,38 +105,49 @@ protected:
         Rect2ui windowsRect;
         rootWindow->getWindowsRect(windowsRect);
 
-        Camera *camera = getActiveWorld()->addCamera("cam1");
-        camera->setProjectionParameters(60.f, (f32)windowsRect.m_width, (f32)windowsRect.m_height, 0.0001f, 1000.f);
-        mEntity = new App::Entity("instance", getActiveWorld()->getIds(), getActiveWorld());
+        mCamera = getActiveWorld()->addCamera("cam1");
+        mCamera->setProjectionParameters(60.f, (f32)windowsRect.m_width, (f32)windowsRect.m_height, 0.0001f, 1000.f);
         Scene::MeshBuilder meshBuilder;
-        AppBase::getActiveWorld()->addEntity(mEntity);
-//        RenderBackend::Mesh *mesh = meshBuilder.allocCube(VertexType::RenderVertex, 1, 2, 3, BufferAccessType::ReadWrite).getMesh();
-        RenderBackend::Mesh *mesh = meshBuilder.allocTriangles(VertexType::RenderVertex, BufferAccessType::ReadWrite).getMesh();
-        if (nullptr != mesh) {
-            RenderComponent *rc = (RenderComponent *)mEntity->getComponent(ComponentType::RenderComponentType);
-            rc->addStaticMesh(mesh);
-            Scene::MeshProcessor process;
-            process.addGeo(mesh);
-            process.execute();
-            Scene::Node::AABB aabb = process.getAABB();
-            Node *root = getActiveWorld()->getRootNode();
-            Node *geoNode = root->createChild("mesh_node");
-            geoNode->setAABB(aabb);
-            camera->observeBoundingBox(aabb);
+        mMesh = meshBuilder.allocCube(VertexType::RenderVertex, CubeSize, CubeSize, CubeSize, BufferAccessType::ReadOnly).getMesh();
+        if (nullptr == mMesh) {
+            osre_error(Tag, "Cannot create the cube mesh.");
+            return false;
+        }
+        mMesh->m_material = Scene::MaterialBuilder::createBuildinInstancedMaterial();
+
+        // Every instance gets its own transform and color
+        mInstanceData = new GeoInstanceData;
+        mInstanceData->alloc(NumInstances, BufferAccessType::ReadOnly);
+        Scene::Node::AABB aabb;
+        ui32 idx(0);
+        for (ui32 z = 0; z < GridZ; ++z) {
+            for (ui32 y = 0; y < GridY; ++y) {
+                for (ui32 x = 0; x < GridX; ++x) {
+                    const glm::vec3 pos(x * CubeSpacing, y * CubeSpacing, z * CubeSpacing);
+                    const glm::vec4 color((f32)x / GridX, (f32)y / GridY, (f32)z / GridZ, 1.0f);
+                    mInstanceData->setInstance(idx++, glm::translate(glm::mat4(1.0f), pos), color);
+                    aabb.merge(pos.x, pos.y, pos.z);
+                    aabb.merge(pos.x + CubeSize, pos.y + CubeSize, pos.z + CubeSize);
+                }
+            }
         }
+        mCamera->observeBoundingBox(aabb);
 
         return true;
     }
 
     void onUpdate() override {
-        // Rotate the model
-        glm::mat4 rot(1.0);
-
         RenderBackendService *rbSrv(getRenderBackendService());
 
         rbSrv->beginPass(PipelinePass::getPassNameById(RenderPassId));
         rbSrv->beginRenderBatch("b1");
 
+        // The instances are uploaded once and drawn with a single draw call per frame
+        if (!mInstancesAdded) {
+            rbSrv->addInstancedMesh(mMesh, mInstanceData);
+            mInstancesAdded = true;
+        }
+
         rbSrv->endRenderBatch();
         rbSrv->endPass();
 
@@ -134,7 +159,7 @@ protected:
 
 int main(int argc, char *argv[]) {
     InstancingApp myApp(argc, argv);
-    if (!myApp.initWindow(10, 10, 1024, 768, "ModelLoader-Sample", false, App::RenderBackendType::OpenGLRenderBackend)) {
+    if (!myApp.initWindow(10, 10, 1024, 768, "Instancing-Sample", false, App::RenderBackendType::OpenGLRenderBackend)) {
         return 1;
     }
 
@@ -0,0 +1,177 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2015-2020 OSRE ( Open Source Render Engine ) by Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#include <osre/App/AppBase.h>
+#include <osre/App/AssimpWrapper.h>
+#include <osre/App/Entity.h>
+#include <osre/App/World.h>
+#include <osre/Common/Ids.h>
+#include <osre/IO/Uri.h>
+#include <osre/Platform/AbstractWindow.h>
+#include <osre/Platform/PlatformOperations.h>
+#include <osre/RenderBackend/RenderBackendService.h>
+#include <osre/RenderBackend/RenderCommon.h>
+#include <osre/Scene/Camera.h>
+#include <osre/Threading/TTask.h>
+
+#include <sstream>
+
+using namespace ::OSRE;
+using namespace ::OSRE::App;
+using namespace ::OSRE::Common;
+using namespace ::OSRE::RenderBackend;
+using namespace ::OSRE::Threading;
+
+// To identify local log entries
+static const c8 *Tag = "AsyncLoadingApp";
+
+/// The example application, will import a model on the job scheduler while it keeps rendering
+class AsyncLoadingApp : public App::AppBase {
+    Scene::Camera *m_camera;
+    TTask<AssimpWrapper *> m_importTask;
+    ui32 m_numLoadingFrames;
+
+public:
+    AsyncLoadingApp(int argc, char *argv[]) :
+            AppBase(argc, (const char **)argv, "api", "The render API"),
+            m_camera(nullptr),
+            m_importTask(),
+            m_numLoadingFrames(0) {
+        // empty
+    }
+
+    ~AsyncLoadingApp() override {
+        // empty
+    }
+
+protected:
+    bool onCreate() override {
+        if (!AppBase::onCreate()) {
+            return false;
+        }
+
+        AppBase::setWindowsTitle("AsyncLoading sample! Press o to stream in an Asset");
+
+        return true;
+    }
+
+    bool onDestroy() override {
+        // The job scheduler and the material cache are released by the base, so do not leave a
+        // running import behind
+        if (m_importTask.isValid()) {
+            delete m_importTask.get();
+            m_importTask = TTask<AssimpWrapper *>();
+        }
+
+        return AppBase::onDestroy();
+    }
+
+    void startImport(const IO::Uri &modelLoc) {
+        // Only the file gets read and decoded on a worker thread. The material cache is not
+        // thread-safe, so the materials, meshes and the entity will be created on the main thread.
+        AssimpWrapper *assimpWrapper = new AssimpWrapper(*getIdContainer(), getActiveWorld());
+        m_importTask = TTask<AssimpWrapper *>::run(getJobScheduler(), [modelLoc, assimpWrapper]() -> AssimpWrapper * {
+            if (!assimpWrapper->readAsset(modelLoc, 0)) {
+                delete assimpWrapper;
+                return nullptr;
+            }
+
+            return assimpWrapper;
+        });
+        m_numLoadingFrames = 0;
+    }
+
+    void finishImport() {
+        AssimpWrapper *assimpWrapper = m_importTask.get();
+        m_importTask = TTask<AssimpWrapper *>();
+        Entity *entity = nullptr;
+        if (nullptr != assimpWrapper) {
+            entity = assimpWrapper->convertAsset();
+            delete assimpWrapper;
+        }
+        if (nullptr == entity) {
+            osre_error(Tag, "Cannot import asset.");
+            return;
+        }
+
+        std::stringstream stream;
+        stream << "Asset streamed in, " << m_numLoadingFrames << " frames were rendered meanwhile.";
+        osre_info(Tag, stream.str());
+
+        Platform::AbstractWindow *rootWindow = getRootWindow();
+        if (nullptr == rootWindow) {
+            return;
+        }
+
+        World *world = getActiveWorld();
+        if (nullptr == m_camera) {
+            Rect2ui windowsRect;
+            rootWindow->getWindowsRect(windowsRect);
+            m_camera = world->addCamera("camera");
+            m_camera->setProjectionParameters(60.f, (f32)windowsRect.m_width, (f32)windowsRect.m_height, 0.01f, 1000.f);
+        }
+
+        // The entity was added to the active world when it was created
+        m_camera->observeBoundingBox(entity->getAABB());
+    }
+
+    void onUpdate() override {
+        if (m_importTask.isValid()) {
+            // Poll the import, the main loop shall not be blocked
+            if (m_importTask.isReady()) {
+                finishImport();
+            } else {
+                ++m_numLoadingFrames;
+            }
+        } else if (AppBase::isKeyPressed(Platform::KEY_O)) {
+            IO::Uri modelLoc;
+            Platform::PlatformOperations::getFileOpenDialog("*", modelLoc);
+            if (modelLoc.isValid()) {
+                startImport(modelLoc);
+            }
+        }
+
+        RenderBackendService *rbSrv = getRenderBackendService();
+        rbSrv->beginPass(PipelinePass::getPassNameById(RenderPassId));
+        rbSrv->beginRenderBatch("b1");
+        rbSrv->endRenderBatch();
+        rbSrv->endPass();
+
+        AppBase::onUpdate();
+    }
+};
+
+int main(int argc, char *argv[]) {
+    AsyncLoadingApp myApp(argc, argv);
+    if (!myApp.initWindow(10, 10, 1024, 768, "AsyncLoading-Sample", false, App::RenderBackendType::OpenGLRenderBackend)) {
+        return 1;
+    }
+
+    while (myApp.handleEvents()) {
+        myApp.update();
+        myApp.requestNextFrame();
+    }
+
+    myApp.destroy();
+
+    return 0;
+}
@@ -38,6 +38,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <osre/RenderBackend/RenderBackendService.h>
 #include <osre/Scene/MaterialBuilder.h>
 #include <osre/Scene/Camera.h>
+#include <osre/Threading/JobScheduler.h>
 #include <osre/UI/Canvas.h>
 #include <osre/UI/FocusControl.h>
 #include <osre/UI/UiItemFactory.h>
@@ -129,6 +130,7 @@ AppBase::AppBase(i32 argc, const c8 *argv[], const String &supportedArgs, const
         m_mouseEvListener(nullptr),
         m_keyboardEvListener(nullptr),
         m_ids(nullptr),
+        m_jobScheduler(nullptr),
         m_shutdownRequested(false) {
     m_settings = new Properties::Settings;
     m_settings->setString(Properties::Settings::RenderAPI, "opengl");
@@ -236,6 +238,7 @@ World *AppBase::createWorld(const String &name) {
     }
 
     m_activeWorld = new World(name);
+    m_activeWorld->setJobScheduler(m_jobScheduler);
     m_worlds.add(m_activeWorld);
 
     return m_activeWorld;
@@ -384,9 +387,17 @@ bool AppBase::onCreate() {
 
     m_platformInterface->getPlatformEventHandler()->setRenderBackendService(m_rbService);
 
+    // create the job scheduler for the parallel world update and the texture decoding
+    m_jobScheduler = Threading::JobScheduler::create();
+
     // enable render-back-end
     RenderBackend::CreateRendererEventData *data = new RenderBackend::CreateRendererEventData(m_platformInterface->getRootWindow());
     data->m_pipeline = createDefaultPipeline();
+    data->m_staticBatching = m_rbService->getSettings()->getBool(Properties::Settings::StaticBatching);
+    data->m_shaderCacheDir = m_rbService->getSettings()->getString(Properties::Settings::ShaderCacheDir);
+    data->m_asyncShaderCompile = m_rbService->getSettings()->getBool(Properties::Settings::AsyncShaderCompile);
+    data->m_jobScheduler = m_jobScheduler;
+    data->m_textureUploadBudget = static_cast<ui32>(m_rbService->getSettings()->getInt(Properties::Settings::TextureUploadBudget));
     m_rbService->sendEvent(&RenderBackend::OnCreateRendererEvent, data);
 
     m_timer = Platform::PlatformInterface::getInstance()->getTimer();
@@ -394,6 +405,7 @@ bool AppBase::onCreate() {
     // create our world
     RenderMode mode = static_cast<RenderMode>(m_settings->get(Properties::Settings::RenderMode).getInt());
     m_activeWorld = new World("world", mode);
+    m_activeWorld->setJobScheduler(m_jobScheduler);
 
     Scene::MaterialBuilder::create();
 
@@ -464,6 +476,9 @@ bool AppBase::onDestroy() {
     delete m_activeWorld;
     m_activeWorld = nullptr;
 
+    delete m_jobScheduler;
+    m_jobScheduler = nullptr;
+
     delete m_ids;
     m_ids = nullptr;
 
@@ -474,11 +489,8 @@ bool AppBase::onDestroy() {
     return true;
 }
 
-static const i64 Conversion2Micro = 1000;
-
 void AppBase::onUpdate() {
-    i64 microsecs = m_timer->getMilliCurrentSeconds() * Conversion2Micro;
-    Time dt(microsecs);
+    const Time dt(m_timer->getDeltaTime());
     if (nullptr != m_activeWorld) {
         m_activeWorld->update(dt);
     }
@@ -509,6 +521,10 @@ Ids *AppBase::getIdContainer() const {
     return m_ids;
 }
 
+Threading::JobScheduler *AppBase::getJobScheduler() const {
+    return m_jobScheduler;
+}
+
 RenderBackend::Pipeline *AppBase::createDefaultPipeline() {
     Pipeline *pipeline = new Pipeline;
     PipelinePass *renderPass = new PipelinePass(RenderPassId, nullptr);
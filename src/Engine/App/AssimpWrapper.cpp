@@ -85,11 +85,22 @@ AssimpWrapper::AssimpWrapper(Common::Ids &ids, World *world) :
 AssimpWrapper::~AssimpWrapper() {
     ::CPPCore::ContainerClear(m_boneInfoArray);
 
+    delete m_scene;
+    m_scene = nullptr;
+
     delete mDefaultTexture;
     mDefaultTexture = nullptr;
 }
 
 bool AssimpWrapper::importAsset(const IO::Uri &file, ui32 flags) {
+    if (!readAsset(file, flags)) {
+        return false;
+    }
+
+    return nullptr != convertAsset();
+}
+
+bool AssimpWrapper::readAsset(const IO::Uri &file, ui32 flags) {
     if (!file.isValid()) {
         osre_error(Tag, "URI " + file.getUri() + " is invalid ");
         return false;
@@ -108,18 +119,25 @@ bool AssimpWrapper::importAsset(const IO::Uri &file, ui32 flags) {
     }
 
     filename = m_root + filename;
+    delete m_scene;
+    m_scene = nullptr;
+
+    // The scene shall outlive the importer, the conversion may be done later
     Importer myImporter;
-    m_scene = myImporter.ReadFile(filename, flags);
-    if (nullptr == m_scene) {
+    if (nullptr == myImporter.ReadFile(filename, flags)) {
         m_root = "";
         m_absPathWithFile = "";
         return false;
     }
-    convertScene();
+    m_scene = myImporter.GetOrphanedScene();
 
     return true;
 }
 
+Entity *AssimpWrapper::convertAsset() {
+    return convertScene();
+}
+
 Entity *AssimpWrapper::getEntity() const {
     return m_entity;
 }
@@ -105,6 +105,14 @@ bool Entity::preprocess() {
     return true;
 }
 
+bool Entity::preUpdate(Time dt) {
+    if (nullptr != m_behaviour) {
+        m_behaviour->preUpdate(dt);
+    }
+
+    return true;
+}
+
 bool Entity::update(Time dt) {
     if (nullptr != m_behaviour) {
         m_behaviour->update(dt);
@@ -113,6 +121,22 @@ bool Entity::update(Time dt) {
     return true;
 }
 
+bool Entity::postUpdate(Time dt) {
+    if (nullptr != m_behaviour) {
+        m_behaviour->postUpdate(dt);
+    }
+
+    return true;
+}
+
+bool Entity::isThreadSafe() const {
+    if (nullptr == m_behaviour) {
+        return false;
+    }
+
+    return m_behaviour->isThreadSafe();
+}
+
 bool Entity::render(RenderBackend::RenderBackendService *rbSrv) {
     m_renderComponent->render(rbSrv);
 
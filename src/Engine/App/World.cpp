@@ -27,6 +27,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <osre/Debugging/osre_debugging.h>
 #include <osre/RenderBackend/RenderBackendService.h>
 #include <osre/Scene/Camera.h>
+#include <osre/Threading/JobScheduler.h>
 
 namespace OSRE {
 namespace App {
@@ -35,6 +36,10 @@ using namespace ::CPPCore;
 using namespace ::OSRE::Common;
 using namespace ::OSRE::RenderBackend;
 using namespace ::OSRE::Scene;
+using namespace ::OSRE::Threading;
+
+// Below this number of thread-safe entities the job overhead is higher than the win
+static const ui32 MinParallelEntities = 256;
 
 static const c8 *Tag = "World";
 
@@ -54,6 +59,9 @@ World::World(const String &worldName, RenderMode renderMode) :
         m_views(),
         m_lookupViews(),
         m_entities(),
+        m_parallelEntities(),
+        m_rootNodes(),
+        m_jobScheduler(nullptr),
         m_activeCamera(nullptr),
         mRoot(nullptr),
         m_ids(),
@@ -168,18 +176,84 @@ Scene::Node *World::getRootNode() const {
     return mRoot;
 }
 
+void World::setJobScheduler(JobScheduler *scheduler) {
+    m_jobScheduler = scheduler;
+}
+
+JobScheduler *World::getJobScheduler() const {
+    return m_jobScheduler;
+}
+
 void World::update(Time dt) {
     if (nullptr != m_activeCamera) {
         m_activeCamera->update(dt);
     }
 
+    // Pre-update phase, serial
+    for (ui32 i = 0; i < m_entities.size(); ++i) {
+        Entity *entity = m_entities[i];
+        if (nullptr == entity) {
+            continue;
+        }
+
+        entity->preUpdate(dt);
+    }
+
+    // Update phase, the thread-safe entities will be collected for the parallel update
+    m_parallelEntities.resize(0);
+    for (ui32 i = 0; i < m_entities.size(); ++i) {
+        Entity *entity = m_entities[i];
+        if (nullptr == entity) {
+            continue;
+        }
+
+        if (entity->isThreadSafe()) {
+            m_parallelEntities.add(entity);
+        } else {
+            entity->update(dt);
+        }
+    }
+
+    if (nullptr != m_jobScheduler && m_parallelEntities.size() >= MinParallelEntities) {
+        m_jobScheduler->parallelFor(m_parallelEntities, [dt](Entity *&entity, ui32) {
+            entity->update(dt);
+        });
+    } else {
+        for (ui32 i = 0; i < m_parallelEntities.size(); ++i) {
+            m_parallelEntities[i]->update(dt);
+        }
+    }
+
+    // Post-update phase, serial
     for (ui32 i = 0; i < m_entities.size(); ++i) {
         Entity *entity = m_entities[i];
         if (nullptr == entity) {
             continue;
         }
 
-        entity->update(dt);
+        entity->postUpdate(dt);
+    }
+
+    // The node hierarchies are updated from their roots, so nodes of child entities are updated
+    // only once
+    m_rootNodes.resize(0);
+    for (ui32 i = 0; i < m_entities.size(); ++i) {
+        Entity *entity = m_entities[i];
+        if (nullptr == entity || nullptr == entity->getNode()) {
+            continue;
+        }
+
+        Node *root = entity->getNode();
+        while (nullptr != root->getParent()) {
+            root = root->getParent();
+        }
+        if (m_rootNodes.end() == m_rootNodes.find(root)) {
+            m_rootNodes.add(root);
+        }
+    }
+
+    for (ui32 i = 0; i < m_rootNodes.size(); ++i) {
+        m_rootNodes[i]->update(dt);
     }
 }
 
@@ -27,24 +27,29 @@ namespace OSRE {
 
 static const c8 *Tag = "Common";
 
-size_t MemoryStatistics::sAllocated = 0;
-size_t MemoryStatistics::sNumNew = 0;
-size_t MemoryStatistics::sActiveAllocs = 0;
+std::atomic<size_t> MemoryStatistics::sAllocated(0);
+std::atomic<size_t> MemoryStatistics::sNumNew(0);
+std::atomic<size_t> MemoryStatistics::sActiveAllocs(0);
 
 void MemoryStatistics::addAllocated( size_t allocSize ) {
-    sNumNew++;
-    sActiveAllocs++;
-    sAllocated += allocSize;
+    sNumNew.fetch_add(1, std::memory_order_relaxed);
+    sActiveAllocs.fetch_add(1, std::memory_order_relaxed);
+    sAllocated.fetch_add(allocSize, std::memory_order_relaxed);
 }
+
 void MemoryStatistics::releaseAlloc() {
-    sActiveAllocs--;
+    sActiveAllocs.fetch_sub(1, std::memory_order_relaxed);
+}
+
+size_t MemoryStatistics::getNumAllocs() {
+    return sNumNew.load(std::memory_order_relaxed);
 }
 
 void MemoryStatistics::showStatistics() {
     osre_info(Tag, "Memory-Statistics\n=================");
     std::stringstream stream;
-    stream << "\nSum Allocs      : " << sNumNew << "\n";
-    stream << "Number of leaks : " << sActiveAllocs << "\n";
+    stream << "\nSum Allocs      : " << sNumNew.load() << "\n";
+    stream << "Number of leaks : " << sActiveAllocs.load() << "\n";
     osre_info(Tag, stream.str());
 }
 
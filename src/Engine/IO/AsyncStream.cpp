@@ -0,0 +1,73 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2015-2020 OSRE ( Open Source Render Engine ) by Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#include <osre/IO/AsyncStream.h>
+#include <osre/IO/IOService.h>
+#include <osre/IO/Uri.h>
+#include <osre/Common/Logger.h>
+
+namespace OSRE {
+namespace IO {
+
+using namespace ::OSRE::Threading;
+
+static const c8 *Tag = "AsyncStream";
+
+TTask<ui32> AsyncStream::read(JobScheduler *scheduler, Stream *stream, void *buffer, ui32 size) {
+    if (nullptr == stream || nullptr == buffer || 0 == size) {
+        return TTask<ui32>::fromValue(0);
+    }
+
+    return TTask<ui32>::run(scheduler, [stream, buffer, size]() {
+        return stream->read(buffer, size);
+    });
+}
+
+TTask<MemoryBuffer> AsyncStream::readFile(JobScheduler *scheduler, const Uri &file) {
+    return TTask<MemoryBuffer>::run(scheduler, [file]() {
+        MemoryBuffer content;
+        IOService *ioService = IOService::getInstance();
+        if (nullptr == ioService) {
+            osre_error(Tag, "IOService not created.");
+            return content;
+        }
+
+        Stream *stream = ioService->openStream(file, Stream::AccessMode::ReadAccessBinary);
+        if (nullptr == stream) {
+            osre_error(Tag, "Cannot open " + file.getAbsPath());
+            return content;
+        }
+
+        const ui32 size = stream->getSize();
+        if (0 != size) {
+            content.resize(size);
+            const ui32 numRead = stream->read(&content[0], size);
+            content.resize(numRead);
+        }
+        ioService->closeStream(&stream);
+
+        return content;
+    });
+}
+
+} // Namespace IO
+} // Namespace OSRE
@@ -51,7 +51,8 @@ static AbstractFileSystem *createFS( const Uri &file ) {
 
 IOService::IOService() 
 : AbstractService( "io/ioserver" )
-, m_mountedMap() {
+, m_mountedMap()
+, m_streamLock() {
     CREATE_SINGLETON( IOService );
 
     m_mountedMap["file"] = new LocaleFileSystem();
@@ -117,7 +118,10 @@ Stream *IOService::openStream( const Uri &file, Stream::AccessMode mode ) {
     Stream *pStream( nullptr );
     AbstractFileSystem *pFS = getFileSystem( file.getScheme() );
     if ( pFS ) {
+        // The file systems track their open streams
+        m_streamLock.enter();
         pStream  = pFS->open( file, mode );
+        m_streamLock.leave();
     }
 
     return pStream;
@@ -131,7 +135,9 @@ void IOService::closeStream( Stream **ppStream ) {
     const String &schema( (*ppStream)->getUri().getScheme() );
     AbstractFileSystem *pFS = getFileSystem( schema );
     if( pFS ) {
+        m_streamLock.enter();
         pFS->close( ppStream );
+        m_streamLock.leave();
     }
 }
 
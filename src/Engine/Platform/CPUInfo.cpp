@@ -25,14 +25,52 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #  include <osre/Platform/Windows/MinWindows.h>
 #else
 #   include <unistd.h>
+#   include <cstdio>
+#   include <cstdlib>
 #endif
 
+#include <map>
+
 namespace OSRE {
 namespace Platform {
 
 bool CPUInfo::m_IsInited  = false;
 i32  CPUInfo::m_CPUFlags  = CPUID_None;
 ui32 CPUInfo::m_NumCPUs   = 0;
+ui32 CPUInfo::m_NumPhysicalCores = 0;
+ui32 CPUInfo::m_NumCacheDomains  = 0;
+ui32 CPUInfo::m_PhysicalCore[ CPUInfo::MaxCPUs ] = {};
+ui32 CPUInfo::m_CacheDomain[ CPUInfo::MaxCPUs ]  = {};
+ui64 CPUInfo::m_RenderMask = 0;
+ui64 CPUInfo::m_WorkerMask = 0;
+
+static const c8 *SysfsCPURoot = "/sys/devices/system/cpu";
+
+#ifndef OSRE_WINDOWS
+//-------------------------------------------------------------------------------------------------
+//	Reads the first line of a sysfs file, trailing whitespaces will be removed.
+//-------------------------------------------------------------------------------------------------
+static bool readSysfsValue( const String &path, String &value ) {
+    FILE *file = ::fopen( path.c_str(), "r" );
+    if ( nullptr == file ) {
+        return false;
+    }
+
+    c8 buffer[ 256 ];
+    const bool ok = nullptr != ::fgets( buffer, sizeof( buffer ), file );
+    ::fclose( file );
+    if ( !ok ) {
+        return false;
+    }
+
+    value = buffer;
+    while ( !value.empty() && ( '\n' == value.back() || ' ' == value.back() ) ) {
+        value.pop_back();
+    }
+
+    return true;
+}
+#endif
 
 //-------------------------------------------------------------------------------------------------
 //	Looks for the CPU ids.
@@ -207,6 +245,50 @@ i32 CPUInfo::getCPUProperties() const {
     return m_CPUFlags;
 }
 
+ui32 CPUInfo::getNumPhysicalCores() const {
+    return m_NumPhysicalCores;
+}
+
+ui32 CPUInfo::getNumCacheDomains() const {
+    return m_NumCacheDomains;
+}
+
+ui32 CPUInfo::getPhysicalCore( ui32 cpu ) const {
+    if ( cpu >= MaxCPUs ) {
+        return 0;
+    }
+
+    return m_PhysicalCore[ cpu ];
+}
+
+ui32 CPUInfo::getCacheDomain( ui32 cpu ) const {
+    if ( cpu >= MaxCPUs ) {
+        return 0;
+    }
+
+    return m_CacheDomain[ cpu ];
+}
+
+ui64 CPUInfo::getPhysicalCoreMask( ui32 core ) const {
+    ui64 mask( 0 );
+    const ui32 numCPUs = m_NumCPUs < MaxCPUs ? m_NumCPUs : MaxCPUs;
+    for ( ui32 cpu = 0; cpu < numCPUs; ++cpu ) {
+        if ( core == m_PhysicalCore[ cpu ] ) {
+            mask |= ( ui64 ) 1 << cpu;
+        }
+    }
+
+    return mask;
+}
+
+ui64 CPUInfo::getRenderThreadMask() const {
+    return m_RenderMask;
+}
+
+ui64 CPUInfo::getWorkerThreadMask() const {
+    return m_WorkerMask;
+}
+
 bool CPUInfo::isInited() {
     return m_IsInited;
 }
@@ -220,6 +302,7 @@ bool CPUInfo::init() {
         return false;
     }
 
+    initTopology( SysfsCPURoot );
     m_IsInited = true;
 
     return true;
@@ -261,6 +344,9 @@ bool CPUInfo::initCPUProperties() {
         m_CPUFlags |= CPUID_SSE3;
     }
     */
+    SYSTEM_INFO sysInfo;
+    ::GetSystemInfo( &sysInfo );
+    m_NumCPUs = sysInfo.dwNumberOfProcessors;
 #else
     m_NumCPUs = sysconf( _SC_NPROCESSORS_ONLN );
 #endif
@@ -268,5 +354,99 @@ bool CPUInfo::initCPUProperties() {
     return true;
 }
 
+bool CPUInfo::initTopology( const String &sysfsCPURoot ) {
+    const ui32 numCPUs = m_NumCPUs < MaxCPUs ? m_NumCPUs : MaxCPUs;
+    m_NumPhysicalCores = 0;
+    m_NumCacheDomains = 0;
+
+    bool success( false );
+#ifndef OSRE_WINDOWS
+    // SMT siblings report the same core id inside of one package, CPUs sharing the last level cache
+    // report the same list of CPUs for the highest cache index
+    static const ui32 MaxCacheIndices = 8;
+    std::map<ui64, ui32> cores;
+    std::map<String, ui32> domains;
+    success = 0 != numCPUs;
+    for ( ui32 cpu = 0; cpu < numCPUs; ++cpu ) {
+        const String cpuPath( sysfsCPURoot + "/cpu" + osre_to_string( cpu ) );
+        String coreId, packageId;
+        if ( !readSysfsValue( cpuPath + "/topology/core_id", coreId ) ||
+                !readSysfsValue( cpuPath + "/topology/physical_package_id", packageId ) ) {
+            success = false;
+            break;
+        }
+
+        const ui64 coreKey = ( ( ui64 ) ::atoi( packageId.c_str() ) << 32 ) | ( ui32 ) ::atoi( coreId.c_str() );
+        std::map<ui64, ui32>::const_iterator coreIt( cores.find( coreKey ) );
+        if ( cores.end() == coreIt ) {
+            coreIt = cores.insert( std::make_pair( coreKey, ( ui32 ) cores.size() ) ).first;
+        }
+        m_PhysicalCore[ cpu ] = coreIt->second;
+
+        String sharedCPUs( "package" + packageId );
+        i32 maxLevel( -1 );
+        for ( ui32 index = 0; index < MaxCacheIndices; ++index ) {
+            const String indexPath( cpuPath + "/cache/index" + osre_to_string( index ) );
+            String level, cpuList;
+            if ( !readSysfsValue( indexPath + "/level", level ) ) {
+                break;
+            }
+            if ( ::atoi( level.c_str() ) > maxLevel && readSysfsValue( indexPath + "/shared_cpu_list", cpuList ) ) {
+                maxLevel = ::atoi( level.c_str() );
+                sharedCPUs = cpuList;
+            }
+        }
+
+        std::map<String, ui32>::const_iterator domainIt( domains.find( sharedCPUs ) );
+        if ( domains.end() == domainIt ) {
+            domainIt = domains.insert( std::make_pair( sharedCPUs, ( ui32 ) domains.size() ) ).first;
+        }
+        m_CacheDomain[ cpu ] = domainIt->second;
+    }
+
+    if ( success ) {
+        m_NumPhysicalCores = static_cast<ui32>( cores.size() );
+        m_NumCacheDomains = static_cast<ui32>( domains.size() );
+    }
+#else
+    (void) sysfsCPURoot;
+#endif
+
+    // No topology available, so each logical CPU is an own core
+    if ( !success ) {
+        for ( ui32 cpu = 0; cpu < numCPUs; ++cpu ) {
+            m_PhysicalCore[ cpu ] = cpu;
+            m_CacheDomain[ cpu ] = 0;
+        }
+        m_NumPhysicalCores = numCPUs;
+        m_NumCacheDomains = 0 != numCPUs ? 1 : 0;
+    }
+
+    initPlacement();
+
+    return success;
+}
+
+void CPUInfo::initPlacement() {
+    m_RenderMask = 0;
+    m_WorkerMask = 0;
+
+    // The render thread gets a physical core on its own, this only pays off when at least one more
+    // core is left for the workers
+    if ( m_NumPhysicalCores < 2 ) {
+        return;
+    }
+
+    const ui32 numCPUs = m_NumCPUs < MaxCPUs ? m_NumCPUs : MaxCPUs;
+    const ui32 renderCore = m_NumPhysicalCores - 1;
+    for ( ui32 cpu = 0; cpu < numCPUs; ++cpu ) {
+        if ( renderCore == m_PhysicalCore[ cpu ] ) {
+            m_RenderMask |= ( ui64 ) 1 << cpu;
+        } else {
+            m_WorkerMask |= ( ui64 ) 1 << cpu;
+        }
+    }
+}
+
 } // Namespace System
 } // Namespace OSRE
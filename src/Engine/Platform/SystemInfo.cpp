@@ -46,6 +46,10 @@ enum {
 bool                      SystemInfo::m_IsInited  = false;
 CPUInfo                  *SystemInfo::m_pCPUInfo  = nullptr;
 SystemInfo::ThreadNameMap SystemInfo::s_threadNames;
+SystemInfo::ThreadPlacementMap SystemInfo::s_threadPlacements;
+
+// Threads register themselves on startup, so the name map needs a guard
+static CriticalSection s_threadNamesLock;
 
 SystemInfo::SystemInfo() {
     // empty
@@ -89,6 +93,7 @@ CPUInfo *SystemInfo::getCPUInfo() {
 }
 
 bool SystemInfo::registerThreadName( const ThreadId &id, const String &name ) {
+    s_threadNamesLock.enter();
     ThreadNameMap::const_iterator it( s_threadNames.find( id.Id) );
     bool success( true );
     if ( s_threadNames.end() == it ) {
@@ -96,31 +101,40 @@ bool SystemInfo::registerThreadName( const ThreadId &id, const String &name ) {
     } else {
         success = false;
     }
+    s_threadNamesLock.leave();
 
     return success;
 }
 
 bool SystemInfo::unregisterThreadName( const ThreadId &id ) {
+    s_threadNamesLock.enter();
     ThreadNameMap::iterator it( s_threadNames.find( id.Id) );
     bool success( false );
     if ( s_threadNames.end() != it ) {
         s_threadNames.erase( it );
         success = true;
     } 
+    s_threadPlacements.erase( id.Id );
+    s_threadNamesLock.leave();
 
     return success;
 }
 
 String SystemInfo::getThreadName( const ThreadId &id ) {
+    s_threadNamesLock.enter();
     ThreadNameMap::const_iterator it( s_threadNames.find( id.Id) );
     if ( s_threadNames.end() != it ) {
-        return it->second;
+        const String name( it->second );
+        s_threadNamesLock.leave();
+        return name;
     } 
 
     std::stringstream stream;
     stream << "t" << id.Id;
     const String name( stream.str() );
     s_threadNames[ id.Id ] = name;
+    s_threadNamesLock.leave();
+
     return name;
 }
 
@@ -134,6 +148,62 @@ String SystemInfo::getCurrentThreadName() {
     return getThreadName( threadId );
 }
 
+void SystemInfo::registerThreadPlacement( const ThreadId &id, const ThreadPlacement &placement ) {
+    s_threadNamesLock.enter();
+    s_threadPlacements[ id.Id ] = placement;
+    s_threadNamesLock.leave();
+}
+
+bool SystemInfo::getThreadPlacement( const ThreadId &id, ThreadPlacement &placement ) {
+    s_threadNamesLock.enter();
+    ThreadPlacementMap::const_iterator it( s_threadPlacements.find( id.Id ) );
+    const bool found( s_threadPlacements.end() != it );
+    if ( found ) {
+        placement = it->second;
+    }
+    s_threadNamesLock.leave();
+
+    return found;
+}
+
+static const c8 *getPrioName( Thread::Priority prio ) {
+    switch ( prio ) {
+        case Thread::Priority::Low:
+            return "low";
+        case Thread::Priority::High:
+            return "high";
+        case Thread::Priority::Critical:
+            return "critical";
+        default:
+            break;
+    }
+
+    return "normal";
+}
+
+String SystemInfo::getPlacementInfo() {
+    CPUInfo::init();
+    CPUInfo info;
+
+    std::stringstream stream;
+    stream << "CPUs: " << info.getNumCPUs()
+           << ", physical cores: " << info.getNumPhysicalCores()
+           << ", cache domains: " << info.getNumCacheDomains() << "\n";
+    stream << std::hex << "render mask: 0x" << info.getRenderThreadMask()
+           << ", worker mask: 0x" << info.getWorkerThreadMask() << std::dec << "\n";
+
+    s_threadNamesLock.enter();
+    for ( ThreadPlacementMap::const_iterator it = s_threadPlacements.begin(); it != s_threadPlacements.end(); ++it ) {
+        const ThreadPlacement &placement( it->second );
+        stream << placement.m_name << ": prio " << getPrioName( placement.m_prio )
+               << ( placement.m_prioGranted ? "" : " (not granted)" )
+               << ", affinity 0x" << std::hex << placement.m_affinityMask << std::dec << "\n";
+    }
+    s_threadNamesLock.leave();
+
+    return stream.str();
+}
+
 bool SystemInfo::init() {
     if ( m_IsInited ) {
         return false;
@@ -0,0 +1,182 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2015-2020 OSRE ( Open Source Render Engine ) by Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#include <osre/Platform/Threading.h>
+
+#ifdef OSRE_USE_FUTEX
+
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+namespace OSRE {
+namespace Platform {
+
+static_assert(sizeof(std::atomic<i32>) == sizeof(i32), "A futex word must be a plain 32 bit int.");
+
+// The max. number of spin iterations before a contended enter parks the thread
+static const i32 MaxSpinCount = 100;
+
+static i32 futexWait(std::atomic<i32> *word, i32 expected, const struct timespec *timeout) {
+    return static_cast<i32>(::syscall(SYS_futex, reinterpret_cast<i32 *>(word), FUTEX_WAIT_PRIVATE, expected, timeout, nullptr, 0));
+}
+
+static void futexWake(std::atomic<i32> *word, i32 numWaiters) {
+    ::syscall(SYS_futex, reinterpret_cast<i32 *>(word), FUTEX_WAKE_PRIVATE, numWaiters, nullptr, nullptr, 0);
+}
+
+static inline void cpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+    __asm__ __volatile__("yield");
+#endif
+}
+
+// State of the critical section: 0 = free, 1 = taken, 2 = taken and threads are parked
+CriticalSection::CriticalSection() :
+        m_state(0),
+        m_spinEstimate(MaxSpinCount / 4),
+        m_numContended(0),
+        m_numParked(0) {
+    // empty
+}
+
+CriticalSection::~CriticalSection() {
+    // empty
+}
+
+void CriticalSection::enter() {
+    i32 state = 0;
+    if (m_state.compare_exchange_strong(state, 1, std::memory_order_acquire)) {
+        return;
+    }
+    m_numContended.fetch_add(1, std::memory_order_relaxed);
+
+    // Spin as long as the lock was usually held before, the estimate adapts to the observed spins
+    const i32 estimate = m_spinEstimate.load(std::memory_order_relaxed);
+    const i32 maxSpins = estimate * 2 + 10 < MaxSpinCount ? estimate * 2 + 10 : MaxSpinCount;
+    for (i32 spins = 0; spins < maxSpins; ++spins) {
+        cpuRelax();
+        state = 0;
+        if (0 == m_state.load(std::memory_order_relaxed) &&
+                m_state.compare_exchange_weak(state, 1, std::memory_order_acquire)) {
+            m_spinEstimate.store(estimate + (spins - estimate) / 8, std::memory_order_relaxed);
+            return;
+        }
+    }
+    m_spinEstimate.store(estimate + (maxSpins - estimate) / 8, std::memory_order_relaxed);
+
+    // Park until the owner leaves, marking the lock as contended so leave will wake us
+    state = m_state.exchange(2, std::memory_order_acquire);
+    while (0 != state) {
+        m_numParked.fetch_add(1, std::memory_order_relaxed);
+        futexWait(&m_state, 2, nullptr);
+        state = m_state.exchange(2, std::memory_order_acquire);
+    }
+}
+
+bool CriticalSection::tryEnter() {
+    i32 state = 0;
+    return m_state.compare_exchange_strong(state, 1, std::memory_order_acquire);
+}
+
+void CriticalSection::leave() {
+    if (1 != m_state.fetch_sub(1, std::memory_order_release)) {
+        m_state.store(0, std::memory_order_release);
+        futexWake(&m_state, 1);
+    }
+}
+
+// State of the event: 0 = not signaled, 1 = signaled. It is auto-reset, a wait consumes the signal.
+ThreadEvent::ThreadEvent() :
+        m_state(0),
+        m_numWaiters(0) {
+    // empty
+}
+
+ThreadEvent::~ThreadEvent() {
+    // empty
+}
+
+void ThreadEvent::signal() {
+    m_state.store(1);
+    if (0 != m_numWaiters.load()) {
+        futexWake(&m_state, 1);
+    }
+}
+
+void ThreadEvent::waitForOne() {
+    i32 state = 1;
+    while (!m_state.compare_exchange_strong(state, 0, std::memory_order_acquire)) {
+        m_numWaiters.fetch_add(1);
+        futexWait(&m_state, 0, nullptr);
+        m_numWaiters.fetch_sub(1);
+        state = 1;
+    }
+}
+
+void ThreadEvent::waitForAll() {
+    waitForOne();
+}
+
+void ThreadEvent::waitForTimeout(ui32 ms) {
+    if (0 == ms) {
+        waitForOne();
+        return;
+    }
+
+    struct timespec end;
+    ::clock_gettime(CLOCK_MONOTONIC, &end);
+    end.tv_sec += ms / 1000;
+    end.tv_nsec += (ms % 1000) * 1000000L;
+    if (end.tv_nsec >= 1000000000L) {
+        ++end.tv_sec;
+        end.tv_nsec -= 1000000000L;
+    }
+
+    i32 state = 1;
+    while (!m_state.compare_exchange_strong(state, 0, std::memory_order_acquire)) {
+        struct timespec now, timeout;
+        ::clock_gettime(CLOCK_MONOTONIC, &now);
+        timeout.tv_sec = end.tv_sec - now.tv_sec;
+        timeout.tv_nsec = end.tv_nsec - now.tv_nsec;
+        if (timeout.tv_nsec < 0) {
+            --timeout.tv_sec;
+            timeout.tv_nsec += 1000000000L;
+        }
+        if (timeout.tv_sec < 0) {
+            return;
+        }
+
+        m_numWaiters.fetch_add(1);
+        futexWait(&m_state, 0, &timeout);
+        m_numWaiters.fetch_sub(1);
+        state = 1;
+    }
+}
+
+} // Namespace Platform
+} // Namespace OSRE
+
+#endif // OSRE_USE_FUTEX
@@ -24,12 +24,29 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #include <SDL.h>
 
+#ifdef __linux__
+#   include <time.h>
+#endif
+
 namespace OSRE {
 namespace Platform {
 
+static i64 getClockNanoSeconds() {
+#ifdef __linux__
+    struct timespec ts;
+    ::clock_gettime( CLOCK_MONOTONIC_RAW, &ts );
+    return static_cast<i64>( ts.tv_sec ) * 1000000000L + static_cast<i64>( ts.tv_nsec );
+#else
+    // Split the conversion to avoid an overflow for large counter values
+    const i64 counter = static_cast<i64>( SDL_GetPerformanceCounter() );
+    const i64 freq = static_cast<i64>( SDL_GetPerformanceFrequency() );
+    return ( counter / freq ) * 1000000000L + ( counter % freq ) * 1000000000L / freq;
+#endif
+}
+
 SDL2Timer::SDL2Timer()
 : AbstractTimer( "platform/sdl2timer" )
-, m_lasttick( 0 ){
+, m_startTick( getClockNanoSeconds() ) {
     // empty
 }
 
@@ -37,25 +54,8 @@ SDL2Timer::~SDL2Timer( ) {
     // empty
 }
 
-i64 SDL2Timer::getMilliCurrentSeconds( ) {
-    i64 ticks =  static_cast<i64>( SDL_GetTicks() / 1000U );
-    return ticks;
-}
-
-i64 SDL2Timer::getTimeDiff( ) {
-    i64 currentTime = getMilliCurrentSeconds();
-    if ( m_lasttick == 0 ) {
-        m_lasttick = currentTime;
-        return 0;
-    } else {
-        i64 diff( currentTime - m_lasttick );
-        if( diff > 1000 ) {
-            diff = AbstractTimer::getRequestedTimeStep();
-        }
-        m_lasttick = currentTime;
-        
-        return diff;
-    }
+i64 SDL2Timer::getNanoCurrentSeconds( ) {
+    return getClockNanoSeconds() - m_startTick;
 }
 
 } // Namespace Platform
@@ -31,17 +31,17 @@ namespace Platform {
 ///	@class
 ///	@ingroup    Engine
 ///
-///	@brief
+///	@brief  The SDL2-based timer. On Linux CLOCK_MONOTONIC_RAW is used, which is not slewed by NTP,
+/// on all other platforms the SDL performance counter.
 //-------------------------------------------------------------------------------------------------
 class SDL2Timer : public AbstractTimer {
 public:
     SDL2Timer();
     virtual ~SDL2Timer();
-    i64 getMilliCurrentSeconds() override;
-    i64 getTimeDiff() override;
+    i64 getNanoCurrentSeconds() override;
 
 private:
-    i64 m_lasttick;
+    i64 m_startTick;
 };
 
 } // Namespace Platform
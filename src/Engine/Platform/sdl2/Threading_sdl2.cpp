@@ -5,6 +5,11 @@
 #include <SDL.h>
 #include <SDL_atomic.h>
 
+#ifdef __linux__
+#   include <pthread.h>
+#   include <sched.h>
+#endif
+
 namespace OSRE {
 namespace Platform {
 
@@ -14,8 +19,13 @@ static const c8 *Tag = "Threading_sdl2";
 
 }
 
+// The futex-based critical section and event are implemented in Threading_futex.cpp
+#ifndef OSRE_USE_FUTEX
+
 CriticalSection::CriticalSection() :
-        m_spinlock( 0 ) {
+        m_spinlock( 0 ),
+        m_numContended( 0 ),
+        m_numParked( 0 ) {
     // empty
 }
 
@@ -24,6 +34,11 @@ CriticalSection::~CriticalSection() {
 }
 
 void CriticalSection::enter() {
+    if ( SDL_TRUE == SDL_AtomicTryLock( &m_spinlock ) ) {
+        return;
+    }
+
+    m_numContended.fetch_add( 1, std::memory_order_relaxed );
     SDL_AtomicLock( &m_spinlock );
 }
 
@@ -39,6 +54,8 @@ void CriticalSection::leave() {
     SDL_AtomicUnlock( &m_spinlock );
 }
 
+#endif // OSRE_USE_FUTEX
+
 ThreadLocalStorage::ThreadLocalStorage() :
         m_index( 99999999 ) {
     // empty
@@ -66,6 +83,7 @@ Thread::Thread( const String &name, ui32 stacksize ) :
         m_stacksize( stacksize ),
         mThreadName( name ),
         m_Prio( Priority::Normal ),
+        m_affinity( 0 ),
         m_thread( nullptr ),
         m_threadSignal( nullptr ),
         mTls( nullptr ) {
@@ -176,6 +194,41 @@ Thread::Priority Thread::getPriority( ) const {
     return m_Prio;
 }
 
+#ifdef __linux__
+static bool setNativeAffinity( pthread_t thread, ui64 mask ) {
+    cpu_set_t cpuSet;
+    CPU_ZERO( &cpuSet );
+    for ( ui32 cpu = 0; cpu < 64; ++cpu ) {
+        if ( 0 != ( mask & ( ( ui64 ) 1 << cpu ) ) ) {
+            CPU_SET( cpu, &cpuSet );
+        }
+    }
+
+    return 0 == pthread_setaffinity_np( thread, sizeof( cpuSet ), &cpuSet );
+}
+#endif
+
+bool Thread::setAffinity( ui64 mask ) {
+#ifdef __linux__
+    m_affinity = mask;
+
+    // A running thread will be moved immediately, otherwise the mask is applied on start
+    if ( 0 != mask && ThreadState::Running == getCurrentState() && 0 != m_id.Id ) {
+        return setNativeAffinity( ( pthread_t ) m_id.Id, mask );
+    }
+
+    return true;
+#else
+    (void) mask;
+    osre_debug( Tag, "Thread affinity is not supported on this platform." );
+    return false;
+#endif
+}
+
+ui64 Thread::getAffinity() const {
+    return m_affinity;
+}
+
 ThreadLocalStorage *Thread::getThreadLocalStorage() {
     return mTls;
 }
@@ -192,31 +245,71 @@ ThreadId Thread::getThreadId() {
     return m_id;
 }
 
+bool Thread::applyPlacement( Thread *thread ) {
+    i32 retCode( 0 );
+    switch( thread->getPriority() ) {
+        case Priority::Low:
+            retCode = SDL_SetThreadPriority( SDL_THREAD_PRIORITY_LOW );
+            break;
+        case Priority::Normal:
+            retCode = SDL_SetThreadPriority( SDL_THREAD_PRIORITY_NORMAL );
+            break;
+        case Priority::High:
+            retCode = SDL_SetThreadPriority( SDL_THREAD_PRIORITY_HIGH );
+            break;
+        case Priority::Critical:
+#ifdef __linux__
+            {
+                // Round-robin real-time scheduling needs CAP_SYS_NICE, fall back to a high prio
+                struct sched_param param;
+                param.sched_priority = sched_get_priority_min( SCHED_RR );
+                retCode = pthread_setschedparam( pthread_self(), SCHED_RR, &param );
+            }
+            if ( 0 == retCode ) {
+                break;
+            }
+#endif
+            retCode = SDL_SetThreadPriority( SDL_THREAD_PRIORITY_HIGH );
+            break;
+        default:
+            retCode = 1;
+            break;
+    }
+
+    ui64 affinity( thread->getAffinity() );
+#ifdef __linux__
+    if ( 0 != affinity && !setNativeAffinity( pthread_self(), affinity ) ) {
+        osre_debug( Tag, "Cannot set affinity of thread " + thread->getName() + "." );
+        affinity = 0;
+    }
+#else
+    affinity = 0;
+#endif
+
+    ThreadPlacement placement;
+    placement.m_name = thread->getName();
+    placement.m_prio = thread->getPriority();
+    placement.m_prioGranted = 0 == retCode;
+    placement.m_affinityMask = affinity;
+    SystemInfo::registerThreadPlacement( thread->getThreadId(), placement );
+
+    return 0 == retCode;
+}
+
 i32 Thread::sdl2threadfunc( void *data ) {
     i32 retCode( 0 );
     if( nullptr != data ) {
         Thread *instance = ( Thread* ) data;
-        switch( instance->getPriority() ) {
-            case Priority::Low:
-                retCode = SDL_SetThreadPriority( SDL_THREAD_PRIORITY_LOW );
-                break;
-            case Priority::Normal:
-                retCode = SDL_SetThreadPriority( SDL_THREAD_PRIORITY_NORMAL );
-                break;
-            case Priority::High:
-                retCode = SDL_SetThreadPriority( SDL_THREAD_PRIORITY_HIGH );
-                break;
-            default:
-                retCode = 1;
-                break;
-        }
-        if( 0 == retCode ) {
-            ThreadId id;
-            id.Id = ( unsigned long ) SDL_ThreadID();
-            instance->setThreadId( id );
-            SystemInfo::registerThreadName( id, instance->getName() );
-            retCode = instance->run();
+        ThreadId id;
+        id.Id = ( unsigned long ) SDL_ThreadID();
+        instance->setThreadId( id );
+        SystemInfo::registerThreadName( id, instance->getName() );
+
+        // A refused prio is no reason to not run the thread
+        if ( !applyPlacement( instance ) ) {
+            osre_debug( Tag, "Thread prio for " + instance->getName() + " was not granted." );
         }
+        retCode = instance->run();
     } else {
         osre_error( Tag, "Invalid thread data." );
         retCode = 1;
@@ -231,6 +324,8 @@ i32 Thread::run( ) {
     return 0;
 }
 
+#ifndef OSRE_USE_FUTEX
+
 ThreadEvent::ThreadEvent()
 : m_bool( SDL_FALSE )
 , m_lock( nullptr )
@@ -255,33 +350,41 @@ void ThreadEvent::signal( ) {
 }
 
 void ThreadEvent::waitForOne( ) {
-    m_bool = SDL_FALSE;
+    // Auto-reset like the win32 event: a signal sent before the wait is not lost, the wait
+    // consumes it.
     SDL_LockMutex( m_lock );
     while( !m_bool ) {
         SDL_CondWait( m_event, m_lock );
     }
+    m_bool = SDL_FALSE;
     SDL_UnlockMutex( m_lock );
 }
 
 void ThreadEvent::waitForAll() {
-    m_bool = SDL_FALSE;
-    SDL_LockMutex( m_lock );
-    while (!m_bool) {
-        SDL_CondWait( m_event, m_lock );
-    }
-    SDL_UnlockMutex( m_lock );
+    waitForOne();
 }
 
-
 void ThreadEvent::waitForTimeout( ui32 ms ) {
-    m_bool = SDL_FALSE;
+    if ( 0 == ms ) {
+        waitForOne();
+        return;
+    }
+
     SDL_LockMutex( m_lock );
-    while (!m_bool) {
-        SDL_CondWaitTimeout( m_event, m_lock, ms );
+    const Uint32 end = SDL_GetTicks() + ms;
+    while ( !m_bool ) {
+        const Uint32 now = SDL_GetTicks();
+        if ( SDL_TICKS_PASSED( now, end ) ) {
+            break;
+        }
+        SDL_CondWaitTimeout( m_event, m_lock, end - now );
     }
+    m_bool = SDL_FALSE;
     SDL_UnlockMutex( m_lock );
 }
 
+#endif // OSRE_USE_FUTEX
+
 Mutex::Mutex(ui32 timeout) :
         m_mutex( nullptr ),
         m_timeout(timeout) {
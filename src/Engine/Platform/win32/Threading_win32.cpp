@@ -31,7 +31,9 @@ namespace Platform {
 
 static const c8 *Tag = "Threading.win32";
 
-CriticalSection::CriticalSection() {
+CriticalSection::CriticalSection() :
+        m_numContended(0),
+        m_numParked(0) {
     OSRE_VALIDATE(InitializeCriticalSectionAndSpinCount(&m_CriticalSection, 1024), "Error while InitializeCriticalSectionAndSpinCount");
 }
 
@@ -40,6 +42,11 @@ CriticalSection::~CriticalSection() {
 }
 
 void CriticalSection::enter() {
+    if (0 != ::TryEnterCriticalSection(&m_CriticalSection)) {
+        return;
+    }
+
+    m_numContended.fetch_add(1, std::memory_order_relaxed);
     ::EnterCriticalSection(const_cast<LPCRITICAL_SECTION>(&m_CriticalSection));
 }
 
@@ -104,6 +111,7 @@ Thread::Thread(const String &name, ui32 stacksize) :
         m_ThreadHandle(NULL),
         m_pThreadSignal(NULL),
         m_Prio(Priority::Normal),
+        m_affinity(0),
         m_threadState(ThreadState::New),
         mTls(nullptr),
         mThreadName(name),
@@ -138,7 +146,6 @@ bool Thread::start(void *pData) {
             NULL);
 
     assert(NULL != m_ThreadHandle);
-    setPriority(Priority::Normal);
     resume();
     setState(ThreadState::Running);
 
@@ -225,27 +232,33 @@ ThreadEvent *Thread::getThreadEvent() const {
     return m_pThreadSignal;
 }
 
-void Thread::setPriority(Priority prio) {
-    m_Prio = prio;
-    BOOL result(TRUE);
-    switch (m_Prio) {
-        case Priority::Low:
-            result = ::SetThreadPriority(m_ThreadHandle, THREAD_PRIORITY_BELOW_NORMAL);
-            break;
+static int getNativePriority(Thread::Priority prio) {
+    switch (prio) {
+        case Thread::Priority::Low:
+            return THREAD_PRIORITY_BELOW_NORMAL;
 
-        case Priority::Normal:
-            result = ::SetThreadPriority(m_ThreadHandle, THREAD_PRIORITY_NORMAL);
-            break;
+        case Thread::Priority::High:
+            return THREAD_PRIORITY_ABOVE_NORMAL;
 
-        case Priority::High:
-            result = ::SetThreadPriority(m_ThreadHandle, THREAD_PRIORITY_ABOVE_NORMAL);
-            break;
+        case Thread::Priority::Critical:
+            // TIME_CRITICAL would starve the message pump and the workers
+            return THREAD_PRIORITY_HIGHEST;
 
         default:
             break;
     }
 
-    if (!result) {
+    return THREAD_PRIORITY_NORMAL;
+}
+
+void Thread::setPriority(Priority prio) {
+    m_Prio = prio;
+    if (NULL == m_ThreadHandle) {
+        // Will be applied on start
+        return;
+    }
+
+    if (!::SetThreadPriority(m_ThreadHandle, getNativePriority(m_Prio))) {
         osre_error(Tag, "Error while setting thread prio.");
     }
 }
@@ -254,6 +267,40 @@ Thread::Priority Thread::getPriority() const {
     return m_Prio;
 }
 
+bool Thread::setAffinity(ui64 mask) {
+    m_affinity = mask;
+
+    // A running thread will be moved immediately, otherwise the mask is applied on start
+    if (0 != mask && NULL != m_ThreadHandle) {
+        return 0 != ::SetThreadAffinityMask(m_ThreadHandle, static_cast<DWORD_PTR>(mask));
+    }
+
+    return true;
+}
+
+ui64 Thread::getAffinity() const {
+    return m_affinity;
+}
+
+bool Thread::applyPlacement(Thread *thread) {
+    HANDLE handle = ::GetCurrentThread();
+    const bool prioGranted = 0 != ::SetThreadPriority(handle, getNativePriority(thread->getPriority()));
+    ui64 affinity = thread->getAffinity();
+    if (0 != affinity && 0 == ::SetThreadAffinityMask(handle, static_cast<DWORD_PTR>(affinity))) {
+        osre_debug(Tag, "Cannot set affinity of thread " + thread->getName() + ".");
+        affinity = 0;
+    }
+
+    ThreadPlacement placement;
+    placement.m_name = thread->getName();
+    placement.m_prio = thread->getPriority();
+    placement.m_prioGranted = prioGranted;
+    placement.m_affinityMask = affinity;
+    SystemInfo::registerThreadPlacement(thread->getThreadId(), placement);
+
+    return prioGranted;
+}
+
 ThreadLocalStorage *Thread::getThreadLocalStorage() {
     return mTls;
 }
@@ -273,6 +320,9 @@ ui32 WINAPI Thread::ThreadFunc(LPVOID data) {
     id.Id = ::GetCurrentThreadId();
     SystemInfo::registerThreadName(id, thread->getName());
     thread->setThreadId(id);
+    if (!applyPlacement(thread)) {
+        osre_debug(Tag, "Thread prio for " + thread->getName() + " was not granted.");
+    }
     const i32 retCode(thread->run());
 
     return retCode;
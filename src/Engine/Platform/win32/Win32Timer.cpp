@@ -28,8 +28,7 @@ namespace Platform {
 Win32Timer::Win32Timer() 
 : AbstractTimer( "platform/win32timer" )
 , m_globeTime()
-, m_globeFrequency()
-, m_LastTime( 0 ) {
+, m_globeFrequency() {
     ::QueryPerformanceCounter( &m_globeTime );
     ::QueryPerformanceFrequency( &m_globeFrequency );
 }
@@ -38,28 +37,14 @@ Win32Timer::~Win32Timer() {
     // empty
 }
 
-i64 Win32Timer::getMilliCurrentSeconds() {
+i64 Win32Timer::getNanoCurrentSeconds() {
     LARGE_INTEGER currentTime;
-    QueryPerformanceCounter( &currentTime );
-    const i64 secs = static_cast<i64>( ( currentTime.QuadPart - m_globeTime.QuadPart ) ) 
-        / static_cast<i64>(m_globeFrequency.QuadPart );
+    ::QueryPerformanceCounter( &currentTime );
+    const i64 ticks = static_cast<i64>( currentTime.QuadPart - m_globeTime.QuadPart );
+    const i64 freq = static_cast<i64>( m_globeFrequency.QuadPart );
 
-    return secs;
-}
-
-i64 Win32Timer::getTimeDiff() {
-    i64 currentTime = getMilliCurrentSeconds();
-    if ( m_LastTime == 0L ) {
-        m_LastTime = currentTime;
-        return 0L;
-    } 
-      
-    i64 diff( currentTime - m_LastTime );
-    if( diff > 1000L ) {
-        diff = AbstractTimer::getRequestedTimeStep();
-    }
-    m_LastTime = currentTime;
-    return diff;
+    // Split the conversion to avoid an overflow for long running sessions
+    return ( ticks / freq ) * 1000000000L + ( ticks % freq ) * 1000000000L / freq;
 }
 
 } // Namespace Platform
@@ -39,14 +39,11 @@ public:
 	Win32Timer();
 	///	The class destructor.
 	~Win32Timer();
-	///	Seconds getter.
-	i64 getMilliCurrentSeconds() override;
-	///	Time difference getter.
-	i64 getTimeDiff() override;
+	///	Nano-seconds getter, based on the performance counter.
+	i64 getNanoCurrentSeconds() override;
 
 private:
 	LARGE_INTEGER m_globeTime, m_globeFrequency;
-	i64 m_LastTime;
 };
 
 } // Namespace Platform
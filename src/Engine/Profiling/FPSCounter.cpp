@@ -33,12 +33,12 @@ static const c8 *Tag = "FPSCounter";
 
 FPSCounter::FPSCounter( Platform::AbstractTimer *timer )
 : m_timerPtr( timer )
-, m_timeDiff( 0 )
-, m_lastTime( 0 )
+, m_lastTick( 0 )
+, m_elapsed( 0 )
 , m_fps( 0 )
 , m_lastFPS( 0 ) {
     if ( m_timerPtr.isValid() ) {
-        m_timeDiff = m_timerPtr->getTimeDiff();
+        m_lastTick = m_timerPtr->getNanoCurrentSeconds();
     }
 }
 
@@ -52,11 +52,13 @@ ui32 FPSCounter::getFPS() {
         return 0;
     }
     
-    m_timeDiff = m_timerPtr->getTimeDiff();
-    m_lastTime += m_timeDiff;
+    // Uses an own time stamp, the timer is shared with the application thread
+    const i64 now = m_timerPtr->getNanoCurrentSeconds();
+    m_elapsed += now - m_lastTick;
+    m_lastTick = now;
     m_fps++;
-    if (m_lastTime > 1000) {
-        m_lastTime = 0;
+    if (m_elapsed >= 1000L * Platform::NanoPerMilli) {
+        m_elapsed -= 1000L * Platform::NanoPerMilli;
         m_lastFPS = m_fps;
         m_fps = 0;
     }
@@ -55,7 +55,12 @@ static const String ConfigKeyStringTable[Settings::MaxKonfigKey] = {
     "ChildWindow",
     "PollingMode",
     "DefaultFont",
-    "RenderMode"
+    "RenderMode",
+    "FramesInFlight",
+    "StaticBatching",
+    "ShaderCacheDir",
+    "AsyncShaderCompile",
+    "TextureUploadBudget"
 };
 
 Settings::Settings() :
@@ -226,6 +231,21 @@ void Settings::initDefaults() {
 
     value.setInt( 1 );
     m_propertyMap->setProperty( RenderMode, ConfigKeyStringTable[ RenderMode], value );
+
+    value.setInt( 2 );
+    m_propertyMap->setProperty( FramesInFlight, ConfigKeyStringTable[ FramesInFlight ], value );
+
+    value.setBool( false );
+    m_propertyMap->setProperty( StaticBatching, ConfigKeyStringTable[ StaticBatching ], value );
+
+    value.setStdString( "" );
+    m_propertyMap->setProperty( ShaderCacheDir, ConfigKeyStringTable[ ShaderCacheDir ], value );
+
+    value.setBool( false );
+    m_propertyMap->setProperty( AsyncShaderCompile, ConfigKeyStringTable[ AsyncShaderCompile ], value );
+
+    value.setInt( 4 * 1024 * 1024 );
+    m_propertyMap->setProperty( TextureUploadBudget, ConfigKeyStringTable[ TextureUploadBudget ], value );
 }
 
 } // Namespace Properties
@@ -0,0 +1,263 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2015-2020 OSRE ( Open Source Render Engine ) by Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#include <osre/RenderBackend/BlockCompressor.h>
+
+namespace OSRE {
+namespace RenderBackend {
+
+static ui16 toRGB565(i32 r, i32 g, i32 b) {
+    return static_cast<ui16>((((r * 31 + 127) / 255) << 11) | (((g * 63 + 127) / 255) << 5) | ((b * 31 + 127) / 255));
+}
+
+static void fromRGB565(ui16 color, i32 *rgb) {
+    const i32 r = (color >> 11) & 31;
+    const i32 g = (color >> 5) & 63;
+    const i32 b = color & 31;
+    rgb[0] = (r << 3) | (r >> 2);
+    rgb[1] = (g << 2) | (g >> 4);
+    rgb[2] = (b << 3) | (b >> 2);
+}
+
+static void writeUI16(uc8 *data, ui16 value) {
+    data[0] = static_cast<uc8>(value & 0xff);
+    data[1] = static_cast<uc8>(value >> 8);
+}
+
+// The endpoints are the bounding box corners on the diagonal which follows the color distribution
+static void getColorEndpoints(const uc8 *rgba, i32 *minColor, i32 *maxColor) {
+    i32 center[3] = { 0, 0, 0 };
+    for (ui32 c = 0; c < 3; ++c) {
+        minColor[c] = 255;
+        maxColor[c] = 0;
+    }
+    for (ui32 i = 0; i < 16; ++i) {
+        for (ui32 c = 0; c < 3; ++c) {
+            const i32 value = rgba[i * 4 + c];
+            minColor[c] = value < minColor[c] ? value : minColor[c];
+            maxColor[c] = value > maxColor[c] ? value : maxColor[c];
+            center[c] += value;
+        }
+    }
+
+    ui32 mainAxis(0);
+    for (ui32 c = 0; c < 3; ++c) {
+        center[c] /= 16;
+        if (maxColor[c] - minColor[c] > maxColor[mainAxis] - minColor[mainAxis]) {
+            mainAxis = c;
+        }
+    }
+
+    for (ui32 c = 0; c < 3; ++c) {
+        if (c == mainAxis) {
+            continue;
+        }
+
+        i32 covariance(0);
+        for (ui32 i = 0; i < 16; ++i) {
+            covariance += (rgba[i * 4 + mainAxis] - center[mainAxis]) * (rgba[i * 4 + c] - center[c]);
+        }
+        if (covariance < 0) {
+            const i32 temp = minColor[c];
+            minColor[c] = maxColor[c];
+            maxColor[c] = temp;
+        }
+    }
+
+    // Move the endpoints a bit inside, the outliers are rare
+    for (ui32 c = 0; c < 3; ++c) {
+        const i32 inset = (maxColor[c] - minColor[c]) / 16;
+        minColor[c] += inset;
+        maxColor[c] -= inset;
+    }
+}
+
+static void compressColorBlock(const uc8 *rgba, uc8 *block) {
+    i32 minColor[3], maxColor[3];
+    getColorEndpoints(rgba, minColor, maxColor);
+
+    ui16 color0 = toRGB565(maxColor[0], maxColor[1], maxColor[2]);
+    ui16 color1 = toRGB565(minColor[0], minColor[1], minColor[2]);
+    if (color0 < color1) {
+        const ui16 temp = color0;
+        color0 = color1;
+        color1 = temp;
+    }
+    writeUI16(&block[0], color0);
+    writeUI16(&block[2], color1);
+
+    ui32 indices(0);
+    if (color0 != color1) {
+        // The four color mode, the two colors in between are interpolated
+        i32 palette[4][3];
+        fromRGB565(color0, palette[0]);
+        fromRGB565(color1, palette[1]);
+        for (ui32 c = 0; c < 3; ++c) {
+            palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+            palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+        }
+
+        for (ui32 i = 0; i < 16; ++i) {
+            ui32 best(0);
+            i32 bestDist(0x7fffffff);
+            for (ui32 j = 0; j < 4; ++j) {
+                i32 dist(0);
+                for (ui32 c = 0; c < 3; ++c) {
+                    const i32 diff = rgba[i * 4 + c] - palette[j][c];
+                    dist += diff * diff;
+                }
+                if (dist < bestDist) {
+                    bestDist = dist;
+                    best = j;
+                }
+            }
+            indices |= best << (2 * i);
+        }
+    }
+
+    for (ui32 i = 0; i < 4; ++i) {
+        block[4 + i] = static_cast<uc8>((indices >> (8 * i)) & 0xff);
+    }
+}
+
+static void compressAlphaBlock(const uc8 *rgba, uc8 *block) {
+    i32 minAlpha(255), maxAlpha(0);
+    for (ui32 i = 0; i < 16; ++i) {
+        const i32 alpha = rgba[i * 4 + 3];
+        minAlpha = alpha < minAlpha ? alpha : minAlpha;
+        maxAlpha = alpha > maxAlpha ? alpha : maxAlpha;
+    }
+    block[0] = static_cast<uc8>(maxAlpha);
+    block[1] = static_cast<uc8>(minAlpha);
+
+    ui64 indices(0);
+    if (maxAlpha != minAlpha) {
+        // The eight alpha mode, six values are interpolated
+        i32 palette[8];
+        palette[0] = maxAlpha;
+        palette[1] = minAlpha;
+        for (i32 j = 1; j < 7; ++j) {
+            palette[j + 1] = ((7 - j) * maxAlpha + j * minAlpha) / 7;
+        }
+
+        for (ui32 i = 0; i < 16; ++i) {
+            ui64 best(0);
+            i32 bestDist(0x7fffffff);
+            for (ui32 j = 0; j < 8; ++j) {
+                const i32 diff = rgba[i * 4 + 3] - palette[j];
+                if (diff * diff < bestDist) {
+                    bestDist = diff * diff;
+                    best = j;
+                }
+            }
+            indices |= best << (3 * i);
+        }
+    }
+
+    for (ui32 i = 0; i < 6; ++i) {
+        block[2 + i] = static_cast<uc8>((indices >> (8 * i)) & 0xff);
+    }
+}
+
+bool BlockCompressor::compress(TextureFormatType format, const uc8 *pixels, ui32 width, ui32 height, ui32 channels,
+        MemoryBuffer &buffer) {
+    if (TextureFormatType::BC1 != format && TextureFormatType::BC3 != format) {
+        return false;
+    }
+
+    if (nullptr == pixels || 0 == channels || channels > 4) {
+        return false;
+    }
+
+    const size_t blockSize = TextureFormatType::BC1 == format ? 8 : 16;
+    const ui32 blocksX = (width + 3) / 4;
+    const ui32 blocksY = (height + 3) / 4;
+    size_t offset = buffer.size();
+    buffer.resize(offset + blocksX * blocksY * blockSize);
+
+    uc8 rgba[64];
+    for (ui32 by = 0; by < blocksY; ++by) {
+        for (ui32 bx = 0; bx < blocksX; ++bx) {
+            // Pixels outside of the image repeat the border
+            for (ui32 i = 0; i < 16; ++i) {
+                const ui32 x = (bx * 4 + (i % 4)) < width ? bx * 4 + (i % 4) : width - 1;
+                const ui32 y = (by * 4 + (i / 4)) < height ? by * 4 + (i / 4) : height - 1;
+                const uc8 *pixel = &pixels[(static_cast<size_t>(y) * width + x) * channels];
+                uc8 *dest = &rgba[i * 4];
+                if (channels < 3) {
+                    dest[0] = dest[1] = dest[2] = pixel[0];
+                    dest[3] = 2 == channels ? pixel[1] : 255;
+                } else {
+                    dest[0] = pixel[0];
+                    dest[1] = pixel[1];
+                    dest[2] = pixel[2];
+                    dest[3] = 4 == channels ? pixel[3] : 255;
+                }
+            }
+
+            uc8 *block = reinterpret_cast<uc8 *>(&buffer[offset]);
+            if (TextureFormatType::BC1 == format) {
+                compressBlockBC1(rgba, block);
+            } else {
+                compressBlockBC3(rgba, block);
+            }
+            offset += blockSize;
+        }
+    }
+
+    return true;
+}
+
+void BlockCompressor::compressBlockBC1(const uc8 *rgba, uc8 *block) {
+    compressColorBlock(rgba, block);
+}
+
+void BlockCompressor::compressBlockBC3(const uc8 *rgba, uc8 *block) {
+    compressAlphaBlock(rgba, block);
+    compressColorBlock(rgba, &block[8]);
+}
+
+void BlockCompressor::downsample(const uc8 *pixels, ui32 width, ui32 height, ui32 channels, MemoryBuffer &buffer) {
+    const ui32 newWidth = width > 1 ? width / 2 : 1;
+    const ui32 newHeight = height > 1 ? height / 2 : 1;
+    buffer.resize(static_cast<size_t>(newWidth) * newHeight * channels);
+    if (nullptr == pixels || 0 == width || 0 == height) {
+        return;
+    }
+
+    for (ui32 y = 0; y < newHeight; ++y) {
+        const ui32 y0 = y * 2 < height ? y * 2 : height - 1;
+        const ui32 y1 = y * 2 + 1 < height ? y * 2 + 1 : height - 1;
+        for (ui32 x = 0; x < newWidth; ++x) {
+            const ui32 x0 = x * 2 < width ? x * 2 : width - 1;
+            const ui32 x1 = x * 2 + 1 < width ? x * 2 + 1 : width - 1;
+            for (ui32 c = 0; c < channels; ++c) {
+                const ui32 sum = pixels[(y0 * width + x0) * channels + c] + pixels[(y0 * width + x1) * channels + c] +
+                                 pixels[(y1 * width + x0) * channels + c] + pixels[(y1 * width + x1) * channels + c];
+                buffer[(y * newWidth + x) * channels + c] = static_cast<c8>((sum + 2) / 4);
+            }
+        }
+    }
+}
+
+} // Namespace RenderBackend
+} // Namespace OSRE
@@ -28,6 +28,11 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <osre/RenderBackend/RenderCommon.h>
 #include <osre/RenderBackend/RenderStates.h>
 
+// GL_KHR_parallel_shader_compile is not part of the bundled GLEW version
+#ifndef GL_COMPLETION_STATUS_KHR
+#define GL_COMPLETION_STATUS_KHR 0x91B1
+#endif
+
 namespace OSRE {
 namespace RenderBackend {
 
@@ -94,6 +99,8 @@ struct OGLTexture {
     ui32 m_width;
     ui32 m_height;
     ui32 m_channels;
+    ui32 m_layers;      ///< The number of layers of a texture array, 1 otherwise.
+    bool m_resident;    ///< false while the pixels are still streamed in.
 };
 
 ///	@brief
@@ -124,17 +131,20 @@ inline OGLRenderCmd::OGLRenderCmd(OGLRenderCmdType type) :
 
 struct UniformDataBlob;
 
-///	@brief
+///	@brief  A uniform parameter, interned once by its hashed name. The handle indexes the location
+/// tables of the shaders, which are resolved per program.
 struct OGLParameter {
     String m_name;
-    GLint m_loc;
+    HashId m_hash;
+    ui32 m_handle;
     ParameterType m_type;
     UniformDataBlob *m_data;
     size_t m_numItems;
 
     OGLParameter() :
             m_name(""),
-            m_loc(NoneLocation),
+            m_hash(0),
+            m_handle(OGLNotSetId),
             m_type(ParameterType::PT_None),
             m_data(nullptr),
             m_numItems(1) {
@@ -148,6 +158,7 @@ struct OGLPrimGroup {
     ui32 m_startIndex;
     size_t m_numIndices;
     GLenum m_indexType;
+    GLint m_baseVertex;
 };
 
 ///	@brief
@@ -222,6 +233,15 @@ struct OGLCapabilities {
     i32 mMaxTextureUnits;
     i32 mMaxTextureImageUnits;
     i32 mMaxTextureCoords;
+    i32 mMaxUniformBufferBindings;
+    i32 mMaxUniformBlockSize;
+    i32 mStorageBufferOffsetAlignment;
+    bool mMultiDrawIndirect;
+    bool mShaderStorageBuffers;
+    bool mParallelShaderCompile;
+    bool mS3TCCompression;
+    bool mRGTCCompression;
+    bool mBPTCCompression;
 
     OGLCapabilities() :
             mMaxAniso(0.0f),
@@ -229,7 +249,16 @@ struct OGLCapabilities {
             mMax3DTextureSize(0),
             mMaxTextureUnits(0),
             mMaxTextureImageUnits(0),
-            mMaxTextureCoords(0) {
+            mMaxTextureCoords(0),
+            mMaxUniformBufferBindings(0),
+            mMaxUniformBlockSize(0),
+            mStorageBufferOffsetAlignment(0),
+            mMultiDrawIndirect(false),
+            mShaderStorageBuffers(false),
+            mParallelShaderCompile(false),
+            mS3TCCompression(false),
+            mRGTCCompression(false),
+            mBPTCCompression(false) {
         // empty
     }
 };
@@ -106,6 +106,8 @@ GLenum OGLEnum::getGLTextureTarget( TextureTargetType type ) {
             return GL_TEXTURE_2D;
         case TextureTargetType::Texture3D:
             return GL_TEXTURE_3D;
+        case TextureTargetType::Texture2DArray:
+            return GL_TEXTURE_2D_ARRAY;
         default:
             OSRE_ASSERT2( false, "Unknown enum for TextureTargetType." );
             break;
@@ -138,6 +140,28 @@ GLenum  OGLEnum::getGLTextureFormat(TextureFormatType texFormat) {
             return GL_RGB;
         case TextureFormatType::R8G8B8A8:
             return GL_RGBA;
+        case TextureFormatType::BC1:
+            return GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;
+        case TextureFormatType::BC2:
+            return GL_COMPRESSED_RGBA_S3TC_DXT3_EXT;
+        case TextureFormatType::BC3:
+            return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+        case TextureFormatType::BC4:
+            return GL_COMPRESSED_RED_RGTC1;
+        case TextureFormatType::BC5:
+            return GL_COMPRESSED_RG_RGTC2;
+        case TextureFormatType::BC6H:
+            return GL_COMPRESSED_RGB_BPTC_UNSIGNED_FLOAT;
+        case TextureFormatType::BC7:
+            return GL_COMPRESSED_RGBA_BPTC_UNORM;
+        case TextureFormatType::BC1_SRGB:
+            return GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT;
+        case TextureFormatType::BC2_SRGB:
+            return GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT3_EXT;
+        case TextureFormatType::BC3_SRGB:
+            return GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT;
+        case TextureFormatType::BC7_SRGB:
+            return GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM;
         case TextureFormatType::InvaliTextureType:
         default:
             OSRE_ASSERT2( false, "Unknown enum for TextureParameterName." );
@@ -0,0 +1,149 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2015-2020 OSRE ( Open Source Render Engine ) by Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#include "OGLIndirectDrawBuffer.h"
+
+namespace OSRE {
+namespace RenderBackend {
+
+OGLIndirectDrawBuffer::OGLIndirectDrawBuffer() :
+        m_commands(),
+        m_drawData(),
+        m_primitive(GL_TRIANGLES),
+        m_indexType(GL_UNSIGNED_INT) {
+    // empty
+}
+
+OGLIndirectDrawBuffer::~OGLIndirectDrawBuffer() {
+    // empty
+}
+
+void OGLIndirectDrawBuffer::clear() {
+    m_commands.resize(0);
+    m_drawData.resize(0);
+}
+
+bool OGLIndirectDrawBuffer::addDraw(const OGLPrimGroup &grp, const glm::mat4 &model) {
+    if (m_commands.isEmpty()) {
+        m_primitive = grp.m_primitive;
+        m_indexType = grp.m_indexType;
+    } else if (m_primitive != grp.m_primitive || m_indexType != grp.m_indexType) {
+        return false;
+    }
+
+    // The start of the group is a byte offset into the index buffer
+    const size_t indexSize = getIndexSize(grp.m_indexType);
+    if (0 != grp.m_startIndex % indexSize) {
+        return false;
+    }
+
+    DrawElementsIndirectCommand cmd;
+    cmd.m_count = static_cast<GLuint>(grp.m_numIndices);
+    cmd.m_instanceCount = 1;
+    cmd.m_firstIndex = static_cast<GLuint>(grp.m_startIndex / indexSize);
+    cmd.m_baseVertex = grp.m_baseVertex;
+    cmd.m_baseInstance = 0;
+    m_commands.add(cmd);
+
+    IndirectDrawData data;
+    data.m_model = model;
+    m_drawData.add(data);
+
+    return true;
+}
+
+void OGLIndirectDrawBuffer::resize(size_t numDraws) {
+    if (numDraws < m_commands.size()) {
+        m_commands.resize(numDraws);
+        m_drawData.resize(numDraws);
+    }
+}
+
+void OGLIndirectDrawBuffer::setVisible(size_t idx, bool visible) {
+    if (idx < m_commands.size()) {
+        m_commands[idx].m_instanceCount = visible ? 1 : 0;
+    }
+}
+
+const DrawElementsIndirectCommand *OGLIndirectDrawBuffer::getCommands() const {
+    if (m_commands.isEmpty()) {
+        return nullptr;
+    }
+
+    return &m_commands[0];
+}
+
+const IndirectDrawData *OGLIndirectDrawBuffer::getDrawData() const {
+    if (m_drawData.isEmpty()) {
+        return nullptr;
+    }
+
+    return &m_drawData[0];
+}
+
+size_t OGLIndirectDrawBuffer::getIndexSize(GLenum indexType) {
+    switch (indexType) {
+        case GL_UNSIGNED_BYTE:
+            return 1;
+        case GL_UNSIGNED_SHORT:
+            return 2;
+        default:
+            break;
+    }
+
+    return 4;
+}
+
+String OGLIndirectDrawBuffer::getGLSLDeclaration(bool multiDraw) {
+    String decl("#extension GL_ARB_shader_storage_buffer_object : require\n");
+    if (multiDraw) {
+        decl += "#extension GL_ARB_shader_draw_parameters : require\n";
+        decl += "#define OSRE_DRAW_INDEX gl_DrawIDARB\n";
+    } else {
+        decl += "uniform int " + String(DrawIndexName) + ";\n";
+        decl += "#define OSRE_DRAW_INDEX " + String(DrawIndexName) + "\n";
+    }
+    decl += "uniform int " + String(DrawDataEnabledName) + ";\n";
+    decl += "struct DrawData {\n    mat4 Model;\n};\n";
+    decl += "layout(std430) readonly buffer " + String(DrawDataBlockName) + " {\n";
+    decl += "    DrawData Draws[];\n";
+    decl += "};\n";
+
+    return decl;
+}
+
+String OGLIndirectDrawBuffer::injectGLSLDeclaration(const String &src, bool multiDraw, bool supported) {
+    const String define(DrawDataDefine);
+    const String::size_type pos = src.find(define);
+    if (String::npos == pos) {
+        return src;
+    }
+
+    String result(src);
+    const String decl = supported ? getGLSLDeclaration(multiDraw) : String("#undef DRAW_DATA\n");
+    result.insert(pos + define.size(), decl);
+
+    return result;
+}
+
+} // Namespace RenderBackend
+} // Namespace OSRE
@@ -0,0 +1,129 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2015-2020 OSRE ( Open Source Render Engine ) by Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#pragma once
+
+#include "OGLCommon.h"
+
+#include <cppcore/Container/TArray.h>
+
+namespace OSRE {
+namespace RenderBackend {
+
+/// The name of the shader storage block with the per-draw data.
+static const c8 *const DrawDataBlockName = "DrawDataBlock";
+
+/// The uniform passing the draw index when the draws are issued one by one.
+static const c8 *const DrawIndexName = "DrawIndex";
+
+/// The uniform telling the shader to read the model matrix from the per-draw data.
+static const c8 *const DrawDataEnabledName = "DrawDataEnabled";
+
+/// Shaders defining it get the declaration of the per-draw data, see injectGLSLDeclaration.
+static const c8 *const DrawDataDefine = "#define DRAW_DATA\n";
+
+///	@brief  The layout of one command of glMultiDrawElementsIndirect.
+struct DrawElementsIndirectCommand {
+    GLuint m_count;
+    GLuint m_instanceCount;
+    GLuint m_firstIndex;
+    GLint m_baseVertex;
+    GLuint m_baseInstance;
+};
+
+///	@brief  The data of one draw, read by the shader with the draw index. The std430 layout of
+/// a mat4 needs no padding.
+struct IndirectDrawData {
+    glm::mat4 m_model;
+};
+
+//-------------------------------------------------------------------------------------------------
+///	@ingroup	Engine
+///
+///	@brief  Collects the draws of primitive groups sharing one vertex array, so they can be
+/// submitted with one glMultiDrawElementsIndirect call. The commands are built on the CPU every
+/// frame and can be culled by setting their instance count to zero.
+///
+/// The per-draw data is stored in a shader storage block indexed by gl_DrawIDARB, when the draws
+/// must be issued one by one the index is passed in the DrawIndex uniform instead.
+//-------------------------------------------------------------------------------------------------
+class OGLIndirectDrawBuffer {
+public:
+    /// The binding point of the per-draw data block.
+    static const ui32 DrawDataBinding = 0;
+
+    /// The default class constructor.
+    OGLIndirectDrawBuffer();
+    /// The class destructor.
+    ~OGLIndirectDrawBuffer();
+    /// @brief  Removes all draws.
+    void clear();
+    /// @brief  Appends the draw of a primitive group.
+    /// @param  grp     [in] The primitive group, must match the primitive and index type of the
+    ///                 first draw.
+    /// @param  model   [in] The model matrix of the draw.
+    /// @return false, if the group cannot be part of the same multi-draw.
+    bool addDraw(const OGLPrimGroup &grp, const glm::mat4 &model);
+    /// @brief  Drops all draws behind the given number.
+    void resize(size_t numDraws);
+    /// @brief  Culls or restores a draw.
+    void setVisible(size_t idx, bool visible);
+    /// @brief  Returns the number of draws, including culled ones.
+    size_t getNumDraws() const;
+    GLenum getPrimitive() const;
+    GLenum getIndexType() const;
+    const DrawElementsIndirectCommand *getCommands() const;
+    const IndirectDrawData *getDrawData() const;
+    /// @brief  Returns the size of one index in bytes.
+    static size_t getIndexSize(GLenum indexType);
+    /// @brief  Returns the GLSL declaration of the per-draw data and the OSRE_DRAW_INDEX macro, it
+    /// must follow the #version line.
+    /// @param  multiDraw   [in] true, if the draws are issued by glMultiDrawElementsIndirect.
+    static String getGLSLDeclaration(bool multiDraw);
+    /// @brief  Inserts the declaration after the DRAW_DATA define of a shader source. Without
+    /// shader storage buffers the define is removed again, so the shader uses its uniforms only.
+    /// @param  src         [in] The shader source.
+    /// @param  multiDraw   [in] true, if the draws are issued by glMultiDrawElementsIndirect.
+    /// @param  supported   [in] true, if shader storage buffers are supported.
+    static String injectGLSLDeclaration(const String &src, bool multiDraw, bool supported);
+
+private:
+    ::CPPCore::TArray<DrawElementsIndirectCommand> m_commands;
+    ::CPPCore::TArray<IndirectDrawData> m_drawData;
+    GLenum m_primitive;
+    GLenum m_indexType;
+};
+
+inline size_t OGLIndirectDrawBuffer::getNumDraws() const {
+    return m_commands.size();
+}
+
+inline GLenum OGLIndirectDrawBuffer::getPrimitive() const {
+    return m_primitive;
+}
+
+inline GLenum OGLIndirectDrawBuffer::getIndexType() const {
+    return m_indexType;
+}
+
+} // Namespace RenderBackend
+} // Namespace OSRE
@@ -0,0 +1,247 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2015-2020 OSRE ( Open Source Render Engine ) by Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#include "OGLProgramCache.h"
+#include "OGLShader.h"
+
+#include <osre/Common/Logger.h>
+#include <osre/IO/Directory.h>
+#include <osre/IO/IOService.h>
+#include <osre/IO/Stream.h>
+#include <osre/IO/Uri.h>
+
+#include <cstdio>
+#include <cstring>
+
+namespace OSRE {
+namespace RenderBackend {
+
+using namespace ::OSRE::IO;
+
+static const c8 *Tag = "OGLProgramCache";
+
+static const ui64 FNVOffsetBasis = 14695981039346656037ULL;
+static const ui64 FNVPrime = 1099511628211ULL;
+
+static ui64 hashBytes(ui64 hash, const c8 *data, size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= FNVPrime;
+    }
+
+    return hash;
+}
+
+const ui32 ProgramBinaryHeader::Magic;
+const ui32 ProgramBinaryHeader::Version;
+
+ProgramBinaryHeader::ProgramBinaryHeader() :
+        m_magic(Magic),
+        m_version(Version),
+        m_key(0),
+        m_format(0),
+        m_size(0) {
+    // empty
+}
+
+const c8 *const OGLProgramCache::FileExtension = ".glbin";
+
+OGLProgramCache::OGLProgramCache() :
+        m_cacheDir(),
+        m_driverId(),
+        m_enabled(false),
+        m_numHits(0),
+        m_numMisses(0) {
+    // empty
+}
+
+OGLProgramCache::~OGLProgramCache() {
+    // empty
+}
+
+bool OGLProgramCache::init(const String &cacheDir, const String &driverId) {
+    m_enabled = false;
+    if (cacheDir.empty()) {
+        return false;
+    }
+
+    if (!Directory::exists(cacheDir)) {
+        if (!Directory::createDirectory(cacheDir.c_str())) {
+            osre_error(Tag, "Cannot create shader cache directory " + cacheDir);
+            return false;
+        }
+    }
+
+    m_cacheDir = cacheDir;
+    if ('/' != m_cacheDir[m_cacheDir.size() - 1]) {
+        m_cacheDir += "/";
+    }
+    m_driverId = driverId;
+    m_enabled = true;
+
+    return true;
+}
+
+bool OGLProgramCache::isEnabled() const {
+    return m_enabled;
+}
+
+ui64 OGLProgramCache::getKey(const String *sources, size_t numSources) const {
+    return computeKey(sources, numSources, m_driverId);
+}
+
+String OGLProgramCache::getFileName(ui64 key) const {
+    c8 name[17];
+    ::snprintf(name, sizeof(name), "%016llx", static_cast<unsigned long long>(key));
+
+    return m_cacheDir + name + FileExtension;
+}
+
+bool OGLProgramCache::load(ui64 key, OGLShader *shader) {
+    if (!m_enabled || nullptr == shader) {
+        return false;
+    }
+
+    const Uri fileUri("file://" + getFileName(key));
+    IOService *ioService = IOService::getInstance();
+    if (nullptr == ioService || !ioService->fileExists(fileUri)) {
+        ++m_numMisses;
+        return false;
+    }
+
+    Stream *stream = ioService->openStream(fileUri, Stream::AccessMode::ReadAccessBinary);
+    if (nullptr == stream) {
+        ++m_numMisses;
+        return false;
+    }
+
+    MemoryBuffer content;
+    const ui32 size = stream->getSize();
+    if (size > 0) {
+        content.resize(size);
+        content.resize(stream->read(&content[0], size));
+    }
+    ioService->closeStream(&stream);
+
+    ProgramBinaryHeader header;
+    const c8 *binary = content.isEmpty() ? nullptr : decode(&content[0], content.size(), key, header);
+    if (nullptr == binary) {
+        osre_debug(Tag, "Ignoring outdated program binary " + fileUri.getAbsPath());
+        ++m_numMisses;
+        return false;
+    }
+
+    // The driver may reject binaries of an older version, the caller will compile the sources then.
+    if (!shader->createFromBinary(header.m_format, binary, static_cast<GLsizei>(header.m_size))) {
+        osre_debug(Tag, "Program binary was rejected by the driver.");
+        ++m_numMisses;
+        return false;
+    }
+    ++m_numHits;
+
+    return true;
+}
+
+bool OGLProgramCache::store(ui64 key, OGLShader *shader) {
+    if (!m_enabled || nullptr == shader || !shader->isCompiled()) {
+        return false;
+    }
+
+    MemoryBuffer binary;
+    GLenum format(0);
+    if (!shader->getProgramBinary(binary, format) || binary.isEmpty()) {
+        return false;
+    }
+
+    MemoryBuffer content;
+    encode(key, format, &binary[0], static_cast<ui32>(binary.size()), content);
+
+    IOService *ioService = IOService::getInstance();
+    if (nullptr == ioService) {
+        return false;
+    }
+
+    const Uri fileUri("file://" + getFileName(key));
+    Stream *stream = ioService->openStream(fileUri, Stream::AccessMode::WriteAccessBinary);
+    if (nullptr == stream) {
+        osre_error(Tag, "Cannot write program binary " + fileUri.getAbsPath());
+        return false;
+    }
+    const ui32 written = stream->write(&content[0], static_cast<ui32>(content.size()));
+    ioService->closeStream(&stream);
+
+    return written == content.size();
+}
+
+ui32 OGLProgramCache::getNumHits() const {
+    return m_numHits;
+}
+
+ui32 OGLProgramCache::getNumMisses() const {
+    return m_numMisses;
+}
+
+ui64 OGLProgramCache::computeKey(const String *sources, size_t numSources, const String &driverId) {
+    ui64 hash = FNVOffsetBasis;
+    for (size_t i = 0; i < numSources; ++i) {
+        // The size separates the stages, so moving code from one stage into another changes the key.
+        const ui64 size = sources[i].size();
+        hash = hashBytes(hash, reinterpret_cast<const c8 *>(&size), sizeof(size));
+        hash = hashBytes(hash, sources[i].c_str(), sources[i].size());
+    }
+    hash = hashBytes(hash, driverId.c_str(), driverId.size());
+
+    return hash;
+}
+
+void OGLProgramCache::encode(ui64 key, GLenum format, const c8 *binary, ui32 size, MemoryBuffer &buffer) {
+    ProgramBinaryHeader header;
+    header.m_key = key;
+    header.m_format = format;
+    header.m_size = size;
+
+    buffer.resize(sizeof(ProgramBinaryHeader) + size);
+    ::memcpy(&buffer[0], &header, sizeof(ProgramBinaryHeader));
+    if (size > 0) {
+        ::memcpy(&buffer[sizeof(ProgramBinaryHeader)], binary, size);
+    }
+}
+
+const c8 *OGLProgramCache::decode(const c8 *data, size_t size, ui64 key, ProgramBinaryHeader &header) {
+    if (nullptr == data || size < sizeof(ProgramBinaryHeader)) {
+        return nullptr;
+    }
+
+    ::memcpy(&header, data, sizeof(ProgramBinaryHeader));
+    if (ProgramBinaryHeader::Magic != header.m_magic || ProgramBinaryHeader::Version != header.m_version) {
+        return nullptr;
+    }
+
+    if (key != header.m_key || 0 == header.m_size || size - sizeof(ProgramBinaryHeader) != header.m_size) {
+        return nullptr;
+    }
+
+    return data + sizeof(ProgramBinaryHeader);
+}
+
+} // Namespace RenderBackend
+} // Namespace OSRE
@@ -0,0 +1,101 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2015-2020 OSRE ( Open Source Render Engine ) by Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#pragma once
+
+#include "OGLCommon.h"
+
+namespace OSRE {
+namespace RenderBackend {
+
+class OGLShader;
+
+///	@brief  The header of a cached program binary file.
+struct ProgramBinaryHeader {
+    static const ui32 Magic = 0x4250534f; // "OSPB"
+    static const ui32 Version = 1;
+
+    ui32 m_magic;
+    ui32 m_version;
+    ui64 m_key;
+    GLenum m_format;
+    ui32 m_size;
+
+    ProgramBinaryHeader();
+};
+
+//-------------------------------------------------------------------------------------------------
+///	@ingroup	Engine
+///
+///	@brief  Stores linked shader programs with glGetProgramBinary in a cache directory, so they
+/// can be restored with glProgramBinary on the next start instead of being compiled again.
+///
+/// The key hashes the final sources of all stages, so defines injected into a source are part of
+/// it, and the vendor, renderer and version strings of the driver. A driver update therefore
+/// misses the cache. Binaries rejected by the driver are replaced after the next full compile.
+//-------------------------------------------------------------------------------------------------
+class OGLProgramCache {
+public:
+    /// The file extension of cached binaries.
+    static const c8 *const FileExtension;
+
+    /// The default class constructor, the cache is disabled.
+    OGLProgramCache();
+    /// The class destructor.
+    ~OGLProgramCache();
+    /// @brief  Enables the cache, the directory will be created when missing.
+    /// @param  cacheDir    [in] The cache directory, empty to disable the cache.
+    /// @param  driverId    [in] Identifies the driver, the binaries are only valid for it.
+    /// @return true, if the cache is enabled.
+    bool init(const String &cacheDir, const String &driverId);
+    /// @brief  Returns true, if the cache is enabled.
+    bool isEnabled() const;
+    /// @brief  Returns the key for the given shader sources.
+    ui64 getKey(const String *sources, size_t numSources) const;
+    /// @brief  Returns the file name of a cached binary.
+    String getFileName(ui64 key) const;
+    /// @brief  Restores a program from the cache, returns false for a miss or a rejected binary.
+    bool load(ui64 key, OGLShader *shader);
+    /// @brief  Writes the binary of a linked program to the cache.
+    bool store(ui64 key, OGLShader *shader);
+    /// @brief  Returns the number of programs restored from the cache.
+    ui32 getNumHits() const;
+    /// @brief  Returns the number of programs, which had to be compiled.
+    ui32 getNumMisses() const;
+
+    /// @brief  Hashes the sources and the driver id with 64-bit FNV-1a.
+    static ui64 computeKey(const String *sources, size_t numSources, const String &driverId);
+    /// @brief  Writes the header and the binary into one buffer.
+    static void encode(ui64 key, GLenum format, const c8 *binary, ui32 size, MemoryBuffer &buffer);
+    /// @brief  Validates the header of a cached file, returns the binary or nullptr.
+    static const c8 *decode(const c8 *data, size_t size, ui64 key, ProgramBinaryHeader &header);
+
+private:
+    String m_cacheDir;
+    String m_driverId;
+    bool m_enabled;
+    ui32 m_numHits;
+    ui32 m_numMisses;
+};
+
+} // Namespace RenderBackend
+} // Namespace OSRE
@@ -26,28 +26,41 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "OGLShader.h"
 
 #include <osre/Common/Logger.h>
+#include <osre/Common/StringUtils.h>
 #include <osre/Debugging/osre_debugging.h>
+#include <osre/IO/IOService.h>
 #include <osre/IO/Stream.h>
 #include <osre/IO/Uri.h>
 #include <osre/Platform/AbstractOGLRenderContext.h>
 #include <osre/Profiling/PerformanceCounterRegistry.h>
 #include <osre/RenderBackend/RenderStates.h>
 #include <osre/RenderBackend/Shader.h>
+#include <osre/RenderBackend/TextureContainer.h>
 
 #include <cppcore/CPPCoreCommon.h>
 #include <cppcore/Memory/MemUtils.h>
 
 #include "SOIL.h"
 
+#include <chrono>
 #include <iostream>
+#include <sstream>
 
 namespace OSRE {
 namespace RenderBackend {
 
 using namespace ::CPPCore;
+using namespace ::OSRE::Common;
 
 static const String Tag = "OGLRenderBackend";
 static const ui32 NotInitedHandle = 9999999;
+static const size_t StreamRegionSize = 4 * 1024 * 1024;
+static const d32 PendingProgramBudget = 2.0;
+
+// The members of the camera block, written every frame
+static const HashId ViewHash = StringUtils::hashName("View");
+static const HashId ProjectionHash = StringUtils::hashName("Projection");
+static const HashId ViewProjectionHash = StringUtils::hashName("ViewProjection");
 
 OGLRenderBackend::OGLRenderBackend() :
         m_renderCtx(nullptr),
@@ -55,19 +68,34 @@ OGLRenderBackend::OGLRenderBackend() :
         m_activeVB(NotInitedHandle),
         m_activeIB(NotInitedHandle),
         m_vertexarrays(),
-        m_activeVertexArray(OGLNotSetId),
         m_shaders(),
         m_textures(),
         m_freeTexSlots(),
         m_texLookupMap(),
         m_parameters(),
+        m_parameterLookup(),
+        m_mvpParam(nullptr),
         m_shaderInUse(nullptr),
         m_freeBufferSlots(),
         m_primitives(),
         m_fpState(nullptr),
         m_fpsCounter(nullptr),
         m_oglCapabilities(nullptr),
-        m_framebuffers() {
+        m_framebuffers(),
+        m_stateCache(),
+        m_bindingPoints(),
+        m_uniformBlocks(),
+        m_cameraBlock(nullptr),
+        m_streamBuffer(nullptr),
+        m_numIndirectDraws(0),
+        m_driverId(),
+        m_programCache(),
+        m_numPrograms(0),
+        m_shaderSetupTime(0.0),
+        m_asyncShaderCompile(false),
+        m_pendingPrograms(),
+        m_textureUploader(),
+        m_defaultTexture(nullptr) {
     mBindedTextures.resize((size_t)TextureStageType::NumTextureStageTypes);
     for (size_t i = 0; i < (size_t)TextureStageType::NumTextureStageTypes; ++i) {
         mBindedTextures[i] = nullptr;
@@ -81,6 +109,13 @@ OGLRenderBackend::~OGLRenderBackend() {
     delete m_oglCapabilities;
     m_oglCapabilities = nullptr;
 
+    delete m_streamBuffer;
+    m_streamBuffer = nullptr;
+
+    m_textureUploader.destroy();
+    TextureLoader::setDeferredDecoding(false);
+
+    releaseAllUniformBlocks();
     releaseAllShaders();
     releaseAllTextures();
     releaseAllVertexArrays();
@@ -98,6 +133,27 @@ void OGLRenderBackend::enumerateGPUCaps() {
     glGetIntegerv(GL_MAX_TEXTURE_UNITS, &m_oglCapabilities->mMaxTextureUnits);
     glGetIntegerv(GL_MAX_VERTEX_TEXTURE_IMAGE_UNITS, &m_oglCapabilities->mMaxTextureImageUnits);
     glGetIntegerv(GL_MAX_TEXTURE_COORDS, &m_oglCapabilities->mMaxTextureCoords);
+    glGetIntegerv(GL_MAX_UNIFORM_BUFFER_BINDINGS, &m_oglCapabilities->mMaxUniformBufferBindings);
+    glGetIntegerv(GL_MAX_UNIFORM_BLOCK_SIZE, &m_oglCapabilities->mMaxUniformBlockSize);
+    m_oglCapabilities->mMultiDrawIndirect = GLEW_ARB_multi_draw_indirect || GLEW_VERSION_4_3;
+    m_oglCapabilities->mShaderStorageBuffers = GLEW_ARB_shader_storage_buffer_object || GLEW_VERSION_4_3;
+    if (m_oglCapabilities->mShaderStorageBuffers) {
+        glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &m_oglCapabilities->mStorageBufferOffsetAlignment);
+    }
+    m_oglCapabilities->mS3TCCompression = GLEW_EXT_texture_compression_s3tc;
+    m_oglCapabilities->mRGTCCompression = GLEW_ARB_texture_compression_rgtc || GLEW_VERSION_3_0;
+    m_oglCapabilities->mBPTCCompression = GLEW_ARB_texture_compression_bptc || GLEW_VERSION_4_2;
+
+    GLint numExtensions(0);
+    glGetIntegerv(GL_NUM_EXTENSIONS, &numExtensions);
+    for (GLint i = 0; i < numExtensions; ++i) {
+        const c8 *extension = (const c8 *)glGetStringi(GL_EXTENSIONS, i);
+        if (nullptr != extension && (0 == ::strcmp(extension, "GL_KHR_parallel_shader_compile") ||
+                                            0 == ::strcmp(extension, "GL_ARB_parallel_shader_compile"))) {
+            m_oglCapabilities->mParallelShaderCompile = true;
+            break;
+        }
+    }
 }
 
 void OGLRenderBackend::setMatrix(MatrixType type, const glm::mat4 &mat) {
@@ -139,16 +195,19 @@ const glm::mat4 &OGLRenderBackend::getMatrix(MatrixType type) const {
 }
 
 void OGLRenderBackend::applyMatrix() {
-    OGLParameter *mvp = getParameter("MVP");
-    if (nullptr == mvp) {
+    if (nullptr == m_mvpParam) {
         UniformDataBlob *blob = UniformDataBlob::create(ParameterType::PT_Mat4, 1);
         ::memcpy(blob->m_data, m_mvp.getMVP(), sizeof(glm::mat4));
-        mvp = createParameter("MVP", ParameterType::PT_Mat4, blob, 1);
+        m_mvpParam = createParameter("MVP", ParameterType::PT_Mat4, blob, 1);
+        if (nullptr == m_mvpParam) {
+            return;
+        }
     } else {
-        memcpy(mvp->m_data->m_data, m_mvp.getMVP(), sizeof(glm::mat4));
+        memcpy(m_mvpParam->m_data->m_data, m_mvp.getMVP(), sizeof(glm::mat4));
     }
 
-    setParameter(mvp);
+    setParameter(m_mvpParam);
+    updateCameraBlock();
 }
 
 bool OGLRenderBackend::create(Platform::AbstractOGLRenderContext *renderCtx) {
@@ -174,6 +233,14 @@ bool OGLRenderBackend::create(Platform::AbstractOGLRenderContext *renderCtx) {
         String version(GLVersionString);
         osre_info(Tag, version);
     }
+
+    // Program binaries are only valid for the driver, which has written them
+    m_driverId.clear();
+    m_driverId += nullptr != GLVendorString ? GLVendorString : "";
+    m_driverId += "|";
+    m_driverId += nullptr != GLRendererString ? GLRendererString : "";
+    m_driverId += "|";
+    m_driverId += nullptr != GLVersionString ? GLVersionString : "";
     const char *GLExtensions = (const char *)glGetString(GL_EXTENSIONS);
     if (GLExtensions) {
         String extensions(GLExtensions);
@@ -190,9 +257,16 @@ bool OGLRenderBackend::create(Platform::AbstractOGLRenderContext *renderCtx) {
     glEnable(GL_TEXTURE_3D);
     glDisable(GL_LIGHTING);
 
-    glEnable(GL_DEPTH_TEST);
-    glDepthMask(GL_TRUE);
-    glDepthFunc(GL_LESS);
+    m_stateCache.reset();
+    if (m_stateCache.setCapability(GL_DEPTH_TEST, true)) {
+        glEnable(GL_DEPTH_TEST);
+    }
+    if (m_stateCache.setDepthMask(true)) {
+        glDepthMask(GL_TRUE);
+    }
+    if (m_stateCache.setDepthFunc(GL_LESS)) {
+        glDepthFunc(GL_LESS);
+    }
     glEnable(GL_MULTISAMPLE);
 
     return true;
@@ -211,6 +285,7 @@ void OGLRenderBackend::setTimer(Platform::AbstractTimer *timer) {
 void OGLRenderBackend::setRenderContext(Platform::AbstractOGLRenderContext *renderCtx) {
     if (m_renderCtx != renderCtx) {
         m_renderCtx = renderCtx;
+        m_stateCache.reset();
         if (nullptr != m_renderCtx) {
             m_renderCtx->activate();
         }
@@ -282,7 +357,9 @@ void OGLRenderBackend::bindBuffer(OGLBuffer *buffer) {
     }
 
     GLenum target = OGLEnum::getGLBufferType(buffer->m_type);
-    glBindBuffer(target, buffer->m_oglId);
+    if (m_stateCache.bindBuffer(target, buffer->m_oglId)) {
+        glBindBuffer(target, buffer->m_oglId);
+    }
 
     //CHECKOGLERRORSTATE();
 }
@@ -302,7 +379,9 @@ void OGLRenderBackend::unbindBuffer(OGLBuffer *buffer) {
     m_activeVB = NotInitedHandle;
     m_activeIB = NotInitedHandle;
     GLenum target = OGLEnum::getGLBufferType(buffer->m_type);
-    glBindBuffer(target, 0);
+    if (m_stateCache.bindBuffer(target, 0)) {
+        glBindBuffer(target, 0);
+    }
 
     CHECKOGLERRORSTATE();
 }
@@ -314,10 +393,81 @@ void OGLRenderBackend::copyDataToBuffer(OGLBuffer *buffer, void *data, size_t si
     }
     GLenum target = OGLEnum::getGLBufferType(buffer->m_type);
     glBufferData(target, size, data, OGLEnum::getGLBufferAccessType(usage));
+    buffer->m_size = size;
+
+    CHECKOGLERRORSTATE();
+}
+
+void OGLRenderBackend::copySubDataToBuffer(OGLBuffer *buffer, size_t offset, const void *data, size_t size) {
+    if (nullptr == buffer || nullptr == data) {
+        osre_debug(Tag, "Invalid buffer range.");
+        return;
+    }
+
+    if (offset + size > buffer->m_size) {
+        osre_error(Tag, "Range exceeds the buffer size.");
+        return;
+    }
+
+    if (m_stateCache.bindBuffer(GL_COPY_WRITE_BUFFER, buffer->m_oglId)) {
+        glBindBuffer(GL_COPY_WRITE_BUFFER, buffer->m_oglId);
+    }
+    glBufferSubData(GL_COPY_WRITE_BUFFER, offset, size, data);
 
     CHECKOGLERRORSTATE();
 }
 
+void OGLRenderBackend::updateBuffer(OGLBuffer *buffer, const void *data, size_t size, BufferAccessType usage, size_t offset) {
+    if (nullptr == buffer || nullptr == data) {
+        osre_debug(Tag, "Invalid buffer update.");
+        return;
+    }
+
+    // Growing buffers need new storage
+    OGLStreamBuffer *streamBuffer = getStreamBuffer();
+    size_t streamOffset(0);
+    void *dest = nullptr;
+    if (offset + size <= buffer->m_size && nullptr != streamBuffer) {
+        dest = streamBuffer->map(size, streamOffset);
+    }
+
+    if (nullptr == dest) {
+        if (0 != offset) {
+            copySubDataToBuffer(buffer, offset, data, size);
+            return;
+        }
+        bindBuffer(buffer);
+        copyDataToBuffer(buffer, const_cast<void *>(data), size, usage);
+        return;
+    }
+
+    ::memcpy(dest, data, size);
+    streamBuffer->unmap();
+
+    // A persistent stream buffer is not rebound by map, so bind it as copy source here
+    if (m_stateCache.bindBuffer(GL_COPY_READ_BUFFER, streamBuffer->getId())) {
+        glBindBuffer(GL_COPY_READ_BUFFER, streamBuffer->getId());
+    }
+    if (m_stateCache.bindBuffer(GL_COPY_WRITE_BUFFER, buffer->m_oglId)) {
+        glBindBuffer(GL_COPY_WRITE_BUFFER, buffer->m_oglId);
+    }
+    glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, streamOffset, offset, size);
+
+    CHECKOGLERRORSTATE();
+}
+
+OGLStreamBuffer *OGLRenderBackend::getStreamBuffer() {
+    if (nullptr == m_streamBuffer) {
+        m_streamBuffer = new OGLStreamBuffer;
+        if (!m_streamBuffer->create(&m_stateCache, StreamRegionSize)) {
+            delete m_streamBuffer;
+            m_streamBuffer = nullptr;
+        }
+    }
+
+    return m_streamBuffer;
+}
+
 void OGLRenderBackend::releaseBuffer(OGLBuffer *buffer) {
     if (nullptr == buffer) {
         osre_debug(Tag, "Pointer to buffer instance is nullptr");
@@ -325,6 +475,7 @@ void OGLRenderBackend::releaseBuffer(OGLBuffer *buffer) {
     }
     const size_t slot = buffer->m_handle;
     glDeleteBuffers(1, &buffer->m_oglId);
+    m_stateCache.onBufferDeleted(buffer->m_oglId);
     buffer->m_handle = OGLNotSetId;
     buffer->m_type = BufferType::EmptyBuffer;
     buffer->m_oglId = OGLNotSetId;
@@ -513,12 +664,37 @@ bool OGLRenderBackend::bindVertexLayout(OGLVertexArray *va, OGLShader *shader, s
     return true;
 }
 
+bool OGLRenderBackend::bindInstanceLayout(OGLVertexArray *va, OGLShader *shader) {
+    if (nullptr == va || nullptr == shader) {
+        return false;
+    }
+
+    // Uses the bound instance buffer, every attribute is a vec4 advanced once per instance
+    const size_t numAttribs = InstanceVert::getNumAttributes();
+    const String *attribs = InstanceVert::getAttributes();
+    for (size_t i = 0; i < numAttribs; ++i) {
+        const GLint loc = shader->getAttributeLocation(attribs[i]);
+        if (-1 == loc) {
+            osre_debug(Tag, "Cannot find " + attribs[i]);
+            continue;
+        }
+
+        glEnableVertexAttribArray(loc);
+        glVertexAttribPointer(loc, 4, GL_FLOAT, GL_FALSE, (GLsizei)sizeof(InstanceVert),
+                (const GLvoid *)(i * sizeof(glm::vec4)));
+        glVertexAttribDivisor(loc, 1);
+    }
+
+    return true;
+}
+
 void OGLRenderBackend::destroyVertexArray(OGLVertexArray *vertexArray) {
     if (nullptr == vertexArray) {
         return;
     }
 
     glDeleteVertexArrays(1, &vertexArray->m_id);
+    m_stateCache.onVertexArrayDeleted(vertexArray->m_id);
     vertexArray->m_id = NotInitedHandle;
 }
 
@@ -537,16 +713,19 @@ void OGLRenderBackend::bindVertexArray(OGLVertexArray *vertexArray) {
         return;
     }
 
-    if ((m_activeVertexArray == OGLNotSetId) || (m_activeVertexArray != vertexArray->m_id)) {
-        m_activeVertexArray = vertexArray->m_id;
-        glBindVertexArray(m_activeVertexArray);
+    if (m_stateCache.bindVertexArray(vertexArray->m_id)) {
+        // The element array binding is part of the vertex array state
+        m_stateCache.invalidateBuffer(GL_ELEMENT_ARRAY_BUFFER);
+        glBindVertexArray(vertexArray->m_id);
         CHECKOGLERRORSTATE();
     }
 }
 
 void OGLRenderBackend::unbindVertexArray() {
-    glBindVertexArray(0);
-    m_activeVertexArray = OGLNotSetId;
+    if (m_stateCache.bindVertexArray(0)) {
+        m_stateCache.invalidateBuffer(GL_ELEMENT_ARRAY_BUFFER);
+        glBindVertexArray(0);
+    }
 }
 
 void OGLRenderBackend::releaseAllVertexArrays() {
@@ -556,6 +735,15 @@ void OGLRenderBackend::releaseAllVertexArrays() {
     m_vertexarrays.clear();
 }
 
+bool OGLRenderBackend::enableProgramCache(const String &cacheDir) {
+    if (!m_programCache.init(cacheDir, m_driverId)) {
+        return false;
+    }
+    osre_info(Tag, "Using shader cache " + cacheDir);
+
+    return true;
+}
+
 OGLShader *OGLRenderBackend::createShader(const String &name, Shader *shaderInfo) {
     if (name.empty()) {
         osre_debug(Tag, "Name for shader is nullptr");
@@ -570,40 +758,127 @@ OGLShader *OGLRenderBackend::createShader(const String &name, Shader *shaderInfo
     oglShader = new OGLShader(name);
     m_shaders.add(oglShader);
     if (shaderInfo) {
-        bool result(false);
-        if (!shaderInfo->m_src[static_cast<int>(ShaderType::SH_VertexShaderType)].empty()) {
-            result = oglShader->loadFromSource(ShaderType::SH_VertexShaderType,
-                    shaderInfo->m_src[static_cast<int>(ShaderType::SH_VertexShaderType)]);
-            if (!result) {
-                osre_error(Tag, "Error while compiling VertexShader.");
-            }
+        typedef std::chrono::high_resolution_clock Clock;
+        const Clock::time_point start = Clock::now();
+
+        // Shaders defining DRAW_DATA read the model matrix of merged draws from the per-draw data
+        String sources[MaxShaderTypes];
+        for (ui32 i = 0; i < MaxShaderTypes; ++i) {
+            sources[i] = shaderInfo->m_src[i];
         }
+        const bool drawData = nullptr != m_oglCapabilities && m_oglCapabilities->mShaderStorageBuffers;
+        String &vs = sources[static_cast<int>(ShaderType::SH_VertexShaderType)];
+        vs = OGLIndirectDrawBuffer::injectGLSLDeclaration(vs, isMultiDrawIndirectSupported(), drawData);
+
+        const ui64 key = m_programCache.getKey(sources, MaxShaderTypes);
+        const bool cached = m_programCache.load(key, oglShader);
+        if (!cached) {
+            bool result(false);
+            if (!sources[static_cast<int>(ShaderType::SH_VertexShaderType)].empty()) {
+                result = oglShader->loadFromSource(ShaderType::SH_VertexShaderType,
+                        sources[static_cast<int>(ShaderType::SH_VertexShaderType)]);
+                if (!result) {
+                    osre_error(Tag, "Error while compiling VertexShader.");
+                }
+            }
 
-        if (!shaderInfo->m_src[static_cast<int>(ShaderType::SH_FragmentShaderType)].empty()) {
-            result = oglShader->loadFromSource(ShaderType::SH_FragmentShaderType,
-                    shaderInfo->m_src[static_cast<int>(ShaderType::SH_FragmentShaderType)]);
-            if (!result) {
-                osre_error(Tag, "Error while compiling FragmentShader.");
+            if (!sources[static_cast<int>(ShaderType::SH_FragmentShaderType)].empty()) {
+                result = oglShader->loadFromSource(ShaderType::SH_FragmentShaderType,
+                        sources[static_cast<int>(ShaderType::SH_FragmentShaderType)]);
+                if (!result) {
+                    osre_error(Tag, "Error while compiling FragmentShader.");
+                }
+            }
+
+            if (!sources[static_cast<int>(ShaderType::SH_GeometryShaderType)].empty()) {
+                result = oglShader->loadFromSource(ShaderType::SH_GeometryShaderType,
+                        sources[static_cast<int>(ShaderType::SH_GeometryShaderType)]);
+                if (!result) {
+                    osre_error(Tag, "Error while compiling GeometryShader.");
+                }
             }
-        }
 
-        if (!shaderInfo->m_src[static_cast<int>(ShaderType::SH_GeometryShaderType)].empty()) {
-            result = oglShader->loadFromSource(ShaderType::SH_GeometryShaderType,
-                    shaderInfo->m_src[static_cast<int>(ShaderType::SH_GeometryShaderType)]);
-            if (!result) {
-                osre_error(Tag, "Error while compiling GeometryShader.");
+            result = oglShader->link(m_programCache.isEnabled());
+            if (result && m_asyncShaderCompile) {
+                // Draws using the program are skipped until updatePendingShaders has finished it
+                PendingProgram pending;
+                pending.m_shader = oglShader;
+                pending.m_key = key;
+                m_pendingPrograms.add(pending);
+            } else if (result) {
+                oglShader->updateLinkState(true);
             }
         }
 
-        result = oglShader->createAndLink();
-        if (!result) {
-            osre_error(Tag, "Error while linking shader");
+        // Startup cost of the programs, compare a run with an empty cache against a warm one
+        m_shaderSetupTime += std::chrono::duration<d32, std::milli>(Clock::now() - start).count();
+        if (!oglShader->isLinkPending()) {
+            finishShader(oglShader, key, cached);
         }
     }
 
     return oglShader;
 }
 
+void OGLRenderBackend::finishShader(OGLShader *shader, ui64 key, bool cached) {
+    if (!shader->isCompiled()) {
+        osre_error(Tag, "Error while linking shader " + shader->getName());
+    } else {
+        if (!cached) {
+            m_programCache.store(key, shader);
+        }
+        linkUniformBlocks(shader);
+    }
+
+    ++m_numPrograms;
+    Profiling::PerformanceCounterRegistry::setCounter("shader_programs_cached", m_programCache.getNumHits());
+    Profiling::PerformanceCounterRegistry::setCounter("shader_setup_ms", static_cast<ui32>(m_shaderSetupTime));
+
+    std::stringstream stream;
+    stream << "Shader setup: " << m_numPrograms << " programs, " << m_programCache.getNumHits()
+           << " from cache, " << m_pendingPrograms.size() << " pending, " << m_shaderSetupTime << " ms.";
+    osre_debug(Tag, stream.str());
+}
+
+void OGLRenderBackend::setAsyncShaderCompile(bool enabled) {
+    m_asyncShaderCompile = enabled;
+}
+
+void OGLRenderBackend::updatePendingShaders() {
+    if (m_pendingPrograms.isEmpty()) {
+        return;
+    }
+
+    typedef std::chrono::high_resolution_clock Clock;
+    const Clock::time_point start = Clock::now();
+    const bool parallel = nullptr != m_oglCapabilities && m_oglCapabilities->mParallelShaderCompile;
+    d32 elapsed(0.0);
+    ui32 i(0);
+    while (i < m_pendingPrograms.size()) {
+        // Without the extension each program blocks until it is linked, the budget limits the stall
+        if (!parallel && elapsed >= PendingProgramBudget) {
+            break;
+        }
+
+        OGLShader *shader = m_pendingPrograms[i].m_shader;
+        const ui64 key = m_pendingPrograms[i].m_key;
+        if (!shader->updateLinkState(!parallel)) {
+            ++i;
+            continue;
+        }
+
+        m_pendingPrograms.remove(i);
+        const d32 now = std::chrono::duration<d32, std::milli>(Clock::now() - start).count();
+        m_shaderSetupTime += now - elapsed;
+        elapsed = now;
+        finishShader(shader, key, false);
+    }
+}
+
+size_t OGLRenderBackend::getNumPendingShaders() const {
+    return m_pendingPrograms.size();
+}
+
 OGLShader *OGLRenderBackend::getShader(const String &name) {
     if (name.empty()) {
         return nullptr;
@@ -621,20 +896,24 @@ OGLShader *OGLRenderBackend::getShader(const String &name) {
 }
 
 bool OGLRenderBackend::useShader(OGLShader *shader) {
-    if (m_shaderInUse == shader) {
-        // shader already in use
-        return true;
+    // Binding a program, which is still linking, would wait for the driver
+    if (nullptr != shader && shader->isLinkPending()) {
+        return false;
     }
 
     // unuse an older shader
-    if (nullptr != m_shaderInUse) {
-        m_shaderInUse->unuse();
+    if (nullptr != m_shaderInUse && m_shaderInUse != shader) {
+        m_shaderInUse->setInUse(false);
     }
 
-    // use new shader
+    // use new shader, switching directly without binding 0 in between
     m_shaderInUse = shader;
+    const GLuint program = (nullptr != m_shaderInUse) ? m_shaderInUse->getProgramId() : 0;
     if (nullptr != m_shaderInUse) {
-        m_shaderInUse->use();
+        m_shaderInUse->setInUse(true);
+    }
+    if (m_stateCache.useProgram(program)) {
+        glUseProgram(program);
     }
 
     return true;
@@ -662,6 +941,13 @@ bool OGLRenderBackend::releaseShader(OGLShader *shader) {
 
     // remove shader from list
     if (found) {
+        for (ui32 i = 0; i < m_pendingPrograms.size(); ++i) {
+            if (m_pendingPrograms[i].m_shader == shader) {
+                m_pendingPrograms.remove(i);
+                break;
+            }
+        }
+        m_stateCache.onProgramDeleted(m_shaders[idx]->getProgramId());
         delete m_shaders[idx];
         m_shaders.remove(idx);
     }
@@ -675,10 +961,42 @@ void OGLRenderBackend::releaseAllShaders() {
             if (m_shaderInUse == m_shaders[i]) {
                 useShader(nullptr);
             }
+            m_stateCache.onProgramDeleted(m_shaders[i]->getProgramId());
             delete m_shaders[i];
         }
     }
     m_shaders.clear();
+    m_pendingPrograms.clear();
+}
+
+bool OGLRenderBackend::enableTextureStreaming(Threading::JobScheduler *scheduler, size_t budget) {
+    if (!m_textureUploader.create(&m_stateCache, scheduler, budget)) {
+        return false;
+    }
+    TextureLoader::setDeferredDecoding(true);
+
+    std::stringstream stream;
+    stream << "Streaming textures with " << budget << " bytes per frame.";
+    osre_info(Tag, stream.str());
+
+    return true;
+}
+
+size_t OGLRenderBackend::getNumPendingTextures() const {
+    return m_textureUploader.getNumPending();
+}
+
+OGLTexture *OGLRenderBackend::getDefaultTexture() {
+    if (nullptr != m_defaultTexture) {
+        return m_defaultTexture;
+    }
+
+    // A white pixel, so the material colors are shown as they are
+    static const uc8 White[4] = { 255, 255, 255, 255 };
+    m_defaultTexture = createEmptyTexture("$default", TextureTargetType::Texture2D, TextureFormatType::R8G8B8, 1, 1, 3);
+    glTexImage2D(m_defaultTexture->m_target, 0, GL_RGB, 1, 1, 0, m_defaultTexture->m_format, GL_UNSIGNED_BYTE, White);
+
+    return m_defaultTexture;
 }
 
 OGLTexture *OGLRenderBackend::createEmptyTexture(const String &name, TextureTargetType target, TextureFormatType format,
@@ -715,11 +1033,17 @@ OGLTexture *OGLRenderBackend::createEmptyTexture(const String &name, TextureTarg
     tex->m_width = static_cast<ui32>(width);
     tex->m_height = static_cast<ui32>(height);
     tex->m_channels = static_cast<ui32>(channels);
+    tex->m_layers = 1;
     tex->m_format = OGLEnum::getGLTextureFormat(format);
+    tex->m_resident = true;
 
-    glActiveTexture(GL_TEXTURE0);
     tex->m_target = OGLEnum::getGLTextureTarget(target);
-    glBindTexture(tex->m_target, textureId);
+    if (m_stateCache.setActiveTexture(GL_TEXTURE0)) {
+        glActiveTexture(GL_TEXTURE0);
+    }
+    if (m_stateCache.bindTexture(GL_TEXTURE0, tex->m_target, textureId)) {
+        glBindTexture(tex->m_target, textureId);
+    }
 
     glTexParameteri(tex->m_target, OGLEnum::getGLTextureEnum(TextureParameterName::TextureParamMinFilter), GL_LINEAR);
     glTexParameteri(tex->m_target, OGLEnum::getGLTextureEnum(TextureParameterName::TextureParamMagFilter), GL_LINEAR);
@@ -755,15 +1079,62 @@ OGLTexture *OGLRenderBackend::createTexture(const String &name, Texture *tex) {
         return glTex;
     }
 
+    if (TextureContainer::isCompressed(tex->m_format)) {
+        return createTextureFromContainer(name, tex->m_data, tex->m_size);
+    }
+
+    if (TextureTargetType::Texture2DArray == tex->m_targetType) {
+        return createTextureArray(name, tex->m_width, tex->m_height, tex->m_layers, tex->m_numMipLevels, tex->m_data);
+    }
+
+    // Images located by a deferred TextureLoader are decoded and streamed in by the uploader
+    if (nullptr == tex->m_data && !tex->m_loc.getAbsPath().empty()) {
+        return createTextureFromFile(name, tex->m_loc);
+    }
+
     glTex = createEmptyTexture(name, tex->m_targetType, TextureFormatType::R8G8B8, tex->m_width, tex->m_height, tex->m_channels);
     glTexImage2D(glTex->m_target, 0, GL_RGB, tex->m_width, tex->m_height, 0, glTex->m_format, GL_UNSIGNED_BYTE, tex->m_data);
     glGenerateMipmap(glTex->m_target);
     glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAX_ANISOTROPY_EXT, m_oglCapabilities->mMaxAniso);
-    glBindTexture(glTex->m_target, 0);
+    if (m_stateCache.bindTexture(GL_TEXTURE0, glTex->m_target, 0)) {
+        glBindTexture(glTex->m_target, 0);
+    }
 
     return glTex;
 }
 
+OGLTexture *OGLRenderBackend::createTextureArray(const String &name, ui32 width, ui32 height, ui32 layers,
+        ui32 numMipLevels, const uc8 *data) {
+    OGLTexture *tex(findTexture(name));
+    if (nullptr != tex) {
+        return tex;
+    }
+
+    if (0 == width || 0 == height || 0 == layers) {
+        osre_error(Tag, "Invalid size of texture array " + name);
+        return nullptr;
+    }
+
+    tex = createEmptyTexture(name, TextureTargetType::Texture2DArray, TextureFormatType::R8G8B8A8, width, height, 4);
+    tex->m_layers = layers;
+    glTexParameteri(tex->m_target, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(tex->m_target, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(tex->m_target, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    if (0 != numMipLevels) {
+        // The mip generation of later layer updates stops there as well
+        glTexParameteri(tex->m_target, GL_TEXTURE_MAX_LEVEL, numMipLevels - 1);
+    }
+    glTexImage3D(tex->m_target, 0, GL_RGBA8, width, height, layers, 0, tex->m_format, GL_UNSIGNED_BYTE, data);
+    if (nullptr != data) {
+        glGenerateMipmap(tex->m_target);
+    }
+    if (m_stateCache.bindTexture(GL_TEXTURE0, tex->m_target, 0)) {
+        glBindTexture(tex->m_target, 0);
+    }
+
+    return tex;
+}
+
 OGLTexture *OGLRenderBackend::createTextureFromFile(const String &name, const IO::Uri &fileloc) {
     OGLTexture *tex(findTexture(name));
     if (tex) {
@@ -772,6 +1143,38 @@ OGLTexture *OGLRenderBackend::createTextureFromFile(const String &name, const IO
 
     // import the texture
     const String filename = fileloc.getAbsPath();
+    if (TextureContainer::isContainerFile(filename)) {
+        // Nothing to decode, the levels are small enough to be uploaded at once
+        IO::IOService *ioService = IO::IOService::getInstance();
+        IO::Stream *stream = nullptr != ioService ?
+                ioService->openStream(IO::Uri("file://" + filename), IO::Stream::AccessMode::ReadAccessBinary) :
+                nullptr;
+        if (nullptr == stream) {
+            osre_debug(Tag, "Cannot load texture " + filename);
+            return nullptr;
+        }
+
+        MemoryBuffer content;
+        content.resize(stream->getSize());
+        if (!content.isEmpty()) {
+            content.resize(stream->read(&content[0], static_cast<ui32>(content.size())));
+        }
+        ioService->closeStream(&stream);
+        if (content.isEmpty()) {
+            return nullptr;
+        }
+
+        return createTextureFromContainer(name, reinterpret_cast<const uc8 *>(&content[0]), content.size());
+    }
+
+    if (m_textureUploader.isCreated()) {
+        // The storage is allocated once the size is known, until then the default texture is used
+        tex = createEmptyTexture(name, TextureTargetType::Texture2D, TextureFormatType::R8G8B8, 0, 0, 0);
+        tex->m_resident = false;
+        m_textureUploader.enqueue(tex, filename);
+        return tex;
+    }
+
     i32 width(0), height(0), channels(0);
     GLubyte *data = SOIL_load_image(filename.c_str(), &width, &height, &channels, SOIL_LOAD_AUTO);
     if (!data) {
@@ -796,13 +1199,84 @@ OGLTexture *OGLRenderBackend::createTextureFromFile(const String &name, const IO
     // create texture and fill it
     tex = createEmptyTexture(name, TextureTargetType::Texture2D, TextureFormatType::R8G8B8, width, height, channels);
     glTexImage2D(tex->m_target, 0, GL_RGB, width, height, 0, tex->m_format, GL_UNSIGNED_BYTE, data);
-    glBindTexture(tex->m_target, 0);
+    if (m_stateCache.bindTexture(GL_TEXTURE0, tex->m_target, 0)) {
+        glBindTexture(tex->m_target, 0);
+    }
 
     SOIL_free_image_data(data);
 
     return tex;
 }
 
+OGLTexture *OGLRenderBackend::createTextureFromContainer(const String &name, const uc8 *data, size_t size) {
+    OGLTexture *tex(findTexture(name));
+    if (nullptr != tex) {
+        return tex;
+    }
+
+    TextureContainer container;
+    if (!container.parse(data, size)) {
+        osre_error(Tag, "Invalid texture container for " + name);
+        return nullptr;
+    }
+
+    if (!isTextureFormatSupported(container.getFormat())) {
+        osre_error(Tag, "Compressed format of " + name + " is not supported by the GPU.");
+        return nullptr;
+    }
+
+    tex = createEmptyTexture(name, TextureTargetType::Texture2D, container.getFormat(), container.getWidth(),
+            container.getHeight(), 0);
+    for (ui32 i = 0; i < container.getNumLevels(); ++i) {
+        const TextureMipLevel &level = container.getLevel(i);
+        glCompressedTexImage2D(tex->m_target, i, tex->m_format, level.m_width, level.m_height, 0,
+                static_cast<GLsizei>(level.m_size), container.getLevelData(i));
+    }
+
+    // The mip chain is prebuilt, a missing one is not generated at runtime
+    glTexParameteri(tex->m_target, GL_TEXTURE_MAX_LEVEL, container.getNumLevels() - 1);
+    if (container.getNumLevels() > 1) {
+        glTexParameteri(tex->m_target, OGLEnum::getGLTextureEnum(TextureParameterName::TextureParamMinFilter),
+                GL_LINEAR_MIPMAP_LINEAR);
+    }
+    if (m_stateCache.bindTexture(GL_TEXTURE0, tex->m_target, 0)) {
+        glBindTexture(tex->m_target, 0);
+    }
+    CHECKOGLERRORSTATE();
+
+    return tex;
+}
+
+bool OGLRenderBackend::isTextureFormatSupported(TextureFormatType format) const {
+    if (nullptr == m_oglCapabilities) {
+        return false;
+    }
+
+    switch (format) {
+        case TextureFormatType::R8G8B8:
+        case TextureFormatType::R8G8B8A8:
+            return true;
+        case TextureFormatType::BC1:
+        case TextureFormatType::BC2:
+        case TextureFormatType::BC3:
+        case TextureFormatType::BC1_SRGB:
+        case TextureFormatType::BC2_SRGB:
+        case TextureFormatType::BC3_SRGB:
+            return m_oglCapabilities->mS3TCCompression;
+        case TextureFormatType::BC4:
+        case TextureFormatType::BC5:
+            return m_oglCapabilities->mRGTCCompression;
+        case TextureFormatType::BC6H:
+        case TextureFormatType::BC7:
+        case TextureFormatType::BC7_SRGB:
+            return m_oglCapabilities->mBPTCCompression;
+        default:
+            break;
+    }
+
+    return false;
+}
+
 OGLTexture *OGLRenderBackend::createTextureFromStream(const String &name, IO::Stream &stream,
         ui32 width, ui32 height, ui32 channels) {
     OGLTexture *tex(findTexture(name));
@@ -841,10 +1315,20 @@ bool OGLRenderBackend::bindTexture(OGLTexture *oglTexture, TextureStageType stag
         return false;
     }
 
+    if (!oglTexture->m_resident) {
+        oglTexture = getDefaultTexture();
+    }
+
     GLenum glStageType = OGLEnum::getGLTextureStage(stageType);
-    glActiveTexture(glStageType);
-    glBindTexture(oglTexture->m_target, oglTexture->m_textureId);
     mBindedTextures[(size_t)stageType] = oglTexture;
+    if (!m_stateCache.bindTexture(glStageType, oglTexture->m_target, oglTexture->m_textureId)) {
+        return true;
+    }
+
+    if (m_stateCache.setActiveTexture(glStageType)) {
+        glActiveTexture(glStageType);
+    }
+    glBindTexture(oglTexture->m_target, oglTexture->m_textureId);
 
     return true;
 }
@@ -857,7 +1341,13 @@ bool OGLRenderBackend::unbindTexture( TextureStageType stageType ) {
 
     if (nullptr != mBindedTextures[index]) {
         OGLTexture *oglTexture = mBindedTextures[index];
-        glBindTexture(oglTexture->m_target, 0);
+        const GLenum glStageType = OGLEnum::getGLTextureStage(stageType);
+        if (m_stateCache.bindTexture(glStageType, oglTexture->m_target, 0)) {
+            if (m_stateCache.setActiveTexture(glStageType)) {
+                glActiveTexture(glStageType);
+            }
+            glBindTexture(oglTexture->m_target, 0);
+        }
         mBindedTextures[index] = nullptr;
     }
 
@@ -869,7 +1359,12 @@ void OGLRenderBackend::releaseTexture(OGLTexture *oglTexture) {
         return;
     }
 
+    m_textureUploader.cancel(oglTexture);
+    if (m_defaultTexture == oglTexture) {
+        m_defaultTexture = nullptr;
+    }
     glDeleteTextures(1, &oglTexture->m_textureId);
+    m_stateCache.onTextureDeleted(oglTexture->m_textureId);
     oglTexture->m_textureId = OGLNotSetId;
     oglTexture->m_width = 0;
     oglTexture->m_height = 0;
@@ -893,21 +1388,28 @@ void OGLRenderBackend::releaseAllTextures() {
     m_freeTexSlots.clear();
     m_textures.clear();
     m_texLookupMap.clear();
+    m_defaultTexture = nullptr;
 }
 
 OGLParameter *OGLRenderBackend::createParameter(const String &name, ParameterType type,
         UniformDataBlob *blob, size_t numItems) {
     // Check if the parameter is already there
-    OGLParameter *param = getParameter(name);
+    const HashId hash = StringUtils::hashName(name);
+    OGLParameter *param = getParameter(hash);
     if (nullptr != param) {
+        if (param->m_name != name) {
+            osre_error(Tag, "Parameter " + name + " has the same hash as " + param->m_name + ".");
+            return nullptr;
+        }
         return param;
     }
 
     // We need to create it
     param = new OGLParameter;
     param->m_name = name;
+    param->m_hash = hash;
+    param->m_handle = static_cast<ui32>(m_parameters.size());
     param->m_type = type;
-    param->m_loc = NoneLocation;
     param->m_numItems = numItems;
     param->m_data = UniformDataBlob::create(type, param->m_numItems);
     if (nullptr != blob) {
@@ -916,6 +1418,7 @@ OGLParameter *OGLRenderBackend::createParameter(const String &name, ParameterTyp
         }
     }
     m_parameters.add(param);
+    m_parameterLookup[hash] = param;
 
     return param;
 }
@@ -925,13 +1428,16 @@ OGLParameter *OGLRenderBackend::getParameter(const String &name) const {
         return nullptr;
     }
 
-    for (ui32 i = 0; i < m_parameters.size(); ++i) {
-        if (m_parameters[i]->m_name == name) {
-            return m_parameters[i];
-        }
+    return getParameter(StringUtils::hashName(name));
+}
+
+OGLParameter *OGLRenderBackend::getParameter(HashId hash) const {
+    std::map<HashId, OGLParameter *>::const_iterator it(m_parameterLookup.find(hash));
+    if (m_parameterLookup.end() == it) {
+        return nullptr;
     }
 
-    return nullptr;
+    return it->second;
 }
 
 void OGLRenderBackend::setParameter(OGLParameter *param) {
@@ -945,66 +1451,68 @@ void OGLRenderBackend::setParameter(OGLParameter *param) {
         return;
     }
 
-    if (NoneLocation == param->m_loc) {
-        param->m_loc = m_shaderInUse->getUniformLocation(param->m_name);
-        //(*m_shaderInUse)(param->m_name);
-        if (NoneLocation == param->m_loc) {
-            osre_debug(Tag, "Cannot location for parameter " + param->m_name + " in shader " + m_shaderInUse->getName() + ".");
-            return;
-        }
+    // The location table of the program is indexed by the parameter handle
+    const GLint loc = m_shaderInUse->getParameterLocation(param->m_handle, param->m_hash);
+    if (NoneLocation == loc) {
+        return;
+    }
+
+    // Skip uploads of values the program already holds
+    if (!m_stateCache.setUniform(m_shaderInUse->getProgramId(), loc, param->m_data->getData(), param->m_data->m_size)) {
+        return;
     }
 
     switch (param->m_type) {
         case ParameterType::PT_Int: {
             GLint data;
             ::memcpy(&data, param->m_data->getData(), sizeof(GLint));
-            glUniform1i(param->m_loc, data);
+            glUniform1i(loc, data);
         } break;
 
         case ParameterType::PT_IntArray: {
-            glUniform1iv(param->m_loc, (GLsizei)param->m_numItems, (i32 *)param->m_data->getData());
+            glUniform1iv(loc, (GLsizei)param->m_numItems, (i32 *)param->m_data->getData());
         } break;
 
         case ParameterType::PT_Float: {
             GLfloat value;
             ::memcpy(&value, param->m_data->getData(), sizeof(GLfloat));
-            glUniform1f(param->m_loc, value);
+            glUniform1f(loc, value);
         } break;
 
         case ParameterType::PT_FloatArray: {
-            glUniform1fv(param->m_loc, (GLsizei)param->m_numItems, (f32 *)param->m_data->getData());
+            glUniform1fv(loc, (GLsizei)param->m_numItems, (f32 *)param->m_data->getData());
 
         } break;
 
         case ParameterType::PT_Float2: {
             GLfloat value[2];
             ::memcpy(&value[0], param->m_data->getData(), sizeof(GLfloat) * 2);
-            glUniform2f(param->m_loc, value[0], value[1]);
+            glUniform2f(loc, value[0], value[1]);
         } break;
 
         case ParameterType::PT_Float2Array: {
-            glUniform2fv(param->m_loc, (GLsizei)param->m_numItems, (f32 *)param->m_data->getData());
+            glUniform2fv(loc, (GLsizei)param->m_numItems, (f32 *)param->m_data->getData());
         } break;
 
         case ParameterType::PT_Float3: {
             GLfloat value[3];
             ::memcpy(&value[0], param->m_data->getData(), sizeof(GLfloat) * 3);
-            glUniform3f(param->m_loc, value[0], value[1], value[2]);
+            glUniform3f(loc, value[0], value[1], value[2]);
         } break;
 
         case ParameterType::PT_Float3Array: {
-            glUniform3fv(param->m_loc, (GLsizei)param->m_numItems, (f32 *)param->m_data->getData());
+            glUniform3fv(loc, (GLsizei)param->m_numItems, (f32 *)param->m_data->getData());
 
         } break;
 
         case ParameterType::PT_Mat4: {
             glm::mat4 mat;
             ::memcpy(&mat, param->m_data->getData(), sizeof(glm::mat4));
-            glUniformMatrix4fv(param->m_loc, 1, GL_FALSE, glm::value_ptr(mat));
+            glUniformMatrix4fv(loc, 1, GL_FALSE, glm::value_ptr(mat));
         } break;
 
         case ParameterType::PT_Mat4Array: {
-            glUniformMatrix4fv(param->m_loc, (GLsizei)param->m_numItems, GL_FALSE, (f32 *)param->m_data->getData());
+            glUniformMatrix4fv(loc, (GLsizei)param->m_numItems, GL_FALSE, (f32 *)param->m_data->getData());
         } break;
 
         default:
@@ -1015,6 +1523,8 @@ void OGLRenderBackend::setParameter(OGLParameter *param) {
 
 void OGLRenderBackend::releaseAllParameters() {
     ContainerClear(m_parameters);
+    m_parameterLookup.clear();
+    m_mvpParam = nullptr;
 }
 
 void OGLRenderBackend::setParameter(OGLParameter **param, size_t numParam) {
@@ -1030,7 +1540,209 @@ void OGLRenderBackend::setParameter(OGLParameter **param, size_t numParam) {
     }
 }
 
-size_t OGLRenderBackend::addPrimitiveGroup(PrimitiveGroup *grp) {
+ui32 OGLRenderBackend::getUniformBindingPoint(const String &blockName) {
+    std::map<String, ui32>::const_iterator it(m_bindingPoints.find(blockName));
+    if (m_bindingPoints.end() != it) {
+        return it->second;
+    }
+
+    const ui32 bindingPoint = static_cast<ui32>(m_bindingPoints.size());
+    if (nullptr != m_oglCapabilities && static_cast<i32>(bindingPoint) >= m_oglCapabilities->mMaxUniformBufferBindings) {
+        osre_error(Tag, "No free uniform buffer binding point for block " + blockName + ".");
+        return OGLNotSetId;
+    }
+    m_bindingPoints[blockName] = bindingPoint;
+
+    // Bind the block in all shaders which were linked before, pending ones are bound when finished
+    for (ui32 i = 0; i < m_shaders.size(); ++i) {
+        const GLuint program = m_shaders[i]->getProgramId();
+        if (0 == program || m_shaders[i]->isLinkPending()) {
+            continue;
+        }
+
+        const GLuint blockIndex = glGetUniformBlockIndex(program, blockName.c_str());
+        if (GL_INVALID_INDEX != blockIndex) {
+            glUniformBlockBinding(program, blockIndex, bindingPoint);
+        }
+    }
+
+    return bindingPoint;
+}
+
+void OGLRenderBackend::linkUniformBlocks(OGLShader *shader) {
+    if (nullptr == shader || 0 == shader->getProgramId()) {
+        return;
+    }
+
+    const GLuint program = shader->getProgramId();
+    for (std::map<String, ui32>::const_iterator it = m_bindingPoints.begin(); it != m_bindingPoints.end(); ++it) {
+        const GLuint blockIndex = glGetUniformBlockIndex(program, it->first.c_str());
+        if (GL_INVALID_INDEX != blockIndex) {
+            glUniformBlockBinding(program, blockIndex, it->second);
+        }
+    }
+
+    // The per-draw data of indirect draws
+    bool usesDrawData(false);
+    if (nullptr != m_oglCapabilities && m_oglCapabilities->mShaderStorageBuffers) {
+        const GLuint drawDataIndex = glGetProgramResourceIndex(program, GL_SHADER_STORAGE_BLOCK, DrawDataBlockName);
+        if (GL_INVALID_INDEX != drawDataIndex) {
+            glShaderStorageBlockBinding(program, drawDataIndex, OGLIndirectDrawBuffer::DrawDataBinding);
+            usesDrawData = true;
+        }
+    }
+    shader->setDrawData(usesDrawData, glGetUniformLocation(program, DrawIndexName),
+            glGetUniformLocation(program, DrawDataEnabledName));
+}
+
+OGLUniformBlock *OGLRenderBackend::createUniformBlock(const String &name, const String &blockName,
+        const UniformBlockLayout &layout) {
+    if (name.empty() || 0 == layout.m_size) {
+        osre_debug(Tag, "Cannot create uniform block, invalid name or empty layout.");
+        return nullptr;
+    }
+
+    if (nullptr != m_oglCapabilities && static_cast<i32>(layout.m_size) > m_oglCapabilities->mMaxUniformBlockSize) {
+        osre_error(Tag, "Uniform block " + name + " exceeds the maximal block size.");
+        return nullptr;
+    }
+
+    OGLUniformBlock *block = getUniformBlock(name);
+    if (nullptr != block) {
+        if (block->m_name != name) {
+            osre_error(Tag, "Uniform block " + name + " has the same hash as " + block->m_name + ".");
+            return nullptr;
+        }
+        return block;
+    }
+
+    const ui32 bindingPoint = getUniformBindingPoint(blockName);
+    if (OGLNotSetId == bindingPoint) {
+        return nullptr;
+    }
+
+    block = new OGLUniformBlock;
+    block->m_name = name;
+    block->m_blockName = blockName;
+    block->m_bindingPoint = bindingPoint;
+    block->m_layout = layout;
+    block->m_staging.resize(layout.m_size);
+    ::memset(&block->m_staging[0], 0, layout.m_size);
+    block->m_buffer = createBuffer(BufferType::UniformBuffer);
+    bindBuffer(block->m_buffer);
+    glBufferData(GL_UNIFORM_BUFFER, layout.m_size, &block->m_staging[0], GL_DYNAMIC_DRAW);
+    block->m_buffer->m_size = layout.m_size;
+    m_uniformBlocks[StringUtils::hashName(name)] = block;
+    CHECKOGLERRORSTATE();
+
+    return block;
+}
+
+OGLUniformBlock *OGLRenderBackend::getUniformBlock(const String &name) const {
+    return getUniformBlock(StringUtils::hashName(name));
+}
+
+OGLUniformBlock *OGLRenderBackend::getUniformBlock(HashId hash) const {
+    std::map<HashId, OGLUniformBlock *>::const_iterator it(m_uniformBlocks.find(hash));
+    if (m_uniformBlocks.end() == it) {
+        return nullptr;
+    }
+
+    return it->second;
+}
+
+bool OGLRenderBackend::setUniformBlockVar(OGLUniformBlock *block, const String &name, const void *data, size_t size) {
+    return setUniformBlockVar(block, StringUtils::hashName(name), data, size);
+}
+
+bool OGLRenderBackend::setUniformBlockVar(OGLUniformBlock *block, HashId hash, const void *data, size_t size) {
+    if (nullptr == block) {
+        return false;
+    }
+
+    const UniformBlockLayout::Member *member = block->m_layout.findMember(hash);
+    if (nullptr == member) {
+        return false;
+    }
+
+    if (!block->m_layout.pack(*member, data, size, &block->m_staging[0])) {
+        return false;
+    }
+    block->m_dirty = true;
+
+    return true;
+}
+
+void OGLRenderBackend::uploadUniformBlock(OGLUniformBlock *block) {
+    bindBuffer(block->m_buffer);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, block->m_layout.m_size, &block->m_staging[0]);
+    block->m_dirty = false;
+}
+
+void OGLRenderBackend::commitUniformBlocks() {
+    for (std::map<HashId, OGLUniformBlock *>::iterator it = m_uniformBlocks.begin(); it != m_uniformBlocks.end(); ++it) {
+        if (it->second->m_dirty) {
+            uploadUniformBlock(it->second);
+        }
+    }
+}
+
+void OGLRenderBackend::bindUniformBlock(OGLUniformBlock *block) {
+    if (nullptr == block) {
+        return;
+    }
+
+    const GLuint bufferId = block->m_buffer->m_oglId;
+    if (m_stateCache.bindBufferBase(GL_UNIFORM_BUFFER, block->m_bindingPoint, bufferId)) {
+        glBindBufferBase(GL_UNIFORM_BUFFER, block->m_bindingPoint, bufferId);
+    }
+}
+
+void OGLRenderBackend::updateCameraBlock() {
+    if (nullptr == m_cameraBlock) {
+        // The per-frame camera constants
+        UniformBlockLayout cameraLayout;
+        cameraLayout.addMember("View", ParameterType::PT_Mat4, 1);
+        cameraLayout.addMember("Projection", ParameterType::PT_Mat4, 1);
+        cameraLayout.addMember("ViewProjection", ParameterType::PT_Mat4, 1);
+        m_cameraBlock = createUniformBlock("camera", CameraBlockName, cameraLayout);
+        if (nullptr == m_cameraBlock) {
+            return;
+        }
+        bindUniformBlock(m_cameraBlock);
+    }
+
+    const glm::mat4 viewProj = m_mvp.m_projection * m_mvp.m_view;
+    bool changed = setUniformBlockVar(m_cameraBlock, ViewHash, glm::value_ptr(m_mvp.m_view), sizeof(glm::mat4));
+    changed |= setUniformBlockVar(m_cameraBlock, ProjectionHash, glm::value_ptr(m_mvp.m_projection), sizeof(glm::mat4));
+    changed |= setUniformBlockVar(m_cameraBlock, ViewProjectionHash, glm::value_ptr(viewProj), sizeof(glm::mat4));
+    if (changed) {
+        uploadUniformBlock(m_cameraBlock);
+    }
+}
+
+void OGLRenderBackend::releaseUniformBlock(OGLUniformBlock *block) {
+    if (nullptr == block) {
+        return;
+    }
+
+    if (m_cameraBlock == block) {
+        m_cameraBlock = nullptr;
+    }
+    m_uniformBlocks.erase(StringUtils::hashName(block->m_name));
+    if (BufferType::EmptyBuffer != block->m_buffer->m_type) {
+        releaseBuffer(block->m_buffer);
+    }
+    delete block;
+}
+
+void OGLRenderBackend::releaseAllUniformBlocks() {
+    while (!m_uniformBlocks.empty()) {
+        releaseUniformBlock(m_uniformBlocks.begin()->second);
+    }
+}
+
+size_t OGLRenderBackend::addPrimitiveGroup(PrimitiveGroup *grp, ui32 baseVertex, size_t indexOffset) {
     if (nullptr == grp) {
         osre_error(Tag, "Group pointer is nullptr");
         return NotInitedHandle;
@@ -1039,8 +1751,9 @@ size_t OGLRenderBackend::addPrimitiveGroup(PrimitiveGroup *grp) {
     OGLPrimGroup *oglGrp = new OGLPrimGroup;
     oglGrp->m_primitive = OGLEnum::getGLPrimitiveType(grp->m_primitive);
     oglGrp->m_indexType = OGLEnum::getGLIndexType(grp->m_indexType);
-    oglGrp->m_startIndex = (ui32)grp->m_startIndex;
+    oglGrp->m_startIndex = (ui32)(grp->m_startIndex + indexOffset);
     oglGrp->m_numIndices = grp->m_numIndices;
+    oglGrp->m_baseVertex = (GLint)baseVertex;
 
     const size_t idx = m_primitives.size();
     m_primitives.add(oglGrp);
@@ -1048,6 +1761,14 @@ size_t OGLRenderBackend::addPrimitiveGroup(PrimitiveGroup *grp) {
     return idx;
 }
 
+OGLPrimGroup *OGLRenderBackend::getPrimitiveGroup(size_t primGrpIdx) const {
+    if (primGrpIdx >= m_primitives.size()) {
+        return nullptr;
+    }
+
+    return m_primitives[primGrpIdx];
+}
+
 void OGLRenderBackend::releaseAllPrimitiveGroups() {
     ContainerClear(m_primitives);
 }
@@ -1055,10 +1776,17 @@ void OGLRenderBackend::releaseAllPrimitiveGroups() {
 OGLFrameBuffer *OGLRenderBackend::createFrameBuffer(const String &name, ui32 width, ui32 height, bool depthBuffer) {
     OGLFrameBuffer *oglFB = new OGLFrameBuffer(name.c_str(), width, height);
     glGenFramebuffers(1, &oglFB->m_bufferId);
-    glBindFramebuffer(GL_FRAMEBUFFER, oglFB->m_bufferId);
+    if (m_stateCache.bindFrameBuffer(oglFB->m_bufferId)) {
+        glBindFramebuffer(GL_FRAMEBUFFER, oglFB->m_bufferId);
+    }
 
     glGenTextures(1, &oglFB->m_renderedTexture);
-    glBindTexture(GL_TEXTURE_2D, oglFB->m_renderedTexture);
+    if (m_stateCache.setActiveTexture(GL_TEXTURE0)) {
+        glActiveTexture(GL_TEXTURE0);
+    }
+    if (m_stateCache.bindTexture(GL_TEXTURE0, GL_TEXTURE_2D, oglFB->m_renderedTexture)) {
+        glBindTexture(GL_TEXTURE_2D, oglFB->m_renderedTexture);
+    }
 
     // Give an empty image to OpenGL ( the last "0" )
     glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, 0);
@@ -1080,6 +1808,8 @@ OGLFrameBuffer *OGLRenderBackend::createFrameBuffer(const String &name, ui32 wid
     if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
         glDeleteFramebuffers(1, &oglFB->m_bufferId);
         glDeleteTextures(1, &oglFB->m_renderedTexture);
+        m_stateCache.onFrameBufferDeleted(oglFB->m_bufferId);
+        m_stateCache.onTextureDeleted(oglFB->m_renderedTexture);
         delete oglFB;
         oglFB = nullptr;
     }
@@ -1093,11 +1823,15 @@ OGLFrameBuffer *OGLRenderBackend::createFrameBuffer(const String &name, ui32 wid
 
 void OGLRenderBackend::bindFrameBuffer(OGLFrameBuffer *oglFB) {
     if (nullptr == oglFB) {
-        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        if (m_stateCache.bindFrameBuffer(0)) {
+            glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        }
         return;
     }
 
-    glBindFramebuffer(GL_FRAMEBUFFER, oglFB->m_bufferId);
+    if (m_stateCache.bindFrameBuffer(oglFB->m_bufferId)) {
+        glBindFramebuffer(GL_FRAMEBUFFER, oglFB->m_bufferId);
+    }
     glViewport(0, 0, oglFB->m_width, oglFB->m_height);
 }
 
@@ -1124,6 +1858,8 @@ void OGLRenderBackend::releaseFrameBuffer(OGLFrameBuffer *oglFB) {
         if (m_framebuffers[i] == oglFB) {
             glDeleteFramebuffers(1, &oglFB->m_bufferId);
             glDeleteTextures(1, &oglFB->m_renderedTexture);
+            m_stateCache.onFrameBufferDeleted(oglFB->m_bufferId);
+            m_stateCache.onTextureDeleted(oglFB->m_renderedTexture);
             m_framebuffers.remove(i);
         }
     }
@@ -1136,28 +1872,137 @@ void OGLRenderBackend::releaseFrameBuffer(OGLFrameBuffer *oglFB) {
 
 void OGLRenderBackend::render(size_t primpGrpIdx) {
     OGLPrimGroup *grp(m_primitives[primpGrpIdx]);
-    if (nullptr != grp) {
+    if (nullptr == grp) {
+        return;
+    }
+
+    // Meshes sharing a vertex buffer are addressed by their base vertex
+    if (0 != grp->m_baseVertex) {
+        glDrawElementsBaseVertex(grp->m_primitive,
+                (GLsizei)grp->m_numIndices,
+                grp->m_indexType,
+                (const GLvoid *)(size_t)grp->m_startIndex,
+                grp->m_baseVertex);
+    } else {
         glDrawElements(grp->m_primitive,
                 (GLsizei)grp->m_numIndices,
                 grp->m_indexType,
-                (const GLvoid *)grp->m_startIndex);
+                (const GLvoid *)(size_t)grp->m_startIndex);
     }
 }
 
-#if _MSC_VER > 1920 && !defined(__clang__)
-#   pragma warning(pop)
-#endif
-
 void OGLRenderBackend::render(size_t primpGrpIdx, size_t numInstances) {
     OGLPrimGroup *grp(m_primitives[primpGrpIdx]);
-    if (nullptr != grp) {
-        glDrawArraysInstanced(grp->m_primitive,
-                grp->m_startIndex,
+    if (nullptr == grp) {
+        return;
+    }
+
+    if (0 != grp->m_baseVertex) {
+        glDrawElementsInstancedBaseVertex(grp->m_primitive,
                 (GLsizei)grp->m_numIndices,
+                grp->m_indexType,
+                (const GLvoid *)(size_t)grp->m_startIndex,
+                (GLsizei)numInstances,
+                grp->m_baseVertex);
+    } else {
+        glDrawElementsInstanced(grp->m_primitive,
+                (GLsizei)grp->m_numIndices,
+                grp->m_indexType,
+                (const GLvoid *)(size_t)grp->m_startIndex,
                 (GLsizei)numInstances);
     }
 }
 
+#if _MSC_VER > 1920 && !defined(__clang__)
+#   pragma warning(pop)
+#endif
+
+bool OGLRenderBackend::renderIndirect(const OGLIndirectDrawBuffer &draws) {
+    const size_t numDraws = draws.getNumDraws();
+    if (0 == numDraws) {
+        return true;
+    }
+
+    // The commands and the per-draw data are written to the stream buffer of the frame, without
+    // valid per-draw data the caller has to issue the draws of the items one by one
+    OGLStreamBuffer *streamBuffer = getStreamBuffer();
+    const bool drawData = nullptr != m_shaderInUse && m_shaderInUse->usesDrawData();
+    const glm::mat4 model = m_mvp.m_model;
+    if (drawData) {
+        if (nullptr == streamBuffer || m_oglCapabilities->mStorageBufferOffsetAlignment > (i32)OGLStreamBuffer::Alignment) {
+            return false;
+        }
+
+        const size_t size = sizeof(IndirectDrawData) * numDraws;
+        size_t offset(0);
+        void *dest = streamBuffer->map(size, offset);
+        if (nullptr == dest) {
+            return false;
+        }
+        ::memcpy(dest, draws.getDrawData(), size);
+        streamBuffer->unmap();
+        glBindBufferRange(GL_SHADER_STORAGE_BUFFER, OGLIndirectDrawBuffer::DrawDataBinding, streamBuffer->getId(), offset, size);
+
+        // The model matrices are read per draw, so MVP holds the view projection only
+        setDrawDataEnabled(true, glm::mat4(1.0f));
+    }
+
+    m_numIndirectDraws += static_cast<ui32>(numDraws);
+    if (isMultiDrawIndirectSupported() && nullptr != streamBuffer) {
+        const size_t size = sizeof(DrawElementsIndirectCommand) * numDraws;
+        size_t offset(0);
+        void *dest = streamBuffer->map(size, offset);
+        if (nullptr != dest) {
+            ::memcpy(dest, draws.getCommands(), size);
+            streamBuffer->unmap();
+            if (m_stateCache.bindBuffer(GL_DRAW_INDIRECT_BUFFER, streamBuffer->getId())) {
+                glBindBuffer(GL_DRAW_INDIRECT_BUFFER, streamBuffer->getId());
+            }
+            glMultiDrawElementsIndirect(draws.getPrimitive(), draws.getIndexType(), (const GLvoid *)offset,
+                    (GLsizei)numDraws, 0);
+            CHECKOGLERRORSTATE();
+            if (drawData) {
+                setDrawDataEnabled(false, model);
+            }
+            return true;
+        }
+    }
+
+    // One draw per command, the draw index is passed by the uniform
+    const GLint drawIndexLocation = nullptr != m_shaderInUse ? m_shaderInUse->getDrawIndexLocation() : -1;
+    const size_t indexSize = OGLIndirectDrawBuffer::getIndexSize(draws.getIndexType());
+    const DrawElementsIndirectCommand *cmds = draws.getCommands();
+    for (size_t i = 0; i < numDraws; ++i) {
+        const DrawElementsIndirectCommand &cmd = cmds[i];
+        if (0 == cmd.m_instanceCount) {
+            continue;
+        }
+        if (-1 != drawIndexLocation) {
+            glUniform1i(drawIndexLocation, (GLint)i);
+        }
+        glDrawElementsBaseVertex(draws.getPrimitive(), (GLsizei)cmd.m_count, draws.getIndexType(),
+                (const GLvoid *)(cmd.m_firstIndex * indexSize), cmd.m_baseVertex);
+    }
+    if (drawData) {
+        setDrawDataEnabled(false, model);
+    }
+
+    return true;
+}
+
+void OGLRenderBackend::setDrawDataEnabled(bool enabled, const glm::mat4 &model) {
+    const GLint location = m_shaderInUse->getDrawDataEnabledLocation();
+    if (-1 != location) {
+        glUniform1i(location, enabled ? 1 : 0);
+    }
+    setMatrix(MatrixType::Model, model);
+    applyMatrix();
+}
+
+bool OGLRenderBackend::isMultiDrawIndirectSupported() const {
+    return nullptr != m_oglCapabilities && m_oglCapabilities->mMultiDrawIndirect;
+}
+
 void OGLRenderBackend::render2DPanels(const Rect2ui &panel) {
     
 }
@@ -1165,11 +2010,26 @@ void OGLRenderBackend::render2DPanels(const Rect2ui &panel) {
 void OGLRenderBackend::renderFrame() {
     OSRE_ASSERT(nullptr != m_renderCtx);
 
+    if (nullptr != m_streamBuffer) {
+        m_streamBuffer->endFrame();
+        Profiling::PerformanceCounterRegistry::setCounter("stream_buffer_stalls", m_streamBuffer->getNumStalls());
+    }
+
+    // Uploads after the draws, the textures are used from the next frame on
+    m_textureUploader.update();
+    Profiling::PerformanceCounterRegistry::setCounter("textures_pending", static_cast<ui32>(m_textureUploader.getNumPending()));
+
     m_renderCtx->update();
     if (nullptr != m_fpsCounter) {
         const ui32 fps = m_fpsCounter->getFPS();
         Profiling::PerformanceCounterRegistry::setCounter("fps", fps);
     }
+
+    Profiling::PerformanceCounterRegistry::setCounter("gl_calls_issued", m_stateCache.getNumIssuedCalls());
+    Profiling::PerformanceCounterRegistry::setCounter("gl_calls_skipped", m_stateCache.getNumSkippedCalls());
+    Profiling::PerformanceCounterRegistry::setCounter("indirect_draws", m_numIndirectDraws);
+    m_stateCache.resetCounters();
+    m_numIndirectDraws = 0;
 }
 
 void OGLRenderBackend::setFixedPipelineStates(const RenderStates &states) {
@@ -1189,19 +2049,34 @@ void OGLRenderBackend::setFixedPipelineStates(const RenderStates &states) {
     m_fpState->m_stencilState = states.m_stencilState;
 
     if (m_fpState->m_cullState.m_cullMode == CullState::CullMode::Off) {
-        glDisable(GL_CULL_FACE);
+        if (m_stateCache.setCapability(GL_CULL_FACE, false)) {
+            glDisable(GL_CULL_FACE);
+        }
     } else {
-        glEnable(GL_CULL_FACE);
-        glCullFace(OGLEnum::getOGLCullFace(m_fpState->m_cullState.m_cullFace));
-        glPolygonMode(OGLEnum::getOGLCullFace(m_fpState->m_cullState.m_cullFace),
-                OGLEnum::getOGLPolygonMode(m_fpState->m_polygonState.m_polyMode));
-        glFrontFace(OGLEnum::getOGLCullState(m_fpState->m_cullState.m_cullMode));
+        const GLenum cullFace = OGLEnum::getOGLCullFace(m_fpState->m_cullState.m_cullFace);
+        const GLenum polyMode = OGLEnum::getOGLPolygonMode(m_fpState->m_polygonState.m_polyMode);
+        const GLenum frontFace = OGLEnum::getOGLCullState(m_fpState->m_cullState.m_cullMode);
+        if (m_stateCache.setCapability(GL_CULL_FACE, true)) {
+            glEnable(GL_CULL_FACE);
+        }
+        if (m_stateCache.setCullFace(cullFace)) {
+            glCullFace(cullFace);
+        }
+        if (m_stateCache.setPolygonMode(cullFace, polyMode)) {
+            glPolygonMode(cullFace, polyMode);
+        }
+        if (m_stateCache.setFrontFace(frontFace)) {
+            glFrontFace(frontFace);
+        }
     }
 
-    if (m_fpState->m_blendState.m_blendFunc == BlendState::BlendFunc::Off) {
-        glDisable(GL_BLEND);
-    } else {
-        glEnable(GL_BLEND);
+    const bool blend = m_fpState->m_blendState.m_blendFunc != BlendState::BlendFunc::Off;
+    if (m_stateCache.setCapability(GL_BLEND, blend)) {
+        if (blend) {
+            glEnable(GL_BLEND);
+        } else {
+            glDisable(GL_BLEND);
+        }
     }
     m_fpState->m_applied = true;
 }
@@ -28,6 +28,12 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <osre/RenderBackend/RenderCommon.h>
 
 #include "OGLCommon.h"
+#include "OGLIndirectDrawBuffer.h"
+#include "OGLProgramCache.h"
+#include "OGLStateCache.h"
+#include "OGLStreamBuffer.h"
+#include "OGLTextureUploader.h"
+#include "OGLUniformBlock.h"
 #include <map>
 
 namespace OSRE {
@@ -103,6 +109,14 @@ public:
 	void bindBuffer(OGLBuffer *pBuffer);
 	void unbindBuffer(OGLBuffer *pBuffer);
 	void copyDataToBuffer(OGLBuffer *pBuffer, void *pData, size_t size, BufferAccessType usage);
+	/// Writes data into a range of the buffer, the element array binding of the bound vertex
+	/// array is not touched.
+	void copySubDataToBuffer(OGLBuffer *buffer, size_t offset, const void *data, size_t size);
+	/// Updates the content of a buffer. Data fitting into the buffer is written to the stream
+	/// buffer and copied on the GPU, the storage is only re-specified when it must grow.
+	void updateBuffer(OGLBuffer *buffer, const void *data, size_t size, BufferAccessType usage, size_t offset = 0);
+	/// Returns the streaming buffer for per-frame data, will be created on the first call.
+	OGLStreamBuffer *getStreamBuffer();
 	void releaseBuffer(OGLBuffer *pBuffer);
 	void releaseAllBuffers();
 	bool createVertexCompArray(const VertexLayout *layout, OGLShader *pShader, VertAttribArray &attributes);
@@ -113,33 +127,78 @@ public:
 			OGLVertexAttribute *attrib);
 	bool bindVertexLayout(OGLVertexArray *pVertexArray, OGLShader *pShader, size_t stride,
 			const CPPCore::TArray<OGLVertexAttribute *> &attributes);
+	bool bindInstanceLayout(OGLVertexArray *pVertexArray, OGLShader *pShader);
 	void destroyVertexArray(OGLVertexArray *pVertexArray);
 	OGLVertexArray *getVertexArraybyId(ui32 id) const;
 	void bindVertexArray(OGLVertexArray *pVertexArray);
 	void unbindVertexArray();
 	void releaseAllVertexArrays();
+	/// Enables the on-disk cache for linked programs, an empty directory disables it.
+	bool enableProgramCache(const String &cacheDir);
 	OGLShader *createShader(const String &name, Shader *pShader);
+	/// Programs will be linked without waiting for the driver, see updatePendingShaders.
+	void setAsyncShaderCompile(bool enabled);
+	/// Finishes the programs linked by the driver in the meantime. Without
+	/// GL_KHR_parallel_shader_compile the programs are finished within a time budget per frame.
+	void updatePendingShaders();
+	/// Returns the number of programs, which are still linking.
+	size_t getNumPendingShaders() const;
 	OGLShader *getShader(const String &name);
 	bool useShader(OGLShader *pShader);
 	OGLShader *getActiveShader() const;
 	bool releaseShader(OGLShader *pShader);
 	void releaseAllShaders();
+	/// Image files will be decoded by the scheduler and uploaded with at most budget bytes per frame.
+	bool enableTextureStreaming(Threading::JobScheduler *scheduler, size_t budget);
+	/// Returns the number of textures, which are still streamed in.
+	size_t getNumPendingTextures() const;
+	/// Returns the texture, which is bound in place of textures not resident yet.
+	OGLTexture *getDefaultTexture();
 	OGLTexture *createEmptyTexture(const String &name, TextureTargetType target, TextureFormatType format, ui32 width, ui32 height, ui32 channels);
 	void updateTexture(OGLTexture *pOGLTextue, ui32 offsetX, ui32 offsetY, c8 *data, size_t size);
 	OGLTexture *createTexture(const String &name, Texture *tex);
+	/// DDS and KTX2 files are uploaded with their prebuilt mip chain, other images are decoded.
 	OGLTexture *createTextureFromFile(const String &name, const IO::Uri &fileloc);
+	/// Uploads the block compressed levels of a DDS or KTX2 file content.
+	OGLTexture *createTextureFromContainer(const String &name, const uc8 *data, size_t size);
+	/// Creates a RGBA texture array with numMipLevels mip levels or the whole chain for 0, the
+	/// layers are stored one after the other.
+	OGLTexture *createTextureArray(const String &name, ui32 width, ui32 height, ui32 layers, ui32 numMipLevels, const uc8 *data);
+	/// Returns true, if the GPU can sample the format.
+	bool isTextureFormatSupported(TextureFormatType format) const;
 	OGLTexture *createTextureFromStream(const String &name, IO::Stream &stream, ui32 width, ui32 height, ui32 channels);
 	OGLTexture *findTexture(const String &name) const;
 	bool bindTexture(OGLTexture *pOGLTextue, TextureStageType stageType);
     bool unbindTexture( TextureStageType stageType);
 	void releaseTexture(OGLTexture *pTexture);
 	void releaseAllTextures();
+	/// Interns a parameter by its hashed name, returns nullptr if the hash is taken by another name.
 	OGLParameter *createParameter(const String &name, ParameterType type, UniformDataBlob *blob, size_t numItems);
 	OGLParameter *getParameter(const String &name) const;
+	OGLParameter *getParameter(HashId hash) const;
 	void setParameter(OGLParameter *param);
 	void setParameter(OGLParameter **param, size_t numParam);
 	void releaseAllParameters();
-	size_t addPrimitiveGroup(PrimitiveGroup *grp);
+	/// Returns the binding point for a GLSL uniform block name, a new one will be assigned and
+	/// linked into all shaders declaring the block.
+	ui32 getUniformBindingPoint(const String &blockName);
+	/// Creates a uniform buffer object with the given std140 layout.
+	OGLUniformBlock *createUniformBlock(const String &name, const String &blockName, const UniformBlockLayout &layout);
+	OGLUniformBlock *getUniformBlock(const String &name) const;
+	OGLUniformBlock *getUniformBlock(HashId hash) const;
+	/// Writes a member into the staging memory, returns true if the value changed.
+	bool setUniformBlockVar(OGLUniformBlock *block, const String &name, const void *data, size_t size);
+	bool setUniformBlockVar(OGLUniformBlock *block, HashId hash, const void *data, size_t size);
+	/// Uploads the staging memory of all changed blocks.
+	void commitUniformBlocks();
+	/// Binds the block to its binding point.
+	void bindUniformBlock(OGLUniformBlock *block);
+	void releaseUniformBlock(OGLUniformBlock *block);
+	void releaseAllUniformBlocks();
+	/// Registers a primitive group, meshes stored in a shared buffer pass their base vertex and
+	/// the byte offset of their indices.
+	size_t addPrimitiveGroup(PrimitiveGroup *grp, ui32 baseVertex = 0, size_t indexOffset = 0);
+	OGLPrimGroup *getPrimitiveGroup(size_t primGrpIdx) const;
 	void releaseAllPrimitiveGroups();
 	OGLFrameBuffer *createFrameBuffer(const String &name, ui32 width, ui32 height, bool depthBuffer);
 	void bindFrameBuffer(OGLFrameBuffer *oglFB);
@@ -147,25 +206,41 @@ public:
 	void releaseFrameBuffer(OGLFrameBuffer *oglFB);
 	void render(size_t grimpGrpIdx);
 	void render(size_t primpGrpIdx, size_t numInstances);
+	/// Submits the draws with one glMultiDrawElementsIndirect call, the vertex array must be
+	/// bound. Without ARB_multi_draw_indirect the draws are issued one by one. Returns false
+	/// without drawing, if the per-draw data used by the shader cannot be written.
+	bool renderIndirect(const OGLIndirectDrawBuffer &draws);
+	/// Returns true, if glMultiDrawElementsIndirect is supported.
+	bool isMultiDrawIndirectSupported() const;
     void render2DPanels(const Rect2ui &panel);
 	void renderFrame();
 	void setFixedPipelineStates(const RenderStates &states);
     void setExtensions(const String &extensions);
     const String &getExtensions() const;
-    
+    /// Returns the shadow of the GL state, which skips redundant state changes.
+    const OGLStateCache &getStateCache() const;
+
+protected:
+    void linkUniformBlocks(OGLShader *shader);
+    void uploadUniformBlock(OGLUniformBlock *block);
+    void updateCameraBlock();
+    void setDrawDataEnabled(bool enabled, const glm::mat4 &model);
+    void finishShader(OGLShader *shader, ui64 key, bool cached);
+
 private:
 	Platform::AbstractOGLRenderContext *m_renderCtx;
 	CPPCore::TArray<OGLBuffer*> m_buffers;
 	GLuint m_activeVB;
 	GLuint m_activeIB;
 	CPPCore::TArray<OGLVertexArray*> m_vertexarrays;
-	GLuint m_activeVertexArray;
 	CPPCore::TArray<OGLShader *> m_shaders;
 	CPPCore::TArray<OGLTexture *> m_textures;
     CPPCore::TArray<OGLTexture *> mBindedTextures;
 	CPPCore::TArray<size_t> m_freeTexSlots;
 	std::map<String, size_t> m_texLookupMap;
 	CPPCore::TArray<OGLParameter *> m_parameters;
+	std::map<HashId, OGLParameter *> m_parameterLookup;
+	OGLParameter *m_mvpParam;
 	OGLShader *m_shaderInUse;
 	CPPCore::TArray<size_t> m_freeBufferSlots;
 	CPPCore::TArray<OGLPrimGroup*> m_primitives;
@@ -176,7 +251,30 @@ private:
     String m_extensions;
     i32 m_OpenGLVersion[ 2 ];
     Viewport mViewport;
+    OGLStateCache m_stateCache;
+    std::map<String, ui32> m_bindingPoints;
+    std::map<HashId, OGLUniformBlock *> m_uniformBlocks;
+    OGLUniformBlock *m_cameraBlock;
+    OGLStreamBuffer *m_streamBuffer;
+    ui32 m_numIndirectDraws;
+    String m_driverId;
+    OGLProgramCache m_programCache;
+    ui32 m_numPrograms;
+    d32 m_shaderSetupTime;
+    bool m_asyncShaderCompile;
+
+    struct PendingProgram {
+        OGLShader *m_shader;
+        ui64 m_key;
+    };
+    CPPCore::TArray<PendingProgram> m_pendingPrograms;
+    OGLTextureUploader m_textureUploader;
+    OGLTexture *m_defaultTexture;
 };
 
+inline const OGLStateCache &OGLRenderBackend::getStateCache() const {
+    return m_stateCache;
+}
+
 } // Namespace RenderBackend
 } // Namespace OSRE
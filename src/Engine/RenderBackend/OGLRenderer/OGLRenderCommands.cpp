@@ -100,7 +100,12 @@ SetMaterialStageCmdData *setupMaterial(Material *material, OGLRenderBackend *rb,
                 matData->m_textures = textures;
             }
 
-            OGLShader *shader = rb->createShader("mat", material->m_shader);
+            // Materials of the same shader variant share the program
+            String shaderName = material->m_name.empty() ? "mat" : material->m_name;
+            if (nullptr != material->m_shader && !material->m_shader->m_name.empty()) {
+                shaderName = material->m_shader->m_name;
+            }
+            OGLShader *shader = rb->createShader(shaderName, material->m_shader);
             if (nullptr != shader) {
                 matData->m_shader = shader;
                 for (ui32 i = 0; i < material->m_shader->m_attributes.size(); i++) {
@@ -135,9 +140,12 @@ void setupParameter(UniformVar *param, OGLRenderBackend *rb, OGLRenderEventHandl
     }
 
     ::CPPCore::TArray<OGLParameter *> paramArray;
-    OGLParameter *oglParam = rb->getParameter(param->m_name);
+    OGLParameter *oglParam = rb->getParameter(param->m_hash);
     if (nullptr == oglParam) {
         oglParam = rb->createParameter(param->m_name, param->m_type, &param->m_data, param->m_numItems);
+        if (nullptr == oglParam) {
+            return;
+        }
     } else {
         ::memcpy(oglParam->m_data->getData(), param->m_data.getData(), param->m_data.m_size);
     }
@@ -146,7 +154,40 @@ void setupParameter(UniformVar *param, OGLRenderBackend *rb, OGLRenderEventHandl
     ev->setParameter(paramArray);
 }
 
-OGLVertexArray *setupBuffers(Mesh *mesh, OGLRenderBackend *rb, OGLShader *oglShader) {
+void setupUniformBlock(RenderBatchData *batch, OGLRenderBackend *rb, OGLRenderEventHandler *ev) {
+    OSRE_ASSERT(nullptr != batch);
+    OSRE_ASSERT(nullptr != rb);
+    OSRE_ASSERT(nullptr != ev);
+
+    if (nullptr == batch || nullptr == rb || nullptr == ev) {
+        return;
+    }
+
+    if (batch->m_uniforms.isEmpty()) {
+        return;
+    }
+
+    // The uniforms of the batch are also provided as std140 block for shaders declaring it
+    OGLUniformBlock *block = rb->getUniformBlock(batch->m_id);
+    if (nullptr == block) {
+        UniformBlockLayout layout;
+        layout.build(batch->m_uniforms);
+        block = rb->createUniformBlock(batch->m_id, BatchBlockName, layout);
+        if (nullptr == block) {
+            return;
+        }
+    }
+
+    for (ui32 i = 0; i < batch->m_uniforms.size(); ++i) {
+        UniformVar *var = batch->m_uniforms[i];
+        if (nullptr != var) {
+            rb->setUniformBlockVar(block, var->m_name, var->m_data.getData(), var->m_data.m_size);
+        }
+    }
+    ev->getRenderCmdBuffer()->setUniformBlock(batch->m_id, block);
+}
+
+OGLVertexArray *setupBuffers(Mesh *mesh, OGLRenderBackend *rb, OGLShader *oglShader, GeoInstanceData *instanceData) {
     OSRE_ASSERT(nullptr != mesh);
     OSRE_ASSERT(nullptr != rb);
     OSRE_ASSERT(nullptr != oglShader);
@@ -184,6 +225,16 @@ OGLVertexArray *setupBuffers(Mesh *mesh, OGLRenderBackend *rb, OGLShader *oglSha
     rb->bindVertexLayout(vertexArray, oglShader, stride, attributes);
     rb->releaseVertexCompArray(attributes);
 
+    // the per-instance data is stored in its own buffer, advanced once per instance
+    if (nullptr != instanceData && nullptr != instanceData->m_data) {
+        BufferData *instances = instanceData->m_data;
+        OGLBuffer *instanceBuffer = rb->createBuffer(instances->m_type);
+        instanceBuffer->m_geoId = mesh->m_id;
+        rb->bindBuffer(instanceBuffer);
+        rb->copyDataToBuffer(instanceBuffer, instances->getData(), instances->getSize(), instances->m_access);
+        rb->bindInstanceLayout(vertexArray, oglShader);
+    }
+
     // create index buffer and pass indices to element array buffer
     OGLBuffer *ib = rb->createBuffer(indices->m_type);
     ib->m_geoId = mesh->m_id;
@@ -195,6 +246,88 @@ OGLVertexArray *setupBuffers(Mesh *mesh, OGLRenderBackend *rb, OGLShader *oglSha
     return vertexArray;
 }
 
+static const size_t StaticVertexPoolSize = 8 * 1024 * 1024;
+static const size_t StaticIndexPoolSize = 4 * 1024 * 1024;
+
+static size_t getIndexSize(IndexType type) {
+    switch (type) {
+        case IndexType::UnsignedByte:
+            return sizeof(uc8);
+        case IndexType::UnsignedShort:
+            return sizeof(ui16);
+        default:
+            break;
+    }
+
+    return sizeof(ui32);
+}
+
+OGLVertexArray *setupStaticBuffers(Mesh *mesh, OGLRenderBackend *rb, OGLShader *oglShader,
+        OGLBufferManager *bufferManager, ui32 &baseVertex, size_t &indexOffset) {
+    OSRE_ASSERT(nullptr != mesh);
+    OSRE_ASSERT(nullptr != rb);
+    OSRE_ASSERT(nullptr != oglShader);
+    OSRE_ASSERT(nullptr != bufferManager);
+
+    if (nullptr == mesh || nullptr == rb || nullptr == oglShader || nullptr == bufferManager) {
+        return nullptr;
+    }
+
+    BufferData *vertices = mesh->m_vb;
+    BufferData *indices = mesh->m_ib;
+    if (nullptr == vertices || nullptr == indices) {
+        osre_debug(Tag, "No buffer data for setting up static data.");
+        return nullptr;
+    }
+
+    // Meshes larger than a pool keep their own buffers
+    const size_t stride = Mesh::getVertexSize(mesh->m_vertextype);
+    const size_t indexSize = getIndexSize(mesh->m_indextype);
+    if (0 == stride || vertices->getSize() > StaticVertexPoolSize || indices->getSize() > StaticIndexPoolSize) {
+        return nullptr;
+    }
+
+    // The attribute locations are taken from the shader, so it is part of the key as well
+    ui64 key(0);
+    getBufferKey(mesh->m_vertextype, mesh->m_indextype, oglShader->getProgramId(), key);
+
+    OGLBufferManager::Range range;
+    if (!bufferManager->allocRange(mesh->m_id, key, vertices->getSize(), stride, indices->getSize(), indexSize, range)) {
+        rb->useShader(oglShader);
+        OGLVertexArray *vertexArray = rb->createVertexArray();
+        rb->bindVertexArray(vertexArray);
+
+        OGLBuffer *vb = rb->createBuffer(BufferType::VertexBuffer);
+        vb->m_geoId = OGLNotSetId;
+        rb->bindBuffer(vb);
+        rb->copyDataToBuffer(vb, nullptr, StaticVertexPoolSize, BufferAccessType::ReadOnly);
+
+        TArray<OGLVertexAttribute *> attributes;
+        rb->createVertexCompArray(mesh->m_vertextype, oglShader, attributes);
+        rb->bindVertexLayout(vertexArray, oglShader, stride, attributes);
+        rb->releaseVertexCompArray(attributes);
+
+        OGLBuffer *ib = rb->createBuffer(BufferType::IndexBuffer);
+        ib->m_geoId = OGLNotSetId;
+        rb->bindBuffer(ib);
+        rb->copyDataToBuffer(ib, nullptr, StaticIndexPoolSize, BufferAccessType::ReadOnly);
+        rb->unbindVertexArray();
+
+        bufferManager->addPool(key, vb, StaticVertexPoolSize, ib, StaticIndexPoolSize, vertexArray);
+        if (!bufferManager->allocRange(mesh->m_id, key, vertices->getSize(), stride, indices->getSize(), indexSize, range)) {
+            return nullptr;
+        }
+    }
+
+    OGLBufferManager::Pool *pool = range.m_pool;
+    rb->copySubDataToBuffer(pool->m_vertexBuffer, range.m_vertexOffset, vertices->getData(), vertices->getSize());
+    rb->copySubDataToBuffer(pool->m_indexBuffer, range.m_indexOffset, indices->getData(), indices->getSize());
+    baseVertex = static_cast<ui32>(range.m_vertexOffset / stride);
+    indexOffset = range.m_indexOffset;
+
+    return pool->m_vertexArray;
+}
+
 void setupPrimDrawCmd(const char *id, bool useLocalMatrix, const glm::mat4 &model,
         const TArray<size_t> &primGroups, OGLRenderBackend *rb,
         OGLRenderEventHandler *eh, OGLVertexArray *va) {
@@ -38,7 +38,11 @@ class RenderCmdBuffer;
 class OGLRenderEventHandler;
 class Mesh;
 
+template <class TBuffer, class TVertexArray>
+class HWBufferManager;
+
 struct Vertex;
+struct OGLBuffer;
 struct OGLVertexArray;
 struct OGLTexture;
 struct PrimitiveGroup;
@@ -51,11 +55,19 @@ struct SetRenderTargetCmdData;
 struct OGLParameter;
 struct UniformVar;
 struct SetMaterialStageCmdData;
+struct RenderBatchData;
+struct GeoInstanceData;
+
+using OGLBufferManager = HWBufferManager<OGLBuffer, OGLVertexArray>;
 
 bool setupTextures(Material* mat, OGLRenderBackend* rb, CPPCore::TArray<OGLTexture*>& textures);
 SetMaterialStageCmdData* setupMaterial(Material* material, OGLRenderBackend* rb, OGLRenderEventHandler* eh);
 void setupParameter(UniformVar* param, OGLRenderBackend* rb, OGLRenderEventHandler* ev);
-OGLVertexArray* setupBuffers(Mesh* mesh, OGLRenderBackend* rb, OGLShader* oglShader);
+void setupUniformBlock(RenderBatchData* batch, OGLRenderBackend* rb, OGLRenderEventHandler* ev);
+OGLVertexArray* setupBuffers(Mesh* mesh, OGLRenderBackend* rb, OGLShader* oglShader,
+    GeoInstanceData* instanceData = nullptr);
+OGLVertexArray* setupStaticBuffers(Mesh* mesh, OGLRenderBackend* rb, OGLShader* oglShader,
+    OGLBufferManager* bufferManager, ui32& baseVertex, size_t& indexOffset);
 void setupPrimDrawCmd(const char* id, bool useLocalMatrix, const glm::mat4& model,
     const CPPCore::TArray<size_t>& primGroups, OGLRenderBackend* rb,
     OGLRenderEventHandler* eh, OGLVertexArray* va);
@@ -29,6 +29,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #include <osre/App/AssetRegistry.h>
 #include <osre/Common/Logger.h>
+#include <osre/Common/StringUtils.h>
 #include <osre/Debugging/osre_debugging.h>
 #include <osre/IO/Uri.h>
 #include <osre/Platform/AbstractOGLRenderContext.h>
@@ -58,7 +59,8 @@ OGLRenderEventHandler::OGLRenderEventHandler() :
         m_renderCmdBuffer(nullptr),
         m_renderCtx(nullptr),
         m_vertexArray(nullptr),
-        mHwBufferManager(nullptr) {
+        mHwBufferManager(nullptr),
+        m_staticBatching(false) {
     // empty
 }
 
@@ -67,9 +69,20 @@ OGLRenderEventHandler::~OGLRenderEventHandler() {
     mHwBufferManager = nullptr;
 }
 
+static void retireFrame(const EventData *data) {
+    const RenderFrameEventData *frameData = (const RenderFrameEventData *)data;
+    if (nullptr != frameData && nullptr != frameData->m_frame) {
+        frameData->m_frame->m_fence.retire();
+    }
+}
+
 bool OGLRenderEventHandler::onEvent(const Event &ev, const EventData *data) {
     bool result(false);
     if (!m_isRunning) {
+        // The submitter may wait for the frame, so retire it anyway
+        if (OnRenderFrameEvent == ev) {
+            retireFrame(data);
+        }
         return true;
     }
 
@@ -87,6 +100,7 @@ bool OGLRenderEventHandler::onEvent(const Event &ev, const EventData *data) {
         result = onDetachView(data);
     } else if (OnRenderFrameEvent == ev) {
         result = onRenderFrame(data);
+        retireFrame(data);
     } else if (OnInitPassesEvent == ev) {
         result = onInitRenderPasses(data);
     } else if (OnCommitFrameEvent == ev) {
@@ -121,7 +135,7 @@ bool OGLRenderEventHandler::onAttached(const EventData *) {
 
     m_oglBackend = new OGLRenderBackend;
     m_oglBackend->setTimer(PlatformInterface::getInstance()->getTimer());
-    mHwBufferManager = new HWBufferManager<OGLBuffer>;
+    mHwBufferManager = new HWBufferManager<OGLBuffer, OGLVertexArray>;
 
     return true;
 }
@@ -175,6 +189,14 @@ bool OGLRenderEventHandler::onCreateRenderer(const EventData *eventData) {
         return false;
     }
 
+    if (!createRendererEvData->m_shaderCacheDir.empty()) {
+        m_oglBackend->enableProgramCache(createRendererEvData->m_shaderCacheDir);
+    }
+    m_oglBackend->setAsyncShaderCompile(createRendererEvData->m_asyncShaderCompile);
+    if (0 != createRendererEvData->m_textureUploadBudget) {
+        m_oglBackend->enableTextureStreaming(createRendererEvData->m_jobScheduler, createRendererEvData->m_textureUploadBudget);
+    }
+
     Rect2ui rect;
     activeSurface->getWindowsRect(rect);
     m_oglBackend->setViewport(rect.m_x1, rect.m_y1, rect.m_width, rect.m_height);
@@ -186,6 +208,8 @@ bool OGLRenderEventHandler::onCreateRenderer(const EventData *eventData) {
     fontUri.setPath(path);
     //m_oglBackend->createFont( fontUri );
     m_renderCmdBuffer = new RenderCmdBuffer(m_oglBackend, m_renderCtx, createRendererEvData->m_pipeline);
+    m_staticBatching = createRendererEvData->m_staticBatching;
+    m_renderCmdBuffer->setIndirectDraws(m_staticBatching);
 
     bool ok(Profiling::PerformanceCounterRegistry::create());
     if (!ok) {
@@ -194,6 +218,14 @@ bool OGLRenderEventHandler::onCreateRenderer(const EventData *eventData) {
     }
 
     Profiling::PerformanceCounterRegistry::registerCounter("fps");
+    Profiling::PerformanceCounterRegistry::registerCounter("state_changes_saved");
+    Profiling::PerformanceCounterRegistry::registerCounter("gl_calls_issued");
+    Profiling::PerformanceCounterRegistry::registerCounter("gl_calls_skipped");
+    Profiling::PerformanceCounterRegistry::registerCounter("stream_buffer_stalls");
+    Profiling::PerformanceCounterRegistry::registerCounter("indirect_draws");
+    Profiling::PerformanceCounterRegistry::registerCounter("shader_programs_cached");
+    Profiling::PerformanceCounterRegistry::registerCounter("shader_setup_ms");
+    Profiling::PerformanceCounterRegistry::registerCounter("textures_pending");
 
     return true;
 }
@@ -235,6 +267,12 @@ bool OGLRenderEventHandler::onDetachView(const EventData *) {
 bool OGLRenderEventHandler::onClearGeo(const EventData *) {
     OSRE_ASSERT(nullptr != m_oglBackend);
 
+    // The pool buffers are released with all other buffers
+    for (size_t i = 0; i < mHwBufferManager->getNumPools(); ++i) {
+        m_oglBackend->destroyVertexArray(mHwBufferManager->getPoolAt(i)->m_vertexArray);
+    }
+    mHwBufferManager->clearPools();
+    m_oglBackend->releaseAllUniformBlocks();
     m_oglBackend->releaseAllBuffers();
     m_oglBackend->releaseAllShaders();
     m_oglBackend->releaseAllTextures();
@@ -280,6 +318,7 @@ bool OGLRenderEventHandler::onInitRenderPasses(const Common::EventData *eventDat
         if (!currentPass->m_isDirty) {
             continue;
         }
+        m_renderCmdBuffer->setActivePass(passIdx);
 
         // ToDo: create pipeline pass for the name.
         for (ui32 batchIdx = 0; batchIdx < currentPass->m_geoBatches.size(); ++batchIdx) {
@@ -294,6 +333,7 @@ bool OGLRenderEventHandler::onInitRenderPasses(const Common::EventData *eventDat
             for (ui32 uniformIdx = 0; uniformIdx < currentBatchData->m_uniforms.size(); ++uniformIdx) {
                 setupParameter(currentBatchData->m_uniforms[uniformIdx], m_oglBackend, this);
             }
+            setupUniformBlock(currentBatchData, m_oglBackend, this);
 
             // set meshes
             for (ui32 meshEntryIdx = 0; meshEntryIdx < currentBatchData->m_meshArray.size(); ++meshEntryIdx) {
@@ -311,23 +351,34 @@ bool OGLRenderEventHandler::onInitRenderPasses(const Common::EventData *eventDat
                     Mesh *currentMesh = currentMeshEntry->m_geo[meshIdx];
                     OSRE_ASSERT(nullptr != currentMesh);
 
-                    // register primitive groups to render
-                    for (size_t i = 0; i < currentMesh->m_numPrimGroups; ++i) {
-                        const size_t primIdx(m_oglBackend->addPrimitiveGroup(&currentMesh->m_primGroups[i]));
-                        primGroups.add(primIdx);
-                    }
-
                     // create the default material
                     SetMaterialStageCmdData *data = setupMaterial(currentMesh->m_material, m_oglBackend, this);
 
-                    // setup vertex array, vertex and index buffers
-                    m_vertexArray = setupBuffers(currentMesh, m_oglBackend, m_renderCmdBuffer->getActiveShader());
+                    // setup vertex array, vertex and index buffers, static meshes can share them
+                    ui32 baseVertex(0);
+                    size_t indexOffset(0);
+                    m_vertexArray = nullptr;
+                    if (m_staticBatching && 0 == currentMeshEntry->numInstances && nullptr != currentMesh->m_vb &&
+                            BufferAccessType::ReadOnly == currentMesh->m_vb->m_access) {
+                        m_vertexArray = setupStaticBuffers(currentMesh, m_oglBackend, m_renderCmdBuffer->getActiveShader(),
+                                mHwBufferManager, baseVertex, indexOffset);
+                    }
+                    if (nullptr == m_vertexArray) {
+                        m_vertexArray = setupBuffers(currentMesh, m_oglBackend, m_renderCmdBuffer->getActiveShader(),
+                                currentMeshEntry->m_instanceData);
+                    }
                     if (nullptr == m_vertexArray) {
                         osre_debug(Tag, "Vertex-Array-pointer is a nullptr.");
                         return false;
                     }
                     data->m_vertexArray = m_vertexArray;
 
+                    // register primitive groups to render
+                    for (size_t i = 0; i < currentMesh->m_numPrimGroups; ++i) {
+                        const size_t primIdx(m_oglBackend->addPrimitiveGroup(&currentMesh->m_primGroups[i], baseVertex, indexOffset));
+                        primGroups.add(primIdx);
+                    }
+
                     // setup the draw calls
                     if (0 == currentMeshEntry->numInstances) {
                         setupPrimDrawCmd(currentBatchData->m_id, currentMesh->m_localMatrix, currentMesh->m_model,
@@ -357,32 +408,53 @@ bool OGLRenderEventHandler::onCommitNexFrame(const Common::EventData *eventData)
         return false;
     }
 
+    UniformBuffer &uniformBuffer = data->m_frame->m_uniformBuffer;
+    uniformBuffer.reset();
     for (ui32 i = 0; i < data->m_frame->m_submitCmds.size(); ++i) {
         FrameSubmitCmd *cmd = data->m_frame->m_submitCmds[i];
         if (nullptr == cmd) {
             continue;
         }
         if (cmd->m_updateFlags & (ui32)FrameSubmitCmd::UpdateMatrixes) {
-            MatrixBuffer *buffer = (MatrixBuffer *)cmd->m_data;
+            // The payload is released with the frame, so the matrices will be copied
+            const MatrixBuffer *buffer = (const MatrixBuffer *)cmd->m_data;
             m_renderCmdBuffer->setMatrixBuffer(cmd->m_batchId, buffer);
         } else if (cmd->m_updateFlags & (ui32)FrameSubmitCmd::UpdateUniforms) {
-            c8 name[255];
-            ::memset(name, '\0', 255);
-            ::strncpy(name, &cmd->m_data[1], cmd->m_data[0]);
-            ui32 offset = cmd->m_data[0] + 1;
-            size_t size = cmd->m_size - offset;
-            OGLParameter *oglParam = m_oglBackend->getParameter(name);
-            ::memcpy(oglParam->m_data->getData(), &cmd->m_data[offset], size);
+            // The command holds the number of variables written to the uniform buffer
+            OGLUniformBlock *block = m_oglBackend->getUniformBlock(StringUtils::hashName(cmd->m_batchId));
+            for (size_t j = 0; j < cmd->m_size; ++j) {
+                HashId hash(0);
+                size_t size(0);
+                const c8 *varData = uniformBuffer.readVar(hash, size);
+                if (nullptr == varData) {
+                    break;
+                }
+
+                // The variables are addressed by their interned names only
+                OGLParameter *oglParam = m_oglBackend->getParameter(hash);
+                if (nullptr != oglParam && size <= oglParam->m_data->m_size) {
+                    ::memcpy(oglParam->m_data->getData(), varData, size);
+                }
+                m_oglBackend->setUniformBlockVar(block, hash, varData, size);
+            }
         } else if (cmd->m_updateFlags & (ui32)FrameSubmitCmd::UpdateBuffer) {
-            OGLBuffer *buffer = m_oglBackend->getBufferById(cmd->m_meshId);
-            m_oglBackend->bindBuffer(buffer);
-            m_oglBackend->copyDataToBuffer(buffer, cmd->m_data, cmd->m_size, BufferAccessType::ReadWrite);
-            m_oglBackend->unbindBuffer(buffer);
+            // Meshes in a shared buffer can only be updated inside of their range
+            const OGLBufferManager::Range *range = mHwBufferManager->getRange(cmd->m_meshId);
+            if (nullptr != range) {
+                if (cmd->m_size <= range->m_vertexSize) {
+                    m_oglBackend->updateBuffer(range->m_pool->m_vertexBuffer, cmd->m_data, cmd->m_size,
+                            BufferAccessType::ReadWrite, range->m_vertexOffset);
+                } else {
+                    osre_error(Tag, "Update exceeds the range of the static mesh.");
+                }
+            } else {
+                OGLBuffer *buffer = m_oglBackend->getBufferById(cmd->m_meshId);
+                m_oglBackend->updateBuffer(buffer, cmd->m_data, cmd->m_size, BufferAccessType::ReadWrite);
+            }
         }
         cmd->m_updateFlags = 0;
     }
-    data->m_frame->m_submitCmds.resize(0);
-    data->m_frame->m_submitCmdAllocator.release();
+    data->m_frame->releaseSubmitCmds();
 
     return true;
 }
@@ -396,12 +468,10 @@ bool OGLRenderEventHandler::onShutdownRequest(const Common::EventData *eventData
 bool OGLRenderEventHandler::onResizeRenderTarget(const Common::EventData *eventData) {
     OSRE_ASSERT(nullptr != eventData);
 
-    ResizeEventData *data = (ResizeEventData *)eventData;
+    const ResizeEventData *data = (const ResizeEventData *)eventData;
     if (nullptr != data) {
-        const ui32 x = data->m_x;
-        const ui32 y = data->m_y;
-        const ui32 w = data->m_w;
-        const ui32 h = data->m_h;
+        ui32 x(0), y(0), w(0), h(0);
+        data->get(x, y, w, h);
         m_oglBackend->setViewport(x, y, w, h);
     }
 
@@ -114,7 +114,8 @@ private:
     RenderCmdBuffer *m_renderCmdBuffer;
     Platform::AbstractOGLRenderContext *m_renderCtx;
     OGLVertexArray *m_vertexArray;
-    HWBufferManager<OGLBuffer> *mHwBufferManager;
+    HWBufferManager<OGLBuffer, OGLVertexArray> *mHwBufferManager;
+    bool m_staticBatching;
 };
 
 } // Namespace RenderBackend
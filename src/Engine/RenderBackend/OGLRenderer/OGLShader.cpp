@@ -23,6 +23,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "OGLShader.h"
 #include "OGLEnum.h"
 #include <osre/Common/Logger.h>
+#include <osre/Common/StringUtils.h>
 #include <osre/Debugging/osre_debugging.h>
 #include <osre/IO/Stream.h>
 
@@ -30,8 +31,40 @@ namespace OSRE {
 namespace RenderBackend {
 
 static const GLint ErrorId = -1;
+static const GLint UnresolvedId = -2;
 static const String Tag = "OGLShader";
 
+/// The locations of the engine vertex attributes, they are bound before the link.
+struct AttributeBinding {
+    VertexAttribute m_attrib;
+    GLuint m_location;
+};
+
+static const AttributeBinding AttributeBindings[] = {
+    { VertexAttribute::Position, 0 },
+    { VertexAttribute::Normal, 1 },
+    { VertexAttribute::Color0, 2 },
+    { VertexAttribute::TexCoord0, 3 },
+    { VertexAttribute::Instance0, 4 },
+    { VertexAttribute::Instance1, 5 },
+    { VertexAttribute::Instance2, 6 },
+    { VertexAttribute::Instance3, 7 },
+    { VertexAttribute::Indices, 8 },
+    { VertexAttribute::Weights, 9 }
+};
+
+static const size_t NumAttributeBindings = sizeof(AttributeBindings) / sizeof(AttributeBinding);
+
+static GLint getBoundAttributeLocation(const String &attribute) {
+    for (size_t i = 0; i < NumAttributeBindings; ++i) {
+        if (getVertCompName(AttributeBindings[i].m_attrib) == attribute) {
+            return static_cast<GLint>(AttributeBindings[i].m_location);
+        }
+    }
+
+    return ErrorId;
+}
+
 OGLShader::OGLShader(const String &name) :
         Object(name),
         m_attribParams(),
@@ -40,8 +73,15 @@ OGLShader::OGLShader(const String &name) :
         m_numShader(0),
         m_attributeMap(),
         m_uniformLocationMap(),
+        m_uniformHashMap(),
+        m_paramLocations(),
+        m_pendingUniforms(),
         m_isCompiledAndLinked(false),
-        m_isInUse(false) {
+        m_isLinkPending(false),
+        m_isInUse(false),
+        m_usesDrawData(false),
+        m_drawIndexLocation(-1),
+        m_drawDataEnabledLocation(-1) {
     ::memset(m_shaders, 0, sizeof(unsigned int) * 3);
 }
 
@@ -75,6 +115,9 @@ bool OGLShader::loadFromSource(ShaderType type, const String &src) {
     const char *tmp = src.c_str();
     glShaderSource(shader, 1, &tmp, nullptr);
 
+    // The compile status is checked together with the link status, so the driver may compile in parallel
+    glCompileShader(shader);
+
     return true;
 }
 
@@ -97,17 +140,35 @@ bool OGLShader::loadFromStream(ShaderType type, IO::Stream &stream) {
     return retCode;
 }
 
-bool OGLShader::createAndLink() {
+bool OGLShader::createAndLink(bool retrievable) {
     if (isCompiled()) {
         osre_info(Tag, "Trying to compile shader program, which was compiled before.");
         return true;
     }
 
-    m_shaderprog = glCreateProgram();
+    if (!link(retrievable)) {
+        return false;
+    }
+    updateLinkState(true);
+
+    return isCompiled();
+}
+
+bool OGLShader::link(bool retrievable) {
+    if (isCompiled() || m_isLinkPending) {
+        return true;
+    }
+
+    if (0 == m_shaderprog) {
+        m_shaderprog = glCreateProgram();
+    }
     if (0 == m_shaderprog) {
         osre_error(Tag, "Error while creating shader program.");
         return false;
     }
+    if (retrievable) {
+        glProgramParameteri(m_shaderprog, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
     if (0 != m_shaders[static_cast<i32>(ShaderType::SH_VertexShaderType)]) {
         glAttachShader(m_shaderprog, m_shaders[static_cast<i32>(ShaderType::SH_VertexShaderType)]);
     }
@@ -118,20 +179,116 @@ bool OGLShader::createAndLink() {
         glAttachShader(m_shaderprog, m_shaders[static_cast<i32>(ShaderType::SH_GeometryShaderType)]);
     }
 
-    bool result(true);
-    GLint status(0);
+    // Explicit locations in the source take precedence, they must match the bindings
+    for (size_t i = 0; i < NumAttributeBindings; ++i) {
+        glBindAttribLocation(m_shaderprog, AttributeBindings[i].m_location,
+                getVertCompName(AttributeBindings[i].m_attrib).c_str());
+    }
+
     glLinkProgram(m_shaderprog);
+    m_isLinkPending = true;
+
+    return true;
+}
+
+bool OGLShader::updateLinkState(bool wait) {
+    if (!m_isLinkPending) {
+        return true;
+    }
+
+    if (!wait) {
+        GLint completed(GL_FALSE);
+        glGetProgramiv(m_shaderprog, GL_COMPLETION_STATUS_KHR, &completed);
+        if (GL_FALSE == completed) {
+            return false;
+        }
+    }
+    m_isLinkPending = false;
+
+    GLint status(0);
     glGetProgramiv(m_shaderprog, GL_LINK_STATUS, &status);
     if (status == GL_FALSE) {
+        for (ui32 i = 0; i < MaxShaderTypes; ++i) {
+            if (0 != m_shaders[i]) {
+                logShaderCompileError(m_shaders[i]);
+            }
+        }
         logCompileOrLinkError(m_shaderprog);
-        result = false;
-    } else {
-        getActiveAttributeList();
-        getActiveUniformList();
+        m_isCompiledAndLinked = false;
+        return true;
+    }
+
+    getActiveAttributeList();
+    getActiveUniformList();
+    m_isCompiledAndLinked = true;
+
+    // The locations used while the link was pending are replaced by the linked ones
+    for (std::map<String, GLint>::iterator it = m_attributeMap.begin(); it != m_attributeMap.end(); ++it) {
+        it->second = glGetAttribLocation(m_shaderprog, it->first.c_str());
+    }
+    for (ui32 i = 0; i < m_pendingUniforms.size(); ++i) {
+        addUniform(m_pendingUniforms[i]);
+    }
+    m_pendingUniforms.clear();
+
+    return true;
+}
+
+bool OGLShader::isLinkPending() const {
+    return m_isLinkPending;
+}
+
+bool OGLShader::createFromBinary(GLenum format, const void *binary, GLsizei size) {
+    if (isCompiled()) {
+        osre_info(Tag, "Trying to load shader program, which was compiled before.");
+        return true;
+    }
+
+    if (nullptr == binary || 0 == size) {
+        return false;
+    }
+
+    if (0 == m_shaderprog) {
+        m_shaderprog = glCreateProgram();
+    }
+    if (0 == m_shaderprog) {
+        osre_error(Tag, "Error while creating shader program.");
+        return false;
+    }
+
+    GLint status(0);
+    glProgramBinary(m_shaderprog, format, binary, size);
+    glGetProgramiv(m_shaderprog, GL_LINK_STATUS, &status);
+    if (status == GL_FALSE) {
+        // Keep the program object, a following createAndLink will reuse it.
+        return false;
+    }
+
+    getActiveAttributeList();
+    getActiveUniformList();
+    m_isCompiledAndLinked = true;
+
+    return true;
+}
+
+bool OGLShader::getProgramBinary(MemoryBuffer &binary, GLenum &format) const {
+    binary.clear();
+    if (!isCompiled()) {
+        return false;
     }
-    m_isCompiledAndLinked = result;
 
-    return result;
+    GLint size(0);
+    glGetProgramiv(m_shaderprog, GL_PROGRAM_BINARY_LENGTH, &size);
+    if (size <= 0) {
+        return false;
+    }
+
+    binary.resize(static_cast<size_t>(size));
+    GLsizei length(0);
+    glGetProgramBinary(m_shaderprog, size, &length, &format, &binary[0]);
+    binary.resize(static_cast<size_t>(length));
+
+    return length > 0;
 }
 
 void OGLShader::use() {
@@ -144,6 +301,32 @@ void OGLShader::unuse() {
     glUseProgram(0);
 }
 
+void OGLShader::setInUse(bool inUse) {
+    m_isInUse = inUse;
+}
+
+ui32 OGLShader::getProgramId() const {
+    return m_shaderprog;
+}
+
+void OGLShader::setDrawData(bool usesDrawData, GLint drawIndexLocation, GLint enabledLocation) {
+    m_usesDrawData = usesDrawData;
+    m_drawIndexLocation = drawIndexLocation;
+    m_drawDataEnabledLocation = enabledLocation;
+}
+
+bool OGLShader::usesDrawData() const {
+    return m_usesDrawData;
+}
+
+GLint OGLShader::getDrawIndexLocation() const {
+    return m_drawIndexLocation;
+}
+
+GLint OGLShader::getDrawDataEnabledLocation() const {
+    return m_drawDataEnabledLocation;
+}
+
 bool OGLShader::hasAttribute(const String &attribute) {
     if (0 == m_shaderprog) {
         return false;
@@ -154,6 +337,11 @@ bool OGLShader::hasAttribute(const String &attribute) {
 }
 
 void OGLShader::addAttribute(const String &attribute) {
+    if (m_isLinkPending) {
+        m_attributeMap[attribute] = getBoundAttributeLocation(attribute);
+        return;
+    }
+
     const GLint location = glGetAttribLocation(m_shaderprog, attribute.c_str());
     m_attributeMap[attribute] = location;
     if (ErrorId == location) {
@@ -170,8 +358,16 @@ bool OGLShader::hasUniform(const String &uniform) {
 }
 
 void OGLShader::addUniform(const String &uniform) {
+    if (m_isLinkPending) {
+        m_pendingUniforms.add(uniform);
+        return;
+    }
+
     const GLint location = glGetUniformLocation(m_shaderprog, uniform.c_str());
     m_uniformLocationMap[uniform] = location;
+    if (ErrorId != location) {
+        m_uniformHashMap[Common::StringUtils::hashName(uniform)] = location;
+    }
     if (ErrorId == location) {
         osre_debug(Tag, "Cannot find uniform variable " + uniform + " in shader.");
     }
@@ -229,11 +425,24 @@ void OGLShader::getActiveUniformList() {
         c8 name[MaxLen];
         ::memset(name, '\0', sizeof(c8) * MaxLen);
         glGetActiveUniform(m_shaderprog, i, MaxLen, &actual_length, &size, &type, name);
-        ActiveParameter *attribParam = new ActiveParameter;
-        strncpy(attribParam->m_name, name, strlen(name));
-        attribParam->m_location = glGetUniformLocation(m_shaderprog, name);
-        m_attribParams.add(attribParam);
+        ActiveParameter *uniformParam = new ActiveParameter;
+        strncpy(uniformParam->m_name, name, strlen(name));
+        uniformParam->m_location = glGetUniformLocation(m_shaderprog, name);
+        m_uniformParams.add(uniformParam);
+
+        // Members of uniform blocks have no location, arrays are reported as name[0]
+        if (ErrorId == uniformParam->m_location) {
+            continue;
+        }
+        c8 *arraySuffix = ::strstr(name, "[0]");
+        if (nullptr != arraySuffix) {
+            *arraySuffix = '\0';
+        }
+        m_uniformHashMap[Common::StringUtils::hashName(name)] = uniformParam->m_location;
     }
+
+    // The parameter locations are resolved on first use for this program
+    m_paramLocations.resize(0);
 }
 
 void OGLShader::logCompileOrLinkError(ui32 shaderprog) {
@@ -247,6 +456,26 @@ void OGLShader::logCompileOrLinkError(ui32 shaderprog) {
     delete[] infoLog;
 }
 
+void OGLShader::logShaderCompileError(ui32 shader) {
+    GLint status(GL_FALSE);
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &status);
+    if (GL_FALSE != status) {
+        return;
+    }
+
+    GLint infoLogLength(0);
+    glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &infoLogLength);
+    if (infoLogLength <= 0) {
+        return;
+    }
+    GLchar *infoLog = new GLchar[infoLogLength];
+    ::memset(infoLog, 0, infoLogLength);
+    glGetShaderInfoLog(shader, infoLogLength, NULL, infoLog);
+    String error(infoLog);
+    osre_debug(Tag, "Compile log: " + error + "\n");
+    delete[] infoLog;
+}
+
 bool OGLShader::isCompiled() const {
     return m_isCompiledAndLinked;
 }
@@ -257,11 +486,37 @@ GLint OGLShader::getAttributeLocation(const String &attribute) {
 }
 
 GLint OGLShader::getUniformLocation(const String &uniform) {
-    std::map<String, GLint>::iterator it(m_uniformLocationMap.find(uniform));
-    if (m_uniformLocationMap.end() == it) {
+    const GLint loc(getUniformLocation(Common::StringUtils::hashName(uniform)));
+    if (ErrorId == loc) {
         osre_error(Tag, "Cannot find uniform " + uniform + ".");
     }
-    const GLint loc(m_uniformLocationMap[uniform]);
+
+    return loc;
+}
+
+GLint OGLShader::getUniformLocation(HashId hash) const {
+    std::map<HashId, GLint>::const_iterator it(m_uniformHashMap.find(hash));
+    if (m_uniformHashMap.end() == it) {
+        return ErrorId;
+    }
+
+    return it->second;
+}
+
+GLint OGLShader::getParameterLocation(ui32 handle, HashId hash) {
+    if (handle >= m_paramLocations.size()) {
+        const size_t oldSize = m_paramLocations.size();
+        m_paramLocations.resize(handle + 1);
+        for (size_t i = oldSize; i < m_paramLocations.size(); ++i) {
+            m_paramLocations[i] = UnresolvedId;
+        }
+    }
+
+    GLint &loc = m_paramLocations[handle];
+    if (UnresolvedId == loc) {
+        loc = getUniformLocation(hash);
+    }
+
     return loc;
 }
 
@@ -68,14 +68,67 @@ public:
     bool loadFromStream( ShaderType type, IO::Stream &stream );
 
     /// @brief  Will create and link a shader program.
+    /// @param  retrievable [in] true, if the binary of the program will be read back afterwards.
     /// @return true, if create & link was successful, false in case of an error.
-    bool createAndLink();
+    bool createAndLink(bool retrievable = false);
+
+    /// @brief  Starts to link the shader program without waiting for the driver.
+    /// While the link is pending, the engine vertex attributes use fixed locations, so vertex
+    /// arrays can be set up. Use updateLinkState to finish the link.
+    /// @param  retrievable [in] true, if the binary of the program will be read back afterwards.
+    /// @return true, if the link was started.
+    bool link(bool retrievable = false);
+
+    /// @brief  Finishes a pending link.
+    /// @param  wait        [in] false to return at once, while the driver is still working on the
+    ///                     program. Requires GL_KHR_parallel_shader_compile.
+    /// @return true, if the link is finished, successful or not.
+    bool updateLinkState(bool wait);
+
+    /// @brief  Returns true, while the link of the program is pending.
+    bool isLinkPending() const;
+
+    /// @brief  Will create the shader program from a binary written by getProgramBinary.
+    /// @param  format      [in] The binary format reported by the driver.
+    /// @param  binary      [in] The program binary.
+    /// @param  size        [in] The size of the binary in bytes.
+    /// @return true, if the driver accepted the binary, false if the sources must be compiled.
+    bool createFromBinary(GLenum format, const void *binary, GLsizei size);
+
+    /// @brief  Reads back the binary of the linked program.
+    /// @param  binary      [out] Will receive the program binary.
+    /// @param  format      [out] Will receive the binary format.
+    /// @return true, if the driver returned a binary.
+    bool getProgramBinary(MemoryBuffer &binary, GLenum &format) const;
     
     /// @brief  Will bind this program to the current render context.
     void use();
 
     /// @brief  Will unbind this program to the current render context.
     void unuse();
+
+    /// @brief  Marks the program as bound or unbound, when the binding was done by the caller.
+    /// @param  inUse   [in] true, if the program is bound.
+    void setInUse(bool inUse);
+
+    /// @brief  Returns the handle of the linked program.
+    /// @return The program handle, 0 if not linked.
+    ui32 getProgramId() const;
+
+    /// @brief  Stores how the program reads the per-draw data of indirect draws.
+    /// @param  usesDrawData        [in] true, if the program declares the per-draw data block.
+    /// @param  drawIndexLocation   [in] The location of the draw index uniform, -1 if not used.
+    /// @param  enabledLocation     [in] The location of the uniform enabling the per-draw data, -1 if not used.
+    void setDrawData(bool usesDrawData, GLint drawIndexLocation, GLint enabledLocation);
+
+    /// @brief  Returns true, if the program declares the per-draw data block.
+    bool usesDrawData() const;
+
+    /// @brief  Returns the location of the draw index uniform, -1 if not used.
+    GLint getDrawIndexLocation() const;
+
+    /// @brief  Returns the location of the uniform enabling the per-draw data, -1 if not used.
+    GLint getDrawDataEnabledLocation() const;
     
 	///	@brief	Will perform a lookup if the attribute is used in the shader program. 
 	///         The shader program must be compiled before.
@@ -107,6 +160,10 @@ public:
     /// @param  shaderprog  [in] The shader program handle.
     static void logCompileOrLinkError( ui32 shaderprog );
 
+    /// @brief  Logs the compile error of a shader stage.
+    /// @param  shader      [in] The shader handle.
+    static void logShaderCompileError( ui32 shader );
+
     ///	@brief	Will return the current compile state.
 	///	@return	true, if the shader is compiled with success, false if not.
 	bool isCompiled() const;
@@ -114,6 +171,17 @@ public:
     GLint getAttributeLocation(const String &attribute);
     GLint getUniformLocation(const String &uniform);
 
+    /// @brief  Returns the location of an active uniform by its hashed name.
+    /// @param  hash        [in] The hashed name, see StringUtils::hashName.
+    /// @return The location or -1, if the program does not use the uniform.
+    GLint getUniformLocation(HashId hash) const;
+
+    /// @brief  Returns the location of an interned parameter, it will be resolved once per program.
+    /// @param  handle      [in] The handle of the parameter.
+    /// @param  hash        [in] The hashed name of the parameter.
+    /// @return The location or -1, if the program does not use the parameter.
+    GLint getParameterLocation(ui32 handle, HashId hash);
+
     /// @brief  returns the location of the attribute.
     /// @param  attribute   [in] The name of the attribute.
     /// @return Its location or -1 for an error.
@@ -150,8 +218,15 @@ private:
     ui32 m_shaders[ MaxShaderTypes ];
     std::map<String, GLint> m_attributeMap;
     std::map<String, GLint> m_uniformLocationMap;
+    std::map<HashId, GLint> m_uniformHashMap;
+    ::CPPCore::TArray<GLint> m_paramLocations;
+    ::CPPCore::TArray<String> m_pendingUniforms;
     bool m_isCompiledAndLinked;
+    bool m_isLinkPending;
 	bool m_isInUse;
+    bool m_usesDrawData;
+    GLint m_drawIndexLocation;
+    GLint m_drawDataEnabledLocation;
 };
 
 } // Namespace RenderBackend
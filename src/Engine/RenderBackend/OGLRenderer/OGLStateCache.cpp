@@ -0,0 +1,249 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2015-2020 OSRE ( Open Source Render Engine ) by Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#include "OGLStateCache.h"
+
+#include <cstring>
+
+namespace OSRE {
+namespace RenderBackend {
+
+static ui64 makeKey(ui32 high, ui32 low) {
+    return (static_cast<ui64>(high) << 32) | low;
+}
+
+OGLStateCache::OGLStateCache() :
+        m_program(Unknown),
+        m_vertexArray(Unknown),
+        m_activeTexture(Unknown),
+        m_frameBuffer(Unknown),
+        m_cullFace(Unknown),
+        m_frontFace(Unknown),
+        m_depthFunc(Unknown),
+        m_depthMask(Unknown),
+        m_buffers(),
+        m_indexedBuffers(),
+        m_textures(),
+        m_capabilities(),
+        m_polygonModes(),
+        m_uniforms(),
+        m_numIssued(0),
+        m_numSkipped(0) {
+    // empty
+}
+
+OGLStateCache::~OGLStateCache() {
+    // empty
+}
+
+void OGLStateCache::reset() {
+    m_program = Unknown;
+    m_vertexArray = Unknown;
+    m_activeTexture = Unknown;
+    m_frameBuffer = Unknown;
+    m_cullFace = Unknown;
+    m_frontFace = Unknown;
+    m_depthFunc = Unknown;
+    m_depthMask = Unknown;
+    m_buffers.clear();
+    m_indexedBuffers.clear();
+    m_textures.clear();
+    m_capabilities.clear();
+    m_polygonModes.clear();
+    m_uniforms.clear();
+}
+
+bool OGLStateCache::useProgram(ui32 program) {
+    return update(m_program, program);
+}
+
+bool OGLStateCache::bindVertexArray(ui32 vertexArray) {
+    return update(m_vertexArray, vertexArray);
+}
+
+bool OGLStateCache::bindBuffer(ui32 target, ui32 buffer) {
+    std::map<ui32, ui32>::iterator it(m_buffers.find(target));
+    if (m_buffers.end() == it) {
+        m_buffers[target] = buffer;
+        return count(true);
+    }
+
+    return update(it->second, buffer);
+}
+
+bool OGLStateCache::bindBufferBase(ui32 target, ui32 index, ui32 buffer) {
+    const ui64 key = makeKey(target, index);
+    std::map<ui64, ui32>::iterator it(m_indexedBuffers.find(key));
+    if (m_indexedBuffers.end() != it && it->second == buffer) {
+        return count(false);
+    }
+    m_indexedBuffers[key] = buffer;
+    m_buffers[target] = buffer;
+
+    return count(true);
+}
+
+void OGLStateCache::invalidateBuffer(ui32 target) {
+    m_buffers.erase(target);
+}
+
+bool OGLStateCache::setActiveTexture(ui32 unit) {
+    return update(m_activeTexture, unit);
+}
+
+bool OGLStateCache::bindTexture(ui32 unit, ui32 target, ui32 texture) {
+    const ui64 key = makeKey(unit, target);
+    std::map<ui64, ui32>::iterator it(m_textures.find(key));
+    if (m_textures.end() == it) {
+        m_textures[key] = texture;
+        return count(true);
+    }
+
+    return update(it->second, texture);
+}
+
+bool OGLStateCache::bindFrameBuffer(ui32 frameBuffer) {
+    return update(m_frameBuffer, frameBuffer);
+}
+
+bool OGLStateCache::setCapability(ui32 cap, bool enabled) {
+    std::map<ui32, bool>::iterator it(m_capabilities.find(cap));
+    if (m_capabilities.end() != it && it->second == enabled) {
+        return count(false);
+    }
+    m_capabilities[cap] = enabled;
+
+    return count(true);
+}
+
+bool OGLStateCache::setCullFace(ui32 face) {
+    return update(m_cullFace, face);
+}
+
+bool OGLStateCache::setFrontFace(ui32 mode) {
+    return update(m_frontFace, mode);
+}
+
+bool OGLStateCache::setPolygonMode(ui32 face, ui32 mode) {
+    std::map<ui32, ui32>::iterator it(m_polygonModes.find(face));
+    if (m_polygonModes.end() == it) {
+        m_polygonModes[face] = mode;
+        return count(true);
+    }
+
+    return update(it->second, mode);
+}
+
+bool OGLStateCache::setDepthFunc(ui32 func) {
+    return update(m_depthFunc, func);
+}
+
+bool OGLStateCache::setDepthMask(bool enabled) {
+    return update(m_depthMask, enabled ? 1 : 0);
+}
+
+bool OGLStateCache::setUniform(ui32 program, i32 location, const void *data, size_t size) {
+    if (nullptr == data || 0 == size) {
+        return count(true);
+    }
+
+    std::vector<uc8> &value = m_uniforms[makeKey(program, static_cast<ui32>(location))];
+    if (value.size() == size && 0 == ::memcmp(&value[0], data, size)) {
+        return count(false);
+    }
+
+    const uc8 *bytes = static_cast<const uc8 *>(data);
+    value.assign(bytes, bytes + size);
+
+    return count(true);
+}
+
+void OGLStateCache::onBufferDeleted(ui32 buffer) {
+    for (std::map<ui32, ui32>::iterator it = m_buffers.begin(); it != m_buffers.end(); ++it) {
+        if (it->second == buffer) {
+            it->second = 0;
+        }
+    }
+    for (std::map<ui64, ui32>::iterator it = m_indexedBuffers.begin(); it != m_indexedBuffers.end(); ++it) {
+        if (it->second == buffer) {
+            it->second = 0;
+        }
+    }
+}
+
+void OGLStateCache::onVertexArrayDeleted(ui32 vertexArray) {
+    if (m_vertexArray == vertexArray) {
+        m_vertexArray = 0;
+    }
+}
+
+void OGLStateCache::onTextureDeleted(ui32 texture) {
+    for (std::map<ui64, ui32>::iterator it = m_textures.begin(); it != m_textures.end(); ++it) {
+        if (it->second == texture) {
+            it->second = 0;
+        }
+    }
+}
+
+void OGLStateCache::onFrameBufferDeleted(ui32 frameBuffer) {
+    if (m_frameBuffer == frameBuffer) {
+        m_frameBuffer = 0;
+    }
+}
+
+void OGLStateCache::onProgramDeleted(ui32 program) {
+    // A deleted program stays in use until another one is bound, its id may be reused afterwards
+    if (m_program == program) {
+        m_program = Unknown;
+    }
+
+    const ui64 first = makeKey(program, 0);
+    const ui64 last = makeKey(program + 1, 0);
+    m_uniforms.erase(m_uniforms.lower_bound(first), m_uniforms.lower_bound(last));
+}
+
+void OGLStateCache::resetCounters() {
+    m_numIssued = 0;
+    m_numSkipped = 0;
+}
+
+bool OGLStateCache::update(ui32 &shadow, ui32 value) {
+    if (shadow == value) {
+        return count(false);
+    }
+    shadow = value;
+
+    return count(true);
+}
+
+bool OGLStateCache::count(bool issue) {
+    if (issue) {
+        ++m_numIssued;
+    } else {
+        ++m_numSkipped;
+    }
+
+    return issue;
+}
+
+} // Namespace RenderBackend
+} // Namespace OSRE
@@ -0,0 +1,134 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2015-2020 OSRE ( Open Source Render Engine ) by Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#pragma once
+
+#include <osre/Common/osre_common.h>
+
+#include <map>
+#include <vector>
+
+namespace OSRE {
+namespace RenderBackend {
+
+//-------------------------------------------------------------------------------------------------
+///	@ingroup	Engine
+///
+///	@brief  Shadow of the OpenGL state set by the render backend. Each setter compares the
+/// requested value with the shadowed one and returns true when the GL call must be issued, false
+/// when it would be a no-op. Issued and skipped calls are counted until the next resetCounters().
+///
+/// State which was never set is unknown, so the first call is always issued. Call reset() when
+/// the state was changed without the cache, for instance after a context switch.
+//-------------------------------------------------------------------------------------------------
+class OGLStateCache {
+public:
+    /// Marks an unknown binding.
+    static const ui32 Unknown = 0xffffffff;
+
+    /// The default class constructor.
+    OGLStateCache();
+    /// The class destructor.
+    ~OGLStateCache();
+    /// Forgets the whole state, the counters will be kept.
+    void reset();
+    /// glUseProgram
+    bool useProgram(ui32 program);
+    /// glBindVertexArray
+    bool bindVertexArray(ui32 vertexArray);
+    /// glBindBuffer
+    bool bindBuffer(ui32 target, ui32 buffer);
+    /// glBindBufferBase, the binding of the target will be set as well.
+    bool bindBufferBase(ui32 target, ui32 index, ui32 buffer);
+    /// Forgets the binding of a target, for bindings owned by other objects like the element
+    /// array buffer of a vertex array.
+    void invalidateBuffer(ui32 target);
+    /// glActiveTexture
+    bool setActiveTexture(ui32 unit);
+    /// glBindTexture on the given unit.
+    bool bindTexture(ui32 unit, ui32 target, ui32 texture);
+    /// glBindFramebuffer
+    bool bindFrameBuffer(ui32 frameBuffer);
+    /// glEnable / glDisable
+    bool setCapability(ui32 cap, bool enabled);
+    /// glCullFace
+    bool setCullFace(ui32 face);
+    /// glFrontFace
+    bool setFrontFace(ui32 mode);
+    /// glPolygonMode
+    bool setPolygonMode(ui32 face, ui32 mode);
+    /// glDepthFunc
+    bool setDepthFunc(ui32 func);
+    /// glDepthMask
+    bool setDepthMask(bool enabled);
+    /// glUniform*, the value is compared byte-wise per program and location.
+    bool setUniform(ui32 program, i32 location, const void *data, size_t size);
+    /// Drops all bindings of a deleted buffer, GL binds 0 instead.
+    void onBufferDeleted(ui32 buffer);
+    /// Drops all bindings of a deleted vertex array.
+    void onVertexArrayDeleted(ui32 vertexArray);
+    /// Drops all bindings of a deleted texture.
+    void onTextureDeleted(ui32 texture);
+    /// Drops the binding of a deleted frame buffer.
+    void onFrameBufferDeleted(ui32 frameBuffer);
+    /// Drops the binding and the uniform values of a deleted program.
+    void onProgramDeleted(ui32 program);
+    /// Returns the number of issued calls since the last reset of the counters.
+    ui32 getNumIssuedCalls() const;
+    /// Returns the number of skipped calls since the last reset of the counters.
+    ui32 getNumSkippedCalls() const;
+    /// Resets the counters, called once per frame.
+    void resetCounters();
+
+private:
+    bool update(ui32 &shadow, ui32 value);
+    bool count(bool issue);
+
+private:
+    ui32 m_program;
+    ui32 m_vertexArray;
+    ui32 m_activeTexture;
+    ui32 m_frameBuffer;
+    ui32 m_cullFace;
+    ui32 m_frontFace;
+    ui32 m_depthFunc;
+    ui32 m_depthMask;
+    std::map<ui32, ui32> m_buffers;
+    std::map<ui64, ui32> m_indexedBuffers;
+    std::map<ui64, ui32> m_textures;
+    std::map<ui32, bool> m_capabilities;
+    std::map<ui32, ui32> m_polygonModes;
+    std::map<ui64, std::vector<uc8>> m_uniforms;
+    ui32 m_numIssued;
+    ui32 m_numSkipped;
+};
+
+inline ui32 OGLStateCache::getNumIssuedCalls() const {
+    return m_numIssued;
+}
+
+inline ui32 OGLStateCache::getNumSkippedCalls() const {
+    return m_numSkipped;
+}
+
+} // Namespace RenderBackend
+} // Namespace OSRE
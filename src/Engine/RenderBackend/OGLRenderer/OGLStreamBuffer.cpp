@@ -0,0 +1,187 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2015-2020 OSRE ( Open Source Render Engine ) by Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#include "OGLStreamBuffer.h"
+#include "OGLStateCache.h"
+
+#include <osre/Common/Logger.h>
+
+namespace OSRE {
+namespace RenderBackend {
+
+static const String Tag = "OGLStreamBuffer";
+
+// Timeout for a single wait on a region fence
+static const GLuint64 FenceTimeout = 1000000000;
+
+const size_t OGLStreamBuffer::Alignment;
+
+OGLStreamBuffer::OGLStreamBuffer() :
+        m_stateCache(nullptr),
+        m_id(0),
+        m_mapped(nullptr),
+        m_persistent(false),
+        m_ring(),
+        m_numStalls(0) {
+    for (ui32 i = 0; i < MaxRegions; ++i) {
+        m_fences[i] = nullptr;
+    }
+}
+
+OGLStreamBuffer::~OGLStreamBuffer() {
+    destroy();
+}
+
+bool OGLStreamBuffer::create(OGLStateCache *stateCache, size_t regionSize, ui32 numRegions) {
+    if (0 != m_id) {
+        return true;
+    }
+
+    if (0 == regionSize || 0 == numRegions || numRegions > MaxRegions) {
+        osre_error(Tag, "Invalid stream buffer size.");
+        return false;
+    }
+
+    m_stateCache = stateCache;
+    m_ring.init((regionSize + Alignment - 1) & ~(Alignment - 1), numRegions);
+    const size_t size = m_ring.m_regionSize * numRegions;
+
+    glGenBuffers(1, &m_id);
+    bind();
+    m_persistent = GLEW_ARB_buffer_storage || GLEW_VERSION_4_4;
+    if (m_persistent) {
+        const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        glBufferStorage(GL_COPY_READ_BUFFER, size, nullptr, flags);
+        m_mapped = (c8 *)glMapBufferRange(GL_COPY_READ_BUFFER, 0, size, flags);
+        if (nullptr == m_mapped) {
+            osre_warn(Tag, "Cannot map stream buffer persistently, using orphaning.");
+            glDeleteBuffers(1, &m_id);
+            m_stateCache->onBufferDeleted(m_id);
+            glGenBuffers(1, &m_id);
+            bind();
+            m_persistent = false;
+        }
+    }
+
+    if (!m_persistent) {
+        glBufferData(GL_COPY_READ_BUFFER, size, nullptr, GL_STREAM_DRAW);
+    }
+    CHECKOGLERRORSTATE();
+
+    return true;
+}
+
+void OGLStreamBuffer::destroy() {
+    if (0 == m_id) {
+        return;
+    }
+
+    for (ui32 i = 0; i < MaxRegions; ++i) {
+        if (nullptr != m_fences[i]) {
+            glDeleteSync(m_fences[i]);
+            m_fences[i] = nullptr;
+        }
+    }
+
+    if (nullptr != m_mapped) {
+        bind();
+        glUnmapBuffer(GL_COPY_READ_BUFFER);
+        m_mapped = nullptr;
+    }
+
+    glDeleteBuffers(1, &m_id);
+    if (nullptr != m_stateCache) {
+        m_stateCache->onBufferDeleted(m_id);
+    }
+    m_id = 0;
+}
+
+void *OGLStreamBuffer::map(size_t size, size_t &offset) {
+    if (0 == m_id) {
+        return nullptr;
+    }
+
+    if (!m_ring.alloc(size, Alignment, offset)) {
+        return nullptr;
+    }
+
+    if (m_persistent) {
+        return &m_mapped[offset];
+    }
+
+    // The region is not in use by the GPU anymore, see endFrame()
+    bind();
+    const GLbitfield access = GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_INVALIDATE_RANGE_BIT;
+
+    return glMapBufferRange(GL_COPY_READ_BUFFER, offset, size, access);
+}
+
+void OGLStreamBuffer::unmap() {
+    if (m_persistent || 0 == m_id) {
+        return;
+    }
+
+    bind();
+    glUnmapBuffer(GL_COPY_READ_BUFFER);
+}
+
+void OGLStreamBuffer::endFrame() {
+    if (0 == m_id) {
+        return;
+    }
+
+    if (!m_persistent) {
+        // Orphan the storage on wrap-around, the driver keeps the old one alive for the GPU
+        if (0 == m_ring.nextRegion()) {
+            bind();
+            glBufferData(GL_COPY_READ_BUFFER, m_ring.m_regionSize * m_ring.m_numRegions, nullptr, GL_STREAM_DRAW);
+        }
+        return;
+    }
+
+    m_fences[m_ring.m_region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    const ui32 region = m_ring.nextRegion();
+    GLsync fence = m_fences[region];
+    if (nullptr == fence) {
+        return;
+    }
+
+    GLenum result = glClientWaitSync(fence, 0, 0);
+    if (GL_TIMEOUT_EXPIRED == result) {
+        ++m_numStalls;
+        result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, FenceTimeout);
+    }
+    if (GL_WAIT_FAILED == result) {
+        osre_error(Tag, "Waiting for the stream buffer region failed.");
+    }
+    glDeleteSync(fence);
+    m_fences[region] = nullptr;
+}
+
+void OGLStreamBuffer::bind() {
+    if (nullptr == m_stateCache || m_stateCache->bindBuffer(GL_COPY_READ_BUFFER, m_id)) {
+        glBindBuffer(GL_COPY_READ_BUFFER, m_id);
+    }
+}
+
+} // Namespace RenderBackend
+} // Namespace OSRE
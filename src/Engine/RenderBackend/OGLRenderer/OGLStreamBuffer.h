@@ -0,0 +1,174 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2015-2020 OSRE ( Open Source Render Engine ) by Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#pragma once
+
+#include "OGLCommon.h"
+
+namespace OSRE {
+namespace RenderBackend {
+
+class OGLStateCache;
+
+//-------------------------------------------------------------------------------------------------
+///	@ingroup	Engine
+///
+///	@brief  Sub-allocates a ring of equally sized regions, one region per frame in flight. All
+/// allocations of a frame are placed in the current region, nextRegion() moves to the next one.
+//-------------------------------------------------------------------------------------------------
+struct StreamRingAllocator {
+    size_t m_regionSize;
+    ui32 m_numRegions;
+    ui32 m_region;
+    size_t m_head;
+
+    StreamRingAllocator();
+    void init(size_t regionSize, ui32 numRegions);
+    /// @brief  Allocates a block in the current region.
+    /// @param  size    [in] The size of the block.
+    /// @param  align   [in] The alignment of the block, must be a power of two.
+    /// @param  offset  [out] The offset of the block in the whole buffer.
+    /// @return false, if the current region is full.
+    bool alloc(size_t size, size_t align, size_t &offset);
+    /// @brief  Moves to the next region and returns its index.
+    ui32 nextRegion();
+    /// @brief  Returns the offset of a region in the whole buffer.
+    size_t getRegionOffset(ui32 region) const;
+};
+
+inline StreamRingAllocator::StreamRingAllocator() :
+        m_regionSize(0),
+        m_numRegions(0),
+        m_region(0),
+        m_head(0) {
+    // empty
+}
+
+inline void StreamRingAllocator::init(size_t regionSize, ui32 numRegions) {
+    m_regionSize = regionSize;
+    m_numRegions = numRegions;
+    m_region = 0;
+    m_head = 0;
+}
+
+inline bool StreamRingAllocator::alloc(size_t size, size_t align, size_t &offset) {
+    const size_t start = (m_head + align - 1) & ~(align - 1);
+    if (0 == size || start + size > m_regionSize) {
+        return false;
+    }
+
+    offset = getRegionOffset(m_region) + start;
+    m_head = start + size;
+
+    return true;
+}
+
+inline ui32 StreamRingAllocator::nextRegion() {
+    if (0 != m_numRegions) {
+        m_region = (m_region + 1) % m_numRegions;
+    }
+    m_head = 0;
+
+    return m_region;
+}
+
+inline size_t StreamRingAllocator::getRegionOffset(ui32 region) const {
+    return m_regionSize * region;
+}
+
+//-------------------------------------------------------------------------------------------------
+///	@ingroup	Engine
+///
+///	@brief  A streaming buffer for per-frame data like dynamic meshes, text, particles, UI or
+/// debug lines. Writers get a pointer into mapped memory and write their data directly.
+///
+/// With GL_ARB_buffer_storage the buffer is mapped persistently and coherently once, each frame
+/// writes into its own region and a fence protects the region until the GPU has consumed it.
+/// Without it each allocation is mapped unsynchronized and the buffer is orphaned when the ring
+/// wraps around.
+//-------------------------------------------------------------------------------------------------
+class OGLStreamBuffer {
+public:
+    static const ui32 MaxRegions = 3;
+    /// The alignment of all allocations, enough for uniform and storage buffer ranges.
+    static const size_t Alignment = 256;
+
+    /// The default class constructor.
+    OGLStreamBuffer();
+    /// The class destructor.
+    ~OGLStreamBuffer();
+    /// @brief  Creates the buffer.
+    /// @param  stateCache  [in] The state shadow of the backend.
+    /// @param  regionSize  [in] The size of the region of one frame.
+    /// @param  numRegions  [in] The number of regions, at most MaxRegions.
+    /// @return true, if the buffer was created.
+    bool create(OGLStateCache *stateCache, size_t regionSize, ui32 numRegions = MaxRegions);
+    /// @brief  Releases the buffer.
+    void destroy();
+    /// @brief  Returns a pointer to write size bytes to, call unmap() when written.
+    /// @param  size    [in] The number of bytes to write.
+    /// @param  offset  [out] The offset of the data in the buffer.
+    /// @return The write pointer, nullptr if the region of the frame is full.
+    void *map(size_t size, size_t &offset);
+    /// @brief  Ends the write access of the last map() call.
+    void unmap();
+    /// @brief  Fences the region of the frame and moves to the next one, waits when the GPU
+    /// still reads from it. Call after all draws of the frame were issued.
+    void endFrame();
+    /// @brief  Returns the GL buffer id.
+    GLuint getId() const;
+    /// @brief  Returns true, if the buffer is mapped persistently.
+    bool isPersistent() const;
+    /// @brief  Returns the number of frames which had to wait for the GPU.
+    ui32 getNumStalls() const;
+
+    // No copying
+    OGLStreamBuffer(const OGLStreamBuffer &) = delete;
+    OGLStreamBuffer &operator=(const OGLStreamBuffer &) = delete;
+
+private:
+    void bind();
+
+private:
+    OGLStateCache *m_stateCache;
+    GLuint m_id;
+    c8 *m_mapped;
+    bool m_persistent;
+    StreamRingAllocator m_ring;
+    GLsync m_fences[MaxRegions];
+    ui32 m_numStalls;
+};
+
+inline GLuint OGLStreamBuffer::getId() const {
+    return m_id;
+}
+
+inline bool OGLStreamBuffer::isPersistent() const {
+    return m_persistent;
+}
+
+inline ui32 OGLStreamBuffer::getNumStalls() const {
+    return m_numStalls;
+}
+
+} // Namespace RenderBackend
+} // Namespace OSRE
@@ -0,0 +1,378 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2015-2020 OSRE ( Open Source Render Engine ) by Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#include "OGLTextureUploader.h"
+#include "OGLStateCache.h"
+
+#include <osre/Common/Logger.h>
+
+#include "SOIL.h"
+
+#include <cstring>
+
+namespace OSRE {
+namespace RenderBackend {
+
+using namespace ::OSRE::Threading;
+
+static const String Tag = "OGLTextureUploader";
+
+const size_t OGLTextureUploader::DefaultBudget;
+const size_t OGLTextureUploader::Alignment;
+
+static void getGLFormat(ui32 channels, GLenum &format, GLint &internalFormat) {
+    switch (channels) {
+        case 1:
+            format = GL_RED;
+            internalFormat = GL_R8;
+            break;
+        case 2:
+            format = GL_RG;
+            internalFormat = GL_RG8;
+            break;
+        case 4:
+            format = GL_RGBA;
+            internalFormat = GL_RGBA8;
+            break;
+        case 3:
+        default:
+            format = GL_RGB;
+            internalFormat = GL_RGB8;
+            break;
+    }
+}
+
+OGLTextureUploader::DecodedImage::DecodedImage() :
+        m_data(nullptr),
+        m_width(0),
+        m_height(0),
+        m_channels(0) {
+    // empty
+}
+
+OGLTextureUploader::OGLTextureUploader() :
+        m_stateCache(nullptr),
+        m_scheduler(nullptr),
+        m_id(0),
+        m_ring(),
+        m_decodes(),
+        m_uploads(),
+        m_blocks(),
+        m_numUploadedBytes(0),
+        m_numStalls(0) {
+    for (ui32 i = 0; i < MaxRegions; ++i) {
+        m_fences[i] = nullptr;
+    }
+}
+
+OGLTextureUploader::~OGLTextureUploader() {
+    destroy();
+}
+
+bool OGLTextureUploader::create(OGLStateCache *stateCache, JobScheduler *scheduler, size_t budget, ui32 numRegions) {
+    if (0 != m_id) {
+        return true;
+    }
+
+    if (0 == budget || 0 == numRegions || numRegions > MaxRegions) {
+        osre_error(Tag, "Invalid texture upload budget.");
+        return false;
+    }
+
+    m_stateCache = stateCache;
+    m_scheduler = scheduler;
+    m_ring.init((budget + Alignment - 1) & ~(Alignment - 1), numRegions);
+
+    glGenBuffers(1, &m_id);
+    bind(m_id);
+    glBufferData(GL_PIXEL_UNPACK_BUFFER, m_ring.m_regionSize * numRegions, nullptr, GL_STREAM_DRAW);
+    bind(0);
+    CHECKOGLERRORSTATE();
+
+    return true;
+}
+
+void OGLTextureUploader::destroy() {
+    // The workers write into the task results, wait for them before dropping the images
+    for (ui32 i = 0; i < m_decodes.size(); ++i) {
+        SOIL_free_image_data(m_decodes[i].m_task.get().m_data);
+    }
+    m_decodes.clear();
+
+    for (ui32 i = 0; i < m_uploads.size(); ++i) {
+        SOIL_free_image_data(m_uploads[i].m_image.m_data);
+    }
+    m_uploads.clear();
+    m_blocks.clear();
+
+    if (0 == m_id) {
+        return;
+    }
+
+    for (ui32 i = 0; i < MaxRegions; ++i) {
+        if (nullptr != m_fences[i]) {
+            glDeleteSync(m_fences[i]);
+            m_fences[i] = nullptr;
+        }
+    }
+
+    glDeleteBuffers(1, &m_id);
+    if (nullptr != m_stateCache) {
+        m_stateCache->onBufferDeleted(m_id);
+    }
+    m_id = 0;
+}
+
+void OGLTextureUploader::enqueue(OGLTexture *tex, const String &filename) {
+    if (nullptr == tex) {
+        return;
+    }
+
+    PendingDecode decode;
+    decode.m_texture = tex;
+    decode.m_task = TTask<DecodedImage>::run(m_scheduler, [filename]() {
+        return OGLTextureUploader::decode(filename);
+    });
+    m_decodes.add(decode);
+}
+
+void OGLTextureUploader::cancel(OGLTexture *tex) {
+    // Decodes in flight keep running, the image is dropped when they are done
+    for (ui32 i = 0; i < m_decodes.size(); ++i) {
+        if (m_decodes[i].m_texture == tex) {
+            m_decodes[i].m_texture = nullptr;
+        }
+    }
+
+    for (ui32 i = 0; i < m_uploads.size(); ++i) {
+        if (m_uploads[i].m_texture == tex) {
+            SOIL_free_image_data(m_uploads[i].m_image.m_data);
+            m_uploads.remove(i);
+            break;
+        }
+    }
+}
+
+void OGLTextureUploader::update() {
+    m_numUploadedBytes = 0;
+    if (0 == m_id) {
+        return;
+    }
+
+    ui32 i(0);
+    while (i < m_decodes.size()) {
+        if (!m_decodes[i].m_task.isReady()) {
+            ++i;
+            continue;
+        }
+
+        OGLTexture *tex = m_decodes[i].m_texture;
+        const DecodedImage &image = m_decodes[i].m_task.get();
+        if (nullptr == tex || nullptr == image.m_data) {
+            // Cancelled or broken files keep showing the default texture
+            if (nullptr != tex) {
+                osre_error(Tag, "Cannot decode texture " + tex->m_name);
+            }
+            SOIL_free_image_data(image.m_data);
+        } else {
+            PendingUpload upload;
+            upload.m_texture = tex;
+            upload.m_image = image;
+            upload.m_cursor.init(image.m_width, image.m_height, image.m_channels);
+            allocStorage(upload);
+            m_uploads.add(upload);
+        }
+        m_decodes.remove(i);
+    }
+
+    if (m_uploads.isEmpty() || !waitForRegion()) {
+        return;
+    }
+
+    // Plan the row blocks of this frame, the first image is finished first
+    m_blocks.clear();
+    for (ui32 j = 0; j < m_uploads.size(); ++j) {
+        const size_t head = (m_ring.m_head + Alignment - 1) & ~(Alignment - 1);
+        if (head >= m_ring.m_regionSize) {
+            break;
+        }
+
+        TextureUploadCursor &cursor = m_uploads[j].m_cursor;
+        const ui32 numRows = cursor.nextRows(m_ring.m_regionSize - head);
+        size_t offset(0);
+        if (0 == numRows || !m_ring.alloc(numRows * cursor.getRowPitch(), Alignment, offset)) {
+            break;
+        }
+
+        UploadBlock block;
+        block.m_upload = j;
+        block.m_row = cursor.m_row;
+        block.m_numRows = numRows;
+        block.m_offset = offset;
+        m_blocks.add(block);
+        cursor.advance(numRows);
+        if (!cursor.isDone()) {
+            break;
+        }
+    }
+
+    // Rows are tightly packed, whatever the number of channels
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    if (m_blocks.isEmpty()) {
+        // A single row is larger than the budget, upload the image directly from client memory
+        PendingUpload &upload = m_uploads[0];
+        bindTexture(upload.m_texture);
+        glTexSubImage2D(upload.m_texture->m_target, 0, 0, 0, upload.m_image.m_width, upload.m_image.m_height,
+                upload.m_texture->m_format, GL_UNSIGNED_BYTE, upload.m_image.m_data);
+        upload.m_cursor.advance(upload.m_image.m_height);
+        m_numUploadedBytes += upload.m_cursor.getRowPitch() * upload.m_image.m_height;
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    } else {
+        bind(m_id);
+        const size_t regionOffset = m_ring.getRegionOffset(m_ring.m_region);
+        const GLbitfield access = GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT;
+        c8 *mapped = (c8 *)glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, regionOffset, m_ring.m_head, access);
+        if (nullptr == mapped) {
+            osre_error(Tag, "Cannot map texture upload buffer.");
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+            bind(0);
+            return;
+        }
+
+        for (ui32 j = 0; j < m_blocks.size(); ++j) {
+            const UploadBlock &block = m_blocks[j];
+            const PendingUpload &upload = m_uploads[block.m_upload];
+            const size_t pitch = upload.m_cursor.getRowPitch();
+            ::memcpy(&mapped[block.m_offset - regionOffset], &upload.m_image.m_data[block.m_row * pitch],
+                    block.m_numRows * pitch);
+        }
+        glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+
+        for (ui32 j = 0; j < m_blocks.size(); ++j) {
+            const UploadBlock &block = m_blocks[j];
+            const PendingUpload &upload = m_uploads[block.m_upload];
+            bindTexture(upload.m_texture);
+            glTexSubImage2D(upload.m_texture->m_target, 0, 0, block.m_row, upload.m_image.m_width, block.m_numRows,
+                    upload.m_texture->m_format, GL_UNSIGNED_BYTE, (const GLvoid *)block.m_offset);
+            m_numUploadedBytes += block.m_numRows * upload.m_cursor.getRowPitch();
+        }
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+        // Client memory pointers of other uploads must not be taken as buffer offsets
+        bind(0);
+        m_fences[m_ring.m_region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        m_ring.nextRegion();
+    }
+
+    // Finished textures get their mip chain and replace the default texture from now on
+    ui32 numDone(0);
+    while (numDone < m_uploads.size() && m_uploads[numDone].m_cursor.isDone()) {
+        OGLTexture *tex = m_uploads[numDone].m_texture;
+        bindTexture(tex);
+        glGenerateMipmap(tex->m_target);
+        tex->m_resident = true;
+        SOIL_free_image_data(m_uploads[numDone].m_image.m_data);
+        ++numDone;
+    }
+    while (0 != numDone) {
+        --numDone;
+        m_uploads.remove(numDone);
+    }
+    CHECKOGLERRORSTATE();
+}
+
+OGLTextureUploader::DecodedImage OGLTextureUploader::decode(const String &filename) {
+    DecodedImage image;
+    i32 width(0), height(0), channels(0);
+    image.m_data = SOIL_load_image(filename.c_str(), &width, &height, &channels, SOIL_LOAD_AUTO);
+    if (nullptr == image.m_data) {
+        return image;
+    }
+
+    // swap the texture data
+    const size_t pitch = static_cast<size_t>(width) * channels;
+    for (i32 j = 0; j * 2 < height; ++j) {
+        uc8 *row1 = &image.m_data[j * pitch];
+        uc8 *row2 = &image.m_data[(height - 1 - j) * pitch];
+        for (size_t i = 0; i < pitch; ++i) {
+            const uc8 temp = row1[i];
+            row1[i] = row2[i];
+            row2[i] = temp;
+        }
+    }
+    image.m_width = static_cast<ui32>(width);
+    image.m_height = static_cast<ui32>(height);
+    image.m_channels = static_cast<ui32>(channels);
+
+    return image;
+}
+
+void OGLTextureUploader::allocStorage(PendingUpload &upload) {
+    OGLTexture *tex = upload.m_texture;
+    GLint internalFormat(GL_RGB8);
+    getGLFormat(upload.m_image.m_channels, tex->m_format, internalFormat);
+    tex->m_width = upload.m_image.m_width;
+    tex->m_height = upload.m_image.m_height;
+    tex->m_channels = upload.m_image.m_channels;
+
+    bindTexture(tex);
+    glTexImage2D(tex->m_target, 0, internalFormat, tex->m_width, tex->m_height, 0, tex->m_format,
+            GL_UNSIGNED_BYTE, nullptr);
+}
+
+bool OGLTextureUploader::waitForRegion() {
+    GLsync fence = m_fences[m_ring.m_region];
+    if (nullptr == fence) {
+        return true;
+    }
+
+    const GLenum result = glClientWaitSync(fence, 0, 0);
+    if (GL_TIMEOUT_EXPIRED == result) {
+        ++m_numStalls;
+        return false;
+    }
+    if (GL_WAIT_FAILED == result) {
+        osre_error(Tag, "Waiting for the texture upload region failed.");
+    }
+    glDeleteSync(fence);
+    m_fences[m_ring.m_region] = nullptr;
+
+    return true;
+}
+
+void OGLTextureUploader::bindTexture(OGLTexture *tex) {
+    if (m_stateCache->setActiveTexture(GL_TEXTURE0)) {
+        glActiveTexture(GL_TEXTURE0);
+    }
+    if (m_stateCache->bindTexture(GL_TEXTURE0, tex->m_target, tex->m_textureId)) {
+        glBindTexture(tex->m_target, tex->m_textureId);
+    }
+}
+
+void OGLTextureUploader::bind(GLuint id) {
+    if (nullptr == m_stateCache || m_stateCache->bindBuffer(GL_PIXEL_UNPACK_BUFFER, id)) {
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, id);
+    }
+}
+
+} // Namespace RenderBackend
+} // Namespace OSRE
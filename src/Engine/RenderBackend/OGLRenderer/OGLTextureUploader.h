@@ -0,0 +1,225 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2015-2020 OSRE ( Open Source Render Engine ) by Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#pragma once
+
+#include "OGLCommon.h"
+#include "OGLStreamBuffer.h"
+
+#include <osre/Threading/TTask.h>
+
+namespace OSRE {
+
+namespace Threading {
+    class JobScheduler;
+}
+
+namespace RenderBackend {
+
+class OGLStateCache;
+
+//-------------------------------------------------------------------------------------------------
+///	@ingroup	Engine
+///
+///	@brief  Splits the upload of an image into blocks of whole rows, which fit into the upload
+/// budget of a frame.
+//-------------------------------------------------------------------------------------------------
+struct TextureUploadCursor {
+    ui32 m_width;
+    ui32 m_height;
+    ui32 m_channels;
+    ui32 m_row;
+
+    TextureUploadCursor();
+    void init(ui32 width, ui32 height, ui32 channels);
+    /// @brief  Returns the size of one row in bytes.
+    size_t getRowPitch() const;
+    /// @brief  Returns the number of rows of the next block.
+    /// @param  budget  [in] The number of bytes left in this frame.
+    /// @return The number of rows, 0 if no row fits into the budget or all rows are uploaded.
+    ui32 nextRows(size_t budget) const;
+    /// @brief  Marks the next rows as uploaded.
+    void advance(ui32 rows);
+    /// @brief  Returns true, if all rows are uploaded.
+    bool isDone() const;
+};
+
+inline TextureUploadCursor::TextureUploadCursor() :
+        m_width(0),
+        m_height(0),
+        m_channels(0),
+        m_row(0) {
+    // empty
+}
+
+inline void TextureUploadCursor::init(ui32 width, ui32 height, ui32 channels) {
+    m_width = width;
+    m_height = height;
+    m_channels = channels;
+    m_row = 0;
+}
+
+inline size_t TextureUploadCursor::getRowPitch() const {
+    return static_cast<size_t>(m_width) * m_channels;
+}
+
+inline ui32 TextureUploadCursor::nextRows(size_t budget) const {
+    const size_t pitch = getRowPitch();
+    if (0 == pitch || isDone()) {
+        return 0;
+    }
+
+    const size_t rows = budget / pitch;
+    const ui32 left = m_height - m_row;
+
+    return rows < left ? static_cast<ui32>(rows) : left;
+}
+
+inline void TextureUploadCursor::advance(ui32 rows) {
+    m_row = (m_row + rows) < m_height ? m_row + rows : m_height;
+}
+
+inline bool TextureUploadCursor::isDone() const {
+    return m_row >= m_height;
+}
+
+//-------------------------------------------------------------------------------------------------
+///	@ingroup	Engine
+///
+///	@brief  Streams image files into textures without stalling the render thread.
+///
+/// The files are decoded by the job scheduler. The pixels are copied into a ring of
+/// pixel-unpack buffer regions, one region per frame, and uploaded from there with
+/// glTexSubImage2D. At most the budget is uploaded per frame, so large textures become resident
+/// over several frames. A fence protects each region until the GPU has consumed it, a frame with
+/// a busy region skips the upload instead of waiting.
+//-------------------------------------------------------------------------------------------------
+class OGLTextureUploader {
+public:
+    static const ui32 MaxRegions = OGLStreamBuffer::MaxRegions;
+    /// The default number of bytes uploaded per frame.
+    static const size_t DefaultBudget = 4 * 1024 * 1024;
+    /// The alignment of the row blocks in the buffer.
+    static const size_t Alignment = 16;
+
+    /// The default class constructor.
+    OGLTextureUploader();
+    /// The class destructor.
+    ~OGLTextureUploader();
+    /// @brief  Creates the pixel-unpack buffer.
+    /// @param  stateCache  [in] The state shadow of the backend.
+    /// @param  scheduler   [in] The scheduler for decoding, nullptr to decode on the calling thread.
+    /// @param  budget      [in] The number of bytes to upload per frame.
+    /// @param  numRegions  [in] The number of regions, at most MaxRegions.
+    /// @return true, if the buffer was created.
+    bool create(OGLStateCache *stateCache, Threading::JobScheduler *scheduler, size_t budget,
+            ui32 numRegions = MaxRegions);
+    /// @brief  Releases the buffer and all pending work.
+    void destroy();
+    /// @brief  Returns true, if the uploader was created.
+    bool isCreated() const;
+    /// @brief  Starts decoding the file, the texture stays not resident until update() has
+    /// uploaded all of its pixels.
+    /// @param  tex         [in] The texture without storage.
+    /// @param  filename    [in] The absolute path of the image file.
+    void enqueue(OGLTexture *tex, const String &filename);
+    /// @brief  Drops all pending work of the texture, call before the texture will be released.
+    void cancel(OGLTexture *tex);
+    /// @brief  Allocates the storage of decoded textures and uploads at most the budget into
+    /// them. Call once per frame after all draws were issued.
+    void update();
+    /// @brief  Returns the number of textures, which are not resident yet.
+    size_t getNumPending() const;
+    /// @brief  Returns the number of bytes uploaded by the last update().
+    size_t getNumUploadedBytes() const;
+    /// @brief  Returns the number of frames, which skipped the upload because of a busy region.
+    ui32 getNumStalls() const;
+
+    // No copying
+    OGLTextureUploader(const OGLTextureUploader &) = delete;
+    OGLTextureUploader &operator=(const OGLTextureUploader &) = delete;
+
+private:
+    struct DecodedImage {
+        uc8 *m_data;
+        ui32 m_width;
+        ui32 m_height;
+        ui32 m_channels;
+
+        DecodedImage();
+    };
+
+    struct PendingDecode {
+        OGLTexture *m_texture;
+        Threading::TTask<DecodedImage> m_task;
+    };
+
+    struct PendingUpload {
+        OGLTexture *m_texture;
+        DecodedImage m_image;
+        TextureUploadCursor m_cursor;
+    };
+
+    struct UploadBlock {
+        ui32 m_upload;
+        ui32 m_row;
+        ui32 m_numRows;
+        size_t m_offset;
+    };
+
+    static DecodedImage decode(const String &filename);
+    void allocStorage(PendingUpload &upload);
+    bool waitForRegion();
+    void bindTexture(OGLTexture *tex);
+    void bind(GLuint id);
+
+private:
+    OGLStateCache *m_stateCache;
+    Threading::JobScheduler *m_scheduler;
+    GLuint m_id;
+    StreamRingAllocator m_ring;
+    GLsync m_fences[MaxRegions];
+    CPPCore::TArray<PendingDecode> m_decodes;
+    CPPCore::TArray<PendingUpload> m_uploads;
+    CPPCore::TArray<UploadBlock> m_blocks;
+    size_t m_numUploadedBytes;
+    ui32 m_numStalls;
+};
+
+inline bool OGLTextureUploader::isCreated() const {
+    return 0 != m_id;
+}
+
+inline size_t OGLTextureUploader::getNumPending() const {
+    return m_decodes.size() + m_uploads.size();
+}
+
+inline size_t OGLTextureUploader::getNumUploadedBytes() const {
+    return m_numUploadedBytes;
+}
+
+inline ui32 OGLTextureUploader::getNumStalls() const {
+    return m_numStalls;
+}
+
+} // Namespace RenderBackend
+} // Namespace OSRE
@@ -0,0 +1,223 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2015-2020 OSRE ( Open Source Render Engine ) by Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#include "OGLUniformBlock.h"
+#include <osre/Common/StringUtils.h>
+
+#include <cstring>
+
+namespace OSRE {
+namespace RenderBackend {
+
+static const ui32 Vec4Size = 16;
+
+static ui32 alignTo(ui32 value, ui32 align) {
+    return (value + align - 1) / align * align;
+}
+
+UniformBlockLayout::UniformBlockLayout() :
+        m_members(),
+        m_size(0) {
+    // empty
+}
+
+UniformBlockLayout::~UniformBlockLayout() {
+    // empty
+}
+
+void UniformBlockLayout::clear() {
+    m_members.clear();
+    m_size = 0;
+}
+
+bool UniformBlockLayout::getStd140Info(ParameterType type, ui32 &align, ui32 &itemSize, bool &isArray) {
+    switch (type) {
+        case ParameterType::PT_Int:
+        case ParameterType::PT_IntArray:
+            align = itemSize = sizeof(i32);
+            break;
+        case ParameterType::PT_Float:
+        case ParameterType::PT_FloatArray:
+            align = itemSize = sizeof(f32);
+            break;
+        case ParameterType::PT_Float2:
+        case ParameterType::PT_Float2Array:
+            align = itemSize = sizeof(f32) * 2;
+            break;
+        case ParameterType::PT_Float3:
+        case ParameterType::PT_Float3Array:
+            align = Vec4Size;
+            itemSize = sizeof(f32) * 3;
+            break;
+        case ParameterType::PT_Mat4:
+        case ParameterType::PT_Mat4Array:
+            align = Vec4Size;
+            itemSize = sizeof(f32) * 16;
+            break;
+        default:
+            return false;
+    }
+
+    // Array items are aligned like a vec4
+    isArray = ParameterType::PT_IntArray == type || ParameterType::PT_FloatArray == type ||
+              ParameterType::PT_Float2Array == type || ParameterType::PT_Float3Array == type ||
+              ParameterType::PT_Mat4Array == type;
+    if (isArray) {
+        align = Vec4Size;
+    }
+
+    return true;
+}
+
+bool UniformBlockLayout::addMember(const String &name, ParameterType type, ui32 numItems) {
+    ui32 align(0), itemSize(0);
+    bool isArray(false);
+    if (!getStd140Info(type, align, itemSize, isArray)) {
+        return false;
+    }
+
+    Member member;
+    member.m_name = name;
+    member.m_hash = Common::StringUtils::hashName(name);
+    member.m_type = type;
+    member.m_numItems = isArray ? numItems : 1;
+    member.m_offset = alignTo(m_size, align);
+    member.m_itemSize = itemSize;
+    member.m_stride = isArray ? alignTo(itemSize, Vec4Size) : itemSize;
+    m_members.add(member);
+
+    const ui32 end = member.m_offset + member.m_stride * member.m_numItems;
+    m_size = alignTo(end, Vec4Size);
+    // Members following a non-array member may use its padding
+    if (!isArray) {
+        m_size = end;
+    }
+
+    return true;
+}
+
+void UniformBlockLayout::build(const ::CPPCore::TArray<UniformVar *> &vars) {
+    clear();
+    for (ui32 i = 0; i < vars.size(); ++i) {
+        if (nullptr != vars[i]) {
+            addMember(vars[i]->m_name, vars[i]->m_type, vars[i]->m_numItems);
+        }
+    }
+    m_size = alignTo(m_size, Vec4Size);
+}
+
+const UniformBlockLayout::Member *UniformBlockLayout::findMember(const String &name) const {
+    return findMember(Common::StringUtils::hashName(name));
+}
+
+const UniformBlockLayout::Member *UniformBlockLayout::findMember(HashId hash) const {
+    for (ui32 i = 0; i < m_members.size(); ++i) {
+        if (m_members[i].m_hash == hash) {
+            return &m_members[i];
+        }
+    }
+
+    return nullptr;
+}
+
+bool UniformBlockLayout::pack(const Member &member, const void *data, size_t size, c8 *block) const {
+    if (nullptr == data || nullptr == block) {
+        return false;
+    }
+
+    bool changed(false);
+    const c8 *src = static_cast<const c8 *>(data);
+    for (ui32 i = 0; i < member.m_numItems; ++i) {
+        const size_t srcOffset = static_cast<size_t>(i) * member.m_itemSize;
+        if (srcOffset + member.m_itemSize > size) {
+            break;
+        }
+
+        c8 *dest = &block[member.m_offset + i * member.m_stride];
+        if (0 != ::memcmp(dest, &src[srcOffset], member.m_itemSize)) {
+            ::memcpy(dest, &src[srcOffset], member.m_itemSize);
+            changed = true;
+        }
+    }
+
+    return changed;
+}
+
+static const c8 *getGLSLTypeName(ParameterType type) {
+    switch (type) {
+        case ParameterType::PT_Int:
+        case ParameterType::PT_IntArray:
+            return "int";
+        case ParameterType::PT_Float:
+        case ParameterType::PT_FloatArray:
+            return "float";
+        case ParameterType::PT_Float2:
+        case ParameterType::PT_Float2Array:
+            return "vec2";
+        case ParameterType::PT_Float3:
+        case ParameterType::PT_Float3Array:
+            return "vec3";
+        case ParameterType::PT_Mat4:
+        case ParameterType::PT_Mat4Array:
+            return "mat4";
+        default:
+            break;
+    }
+
+    return "";
+}
+
+String UniformBlockLayout::getGLSLDeclaration(const String &blockName) const {
+    String decl = "layout(std140) uniform " + blockName + " {\n";
+    for (ui32 i = 0; i < m_members.size(); ++i) {
+        const Member &member = m_members[i];
+        ui32 align(0), itemSize(0);
+        bool isArray(false);
+        getStd140Info(member.m_type, align, itemSize, isArray);
+        decl += "    " + String(getGLSLTypeName(member.m_type)) + " " + member.m_name;
+        if (isArray) {
+            decl += "[" + osre_to_string(member.m_numItems) + "]";
+        }
+        decl += ";\n";
+    }
+    decl += "};\n";
+
+    return decl;
+}
+
+OGLUniformBlock::OGLUniformBlock() :
+        m_name(),
+        m_blockName(),
+        m_bindingPoint(0),
+        m_buffer(nullptr),
+        m_layout(),
+        m_staging(),
+        m_dirty(false) {
+    // empty
+}
+
+OGLUniformBlock::~OGLUniformBlock() {
+    // empty
+}
+
+} // Namespace RenderBackend
+} // Namespace OSRE
@@ -0,0 +1,109 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2015-2020 OSRE ( Open Source Render Engine ) by Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#pragma once
+
+#include <osre/Common/osre_common.h>
+#include <osre/RenderBackend/RenderCommon.h>
+#include <cppcore/Container/TArray.h>
+
+namespace OSRE {
+namespace RenderBackend {
+
+struct OGLBuffer;
+
+//-------------------------------------------------------------------------------------------------
+///	@ingroup	Engine
+///
+///	@brief  The std140 layout of a set of uniform variables. Scalars are aligned to their size,
+/// vec3 and mat4 to 16 bytes and each array item is padded to 16 bytes, the block size is a
+/// multiple of 16 bytes.
+//-------------------------------------------------------------------------------------------------
+struct UniformBlockLayout {
+    struct Member {
+        String m_name;
+        HashId m_hash;
+        ParameterType m_type;
+        ui32 m_numItems;
+        ui32 m_offset;
+        ui32 m_itemSize;
+        ui32 m_stride;
+    };
+
+    ::CPPCore::TArray<Member> m_members;
+    ui32 m_size;
+
+    /// The default class constructor.
+    UniformBlockLayout();
+    /// The class destructor.
+    ~UniformBlockLayout();
+    /// @brief  Removes all members.
+    void clear();
+    /// @brief  Appends a member, returns false for unsupported types.
+    bool addMember(const String &name, ParameterType type, ui32 numItems);
+    /// @brief  Builds the layout for all variables in the given order.
+    void build(const ::CPPCore::TArray<UniformVar *> &vars);
+    /// @brief  Returns the member with the given name or nullptr.
+    const Member *findMember(const String &name) const;
+    /// @brief  Returns the member with the given hashed name or nullptr.
+    const Member *findMember(HashId hash) const;
+    /// @brief  Copies tightly packed data of a member into the std140 block.
+    /// @param  member  [in] The member to write.
+    /// @param  data    [in] The tightly packed data, as stored in UniformVar.
+    /// @param  size    [in] The size of the data in bytes.
+    /// @param  block   [inout] The block, must be m_size bytes.
+    /// @return true, if the block content was changed.
+    bool pack(const Member &member, const void *data, size_t size, c8 *block) const;
+    /// @brief  Returns the GLSL declaration of the block.
+    String getGLSLDeclaration(const String &blockName) const;
+    /// @brief  Returns the std140 base alignment and the size of one item of a type.
+    static bool getStd140Info(ParameterType type, ui32 &align, ui32 &itemSize, bool &isArray);
+};
+
+//-------------------------------------------------------------------------------------------------
+///	@ingroup	Engine
+///
+///	@brief  A uniform buffer object with a std140 layout. The data is staged on the CPU and
+/// uploaded once per change, the block is bound to the binding point of its GLSL block name.
+//-------------------------------------------------------------------------------------------------
+struct OGLUniformBlock {
+    String m_name;
+    String m_blockName;
+    ui32 m_bindingPoint;
+    OGLBuffer *m_buffer;
+    UniformBlockLayout m_layout;
+    MemoryBuffer m_staging;
+    bool m_dirty;
+
+    OGLUniformBlock();
+    ~OGLUniformBlock();
+
+    OSRE_NON_COPYABLE(OGLUniformBlock)
+};
+
+/// The GLSL name of the per-frame camera block.
+static const c8 *const CameraBlockName = "CameraBlock";
+/// The GLSL name of the per-batch block.
+static const c8 *const BatchBlockName = "BatchBlock";
+
+} // Namespace RenderBackend
+} // Namespace OSRE
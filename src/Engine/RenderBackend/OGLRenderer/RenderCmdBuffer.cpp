@@ -23,9 +23,12 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <osre/RenderBackend/Shader.h>
 #include "Engine/RenderBackend/OGLRenderer/RenderCmdBuffer.h"
 #include "OGLCommon.h"
+#include "OGLIndirectDrawBuffer.h"
 #include "OGLRenderBackend.h"
+#include "OGLShader.h"
 #include <osre/Debugging/osre_debugging.h>
 #include <osre/Platform/AbstractOGLRenderContext.h>
+#include <osre/Profiling/PerformanceCounterRegistry.h>
 
 namespace OSRE {
 namespace RenderBackend {
@@ -38,12 +41,25 @@ static const c8 *Tag = "RenderCmdBuffer";
 RenderCmdBuffer::RenderCmdBuffer(OGLRenderBackend *renderBackend, AbstractOGLRenderContext *ctx, Pipeline *pipeline) :
         m_renderbackend(renderBackend),
         m_renderCtx(ctx),
+        m_cmdbuffer(),
+        m_cmdPasses(),
+        m_drawItems(),
+        m_sortScratch(),
+        m_shaderIds(),
+        m_materialIds(),
+        m_activePass(0),
+        m_sortDirty(false),
+        m_numStateChangesSaved(0),
+        m_lastMaterial(nullptr),
         m_activeShader(nullptr),
         m_2dShader(nullptr),
         m_primitives(),
         m_materials(),
         m_paramArray(),
+        m_paramSlots(),
         m_matrixBuffer(),
+        m_uniformBlocks(),
+        m_indirectDraws(nullptr),
         m_pipeline(pipeline) {
     OSRE_ASSERT(nullptr != m_renderbackend);
     OSRE_ASSERT(nullptr != m_renderCtx);
@@ -54,6 +70,8 @@ RenderCmdBuffer::RenderCmdBuffer(OGLRenderBackend *renderBackend, AbstractOGLRen
 
 RenderCmdBuffer::~RenderCmdBuffer() {
     clear();
+    delete m_indirectDraws;
+    m_indirectDraws = nullptr;
 
     m_renderbackend = nullptr;
     m_renderCtx = nullptr;
@@ -79,6 +97,8 @@ void RenderCmdBuffer::enqueueRenderCmd(OGLRenderCmd *renderCmd, EnqueueType type
 
     if (EnqueueType::PushBack == type) {
         m_cmdbuffer.add(renderCmd);
+        m_cmdPasses.add(m_activePass);
+        m_sortDirty = true;
     }
 }
 
@@ -95,6 +115,10 @@ void RenderCmdBuffer::enqueueRenderCmdGroup(const String &groupName, CPPCore::TA
 
     if (EnqueueType::PushBack == type) {
         m_cmdbuffer.add(&cmdGroup[0], cmdGroup.size());
+        for (ui32 i = 0; i < cmdGroup.size(); ++i) {
+            m_cmdPasses.add(m_activePass);
+        }
+        m_sortDirty = true;
     }
 }
 
@@ -117,6 +141,16 @@ void RenderCmdBuffer::onRenderFrame(const EventData *) {
         return;
     }
 
+    if (m_sortDirty) {
+        sortDrawItems();
+    }
+
+    // Programs linked in the background are used from this frame on
+    m_renderbackend->updatePendingShaders();
+
+    // Upload the uniform blocks changed by the last commit once
+    m_renderbackend->commitUniformBlocks();
+
     for (ui32 passId = 0; passId < numPasses; passId++) {
         PipelinePass *pass = m_pipeline->beginPass(passId);
         if (nullptr == pass) {
@@ -132,25 +166,23 @@ void RenderCmdBuffer::onRenderFrame(const EventData *) {
         states.m_stencilState = pass->getStencilState();
         m_renderbackend->setFixedPipelineStates(states);
 
-        for (ui32 i = 0; i < m_cmdbuffer.size(); ++i) {
-            // only valid pointers are allowed
-            OGLRenderCmd *renderCmd = m_cmdbuffer[i];
-            OSRE_ASSERT(nullptr != renderCmd);
-            if (nullptr == renderCmd) {
+        m_lastMaterial = nullptr;
+        for (ui32 i = 0; i < m_drawItems.size();) {
+            const ui32 numMerged = nullptr != m_indirectDraws ? executeIndirectItems(i) : 0;
+            if (0 != numMerged) {
+                i += numMerged;
                 continue;
             }
 
-            if (renderCmd->m_type == OGLRenderCmdType::DrawPrimitivesCmd) {
-                onDrawPrimitivesCmd((DrawPrimitivesCmdData *)renderCmd->m_data);
-            } else if (renderCmd->m_type == OGLRenderCmdType::DrawPrimitivesInstancesCmd) {
-                onDrawPrimitivesInstancesCmd((DrawInstancePrimitivesCmdData *)renderCmd->m_data);
-            } else if (renderCmd->m_type == OGLRenderCmdType::SetRenderTargetCmd) {
-                onSetRenderTargetCmd((SetRenderTargetCmdData *)renderCmd->m_data);
-            } else if (renderCmd->m_type == OGLRenderCmdType::SetMaterialCmd) {
-                onSetMaterialStageCmd((SetMaterialStageCmdData *)renderCmd->m_data);
-            } else {
-                osre_error(Tag, "Unsupported render command type: " + static_cast<ui32>(renderCmd->m_type));
+            const DrawItem &item = m_drawItems[i];
+            if (isPending(item)) {
+                ++i;
+                continue;
             }
+            for (ui32 j = item.m_firstCmd; j < item.m_firstCmd + item.m_numCmds; ++j) {
+                executeRenderCmd(m_cmdbuffer[j]);
+            }
+            ++i;
         }
 
         m_pipeline->endPass(passId);
@@ -160,6 +192,132 @@ void RenderCmdBuffer::onRenderFrame(const EventData *) {
     m_renderbackend->renderFrame();
 }
 
+void RenderCmdBuffer::executeRenderCmd(OGLRenderCmd *renderCmd) {
+    // only valid pointers are allowed
+    OSRE_ASSERT(nullptr != renderCmd);
+    if (nullptr == renderCmd) {
+        return;
+    }
+
+    switch (renderCmd->m_type) {
+        case OGLRenderCmdType::DrawPrimitivesCmd:
+            onDrawPrimitivesCmd((DrawPrimitivesCmdData *)renderCmd->m_data);
+            break;
+        case OGLRenderCmdType::DrawPrimitivesInstancesCmd:
+            onDrawPrimitivesInstancesCmd((DrawInstancePrimitivesCmdData *)renderCmd->m_data);
+            break;
+        case OGLRenderCmdType::SetRenderTargetCmd:
+            onSetRenderTargetCmd((SetRenderTargetCmdData *)renderCmd->m_data);
+            break;
+        case OGLRenderCmdType::SetMaterialCmd:
+            onSetMaterialStageCmd((SetMaterialStageCmdData *)renderCmd->m_data);
+            break;
+        default:
+            osre_error(Tag, "Unsupported render command type: " + osre_to_string(static_cast<ui32>(renderCmd->m_type)));
+            break;
+    }
+}
+
+static ui64 hashTextureSet(const ::CPPCore::TArray<OGLTexture *> &textures) {
+    ui64 hash = 14695981039346656037ULL;
+    for (ui32 i = 0; i < textures.size(); ++i) {
+        hash ^= static_cast<ui64>(reinterpret_cast<size_t>(textures[i]));
+        hash *= 1099511628211ULL;
+    }
+
+    return hash;
+}
+
+template <class TKey>
+static ui32 getDenseId(std::map<TKey, ui32> &ids, const TKey &key) {
+    typename std::map<TKey, ui32>::const_iterator it(ids.find(key));
+    if (ids.end() != it) {
+        return it->second;
+    }
+
+    const ui32 id = static_cast<ui32>(ids.size());
+    ids[key] = id;
+
+    return id;
+}
+
+void RenderCmdBuffer::sortDrawItems() {
+    m_drawItems.resize(0);
+    ui32 layer(0);
+    bool layerOverflow(false);
+    DrawItem *current(nullptr);
+    for (ui32 i = 0; i < m_cmdbuffer.size(); ++i) {
+        OGLRenderCmd *renderCmd = m_cmdbuffer[i];
+        if (nullptr == renderCmd) {
+            continue;
+        }
+
+        const ui32 pass = m_cmdPasses[i];
+        DrawItem item;
+        item.m_firstCmd = i;
+        item.m_numCmds = 1;
+        switch (renderCmd->m_type) {
+            case OGLRenderCmdType::SetRenderTargetCmd:
+                // Nothing is moved across a render target switch
+                if (layer + 2 > RenderSortKey::MaxLayer) {
+                    layerOverflow = true;
+                } else {
+                    ++layer;
+                }
+                item.m_key = RenderSortKey::encode(pass, layer, 0, 0, 0);
+                m_drawItems.add(item);
+                if (!layerOverflow) {
+                    ++layer;
+                }
+                current = nullptr;
+                break;
+
+            case OGLRenderCmdType::SetMaterialCmd: {
+                SetMaterialStageCmdData *data = (SetMaterialStageCmdData *)renderCmd->m_data;
+                const ui32 shaderId = getDenseId(m_shaderIds, data->m_shader);
+                const ui32 materialId = getDenseId(m_materialIds, hashTextureSet(data->m_textures));
+                item.m_key = RenderSortKey::encode(pass, layer, shaderId, materialId, 0);
+                m_drawItems.add(item);
+                current = &m_drawItems[m_drawItems.size() - 1];
+            } break;
+
+            default:
+                if (nullptr == current) {
+                    item.m_key = RenderSortKey::encode(pass, layer, 0, 0, 0);
+                    m_drawItems.add(item);
+                    current = &m_drawItems[m_drawItems.size() - 1];
+                    break;
+                }
+
+                // The first draw with a local matrix defines the depth of the item
+                ++current->m_numCmds;
+                if (OGLRenderCmdType::DrawPrimitivesCmd == renderCmd->m_type && 0 == RenderSortKey::getDepth(current->m_key)) {
+                    DrawPrimitivesCmdData *data = (DrawPrimitivesCmdData *)renderCmd->m_data;
+                    if (data->m_localMatrix) {
+                        const glm::vec4 viewPos = m_view * data->m_model[3];
+                        current->m_key |= RenderSortKey::quantizeDepth(-viewPos.z);
+                    }
+                }
+                break;
+        }
+    }
+
+    m_numStateChangesSaved = 0;
+    if (layerOverflow) {
+        // The layers would wrap and move draws across render targets, so the order is kept
+        osre_debug(Tag, "Too many render target switches, draws are not sorted.");
+    } else {
+        // Material ids are shared by the shaders, so sorting may add changes in rare orders
+        const ui32 unsortedChanges = countStateChanges(m_drawItems);
+        radixSortDrawItems(m_drawItems, m_sortScratch);
+        const ui32 sortedChanges = countStateChanges(m_drawItems);
+        m_numStateChangesSaved = unsortedChanges > sortedChanges ? unsortedChanges - sortedChanges : 0;
+    }
+    Profiling::PerformanceCounterRegistry::setCounter("state_changes_saved", m_numStateChangesSaved);
+
+    m_sortDirty = false;
+}
+
 void RenderCmdBuffer::onPostRenderFrame() {
     OSRE_ASSERT(nullptr != m_renderbackend);
 
@@ -170,29 +328,41 @@ void RenderCmdBuffer::onPostRenderFrame() {
 
 void RenderCmdBuffer::clear() {
     ContainerClear(m_cmdbuffer);
+    m_cmdPasses.resize(0);
+    m_drawItems.resize(0);
+    m_shaderIds.clear();
+    m_materialIds.clear();
+    m_sortDirty = false;
+    m_lastMaterial = nullptr;
     m_paramArray.resize(0);
+    m_paramSlots.resize(0);
+    m_uniformBlocks.clear();
 }
 
-static bool hasParam(const String &name, const ::CPPCore::TArray<OGLParameter *> &paramArray) {
-    for (ui32 i = 0; i < paramArray.size(); i++) {
-        if (name == paramArray[i]->m_name) {
-            return true;
-        }
-    }
-    return false;
+bool RenderCmdBuffer::hasParam(const OGLParameter *param) const {
+    return param->m_handle < m_paramSlots.size() && 0 != m_paramSlots[param->m_handle];
 }
 
 void RenderCmdBuffer::setParameter(OGLParameter *param) {
-    if (!hasParam(param->m_name, m_paramArray)) {
-        m_paramArray.add(param);
+    if (nullptr == param || hasParam(param)) {
+        return;
+    }
+
+    // The parameters are interned, the slot of a handle stores its index + 1
+    if (param->m_handle >= m_paramSlots.size()) {
+        const size_t oldSize = m_paramSlots.size();
+        m_paramSlots.resize(param->m_handle + 1);
+        for (size_t i = oldSize; i < m_paramSlots.size(); ++i) {
+            m_paramSlots[i] = 0;
+        }
     }
+    m_paramArray.add(param);
+    m_paramSlots[param->m_handle] = static_cast<ui32>(m_paramArray.size());
 }
 
 void RenderCmdBuffer::setParameter(const ::CPPCore::TArray<OGLParameter *> &paramArray) {
     for (ui32 i = 0; i < paramArray.size(); i++) {
-        if (!hasParam(paramArray[i]->m_name, m_paramArray)) {
-            m_paramArray.add(paramArray[i]);
-        }
+        setParameter(paramArray[i]);
     }
 }
 
@@ -213,10 +383,143 @@ void RenderCmdBuffer::setMatrixes(const glm::mat4 &model, const glm::mat4 &view,
     m_proj = proj;
 }
 
-void RenderCmdBuffer::setMatrixBuffer(const c8 *id, MatrixBuffer *buffer) {
+void RenderCmdBuffer::setMatrixBuffer(const c8 *id, const MatrixBuffer *buffer) {
+    OSRE_ASSERT(nullptr != id);
+    if (nullptr == buffer) {
+        return;
+    }
+
+    m_matrixBuffer[id] = *buffer;
+}
+
+void RenderCmdBuffer::setIndirectDraws(bool enabled) {
+    if (!enabled) {
+        delete m_indirectDraws;
+        m_indirectDraws = nullptr;
+    } else if (nullptr == m_indirectDraws) {
+        m_indirectDraws = new OGLIndirectDrawBuffer;
+    }
+}
+
+bool RenderCmdBuffer::isPending(const DrawItem &item) const {
+    OGLRenderCmd *cmd = m_cmdbuffer[item.m_firstCmd];
+    if (nullptr == cmd || OGLRenderCmdType::SetMaterialCmd != cmd->m_type) {
+        return false;
+    }
+
+    // The material is ready, when its program has been linked
+    const SetMaterialStageCmdData *data = (const SetMaterialStageCmdData *)cmd->m_data;
+    return nullptr != data->m_shader && data->m_shader->isLinkPending();
+}
+
+static bool isSameState(ui64 key0, ui64 key1) {
+    // The depth only orders the items, it does not change any state
+    return RenderSortKey::getPass(key0) == RenderSortKey::getPass(key1) &&
+           RenderSortKey::getLayer(key0) == RenderSortKey::getLayer(key1) &&
+           RenderSortKey::getShader(key0) == RenderSortKey::getShader(key1) &&
+           RenderSortKey::getMaterial(key0) == RenderSortKey::getMaterial(key1);
+}
+
+ui32 RenderCmdBuffer::executeIndirectItems(ui32 firstItem) {
+    const DrawItem &first = m_drawItems[firstItem];
+    OGLRenderCmd *materialCmd = m_cmdbuffer[first.m_firstCmd];
+    if (nullptr == materialCmd || OGLRenderCmdType::SetMaterialCmd != materialCmd->m_type) {
+        return 0;
+    }
+
+    if (isPending(first)) {
+        return 0;
+    }
+
+    SetMaterialStageCmdData *material = (SetMaterialStageCmdData *)materialCmd->m_data;
+    OGLVertexArray *vertexArray = material->m_vertexArray;
+    const bool usesDrawData = nullptr != material->m_shader && material->m_shader->usesDrawData();
+    m_indirectDraws->clear();
+    const c8 *id = nullptr;
+    ui32 numItems(0);
+    for (ui32 i = firstItem; i < m_drawItems.size(); ++i) {
+        const DrawItem &item = m_drawItems[i];
+        if (!isSameState(first.m_key, item.m_key)) {
+            break;
+        }
+
+        OGLRenderCmd *cmd = m_cmdbuffer[item.m_firstCmd];
+        if (nullptr == cmd || OGLRenderCmdType::SetMaterialCmd != cmd->m_type ||
+                ((SetMaterialStageCmdData *)cmd->m_data)->m_vertexArray != vertexArray) {
+            break;
+        }
+        if (!appendIndirectDraws(item, vertexArray, usesDrawData, id)) {
+            break;
+        }
+        ++numItems;
+    }
+
+    // A single draw is not worth the upload of the commands
+    if (m_indirectDraws->getNumDraws() < 2) {
+        return 0;
+    }
+
+    executeRenderCmd(materialCmd);
+    std::map<const char *, MatrixBuffer>::const_iterator it = m_matrixBuffer.find(id);
+    if (it != m_matrixBuffer.end()) {
+        const MatrixBuffer &buffer = it->second;
+        setMatrixes(buffer.m_model, buffer.m_view, buffer.m_proj);
+    }
+    bindUniformBlock(id);
+    m_renderbackend->bindVertexArray(vertexArray);
+    if (!m_renderbackend->renderIndirect(*m_indirectDraws)) {
+        return 0;
+    }
+
+    return numItems;
+}
+
+bool RenderCmdBuffer::appendIndirectDraws(const DrawItem &item, OGLVertexArray *vertexArray, bool usesDrawData, const c8 *&id) {
+    const size_t numDraws = m_indirectDraws->getNumDraws();
+    for (ui32 i = item.m_firstCmd + 1; i < item.m_firstCmd + item.m_numCmds; ++i) {
+        OGLRenderCmd *cmd = m_cmdbuffer[i];
+        if (nullptr == cmd || OGLRenderCmdType::DrawPrimitivesCmd != cmd->m_type) {
+            m_indirectDraws->resize(numDraws);
+            return false;
+        }
+
+        // Local matrices can only be read from the per-draw data, the batch state must be shared
+        DrawPrimitivesCmdData *data = (DrawPrimitivesCmdData *)cmd->m_data;
+        if (data->m_vertexArray != vertexArray || (data->m_localMatrix && !usesDrawData) ||
+                (nullptr != id && id != data->m_id)) {
+            m_indirectDraws->resize(numDraws);
+            return false;
+        }
+        id = data->m_id;
+
+        const glm::mat4 &model = data->m_localMatrix ? data->m_model : m_model;
+        for (ui32 j = 0; j < data->m_primitives.size(); ++j) {
+            OGLPrimGroup *grp = m_renderbackend->getPrimitiveGroup(data->m_primitives[j]);
+            if (nullptr == grp || !m_indirectDraws->addDraw(*grp, model)) {
+                m_indirectDraws->resize(numDraws);
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+void RenderCmdBuffer::setUniformBlock(const c8 *id, OGLUniformBlock *block) {
     OSRE_ASSERT(nullptr != id);
 
-    m_matrixBuffer[id] = buffer;
+    m_uniformBlocks[id] = block;
+}
+
+void RenderCmdBuffer::bindUniformBlock(const c8 *id) {
+    if (m_uniformBlocks.empty()) {
+        return;
+    }
+
+    std::map<const char *, OGLUniformBlock *>::const_iterator it = m_uniformBlocks.find(id);
+    if (it != m_uniformBlocks.end()) {
+        m_renderbackend->bindUniformBlock(it->second);
+    }
 }
 
 bool RenderCmdBuffer::onDrawPrimitivesCmd(DrawPrimitivesCmdData *data) {
@@ -225,12 +528,13 @@ bool RenderCmdBuffer::onDrawPrimitivesCmd(DrawPrimitivesCmdData *data) {
         return false;
     }
 
-    std::map<const char *, MatrixBuffer *>::iterator it = m_matrixBuffer.find(data->m_id);
+    std::map<const char *, MatrixBuffer>::const_iterator it = m_matrixBuffer.find(data->m_id);
     if (it != m_matrixBuffer.end()) {
-        MatrixBuffer *buffer = it->second;
-        setMatrixes(buffer->m_model, buffer->m_view, buffer->m_proj);
+        const MatrixBuffer &buffer = it->second;
+        setMatrixes(buffer.m_model, buffer.m_view, buffer.m_proj);
     }
 
+    bindUniformBlock(data->m_id);
     m_renderbackend->bindVertexArray(data->m_vertexArray);
     if (data->m_localMatrix) {
         m_renderbackend->setMatrix(MatrixType::Model, data->m_model);
@@ -249,6 +553,7 @@ bool RenderCmdBuffer::onDrawPrimitivesInstancesCmd(DrawInstancePrimitivesCmdData
         return false;
     }
 
+    bindUniformBlock(data->m_id);
     m_renderbackend->bindVertexArray(data->m_vertexArray);
     for (size_t i = 0; i < data->m_primitives.size(); i++) {
         m_renderbackend->render(data->m_primitives[i], data->m_numInstances);
@@ -308,6 +613,16 @@ bool RenderCmdBuffer::onSetMaterialStageCmd(SetMaterialStageCmdData *data) {
 
     commitParameters();
 
+    // Sorted draws share their texture set with the previous one most of the time
+    bool sameTextures = nullptr != m_lastMaterial && m_lastMaterial->m_textures.size() == data->m_textures.size();
+    for (ui32 i = 0; sameTextures && i < data->m_textures.size(); ++i) {
+        sameTextures = m_lastMaterial->m_textures[i] == data->m_textures[i];
+    }
+    m_lastMaterial = data;
+    if (sameTextures) {
+        return true;
+    }
+
     for (ui32 i = 0; i < data->m_textures.size(); ++i) {
         OGLTexture *oglTexture = data->m_textures[i];
         if (nullptr != oglTexture) {
@@ -25,6 +25,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <cppcore/Container/TArray.h>
 #include <osre/Math/BaseMath.h>
 #include <osre/RenderBackend/RenderStates.h>
+#include "RenderSortKey.h"
 
 #include <map>
 
@@ -43,6 +44,7 @@ namespace RenderBackend {
 
 class OGLRenderBackend;
 class OGLShader;
+class OGLIndirectDrawBuffer;
 class Pipeline;
 
 struct OGLVertexArray;
@@ -56,12 +58,21 @@ struct DrawTextCmdData;
 struct PrimitiveGroup;
 struct Material;
 struct OGLParameter;
+struct OGLUniformBlock;
 
 //-------------------------------------------------------------------------------------------------
 ///	@ingroup	Engine
 ///
 ///	@brief  This class is used to manage a render command buffer. Render command buffers are used
 /// to store the list of render ops for rendering one single render frame.
+///
+/// A material command and the draws following it form one draw item. The items get a sort key
+/// (@see RenderSortKey) and are radix-sorted whenever commands were added, so draws sharing a
+/// shader or a texture set are rendered back to back. Render target commands start a new layer,
+/// draws are never moved across them.
+///
+/// With indirect draws enabled, neighbouring items sharing the state and the vertex array are
+/// merged into one multi-draw.
 //-------------------------------------------------------------------------------------------------
 class RenderCmdBuffer {
 public:
@@ -80,6 +91,8 @@ public:
     void setActiveShader(OGLShader *oglShader);
     /// Will return the active shader.
     OGLShader *getActiveShader() const;
+    /// Will set the index of the pass the following commands belong to.
+    void setActivePass(ui32 passIdx);
     /// Will enqueue a new render command.
     void enqueueRenderCmd(OGLRenderCmd *renderCmd, EnqueueType type = EnqueueType::PushBack);
     /// Will enqueue a new render command group.
@@ -101,7 +114,13 @@ public:
     ///
     void setMatrixes(const glm::mat4 &model, const glm::mat4 &view, const glm::mat4 &proj);
     ///
-    void setMatrixBuffer(const c8 *id, MatrixBuffer *buffer);
+    void setMatrixBuffer(const c8 *id, const MatrixBuffer *buffer);
+    /// Assigns the uniform block which will be bound for the draws of a batch.
+    void setUniformBlock(const c8 *id, OGLUniformBlock *block);
+    /// Returns the number of shader and material switches saved by sorting the draws.
+    ui32 getNumStateChangesSaved() const;
+    /// Enables merging draws of shared vertex arrays into indirect multi-draws.
+    void setIndirectDraws(bool enabled);
 
 protected:
     /// The draw primitive callback.
@@ -114,19 +133,46 @@ protected:
     virtual bool onSetRenderTargetCmd(SetRenderTargetCmdData *data);
     /// The set material callback.
     virtual bool onSetMaterialStageCmd(SetMaterialStageCmdData *data);
+    /// Dispatches one render command.
+    void executeRenderCmd(OGLRenderCmd *renderCmd);
+    /// Builds the sort keys of the draw items and sorts them.
+    void sortDrawItems();
+    /// Binds the uniform block of the batch.
+    void bindUniformBlock(const c8 *id);
+    /// Returns true, if the parameter was already added.
+    bool hasParam(const OGLParameter *param) const;
+    /// Renders the items starting at the given one with one indirect draw, returns the number
+    /// of rendered items or 0, when the items cannot be merged.
+    ui32 executeIndirectItems(ui32 firstItem);
+    /// Appends the draws of an item to the indirect draws, all or none of them.
+    bool appendIndirectDraws(const DrawItem &item, OGLVertexArray *vertexArray, bool usesDrawData, const c8 *&id);
+    /// Returns true, when the program of the item's material is still linking, its draws are skipped.
+    bool isPending(const DrawItem &item) const;
 
 private:
     OGLRenderBackend *m_renderbackend;
     ClearState m_clearState;
     Platform::AbstractOGLRenderContext *m_renderCtx;
     ::CPPCore::TArray<OGLRenderCmd *> m_cmdbuffer;
+    ::CPPCore::TArray<ui32> m_cmdPasses;
+    ::CPPCore::TArray<DrawItem> m_drawItems;
+    ::CPPCore::TArray<DrawItem> m_sortScratch;
+    std::map<OGLShader *, ui32> m_shaderIds;
+    std::map<ui64, ui32> m_materialIds;
+    ui32 m_activePass;
+    bool m_sortDirty;
+    ui32 m_numStateChangesSaved;
+    SetMaterialStageCmdData *m_lastMaterial;
     OGLShader *m_activeShader;
     OGLShader *m_2dShader;
     ::CPPCore::TArray<PrimitiveGroup *> m_primitives;
     ::CPPCore::TArray<Material *> m_materials;
     ::CPPCore::TArray<OGLParameter *> m_paramArray;
+    ::CPPCore::TArray<ui32> m_paramSlots;
 
-    std::map<const char *, MatrixBuffer *> m_matrixBuffer;
+    std::map<const char *, MatrixBuffer> m_matrixBuffer;
+    std::map<const char *, OGLUniformBlock *> m_uniformBlocks;
+    OGLIndirectDrawBuffer *m_indirectDraws;
 
     glm::mat4 m_model;
     glm::mat4 m_view;
@@ -134,5 +180,13 @@ private:
     Pipeline *m_pipeline;
 };
 
+inline void RenderCmdBuffer::setActivePass(ui32 passIdx) {
+    m_activePass = passIdx;
+}
+
+inline ui32 RenderCmdBuffer::getNumStateChangesSaved() const {
+    return m_numStateChangesSaved;
+}
+
 } // Namespace RenderBackend
 } // Namespace OSRE
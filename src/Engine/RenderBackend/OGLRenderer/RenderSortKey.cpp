@@ -0,0 +1,110 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2015-2020 OSRE ( Open Source Render Engine ) by Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#include "RenderSortKey.h"
+
+#include <cstring>
+
+namespace OSRE {
+namespace RenderBackend {
+
+const ui32 RenderSortKey::MaxLayer;
+
+ui32 RenderSortKey::quantizeDepth(f32 viewDistance) {
+    if (!(viewDistance > 0.0f)) {
+        return 0;
+    }
+
+    // The bits of a positive float are ordered like its value, keep the exponent and the upper
+    // mantissa bits
+    ui32 bits(0);
+    ::memcpy(&bits, &viewDistance, sizeof(bits));
+
+    return bits >> (31 - DepthBits);
+}
+
+void radixSortDrawItems(::CPPCore::TArray<DrawItem> &items, ::CPPCore::TArray<DrawItem> &scratch) {
+    const size_t numItems = items.size();
+    if (numItems < 2) {
+        return;
+    }
+    scratch.resize(numItems);
+
+    DrawItem *src = &items[0];
+    DrawItem *dst = &scratch[0];
+    size_t histogram[256];
+    for (ui32 shift = 0; shift < 64; shift += 8) {
+        ::memset(histogram, 0, sizeof(histogram));
+        for (size_t i = 0; i < numItems; ++i) {
+            ++histogram[(src[i].m_key >> shift) & 0xff];
+        }
+
+        // All keys share this byte, nothing to reorder
+        if (numItems == histogram[(src[0].m_key >> shift) & 0xff]) {
+            continue;
+        }
+
+        size_t offset(0);
+        for (ui32 bucket = 0; bucket < 256; ++bucket) {
+            const size_t count = histogram[bucket];
+            histogram[bucket] = offset;
+            offset += count;
+        }
+
+        for (size_t i = 0; i < numItems; ++i) {
+            dst[histogram[(src[i].m_key >> shift) & 0xff]++] = src[i];
+        }
+
+        DrawItem *tmp = src;
+        src = dst;
+        dst = tmp;
+    }
+
+    // An odd number of passes leaves the result in the scratch buffer
+    if (src != &items[0]) {
+        ::memcpy(&items[0], src, numItems * sizeof(DrawItem));
+    }
+}
+
+ui32 countStateChanges(const ::CPPCore::TArray<DrawItem> &items) {
+    ui32 numChanges(0);
+    for (size_t i = 0; i < items.size(); ++i) {
+        const ui64 key = items[i].m_key;
+        if (0 == i) {
+            numChanges += 2;
+            continue;
+        }
+
+        const ui64 prevKey = items[i - 1].m_key;
+        if (RenderSortKey::getShader(key) != RenderSortKey::getShader(prevKey)) {
+            ++numChanges;
+        }
+        if (RenderSortKey::getMaterial(key) != RenderSortKey::getMaterial(prevKey)) {
+            ++numChanges;
+        }
+    }
+
+    return numChanges;
+}
+
+} // Namespace RenderBackend
+} // Namespace OSRE
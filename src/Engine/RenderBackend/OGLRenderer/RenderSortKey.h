@@ -0,0 +1,117 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2015-2020 OSRE ( Open Source Render Engine ) by Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#pragma once
+
+#include <osre/Common/osre_common.h>
+#include <cppcore/Container/TArray.h>
+
+namespace OSRE {
+namespace RenderBackend {
+
+//-------------------------------------------------------------------------------------------------
+///	@ingroup	Engine
+///
+///	@brief  Encodes the state of one draw into a 64 bit key, sorting the keys groups the draws by
+/// their state. From the most to the least significant bits:
+///
+/// | pass (6) | layer (6) | shader (12) | material (20) | depth (20) |
+///
+/// The material is the id of the texture set, the depth the view-space distance, so draws with the
+/// same state are rendered front to back.
+//-------------------------------------------------------------------------------------------------
+struct RenderSortKey {
+    static const ui32 PassBits = 6;
+    static const ui32 LayerBits = 6;
+    static const ui32 ShaderBits = 12;
+    static const ui32 MaterialBits = 20;
+    static const ui32 DepthBits = 20;
+
+    static const ui32 DepthShift = 0;
+    static const ui32 MaterialShift = DepthShift + DepthBits;
+    static const ui32 ShaderShift = MaterialShift + MaterialBits;
+    static const ui32 LayerShift = ShaderShift + ShaderBits;
+    static const ui32 PassShift = LayerShift + LayerBits;
+
+    /// The highest layer, each render target switch takes two layers.
+    static const ui32 MaxLayer = (1u << LayerBits) - 1;
+
+    /// @brief  Builds the key, values exceeding their field will be masked.
+    static ui64 encode(ui32 pass, ui32 layer, ui32 shader, ui32 material, ui32 depth);
+
+    /// @brief  Quantizes a view-space distance into the depth field, negative distances are 0.
+    static ui32 quantizeDepth(f32 viewDistance);
+
+    static ui32 getPass(ui64 key);
+    static ui32 getLayer(ui64 key);
+    static ui32 getShader(ui64 key);
+    static ui32 getMaterial(ui64 key);
+    static ui32 getDepth(ui64 key);
+};
+
+/// @brief  A range of render commands sharing one state, the unit which will be sorted.
+struct DrawItem {
+    ui64 m_key;
+    ui32 m_firstCmd;
+    ui32 m_numCmds;
+};
+
+/// @brief  Stable LSD radix sort of the draw items by key, bytes equal for all keys are skipped.
+/// @param  items       [inout] The items to sort.
+/// @param  scratch     [inout] Temporary storage, will be resized to the number of items.
+void radixSortDrawItems(::CPPCore::TArray<DrawItem> &items, ::CPPCore::TArray<DrawItem> &scratch);
+
+/// @brief  Counts the shader and material switches needed to render the items in their order.
+/// @param  items       [in] The draw items.
+/// @return The number of state changes.
+ui32 countStateChanges(const ::CPPCore::TArray<DrawItem> &items);
+
+inline ui64 RenderSortKey::encode(ui32 pass, ui32 layer, ui32 shader, ui32 material, ui32 depth) {
+    return ((ui64)(pass & ((1u << PassBits) - 1)) << PassShift) |
+           ((ui64)(layer & ((1u << LayerBits) - 1)) << LayerShift) |
+           ((ui64)(shader & ((1u << ShaderBits) - 1)) << ShaderShift) |
+           ((ui64)(material & ((1u << MaterialBits) - 1)) << MaterialShift) |
+           ((ui64)(depth & ((1u << DepthBits) - 1)) << DepthShift);
+}
+
+inline ui32 RenderSortKey::getPass(ui64 key) {
+    return (ui32)(key >> PassShift) & ((1u << PassBits) - 1);
+}
+
+inline ui32 RenderSortKey::getLayer(ui64 key) {
+    return (ui32)(key >> LayerShift) & ((1u << LayerBits) - 1);
+}
+
+inline ui32 RenderSortKey::getShader(ui64 key) {
+    return (ui32)(key >> ShaderShift) & ((1u << ShaderBits) - 1);
+}
+
+inline ui32 RenderSortKey::getMaterial(ui64 key) {
+    return (ui32)(key >> MaterialShift) & ((1u << MaterialBits) - 1);
+}
+
+inline ui32 RenderSortKey::getDepth(ui64 key) {
+    return (ui32)(key >> DepthShift) & ((1u << DepthBits) - 1);
+}
+
+} // Namespace RenderBackend
+} // Namespace OSRE
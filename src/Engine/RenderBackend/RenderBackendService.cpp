@@ -20,6 +20,7 @@ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
 IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
 CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 -----------------------------------------------------------------------------------------------*/
+#include <osre/Platform/CPUInfo.h>
 #include <osre/Profiling/PerformanceCounterRegistry.h>
 #include <osre/Properties/Settings.h>
 #include <osre/RenderBackend/Mesh.h>
@@ -72,8 +73,14 @@ RenderBackendService::RenderBackendService() :
         m_settings(nullptr),
         m_ownsSettingsConfig(false),
         m_frameCreated(false),
-        m_renderFrame(&m_frames[0]),
-        m_submitFrame(&m_frames[1]),
+        m_numFramesInFlight(1),
+        m_frameIdx(0),
+        m_submitFrame(&m_frames[0]),
+        m_initPassesEventData(),
+        m_commitFrameEventData(),
+        m_renderFrameEventData(),
+        m_resizeEventData(0, 0, 0, 0),
+        m_numFrameAllocs(0),
         m_screen(nullptr),
         m_dirty(false),
         m_passes(),
@@ -94,12 +101,18 @@ bool RenderBackendService::onOpen() {
         m_settings = new Settings;
         m_ownsSettingsConfig = true;
     }
+    setFramesInFlight(static_cast<ui32>(m_settings->get(Settings::FramesInFlight).getInt()));
 
     // Spawn the thread
     if (!m_renderTaskPtr.isValid()) {
         m_renderTaskPtr.init(SystemTask::create("render_task"));
     }
 
+    // The render thread owns a physical core, the job workers are kept away from it
+    Platform::CPUInfo::init();
+    Platform::CPUInfo cpuInfo;
+    m_renderTaskPtr->setThreadPlacement(Platform::Thread::Priority::Critical, cpuInfo.getRenderThreadMask());
+
     // Run the render task
     bool ok = m_renderTaskPtr->start(nullptr);
     if (!ok) {
@@ -136,6 +149,7 @@ bool RenderBackendService::onClose() {
         osre_error(Tag, "Cannot destroy Debug renderer");
     }
     if (m_renderTaskPtr->isRunning()) {
+        waitForFrames();
         m_renderTaskPtr->detachEventHandler();
         m_renderTaskPtr->stop();
     }
@@ -148,20 +162,61 @@ bool RenderBackendService::onUpdate() {
         return false;
     }
 
+    // The render thread reads the pass data directly during the init, so this frame is synchronous
+    const bool syncFrame = !m_frameCreated;
     if (!m_frameCreated) {
         initPasses();
         m_frameCreated = true;
     }
 
+    const size_t numAllocs = MemoryStatistics::getNumAllocs();
     commitNextFrame();
 
-    // Synchronizing event with render back-end
-    auto result(m_renderTaskPtr->sendEvent(&OnRenderFrameEvent, nullptr));
-    m_renderTaskPtr->awaitUpdate();
+    RenderFrameEventData *data = &m_renderFrameEventData[m_frameIdx];
+    data->m_frame = m_submitFrame;
+    m_submitFrame->m_fence.submit();
+    auto result(m_renderTaskPtr->sendEvent(&OnRenderFrameEvent, data));
+    if (!result) {
+        m_submitFrame->m_fence.retire();
+    }
+    if (syncFrame) {
+        m_submitFrame->m_fence.wait();
+    }
+
+    // Wait until the next frame was retired by the render thread. With one frame in flight this
+    // is the frame just submitted, so update and render are running in lockstep.
+    m_frameIdx = (m_frameIdx + 1) % m_numFramesInFlight;
+    m_submitFrame = &m_frames[m_frameIdx];
+    m_submitFrame->m_fence.wait();
+    m_numFrameAllocs = MemoryStatistics::getNumAllocs() - numAllocs;
 
     return result;
 }
 
+void RenderBackendService::setFramesInFlight(ui32 numFrames) {
+    if (0 == numFrames) {
+        numFrames = 1;
+    } else if (numFrames > MaxFramesInFlight) {
+        numFrames = MaxFramesInFlight;
+    }
+
+    if (numFrames == m_numFramesInFlight) {
+        return;
+    }
+
+    // Drain the ring before it will be resized
+    waitForFrames();
+    m_numFramesInFlight = numFrames;
+    m_frameIdx %= m_numFramesInFlight;
+    m_submitFrame = &m_frames[m_frameIdx];
+}
+
+void RenderBackendService::waitForFrames() {
+    for (ui32 i = 0; i < MaxFramesInFlight; ++i) {
+        m_frames[i].m_fence.wait();
+    }
+}
+
 void RenderBackendService::setSettings(const Settings *config, bool moveOwnership) {
     if (m_ownsSettingsConfig && m_settings != nullptr) {
         delete m_settings;
@@ -181,7 +236,7 @@ void RenderBackendService::initPasses() {
         return;
     }
 
-    InitPassesEventData *data = new InitPassesEventData;
+    InitPassesEventData *data = &m_initPassesEventData;
     m_submitFrame->init(m_passes);
     data->m_frame = m_submitFrame;
 
@@ -193,8 +248,11 @@ void RenderBackendService::commitNextFrame() {
         return;
     }
 
-    CommitFrameEventData *data = new CommitFrameEventData;
+    // One event data instance per frame, the other ones may still be read by the render thread
+    CommitFrameEventData *data = &m_commitFrameEventData[m_frameIdx];
     data->m_frame = m_submitFrame;
+    UniformBuffer &uniformBuffer = m_submitFrame->m_uniformBuffer;
+    uniformBuffer.reset();
     for (ui32 i = 0; i < m_passes.size(); ++i) {
         PassData *currentPass = m_passes[i];
         for (ui32 j = 0; j < currentPass->m_geoBatches.size(); ++j) {
@@ -204,33 +262,21 @@ void RenderBackendService::commitNextFrame() {
                 cmd->m_passId = currentPass->m_id;
                 cmd->m_batchId = currentBatch->m_id;
                 cmd->m_updateFlags |= (ui32) FrameSubmitCmd::UpdateMatrixes;
-                cmd->m_size = sizeof(MatrixBuffer);
-                cmd->m_data = new c8[cmd->m_size];
-                ::memcpy(cmd->m_data, &currentBatch->m_matrixBuffer, cmd->m_size);
+                c8 *payload = m_submitFrame->allocPayload(cmd, sizeof(MatrixBuffer));
+                ::memcpy(payload, &currentBatch->m_matrixBuffer, cmd->m_size);
             } else if (currentBatch->m_dirtyFlag & RenderBatchData::UniformBufferDirty) {
-                UniformBuffer &uniformBuffer = data->m_frame->m_uniforBuffers[i];
-
+                // The variables are written to the uniform buffer of the frame, the command
+                // stores how many of them belong to the batch
+                FrameSubmitCmd *cmd = m_submitFrame->enqueue();
+                cmd->m_passId = currentPass->m_id;
+                cmd->m_batchId = currentBatch->m_id;
+                cmd->m_updateFlags |= (ui32)FrameSubmitCmd::UpdateUniforms;
                 for (ui32 k = 0; k < currentBatch->m_uniforms.size(); ++k) {
-                    FrameSubmitCmd *cmd = m_submitFrame->enqueue();
-                    cmd->m_passId = currentPass->m_id;
-                    cmd->m_batchId = currentBatch->m_id;
-                    cmd->m_updateFlags |= (ui32)FrameSubmitCmd::UpdateUniforms;
                     UniformVar *var = currentBatch->m_uniforms[k];
-                    if (nullptr == var) {
-                        continue;
+                    if (nullptr != var) {
+                        uniformBuffer.writeVar(var);
+                        ++cmd->m_size;
                     }
-
-                    uniformBuffer.writeVar(var);
-
-                    // todo: replace by uniform buffer.
-                    cmd->m_size = var->getSize();
-                    cmd->m_data = new c8[cmd->m_size];
-                    size_t offset(0);
-                    cmd->m_data[offset] = var->m_name.size() > 255 ? 255 : static_cast<c8>(var->m_name.size());
-                    offset++;
-                    ::memcpy(&cmd->m_data[offset], var->m_name.c_str(), var->m_name.size());
-                    offset += var->m_name.size();
-                    ::memcpy(&cmd->m_data[offset], var->m_data.getData(), var->m_data.m_size);
                 }
             } else if (currentBatch->m_dirtyFlag & RenderBatchData::MeshUpdateDirty) {
                 for (ui32 k = 0; k < currentBatch->m_updateMeshArray.size(); ++k) {
@@ -240,9 +286,8 @@ void RenderBackendService::commitNextFrame() {
                     cmd->m_updateFlags |= (ui32)FrameSubmitCmd::UpdateBuffer;
                     Mesh *currentMesh = currentBatch->m_updateMeshArray[k];
                     cmd->m_meshId = currentMesh->m_id;
-                    cmd->m_size = currentMesh->m_vb->getSize();
-                    cmd->m_data = new c8[cmd->m_size];
-                    ::memcpy(cmd->m_data, currentMesh->m_vb->getData(), cmd->m_size);
+                    c8 *payload = m_submitFrame->allocPayload(cmd, currentMesh->m_vb->getSize());
+                    ::memcpy(payload, currentMesh->m_vb->getData(), cmd->m_size);
                 }
             }
 
@@ -250,9 +295,6 @@ void RenderBackendService::commitNextFrame() {
         }
     }
 
-    data->m_frame = m_submitFrame;
-    std::swap(m_submitFrame, m_renderFrame);
-
     m_renderTaskPtr->sendEvent(&OnCommitFrameEvent, data);
 }
 
@@ -410,6 +452,30 @@ void RenderBackendService::addMesh(const CPPCore::TArray<Mesh *> &geoArray, ui32
     m_currentBatch->m_dirtyFlag |= RenderBatchData::MeshDirty;
 }
 
+void RenderBackendService::addInstancedMesh(Mesh *mesh, GeoInstanceData *instanceData) {
+    if (nullptr == mesh) {
+        osre_debug(Tag, "Pointer to geometry is nullptr.");
+        return;
+    }
+
+    if (nullptr == instanceData || 0 == instanceData->m_numInstances) {
+        osre_debug(Tag, "No instance data.");
+        return;
+    }
+
+    if (nullptr == m_currentBatch) {
+        osre_error(Tag, "No active batch.");
+        return;
+    }
+
+    MeshEntry *entry = new MeshEntry;
+    entry->m_geo.add(mesh);
+    entry->numInstances = instanceData->m_numInstances;
+    entry->m_instanceData = instanceData;
+    m_currentBatch->m_meshArray.add(entry);
+    m_currentBatch->m_dirtyFlag |= RenderBatchData::MeshDirty;
+}
+
 void RenderBackendService::updateMesh(Mesh *mesh) {
     if (nullptr == m_currentBatch) {
         osre_error(Tag, "No active batch.");
@@ -465,7 +531,9 @@ void RenderBackendService::attachView() {
 
 void RenderBackendService::resize(ui32 x, ui32 y, ui32 w, ui32 h) {
     if (mBehaviour.ResizeViewport) {
-        ResizeEventData *data = new ResizeEventData(x, y, w, h);
+        // A pending resize will pick up the latest size as well
+        ResizeEventData *data = &m_resizeEventData;
+        data->set(x, y, w, h);
         m_renderTaskPtr->sendEvent(&OnResizeEvent, data);
     }
 
@@ -23,10 +23,15 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <osre/App/AssetRegistry.h>
 #include <osre/Common/Ids.h>
 #include <osre/Common/Logger.h>
+#include <osre/Common/StringUtils.h>
+#include <osre/Debugging/osre_debugging.h>
+#include <osre/IO/IOService.h>
+#include <osre/IO/Stream.h>
 #include <osre/IO/Uri.h>
 #include <osre/RenderBackend/Mesh.h>
 #include <osre/RenderBackend/RenderCommon.h>
 #include <osre/RenderBackend/Shader.h>
+#include <osre/RenderBackend/TextureContainer.h>
 
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
@@ -123,6 +128,48 @@ const String *RenderVert::getAttributes() {
     return RenderVertAttributes;
 }
 
+// List of attributes for instance data
+static const ui32 NumInstanceVertAttributes = 4;
+
+static const String InstanceVertAttributes[NumInstanceVertAttributes] = {
+    "instance0", "instance1", "instance2", "instance3"
+};
+
+InstanceVert::InstanceVert() :
+        color0(1, 1, 1, 1) {
+    transform[0] = glm::vec4(1, 0, 0, 0);
+    transform[1] = glm::vec4(0, 1, 0, 0);
+    transform[2] = glm::vec4(0, 0, 1, 0);
+}
+
+InstanceVert::~InstanceVert() {
+    // empty
+}
+
+void InstanceVert::setTransform(const glm::mat4 &m) {
+    // glm stores columns, the attributes hold the rows
+    for (ui32 row = 0; row < 3; ++row) {
+        transform[row] = glm::vec4(m[0][row], m[1][row], m[2][row], m[3][row]);
+    }
+}
+
+void InstanceVert::getTransform(glm::mat4 &m) const {
+    m = glm::mat4(1.0f);
+    for (ui32 row = 0; row < 3; ++row) {
+        for (ui32 col = 0; col < 4; ++col) {
+            m[col][row] = transform[row][col];
+        }
+    }
+}
+
+size_t InstanceVert::getNumAttributes() {
+    return NumInstanceVertAttributes;
+}
+
+const String *InstanceVert::getAttributes() {
+    return InstanceVertAttributes;
+}
+
 const String &getVertCompName(VertexAttribute attrib) {
     if (attrib > VertexAttribute::Instance3) {
         return ErrorCmpName;
@@ -299,15 +346,44 @@ void PrimitiveGroup::init(IndexType indexType, size_t numPrimitives, PrimitiveTy
     m_startIndex = startIdx;
 }
 
+TextureRegion::TextureRegion() :
+        m_layer(0),
+        m_uvRect(0, 0, 1, 1) {
+    // empty
+}
+
+TextureRegion::TextureRegion(ui32 layer, const glm::vec4 &uvRect) :
+        m_layer(layer),
+        m_uvRect(uvRect) {
+    // empty
+}
+
+glm::vec2 TextureRegion::map(const glm::vec2 &uv) const {
+    return glm::vec2(static_cast<f32>(m_layer) + m_uvRect.x + uv.x * m_uvRect.z, m_uvRect.y + uv.y * m_uvRect.w);
+}
+
+void TextureRegion::apply(RenderVert *vertices, size_t numVertices) const {
+    if (nullptr == vertices) {
+        return;
+    }
+
+    for (size_t i = 0; i < numVertices; ++i) {
+        vertices[i].tex0 = map(vertices[i].tex0);
+    }
+}
+
 Texture::Texture() :
         m_textureName(""),
         m_loc(),
         m_targetType(TextureTargetType::Texture2D),
+        m_format(TextureFormatType::R8G8B8),
         m_size(0),
         m_data(nullptr),
         m_width(0),
         m_height(0),
         m_channels(0),
+        m_layers(1),
+        m_numMipLevels(0),
         m_texHandle() {
     // empty
 }
@@ -328,6 +404,13 @@ size_t TextureLoader::load(const IO::Uri &uri, Texture *tex) {
     }
     String root = App::AssetRegistry::getPath("media");
     String path = App::AssetRegistry::resolvePathFromUri(uri);
+    if (TextureContainer::isContainerFile(path)) {
+        return loadContainer(path, tex);
+    }
+
+    if (s_deferredDecoding) {
+        return locateImage(path, tex);
+    }
 
     i32 width = 0, height = 0, channels = 0;
     tex->m_data = SOIL_load_image(path.c_str(), &width, &height, &channels, SOIL_LOAD_AUTO);
@@ -357,6 +440,71 @@ size_t TextureLoader::load(const IO::Uri &uri, Texture *tex) {
     return size;
 }
 
+size_t TextureLoader::loadContainer(const String &path, Texture *tex) {
+    IO::IOService *ioService = IO::IOService::getInstance();
+    if (nullptr == ioService) {
+        return 0;
+    }
+
+    const IO::Uri fileUri("file://" + path);
+    IO::Stream *stream = ioService->openStream(fileUri, IO::Stream::AccessMode::ReadAccessBinary);
+    if (nullptr == stream) {
+        osre_debug(Tag, "Cannot open texture " + path);
+        return 0;
+    }
+
+    // The levels are uploaded as they are, so the whole container is kept
+    const ui32 size = stream->getSize();
+    uc8 *data = new uc8[size];
+    const ui32 read = stream->read(data, size);
+    ioService->closeStream(&stream);
+
+    TextureContainer container;
+    if (read != size || !container.parse(data, size)) {
+        osre_debug(Tag, "Cannot load texture " + path);
+        delete[] data;
+        return 0;
+    }
+    tex->m_data = data;
+    tex->m_size = size;
+    tex->m_format = container.getFormat();
+    tex->m_width = container.getWidth();
+    tex->m_height = container.getHeight();
+    tex->m_channels = 0;
+
+    return size;
+}
+
+size_t TextureLoader::locateImage(const String &path, Texture *tex) {
+    IO::IOService *ioService = IO::IOService::getInstance();
+    if (nullptr == ioService) {
+        return 0;
+    }
+
+    // Only the size of the file is read, the pixels are decoded by the render backend
+    const IO::Uri fileUri("file://" + path);
+    IO::Stream *stream = ioService->openStream(fileUri, IO::Stream::AccessMode::ReadAccessBinary);
+    if (nullptr == stream) {
+        osre_debug(Tag, "Cannot open texture " + path);
+        return 0;
+    }
+    const size_t size = stream->getSize();
+    ioService->closeStream(&stream);
+    tex->m_loc = fileUri;
+
+    return size;
+}
+
+std::atomic<bool> TextureLoader::s_deferredDecoding(false);
+
+void TextureLoader::setDeferredDecoding(bool enabled) {
+    s_deferredDecoding = enabled;
+}
+
+bool TextureLoader::isDeferredDecoding() {
+    return s_deferredDecoding;
+}
+
 static Texture *DefaultTexture = nullptr;
 
 RenderBackend::Texture *TextureLoader::getDefaultTexture() {
@@ -383,8 +531,13 @@ bool TextureLoader::unload(Texture *tex) {
         return false;
     }
 
-    SOIL_free_image_data(tex->m_data);
+    if (TextureContainer::isCompressed(tex->m_format)) {
+        delete[] tex->m_data;
+    } else {
+        SOIL_free_image_data(tex->m_data);
+    }
     tex->m_data = nullptr;
+    tex->m_size = 0;
     tex->m_width = 0;
     tex->m_height = 0;
     tex->m_channels = 0;
@@ -482,7 +635,8 @@ Material::Material(const String &name) :
         m_parameters(nullptr),
         mShineness(0.0f),
         mShinenessStrength(0.0f),
-        m_uri() {
+        m_uri(),
+        m_region() {
     // empty
 }
 
@@ -497,7 +651,8 @@ Material::Material(const String &name, const IO::Uri &uri) :
         m_parameters(nullptr),
         mShineness(0.0f),
         mShinenessStrength(0.0f),
-        m_uri(uri) {
+        m_uri(uri),
+        m_region() {
     // empty
 }
 
@@ -527,7 +682,8 @@ void Material::createShader(ShaderSourceArray &shaders) {
 }
 
 GeoInstanceData::GeoInstanceData() :
-        m_data(nullptr) {
+        m_data(nullptr),
+        m_numInstances(0) {
     // empty
 }
 
@@ -536,6 +692,40 @@ GeoInstanceData::~GeoInstanceData() {
     m_data = nullptr;
 }
 
+void GeoInstanceData::alloc(ui32 numInstances, BufferAccessType access) {
+    BufferData::free(m_data);
+    m_data = nullptr;
+    m_numInstances = numInstances;
+    if (0 == numInstances) {
+        return;
+    }
+
+    m_data = BufferData::alloc(BufferType::InstanceBuffer, sizeof(InstanceVert) * numInstances, access);
+    InstanceVert *instances = getInstances();
+    for (ui32 i = 0; i < numInstances; ++i) {
+        instances[i] = InstanceVert();
+    }
+}
+
+void GeoInstanceData::setInstance(ui32 idx, const glm::mat4 &transform, const glm::vec4 &color) {
+    if (idx >= m_numInstances) {
+        osre_error(Tag, "Instance index out of range.");
+        return;
+    }
+
+    InstanceVert &instance = getInstances()[idx];
+    instance.setTransform(transform);
+    instance.color0 = color;
+}
+
+InstanceVert *GeoInstanceData::getInstances() const {
+    if (nullptr == m_data) {
+        return nullptr;
+    }
+
+    return (InstanceVert *)m_data->getData();
+}
+
 TransformState::TransformState() :
         m_translate(), m_scale(1.0f), m_rotation() {
     // empty
@@ -676,16 +866,147 @@ RenderBatchData *PassData::getBatchById(const c8 *id) const {
     return nullptr;
 }
 
+FrameFence::FrameFence() :
+        m_pending(0), m_retiredEvent() {
+    // empty
+}
+
+FrameFence::~FrameFence() {
+    // empty
+}
+
+void FrameFence::submit() {
+    m_pending.inc();
+}
+
+void FrameFence::retire() {
+    m_pending.dec();
+    m_retiredEvent.signal();
+}
+
+void FrameFence::wait() {
+    // The event is auto-reset, so a stale signal just causes one more check of the counter
+    while (0 != m_pending.getValue()) {
+        m_retiredEvent.waitForOne();
+    }
+}
+
+bool FrameFence::isPending() {
+    return 0 != m_pending.getValue();
+}
+
+const size_t FrameSubmitCmd::InlineSize;
+const size_t FrameArena::DefaultAlign;
+
+FrameArena::FrameArena() :
+        m_blocks(), m_pos(0), m_used(0) {
+    // empty
+}
+
+FrameArena::~FrameArena() {
+    destroy();
+}
+
+void FrameArena::create(size_t size) {
+    destroy();
+    if (0 != size) {
+        addBlock(size);
+    }
+}
+
+void FrameArena::destroy() {
+    for (size_t i = 0; i < m_blocks.size(); ++i) {
+        delete[] m_blocks[i].m_data;
+    }
+    m_blocks.clear();
+    m_pos = 0;
+    m_used = 0;
+}
+
+void FrameArena::addBlock(size_t size) {
+    Block block;
+    block.m_data = new c8[size];
+    block.m_size = size;
+    m_blocks.add(block);
+    m_pos = 0;
+}
+
+c8 *FrameArena::alloc(size_t size, size_t align) {
+    if (0 == size) {
+        return nullptr;
+    }
+    if (0 == align) {
+        align = 1;
+    }
+
+    if (!m_blocks.isEmpty()) {
+        const Block &block = m_blocks.back();
+        const uintptr_t base = reinterpret_cast<uintptr_t>(block.m_data);
+        const uintptr_t start = (base + m_pos + align - 1) / align * align;
+        const size_t offset = static_cast<size_t>(start - base);
+        if (offset + size <= block.m_size) {
+            m_pos = offset + size;
+            m_used += size;
+            return block.m_data + offset;
+        }
+    }
+
+    // Chain a new block, the old ones stay valid until the next reset
+    const size_t lastSize = m_blocks.isEmpty() ? 0 : m_blocks.back().m_size;
+    const size_t minSize = size + align;
+    addBlock(lastSize * 2 > minSize ? lastSize * 2 : minSize);
+
+    return alloc(size, align);
+}
+
+void FrameArena::reset() {
+    if (m_blocks.size() > 1) {
+        const size_t capacity = getCapacity();
+        destroy();
+        addBlock(capacity);
+    }
+    m_pos = 0;
+    m_used = 0;
+}
+
+size_t FrameArena::getUsed() const {
+    return m_used;
+}
+
+size_t FrameArena::getCapacity() const {
+    size_t capacity(0);
+    for (size_t i = 0; i < m_blocks.size(); ++i) {
+        capacity += m_blocks[i].m_size;
+    }
+
+    return capacity;
+}
+
+size_t FrameArena::getNumBlocks() const {
+    return m_blocks.size();
+}
+
 static const ui32 MaxSubmitCmds = 500;
+static const size_t InitialUniformBufferSize = 64 * 1024;
+static const size_t InitialPayloadArenaSize = 256 * 1024;
 
 Frame::Frame() :
-        m_newPasses(), m_submitCmds(), m_submitCmdAllocator(), m_uniforBuffers(nullptr), m_pipeline(nullptr) {
+        m_newPasses(),
+        m_submitCmds(),
+        m_submitCmdAllocator(),
+        m_uniformBuffer(),
+        m_payloadArena(),
+        m_inlinePayloads(true),
+        m_pipeline(nullptr),
+        m_fence() {
     m_submitCmdAllocator.reserve(MaxSubmitCmds);
+    m_uniformBuffer.create(InitialUniformBufferSize);
+    m_payloadArena.create(InitialPayloadArenaSize);
 }
 
 Frame::~Frame() {
-    delete[] m_uniforBuffers;
-    m_uniforBuffers = nullptr;
+    m_payloadArena.destroy();
+    m_uniformBuffer.destroy();
 }
 
 void Frame::init(TArray<PassData *> &newPasses) {
@@ -695,18 +1016,38 @@ void Frame::init(TArray<PassData *> &newPasses) {
     for (ui32 i = 0; i < newPasses.size(); ++i) {
         m_newPasses.add(newPasses[i]);
     }
-    m_uniforBuffers = new UniformBuffer[newPasses.size()];
 }
 
 FrameSubmitCmd *Frame::enqueue() {
     FrameSubmitCmd *cmd = m_submitCmdAllocator.alloc();
     if (nullptr != cmd) {
+        // The pool reuses the commands of the last frame
+        *cmd = FrameSubmitCmd();
         m_submitCmds.add(cmd);
     }
 
     return cmd;
 }
 
+c8 *Frame::allocPayload(FrameSubmitCmd *cmd, size_t size) {
+    OSRE_ASSERT(nullptr != cmd);
+
+    cmd->m_size = size;
+    if (m_inlinePayloads && size <= FrameSubmitCmd::InlineSize) {
+        cmd->m_data = cmd->m_inline;
+    } else {
+        cmd->m_data = m_payloadArena.alloc(size);
+    }
+
+    return cmd->m_data;
+}
+
+void Frame::releaseSubmitCmds() {
+    m_submitCmds.resize(0);
+    m_submitCmdAllocator.release();
+    m_payloadArena.reset();
+}
+
 UniformDataBlob::UniformDataBlob() :
         m_data(nullptr), m_size(0) {
     // empty
@@ -758,7 +1099,7 @@ UniformDataBlob *UniformDataBlob::create(ParameterType type, size_t arraySize) {
 }
 
 UniformVar::UniformVar() :
-        m_name(""), m_type(ParameterType::PT_None), m_numItems(1), m_next(nullptr) {
+        m_name(""), m_hash(0), m_type(ParameterType::PT_None), m_numItems(1), m_next(nullptr) {
     // empty
 }
 
@@ -772,15 +1113,27 @@ ui32 UniformVar::getParamDataSize(ParameterType type, ui32 arraySize) {
         case ParameterType::PT_Int:
             size = sizeof(i32);
             break;
+        case ParameterType::PT_IntArray:
+            size = sizeof(i32) * arraySize;
+            break;
         case ParameterType::PT_Float:
             size = sizeof(f32);
             break;
+        case ParameterType::PT_FloatArray:
+            size = sizeof(f32) * arraySize;
+            break;
         case ParameterType::PT_Float2:
             size = sizeof(f32) * 2;
             break;
+        case ParameterType::PT_Float2Array:
+            size = sizeof(f32) * 2 * arraySize;
+            break;
         case ParameterType::PT_Float3:
             size = sizeof(f32) * 3;
             break;
+        case ParameterType::PT_Float3Array:
+            size = sizeof(f32) * 3 * arraySize;
+            break;
         case ParameterType::PT_Mat4:
             size = sizeof(f32) * 16;
             break;
@@ -804,6 +1157,7 @@ UniformVar *UniformVar::create(const String &name, ParameterType type,
 
     UniformVar *param = new UniformVar;
     param->m_name = name;
+    param->m_hash = StringUtils::hashName(name);
     param->m_type = type;
     param->m_numItems = arraySize;
     param->m_data.m_size = UniformVar::getParamDataSize(type, arraySize);
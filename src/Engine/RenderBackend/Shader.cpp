@@ -3,7 +3,8 @@
 namespace OSRE {
 namespace RenderBackend {
 
-Shader::Shader() {
+Shader::Shader() :
+        m_name() {
     ::memset(m_compileState, 0, sizeof(CompileState)*MaxCompileState);
 }
 
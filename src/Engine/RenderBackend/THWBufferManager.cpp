@@ -83,7 +83,119 @@ const c8 *getAccessShortCut( BufferAccessType access ) {
     return nullptr;
 }
 
+const size_t OffsetAllocator::InvalidOffset;
 
+OffsetAllocator::OffsetAllocator() :
+        m_freeRanges(),
+        m_capacity(0),
+        m_used(0) {
+    // empty
+}
+
+OffsetAllocator::~OffsetAllocator() {
+    // empty
+}
+
+void OffsetAllocator::init(size_t capacity) {
+    m_freeRanges.clear();
+    m_capacity = capacity;
+    m_used = 0;
+    if (0 != capacity) {
+        Range range;
+        range.m_offset = 0;
+        range.m_size = capacity;
+        m_freeRanges.add(range);
+    }
+}
+
+size_t OffsetAllocator::alloc(size_t size, size_t align) {
+    if (0 == size) {
+        return InvalidOffset;
+    }
+    if (0 == align) {
+        align = 1;
+    }
+
+    for (ui32 i = 0; i < m_freeRanges.size(); ++i) {
+        const Range range = m_freeRanges[i];
+        const size_t offset = (range.m_offset + align - 1) / align * align;
+        const size_t padding = offset - range.m_offset;
+        if (padding + size > range.m_size) {
+            continue;
+        }
+
+        // The padding stays free, the rest of the range behind the allocation as well
+        m_freeRanges.remove(i);
+        const size_t tail = range.m_size - padding - size;
+        if (0 != tail) {
+            addFreeRange(offset + size, tail);
+        }
+        if (0 != padding) {
+            addFreeRange(range.m_offset, padding);
+        }
+        m_used += size;
+
+        return offset;
+    }
+
+    return InvalidOffset;
+}
+
+void OffsetAllocator::release(size_t offset, size_t size) {
+    if (0 == size || offset + size > m_capacity) {
+        return;
+    }
+
+    m_used -= size;
+    addFreeRange(offset, size);
+}
+
+void OffsetAllocator::addFreeRange(size_t offset, size_t size) {
+    // Keep the ranges sorted by their offset and merge the neighbours
+    ui32 idx = 0;
+    while (idx < m_freeRanges.size() && m_freeRanges[idx].m_offset < offset) {
+        ++idx;
+    }
+
+    if (idx > 0) {
+        Range &prev = m_freeRanges[idx - 1];
+        if (prev.m_offset + prev.m_size == offset) {
+            prev.m_size += size;
+            if (idx < m_freeRanges.size() && prev.m_offset + prev.m_size == m_freeRanges[idx].m_offset) {
+                prev.m_size += m_freeRanges[idx].m_size;
+                m_freeRanges.remove(idx);
+            }
+            return;
+        }
+    }
+
+    if (idx < m_freeRanges.size() && offset + size == m_freeRanges[idx].m_offset) {
+        m_freeRanges[idx].m_offset = offset;
+        m_freeRanges[idx].m_size += size;
+        return;
+    }
+
+    Range range;
+    range.m_offset = offset;
+    range.m_size = size;
+    m_freeRanges.add(range);
+    for (size_t i = m_freeRanges.size() - 1; i > idx; --i) {
+        m_freeRanges[i] = m_freeRanges[i - 1];
+    }
+    m_freeRanges[idx] = range;
+}
 
+size_t OffsetAllocator::getCapacity() const {
+    return m_capacity;
 }
+
+size_t OffsetAllocator::getUsed() const {
+    return m_used;
+}
+
+size_t OffsetAllocator::getNumFreeRanges() const {
+    return m_freeRanges.size();
 }
+
+} // namespace RenderBackend
+} // namespace OSRE
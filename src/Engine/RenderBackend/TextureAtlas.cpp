@@ -0,0 +1,264 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2015-2020 OSRE ( Open Source Render Engine ) by Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#include <osre/RenderBackend/TextureAtlas.h>
+#include <osre/Common/Logger.h>
+
+#include <cstring>
+
+namespace OSRE {
+namespace RenderBackend {
+
+static const c8 *Tag = "TextureAtlas";
+
+static i32 clamp(i32 value, i32 maxValue) {
+    if (value < 0) {
+        return 0;
+    }
+
+    return value > maxValue ? maxValue : value;
+}
+
+TextureAtlas::TextureAtlas() :
+        m_width(0),
+        m_height(0),
+        m_maxLayers(0),
+        m_padding(0),
+        m_layers(),
+        m_regions() {
+    // empty
+}
+
+TextureAtlas::~TextureAtlas() {
+    destroy();
+}
+
+bool TextureAtlas::create(ui32 width, ui32 height, ui32 maxLayers, ui32 padding) {
+    if (0 != m_width) {
+        osre_error(Tag, "Atlas already created.");
+        return false;
+    }
+
+    // Without a border the last column of a layer would map to u == layer + 1, the next layer
+    if (0 == width || 0 == height || 0 == maxLayers || 0 == padding || 2 * padding >= width || 2 * padding >= height) {
+        osre_error(Tag, "Invalid atlas size.");
+        return false;
+    }
+
+    m_width = width;
+    m_height = height;
+    m_maxLayers = maxLayers;
+    m_padding = padding;
+
+    return true;
+}
+
+void TextureAtlas::destroy() {
+    for (ui32 i = 0; i < m_layers.size(); ++i) {
+        delete m_layers[i];
+    }
+    m_layers.clear();
+    m_regions.clear();
+    m_width = 0;
+    m_height = 0;
+    m_maxLayers = 0;
+    m_padding = 0;
+}
+
+bool TextureAtlas::add(const String &name, const uc8 *pixels, ui32 width, ui32 height, ui32 channels,
+        TextureRegion &region) {
+    if (name.empty() || nullptr == pixels || 0 == width || 0 == height || 0 == channels || channels > NumChannels) {
+        return false;
+    }
+
+    if (findRegion(name, region)) {
+        return true;
+    }
+
+    ui32 layer(0), x(0), y(0);
+    if (!allocate(width + 2 * m_padding, height + 2 * m_padding, layer, x, y)) {
+        osre_debug(Tag, "No space left for " + name);
+        return false;
+    }
+    copy(m_layers[layer], x, y, pixels, width, height, channels);
+
+    region.m_layer = layer;
+    region.m_uvRect = glm::vec4(static_cast<f32>(x + m_padding) / static_cast<f32>(m_width),
+            static_cast<f32>(y + m_padding) / static_cast<f32>(m_height),
+            static_cast<f32>(width) / static_cast<f32>(m_width),
+            static_cast<f32>(height) / static_cast<f32>(m_height));
+    m_regions[name] = region;
+
+    return true;
+}
+
+bool TextureAtlas::findRegion(const String &name, TextureRegion &region) const {
+    std::map<String, TextureRegion>::const_iterator it(m_regions.find(name));
+    if (m_regions.end() == it) {
+        return false;
+    }
+    region = it->second;
+
+    return true;
+}
+
+ui32 TextureAtlas::getMaxMipLevel() const {
+    ui32 level(0);
+    while ((2u << level) <= m_padding) {
+        ++level;
+    }
+
+    return level;
+}
+
+Texture *TextureAtlas::createTexture(const String &name) const {
+    if (m_layers.isEmpty()) {
+        return nullptr;
+    }
+
+    const ui32 layerSize = m_width * m_height * NumChannels;
+    Texture *tex = new Texture;
+    tex->m_textureName = name;
+    tex->m_targetType = TextureTargetType::Texture2DArray;
+    tex->m_format = TextureFormatType::R8G8B8A8;
+    tex->m_width = m_width;
+    tex->m_height = m_height;
+    tex->m_channels = NumChannels;
+    tex->m_layers = getNumLayers();
+    tex->m_numMipLevels = getMaxMipLevel() + 1;
+    tex->m_size = layerSize * tex->m_layers;
+    tex->m_data = new uc8[tex->m_size];
+    for (ui32 i = 0; i < m_layers.size(); ++i) {
+        ::memcpy(&tex->m_data[i * layerSize], &m_layers[i]->m_pixels[0], layerSize);
+    }
+
+    return tex;
+}
+
+const uc8 *TextureAtlas::getLayerData(ui32 layer) const {
+    if (layer >= m_layers.size()) {
+        return nullptr;
+    }
+
+    return reinterpret_cast<const uc8 *>(&m_layers[layer]->m_pixels[0]);
+}
+
+bool TextureAtlas::allocate(ui32 width, ui32 height, ui32 &layer, ui32 &x, ui32 &y) {
+    if (width > m_width || height > m_height) {
+        return false;
+    }
+
+    for (ui32 i = 0; i < m_layers.size(); ++i) {
+        if (allocateInLayer(m_layers[i], width, height, x, y)) {
+            layer = i;
+            return true;
+        }
+    }
+
+    if (m_layers.size() >= m_maxLayers) {
+        return false;
+    }
+
+    Layer *newLayer = new Layer;
+    newLayer->m_pixels.resize(m_width * m_height * NumChannels);
+    ::memset(&newLayer->m_pixels[0], 0, newLayer->m_pixels.size());
+    newLayer->m_top = 0;
+    m_layers.add(newLayer);
+    layer = static_cast<ui32>(m_layers.size() - 1);
+
+    return allocateInLayer(newLayer, width, height, x, y);
+}
+
+bool TextureAtlas::allocateInLayer(Layer *layer, ui32 width, ui32 height, ui32 &x, ui32 &y) {
+    // Use the lowest shelf with space left, to waste as few rows as possible
+    Shelf *best = nullptr;
+    for (ui32 i = 0; i < layer->m_shelves.size(); ++i) {
+        Shelf &shelf = layer->m_shelves[i];
+        if (shelf.m_height < height || shelf.m_x + width > m_width) {
+            continue;
+        }
+        if (nullptr == best || shelf.m_height < best->m_height) {
+            best = &shelf;
+        }
+    }
+
+    if (nullptr == best) {
+        if (layer->m_top + height > m_height) {
+            return false;
+        }
+
+        Shelf shelf;
+        shelf.m_y = layer->m_top;
+        shelf.m_height = height;
+        shelf.m_x = 0;
+        layer->m_shelves.add(shelf);
+        layer->m_top += height;
+        best = &layer->m_shelves[layer->m_shelves.size() - 1];
+    }
+
+    x = best->m_x;
+    y = best->m_y;
+    best->m_x += width;
+
+    return true;
+}
+
+void TextureAtlas::copy(Layer *layer, ui32 x, ui32 y, const uc8 *pixels, ui32 width, ui32 height, ui32 channels) {
+    // The border repeats the edge pixels, like clamping to the edge of a single texture
+    const i32 padding = static_cast<i32>(m_padding);
+    const i32 w = static_cast<i32>(width);
+    const i32 h = static_cast<i32>(height);
+    const i32 pitch = static_cast<i32>(m_width * NumChannels);
+    const i32 destX = static_cast<i32>(x) + padding;
+    const i32 destY = static_cast<i32>(y) + padding;
+    uc8 *dest = reinterpret_cast<uc8 *>(&layer->m_pixels[0]);
+    for (i32 row = -padding; row < h + padding; ++row) {
+        const uc8 *srcRow = &pixels[clamp(row, h - 1) * w * channels];
+        uc8 *destRow = &dest[(destY + row) * pitch + destX * static_cast<i32>(NumChannels)];
+        for (i32 col = -padding; col < w + padding; ++col) {
+            const uc8 *src = &srcRow[clamp(col, w - 1) * channels];
+            uc8 *texel = &destRow[col * static_cast<i32>(NumChannels)];
+            switch (channels) {
+                case 1:
+                    texel[0] = texel[1] = texel[2] = src[0];
+                    texel[3] = 255;
+                    break;
+                case 2:
+                    texel[0] = texel[1] = texel[2] = src[0];
+                    texel[3] = src[1];
+                    break;
+                case 3:
+                    texel[0] = src[0];
+                    texel[1] = src[1];
+                    texel[2] = src[2];
+                    texel[3] = 255;
+                    break;
+                default:
+                    ::memcpy(texel, src, NumChannels);
+                    break;
+            }
+        }
+    }
+}
+
+} // Namespace RenderBackend
+} // Namespace OSRE
@@ -0,0 +1,481 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2015-2020 OSRE ( Open Source Render Engine ) by Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#include <osre/RenderBackend/TextureContainer.h>
+#include <osre/Common/Logger.h>
+
+#include <cctype>
+#include <cstring>
+
+namespace OSRE {
+namespace RenderBackend {
+
+static const c8 *Tag = "TextureContainer";
+
+// Enough for a 32k texture, protects the level math against broken headers
+static const ui32 MaxLevels = 16;
+
+static const ui32 DDSMagic = 0x20534444; // "DDS "
+static const ui32 DDSHeaderSize = 124;
+static const ui32 DDSPixelFormatSize = 32;
+static const ui32 DDSHeaderDX10Size = 20;
+static const ui32 DDSDCaps = 0x1;
+static const ui32 DDSDHeight = 0x2;
+static const ui32 DDSDWidth = 0x4;
+static const ui32 DDSDPixelFormat = 0x1000;
+static const ui32 DDSDMipMapCount = 0x20000;
+static const ui32 DDSDLinearSize = 0x80000;
+static const ui32 DDPFFourCC = 0x4;
+static const ui32 DDSCapsComplex = 0x8;
+static const ui32 DDSCapsTexture = 0x1000;
+static const ui32 DDSCapsMipMap = 0x400000;
+static const ui32 DDSCaps2CubeMap = 0x200;
+static const ui32 DDSCaps2Volume = 0x200000;
+
+static const uc8 KTX2Identifier[12] = { 0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n' };
+static const ui32 KTX2HeaderSize = 80;
+static const ui32 KTX2LevelIndexSize = 24;
+
+static ui32 makeFourCC(c8 a, c8 b, c8 c, c8 d) {
+    return static_cast<ui32>(static_cast<uc8>(a)) | (static_cast<ui32>(static_cast<uc8>(b)) << 8) |
+           (static_cast<ui32>(static_cast<uc8>(c)) << 16) | (static_cast<ui32>(static_cast<uc8>(d)) << 24);
+}
+
+static ui32 readUI32(const uc8 *data) {
+    ui32 value(0);
+    ::memcpy(&value, data, sizeof(ui32));
+    return value;
+}
+
+static ui64 readUI64(const uc8 *data) {
+    ui64 value(0);
+    ::memcpy(&value, data, sizeof(ui64));
+    return value;
+}
+
+static void writeUI32(uc8 *data, ui32 value) {
+    ::memcpy(data, &value, sizeof(ui32));
+}
+
+static TextureFormatType getFormatFromFourCC(ui32 fourCC) {
+    if (fourCC == makeFourCC('D', 'X', 'T', '1')) {
+        return TextureFormatType::BC1;
+    } else if (fourCC == makeFourCC('D', 'X', 'T', '3')) {
+        return TextureFormatType::BC2;
+    } else if (fourCC == makeFourCC('D', 'X', 'T', '5')) {
+        return TextureFormatType::BC3;
+    } else if (fourCC == makeFourCC('A', 'T', 'I', '1') || fourCC == makeFourCC('B', 'C', '4', 'U')) {
+        return TextureFormatType::BC4;
+    } else if (fourCC == makeFourCC('A', 'T', 'I', '2') || fourCC == makeFourCC('B', 'C', '5', 'U')) {
+        return TextureFormatType::BC5;
+    }
+
+    return TextureFormatType::InvaliTextureType;
+}
+
+static ui32 getFourCC(TextureFormatType format) {
+    switch (format) {
+        case TextureFormatType::BC1:
+            return makeFourCC('D', 'X', 'T', '1');
+        case TextureFormatType::BC2:
+            return makeFourCC('D', 'X', 'T', '3');
+        case TextureFormatType::BC3:
+            return makeFourCC('D', 'X', 'T', '5');
+        case TextureFormatType::BC4:
+            return makeFourCC('B', 'C', '4', 'U');
+        case TextureFormatType::BC5:
+            return makeFourCC('B', 'C', '5', 'U');
+        default:
+            break;
+    }
+
+    // The newer formats are described by the DX10 header
+    return makeFourCC('D', 'X', '1', '0');
+}
+
+static TextureFormatType getFormatFromDXGI(ui32 dxgiFormat) {
+    switch (dxgiFormat) {
+        case 71: // DXGI_FORMAT_BC1_UNORM
+            return TextureFormatType::BC1;
+        case 72: // DXGI_FORMAT_BC1_UNORM_SRGB
+            return TextureFormatType::BC1_SRGB;
+        case 74: // DXGI_FORMAT_BC2_UNORM
+            return TextureFormatType::BC2;
+        case 75: // DXGI_FORMAT_BC2_UNORM_SRGB
+            return TextureFormatType::BC2_SRGB;
+        case 77: // DXGI_FORMAT_BC3_UNORM
+            return TextureFormatType::BC3;
+        case 78: // DXGI_FORMAT_BC3_UNORM_SRGB
+            return TextureFormatType::BC3_SRGB;
+        case 80: // DXGI_FORMAT_BC4_UNORM
+            return TextureFormatType::BC4;
+        case 83: // DXGI_FORMAT_BC5_UNORM
+            return TextureFormatType::BC5;
+        case 95: // DXGI_FORMAT_BC6H_UF16
+            return TextureFormatType::BC6H;
+        case 98: // DXGI_FORMAT_BC7_UNORM
+            return TextureFormatType::BC7;
+        case 99: // DXGI_FORMAT_BC7_UNORM_SRGB
+            return TextureFormatType::BC7_SRGB;
+        default:
+            break;
+    }
+
+    return TextureFormatType::InvaliTextureType;
+}
+
+static ui32 getDXGIFormat(TextureFormatType format) {
+    switch (format) {
+        case TextureFormatType::BC6H:
+            return 95;
+        case TextureFormatType::BC7:
+            return 98;
+        case TextureFormatType::BC1_SRGB:
+            return 72;
+        case TextureFormatType::BC2_SRGB:
+            return 75;
+        case TextureFormatType::BC3_SRGB:
+            return 78;
+        case TextureFormatType::BC7_SRGB:
+            return 99;
+        default:
+            break;
+    }
+
+    return 0;
+}
+
+static TextureFormatType getFormatFromVkFormat(ui32 vkFormat) {
+    switch (vkFormat) {
+        case 131: // VK_FORMAT_BC1_RGB_UNORM_BLOCK
+        case 133: // VK_FORMAT_BC1_RGBA_UNORM_BLOCK
+            return TextureFormatType::BC1;
+        case 132: // VK_FORMAT_BC1_RGB_SRGB_BLOCK
+        case 134: // VK_FORMAT_BC1_RGBA_SRGB_BLOCK
+            return TextureFormatType::BC1_SRGB;
+        case 135: // VK_FORMAT_BC2_UNORM_BLOCK
+            return TextureFormatType::BC2;
+        case 136: // VK_FORMAT_BC2_SRGB_BLOCK
+            return TextureFormatType::BC2_SRGB;
+        case 137: // VK_FORMAT_BC3_UNORM_BLOCK
+            return TextureFormatType::BC3;
+        case 138: // VK_FORMAT_BC3_SRGB_BLOCK
+            return TextureFormatType::BC3_SRGB;
+        case 139: // VK_FORMAT_BC4_UNORM_BLOCK
+            return TextureFormatType::BC4;
+        case 141: // VK_FORMAT_BC5_UNORM_BLOCK
+            return TextureFormatType::BC5;
+        case 143: // VK_FORMAT_BC6H_UFLOAT_BLOCK
+            return TextureFormatType::BC6H;
+        case 145: // VK_FORMAT_BC7_UNORM_BLOCK
+            return TextureFormatType::BC7;
+        case 146: // VK_FORMAT_BC7_SRGB_BLOCK
+            return TextureFormatType::BC7_SRGB;
+        default:
+            break;
+    }
+
+    return TextureFormatType::InvaliTextureType;
+}
+
+TextureContainer::TextureContainer() :
+        m_data(nullptr),
+        m_size(0),
+        m_format(TextureFormatType::InvaliTextureType),
+        m_width(0),
+        m_height(0),
+        m_levels() {
+    // empty
+}
+
+TextureContainer::~TextureContainer() {
+    // empty
+}
+
+bool TextureContainer::isContainer(const uc8 *data, size_t size) {
+    if (nullptr == data) {
+        return false;
+    }
+
+    if (size >= sizeof(ui32) && DDSMagic == readUI32(data)) {
+        return true;
+    }
+
+    return size >= sizeof(KTX2Identifier) && 0 == ::memcmp(data, KTX2Identifier, sizeof(KTX2Identifier));
+}
+
+bool TextureContainer::isContainerFile(const String &filename) {
+    const String::size_type pos = filename.rfind('.');
+    if (String::npos == pos) {
+        return false;
+    }
+
+    String ext = filename.substr(pos + 1);
+    for (size_t i = 0; i < ext.size(); ++i) {
+        ext[i] = static_cast<c8>(::tolower(ext[i]));
+    }
+
+    return "dds" == ext || "ktx2" == ext;
+}
+
+bool TextureContainer::isCompressed(TextureFormatType format) {
+    return 0 != getBlockSize(format);
+}
+
+ui32 TextureContainer::getBlockSize(TextureFormatType format) {
+    switch (format) {
+        case TextureFormatType::BC1:
+        case TextureFormatType::BC1_SRGB:
+        case TextureFormatType::BC4:
+            return 8;
+        case TextureFormatType::BC2:
+        case TextureFormatType::BC2_SRGB:
+        case TextureFormatType::BC3:
+        case TextureFormatType::BC3_SRGB:
+        case TextureFormatType::BC5:
+        case TextureFormatType::BC6H:
+        case TextureFormatType::BC7:
+        case TextureFormatType::BC7_SRGB:
+            return 16;
+        default:
+            break;
+    }
+
+    return 0;
+}
+
+size_t TextureContainer::getLevelSize(TextureFormatType format, ui32 width, ui32 height) {
+    const size_t blocksX = (width + 3) / 4;
+    const size_t blocksY = (height + 3) / 4;
+
+    return blocksX * blocksY * getBlockSize(format);
+}
+
+bool TextureContainer::parse(const uc8 *data, size_t size) {
+    m_data = data;
+    m_size = size;
+    m_format = TextureFormatType::InvaliTextureType;
+    m_width = 0;
+    m_height = 0;
+    m_levels.clear();
+    if (!isContainer(data, size)) {
+        osre_debug(Tag, "Unknown texture container.");
+        return false;
+    }
+
+    const bool result = DDSMagic == readUI32(data) ? parseDDS() : parseKTX2();
+    if (!result) {
+        m_levels.clear();
+    }
+
+    return result;
+}
+
+bool TextureContainer::parseDDS() {
+    if (m_size < sizeof(ui32) + DDSHeaderSize) {
+        osre_error(Tag, "DDS header is truncated.");
+        return false;
+    }
+
+    const uc8 *header = &m_data[sizeof(ui32)];
+    if (DDSHeaderSize != readUI32(&header[0]) || DDSPixelFormatSize != readUI32(&header[72])) {
+        osre_error(Tag, "Invalid DDS header.");
+        return false;
+    }
+
+    const ui32 flags = readUI32(&header[4]);
+    m_height = readUI32(&header[8]);
+    m_width = readUI32(&header[12]);
+    const ui32 mipMapCount = readUI32(&header[24]);
+    const ui32 pfFlags = readUI32(&header[76]);
+    const ui32 fourCC = readUI32(&header[80]);
+    const ui32 caps2 = readUI32(&header[108]);
+    if (0 != (caps2 & (DDSCaps2CubeMap | DDSCaps2Volume))) {
+        osre_error(Tag, "Only 2D textures are supported.");
+        return false;
+    }
+
+    if (0 == (pfFlags & DDPFFourCC)) {
+        osre_error(Tag, "Only block compressed DDS files are supported.");
+        return false;
+    }
+
+    size_t offset = sizeof(ui32) + DDSHeaderSize;
+    if (fourCC == makeFourCC('D', 'X', '1', '0')) {
+        if (m_size < offset + DDSHeaderDX10Size) {
+            osre_error(Tag, "DDS header is truncated.");
+            return false;
+        }
+        const uc8 *dx10 = &m_data[offset];
+        m_format = getFormatFromDXGI(readUI32(&dx10[0]));
+        if (readUI32(&dx10[12]) > 1) {
+            osre_error(Tag, "Texture arrays are not supported.");
+            return false;
+        }
+        offset += DDSHeaderDX10Size;
+    } else {
+        m_format = getFormatFromFourCC(fourCC);
+    }
+
+    if (TextureFormatType::InvaliTextureType == m_format) {
+        osre_error(Tag, "Unsupported DDS format.");
+        return false;
+    }
+
+    const ui32 numLevels = (0 != (flags & DDSDMipMapCount) && 0 != mipMapCount) ? mipMapCount : 1;
+
+    return addLevels(offset, numLevels);
+}
+
+bool TextureContainer::parseKTX2() {
+    if (m_size < KTX2HeaderSize) {
+        osre_error(Tag, "KTX2 header is truncated.");
+        return false;
+    }
+
+    const ui32 vkFormat = readUI32(&m_data[12]);
+    m_width = readUI32(&m_data[20]);
+    m_height = readUI32(&m_data[24]);
+    const ui32 depth = readUI32(&m_data[28]);
+    const ui32 layerCount = readUI32(&m_data[32]);
+    const ui32 faceCount = readUI32(&m_data[36]);
+    const ui32 levelCount = readUI32(&m_data[40]);
+    const ui32 supercompression = readUI32(&m_data[44]);
+    if (0 == m_width || 0 == m_height || 0 != depth || layerCount > 1 || 1 != faceCount) {
+        osre_error(Tag, "Only 2D textures are supported.");
+        return false;
+    }
+
+    if (0 != supercompression) {
+        osre_error(Tag, "Supercompressed KTX2 files are not supported.");
+        return false;
+    }
+
+    m_format = getFormatFromVkFormat(vkFormat);
+    if (TextureFormatType::InvaliTextureType == m_format) {
+        osre_error(Tag, "Unsupported KTX2 format.");
+        return false;
+    }
+
+    // A level count of 0 asks for generated mips, only the base level is stored then
+    const ui32 numLevels = 0 == levelCount ? 1 : levelCount;
+    if (numLevels > MaxLevels) {
+        osre_error(Tag, "Too many KTX2 levels.");
+        return false;
+    }
+    if (m_size < KTX2HeaderSize + numLevels * KTX2LevelIndexSize) {
+        osre_error(Tag, "KTX2 level index is truncated.");
+        return false;
+    }
+
+    for (ui32 i = 0; i < numLevels; ++i) {
+        const uc8 *index = &m_data[KTX2HeaderSize + i * KTX2LevelIndexSize];
+        TextureMipLevel level;
+        level.m_width = m_width >> i > 0 ? m_width >> i : 1;
+        level.m_height = m_height >> i > 0 ? m_height >> i : 1;
+        level.m_offset = static_cast<size_t>(readUI64(&index[0]));
+        level.m_size = static_cast<size_t>(readUI64(&index[8]));
+        if (level.m_size != getLevelSize(m_format, level.m_width, level.m_height) ||
+                level.m_offset > m_size || level.m_size > m_size - level.m_offset) {
+            osre_error(Tag, "Invalid KTX2 level.");
+            return false;
+        }
+        m_levels.add(level);
+    }
+
+    return true;
+}
+
+bool TextureContainer::addLevels(size_t offset, ui32 numLevels) {
+    if (0 == m_width || 0 == m_height || numLevels > MaxLevels) {
+        osre_error(Tag, "Invalid texture size.");
+        return false;
+    }
+
+    for (ui32 i = 0; i < numLevels; ++i) {
+        TextureMipLevel level;
+        level.m_width = m_width >> i > 0 ? m_width >> i : 1;
+        level.m_height = m_height >> i > 0 ? m_height >> i : 1;
+        level.m_offset = offset;
+        level.m_size = getLevelSize(m_format, level.m_width, level.m_height);
+        if (offset > m_size || level.m_size > m_size - offset) {
+            osre_error(Tag, "Texture levels are truncated.");
+            return false;
+        }
+        m_levels.add(level);
+        offset += level.m_size;
+    }
+
+    return true;
+}
+
+bool TextureContainer::writeDDS(TextureFormatType format, ui32 width, ui32 height, ui32 numLevels,
+        const uc8 *levels, size_t size, MemoryBuffer &buffer) {
+    if (!isCompressed(format) || 0 == width || 0 == height || 0 == numLevels || numLevels > MaxLevels ||
+            nullptr == levels) {
+        return false;
+    }
+
+    size_t expected(0);
+    for (ui32 i = 0; i < numLevels; ++i) {
+        const ui32 w = width >> i > 0 ? width >> i : 1;
+        const ui32 h = height >> i > 0 ? height >> i : 1;
+        expected += getLevelSize(format, w, h);
+    }
+    if (expected != size) {
+        osre_error(Tag, "Size of the levels does not match.");
+        return false;
+    }
+
+    const ui32 fourCC = getFourCC(format);
+    const bool dx10 = fourCC == makeFourCC('D', 'X', '1', '0');
+    const size_t headerSize = sizeof(ui32) + DDSHeaderSize + (dx10 ? DDSHeaderDX10Size : 0);
+    buffer.resize(headerSize + size);
+    uc8 *data = reinterpret_cast<uc8 *>(&buffer[0]);
+    ::memset(data, 0, headerSize);
+
+    writeUI32(&data[0], DDSMagic);
+    uc8 *header = &data[sizeof(ui32)];
+    writeUI32(&header[0], DDSHeaderSize);
+    writeUI32(&header[4], DDSDCaps | DDSDHeight | DDSDWidth | DDSDPixelFormat | DDSDLinearSize |
+                                  (numLevels > 1 ? DDSDMipMapCount : 0));
+    writeUI32(&header[8], height);
+    writeUI32(&header[12], width);
+    writeUI32(&header[16], static_cast<ui32>(getLevelSize(format, width, height)));
+    writeUI32(&header[24], numLevels);
+    writeUI32(&header[72], DDSPixelFormatSize);
+    writeUI32(&header[76], DDPFFourCC);
+    writeUI32(&header[80], fourCC);
+    writeUI32(&header[104], DDSCapsTexture | (numLevels > 1 ? DDSCapsComplex | DDSCapsMipMap : 0));
+    if (dx10) {
+        uc8 *ext = &data[sizeof(ui32) + DDSHeaderSize];
+        writeUI32(&ext[0], getDXGIFormat(format));
+        writeUI32(&ext[4], 3); // D3D10_RESOURCE_DIMENSION_TEXTURE2D
+        writeUI32(&ext[12], 1);
+    }
+    ::memcpy(&data[headerSize], levels, size);
+
+    return true;
+}
+
+} // Namespace RenderBackend
+} // Namespace OSRE
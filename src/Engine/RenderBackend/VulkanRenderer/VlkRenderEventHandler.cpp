@@ -66,6 +66,12 @@ bool VlkRenderEventHandler::onEvent( const Event &ev, const EventData *data ) {
         result = onClearGeo( data );
     } else if ( OnRenderFrameEvent == ev ) {
         result = onRenderFrame( data );
+
+        // The submitter may wait for the frame
+        const RenderFrameEventData *frameData = ( const RenderFrameEventData* ) data;
+        if ( nullptr != frameData && nullptr != frameData->m_frame ) {
+            frameData->m_frame->m_fence.retire();
+        }
     }/* else if ( OnSetParameterEvent == ev ) {
         result = onUpdateParameter( data );
     }*/
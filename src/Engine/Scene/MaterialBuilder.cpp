@@ -56,79 +56,118 @@ static const String GLSLCombinedMVPUniformSrc =
         "// uniforms\n"
         "uniform mat4 MVP;	//combined modelview projection matrix\n";
 
-static const String GLSLVsSrc =
-        GLSLVersionString_400 +
-        "\n"
-        "layout(location = 0) in vec3 position;	 // object space vertex position\n"
-        "layout(location = 1) in vec3 normal;    // object space vertex normal\n"
-        "layout(location = 2) in vec3 color0;    // per-vertex colour\n"
-        "\n"
-        "// output from the vertex shader\n"
-        "smooth out vec4 vSmoothColor;		//smooth colour to fragment shader\n"
-        "\n" +
-        GLSLCombinedMVPUniformSrc +
-        "\n"
-        "void main() {\n"
-        "    // assign the per-vertex color to vSmoothColor varying\n"
-        "    vSmoothColor = vec4(color0,1);\n"
-        "    // get the clip space position by multiplying the combined MVP matrix with the object space\n"
-        "    // vertex position\n"
-        "    gl_Position = MVP*vec4(position,1);\n"
-        "}\n";
-
-const String GLSLFsSrc =
-        GLSLVersionString_400 +
-        "\n"
-        "layout(location=0) out vec4 vFragColor; //fragment shader output\n"
+static const String GLSLVariantVsSrc =
+        "// RenderVertex layout, the texture coordinates are only read by textured variants\n"
+        "layout(location = 0) in vec3 position;   // object space vertex position\n"
+        "layout(location = 1) in vec3 normal;     // object space vertex normal\n"
+        "layout(location = 2) in vec3 color0;     // per-vertex diffuse colour\n"
+        "#ifdef TEXTURED\n"
+        "layout(location = 3) in vec2 texcoord0;  // per-vertex tex coord, stage 0\n"
+        "#endif\n"
         "\n"
-        "//input form the vertex shader\n"
-        "smooth in vec4 vSmoothColor;		//interpolated colour to fragment shader\n"
+        "#ifdef INSTANCED\n"
+        "// per-instance data\n"
+        "layout(location = 4) in vec4 instance0;  // first row of the instance transform\n"
+        "layout(location = 5) in vec4 instance1;  // second row of the instance transform\n"
+        "layout(location = 6) in vec4 instance2;  // third row of the instance transform\n"
+        "layout(location = 7) in vec4 instance3;  // instance colour\n"
+        "#endif\n"
         "\n"
-        "void main() {\n"
-        "    // set the interpolated color as the shader output\n"
-        "    vFragColor = vSmoothColor;\n"
-        "}\n";
-
-const String GLSLVsSrcRV =
-        GLSLVersionString_400 +
-        "\n" + GLSLRenderVertexLayout +
+        "#ifdef SKINNED\n"
+        "layout(location = 8) in vec4 indices;  // indices of up to four bones\n"
+        "layout(location = 9) in vec4 weights;  // weights of the bones\n"
+        "uniform mat4 Bones[MAX_BONES];\n"
+        "#endif\n"
         "\n"
         "// output from the vertex shader\n"
         "smooth out vec4 vSmoothColor;		//smooth colour to fragment shader\n"
+        "#ifdef TEXTURED\n"
         "smooth out vec2 vUV;\n"
+        "#endif\n"
+        "#ifdef LIT\n"
+        "smooth out vec3 vNormal;\n"
+        "#endif\n"
         "\n" +
         GLSLCombinedMVPUniformSrc +
         "\n"
-        "void main()\n"
-        "{\n"
-        "    //assign the per-vertex color to vSmoothColor varying\n"
-        "    vSmoothColor = vec4(color0,1);\n"
+        "void main() {\n"
+        "    vec4 pos = vec4(position, 1);\n"
+        "    vec3 nrm = normal;\n"
+        "#ifdef SKINNED\n"
+        "    mat4 skin = Bones[int(indices.x)] * weights.x + Bones[int(indices.y)] * weights.y +\n"
+        "            Bones[int(indices.z)] * weights.z + Bones[int(indices.w)] * weights.w;\n"
+        "    pos = skin * pos;\n"
+        "    nrm = mat3(skin) * nrm;\n"
+        "#endif\n"
+        "#ifdef INSTANCED\n"
+        "    mat4 model = transpose(mat4(instance0, instance1, instance2, vec4(0, 0, 0, 1)));\n"
+        "    pos = model * pos;\n"
+        "    nrm = mat3(model) * nrm;\n"
+        "#endif\n"
+        "#ifdef DRAW_DATA\n"
+        "    // merged draws read their model matrix, MVP is the view projection then\n"
+        "    if (DrawDataEnabled != 0) {\n"
+        "        pos = Draws[OSRE_DRAW_INDEX].Model * pos;\n"
+        "    }\n"
+        "#endif\n"
+        "    gl_Position = MVP * pos;\n"
         "\n"
-        "    //get the clip space position by multiplying the combined MVP matrix with the object space\n"
-        "    //vertex position\n"
-        "    gl_Position = MVP*vec4(position,1);\n"
-        "    vSmoothColor = vec4( color0, 1 );\n"
+        "#ifdef VERTEX_COLOR\n"
+        "    vSmoothColor = vec4(color0, 1);\n"
+        "#else\n"
+        "    vSmoothColor = vec4(1);\n"
+        "#endif\n"
+        "#ifdef INSTANCED\n"
+        "    vSmoothColor *= instance3;\n"
+        "#endif\n"
+        "#ifdef TEXTURED\n"
         "    vUV = texcoord0;\n"
+        "#endif\n"
+        "#ifdef LIT\n"
+        "    vNormal = nrm;\n"
+        "#endif\n"
         "}\n";
 
-const String GLSLFsSrcRV =
-        GLSLVersionString_400 +
-        "\n"
+static const String GLSLVariantFsSrc =
         "layout(location=0) out vec4 vFragColor; //fragment shader output\n"
         "\n"
         "//input form the vertex shader\n"
         "smooth in vec4 vSmoothColor;		//interpolated colour to fragment shader\n"
+        "#ifdef TEXTURED\n"
         "smooth in vec2 vUV;\n"
+        "#ifdef TEXTURE_ARRAY\n"
+        "uniform sampler2DArray tex0;\n"
+        "#else\n"
         "uniform sampler2D tex0;\n"
+        "#endif\n"
+        "#endif\n"
+        "#ifdef LIT\n"
+        "smooth in vec3 vNormal;\n"
         "\n"
-        "void main()\n"
-        "{\n"
-        "    // set the interpolated color as the shader output\n"
-        "    vec4 texColor = texture( tex0, vUV );\n"
-        //"    vFragColor = vSmoothColor * texColor;\n"
-        "    vFragColor = texture( tex0, vUV );\n"
+        "// fixed directional light\n"
+        "vec3 LightDir = vec3(0.4, 0.8, 0.45);\n"
+        "vec3 La = vec3(0.2, 0.2, 0.2); // grey ambient colour\n"
+        "#endif\n"
+        "\n"
+        "void main() {\n"
+        "    vec4 color = vSmoothColor;\n"
+        "#ifdef TEXTURE_ARRAY\n"
+        "    // the integer part of u is the layer, the gradients of vUV keep the mip selection smooth\n"
+        "    float layer = floor(vUV.x);\n"
+        "    color *= textureGrad(tex0, vec3(vUV.x - layer, vUV.y, layer), dFdx(vUV), dFdy(vUV));\n"
+        "#elif defined(TEXTURED)\n"
+        "    color *= texture(tex0, vUV);\n"
+        "#endif\n"
+        "#ifdef LIT\n"
+        "    float diffuse = max(dot(normalize(vNormal), normalize(LightDir)), 0.0);\n"
+        "    color.rgb *= La + (vec3(1.0) - La) * diffuse;\n"
+        "#endif\n"
+        "    vFragColor = color;\n"
         "}\n";
 
+/// The number of bone matrices of skinned variants.
+static const ui32 MaxBones = 64;
+
 const String GLSLVsSrcRV_Editor =
         GLSLVersionString_400 +
         "\n" + GLSLRenderVertexLayout +
@@ -207,54 +246,6 @@ const String GLSLFsSrcRV_Editor =
         "    FragColor = vec4(ambAndDiff, 1.0) * texColor;\n"
         "}\n";
 
-const String GLSLVsSrcUI =
-        GLSLVersionString_400 +
-        "\n" + GLSLRenderVertexLayout +
-        "\n"
-        "// fixed point light properties\n"
-        "vec3 light_position_world = vec3 (0.0, 0.0, 2.0);\n"
-        "vec3 Ls = vec3 (1.0, 1.0, 1.0); // white specular colour\n"
-        "vec3 Ld = vec3 (0.7, 0.7, 0.7); // dull white diffuse light colour\n"
-        "vec3 La = vec3 (0.2, 0.2, 0.2); // grey ambient colour\n"
-        "\n"
-        "// surface reflectance\n"
-        "vec3 Ks = vec3 (1.0, 1.0, 1.0); // fully reflect specular light\n"
-        "vec3 Kd = vec3 (1.0, 0.5, 0.0); // orange diffuse surface reflectance\n"
-        "vec3 Ka = vec3 (1.0, 1.0, 1.0); // fully reflect ambient light\n"
-        "float specular_exponent = 100.0; // specular 'power'\n"
-        "\n"
-        "// output from the vertex shader\n"
-        "smooth out vec4 vSmoothColor;		//smooth colour to fragment shader\n"
-        "smooth out vec2 vUV;\n"
-        "\n" +
-        GLSLCombinedMVPUniformSrc +
-        "\n"
-        "void main() {\n"
-        "    //assign the per-vertex color to vSmoothColor varying\n"
-        "    vSmoothColor = vec4(color0,1);\n"
-        "\n"
-        "    //get the clip space position by multiplying the combined MVP matrix with the object space\n"
-        "    //vertex position\n"
-        "    gl_Position = MVP*vec4(position,1);\n"
-        "    vSmoothColor = vec4( color0, 1 );\n"
-        "    vUV = texcoord0;\n"
-        "}\n";
-
-const String GLSLFsSrcUI =
-        GLSLVersionString_400 +
-        "\n"
-        "layout(location=0) out vec4 vFragColor; //fragment shader output\n"
-        "\n"
-        "//input form the vertex shader\n"
-        "smooth in vec4 vSmoothColor;		//interpolated colour to fragment shader\n"
-        "smooth in vec2 vUV;\n"
-        "uniform sampler2D tex0;\n"
-        "\n"
-        "void main() {\n"
-        "    // set the interpolated color as the shader output\n"
-        "    vFragColor = vSmoothColor;\n"
-        "}\n";
-
 static const String GLSLVSLightRenderVertexSrc =
         "";
 
@@ -287,69 +278,156 @@ void MaterialBuilder::destroy() {
     s_materialCache = nullptr;
 }
 
-Material *MaterialBuilder::createBuildinMaterial(VertexType type) {
-    Material *mat = s_materialCache->find("buildinShaderMaterial");
-    if (nullptr != mat) {
-        return mat;
+static const ui32 TexturedFeature = static_cast<ui32>(ShaderFeatureType::Textured);
+static const ui32 VertexColorFeature = static_cast<ui32>(ShaderFeatureType::VertexColor);
+static const ui32 InstancedFeature = static_cast<ui32>(ShaderFeatureType::Instanced);
+static const ui32 SkinnedFeature = static_cast<ui32>(ShaderFeatureType::Skinned);
+static const ui32 LitFeature = static_cast<ui32>(ShaderFeatureType::Lit);
+static const ui32 TextureArrayFeature = static_cast<ui32>(ShaderFeatureType::TextureArray);
+
+String MaterialBuilder::getVariantName(ui32 features) {
+    c8 name[32];
+    ::snprintf(name, sizeof(name), "variant_%02x", features);
+
+    return String(name);
+}
+
+String MaterialBuilder::getVariantDefines(ui32 features) {
+    String defines;
+    if (features & TexturedFeature) {
+        defines += "#define TEXTURED\n";
     }
-    mat = s_materialCache->create("buildinShaderMaterial", IO::Uri());
-    //mat = new Material( "buildinShaderMaterial", MaterialType::ShaderMaterial);
-    String vs, fs;
-    if (type == VertexType::ColorVertex) {
-        vs = GLSLVsSrc;
-        fs = GLSLFsSrc;
-    } else if (type == VertexType::RenderVertex) {
-        vs = GLSLVsSrcRV;
-        fs = GLSLFsSrcRV;
+    if (features & VertexColorFeature) {
+        defines += "#define VERTEX_COLOR\n";
     }
-    if (vs.empty() || fs.empty()) {
-        delete mat;
-        return nullptr;
+    if (features & InstancedFeature) {
+        defines += "#define INSTANCED\n";
+    }
+    if (features & SkinnedFeature) {
+        c8 maxBones[48];
+        ::snprintf(maxBones, sizeof(maxBones), "#define SKINNED\n#define MAX_BONES %u\n", MaxBones);
+        defines += maxBones;
     }
+    if (features & LitFeature) {
+        defines += "#define LIT\n";
+    }
+    if (features & TextureArrayFeature) {
+        defines += "#define TEXTURE_ARRAY\n";
+    }
+    if (0 == (features & (InstancedFeature | SkinnedFeature))) {
+        // The backend declares the per-draw data of merged draws after this define
+        defines += "#define DRAW_DATA\n";
+    }
+
+    return defines;
+}
 
+void MaterialBuilder::getVariantSources(ui32 features, ShaderSourceArray &sources) {
+    const String header = GLSLVersionString_400 + getVariantDefines(features) + "\n";
+    sources[static_cast<size_t>(ShaderType::SH_VertexShaderType)] = header + GLSLVariantVsSrc;
+    sources[static_cast<size_t>(ShaderType::SH_FragmentShaderType)] = header + GLSLVariantFsSrc;
+}
+
+static bool isVariantSupported(ui32 features, VertexType type) {
+    // The layer is sampled with the texture coordinates
+    if ((features & TextureArrayFeature) && 0 == (features & TexturedFeature)) {
+        return false;
+    }
+
+    if (type == VertexType::RenderVertex) {
+        return true;
+    }
+
+    // Color vertices do not provide texture coordinates
+    return type == VertexType::ColorVertex && 0 == (features & TexturedFeature);
+}
+
+void MaterialBuilder::setupVariantShader(Material *mat, ui32 features, VertexType type) {
     ShaderSourceArray arr;
-    arr[static_cast<size_t>(ShaderType::SH_VertexShaderType)] = vs;
-    arr[static_cast<size_t>(ShaderType::SH_FragmentShaderType)] = fs;
+    getVariantSources(features, arr);
     mat->createShader(arr);
 
-    // Setup shader attributes and variables
-    if (nullptr != mat->m_shader) {
-        if (type == VertexType::ColorVertex) {
-            mat->m_shader->m_attributes.add(ColorVert::getAttributes(),
-                    ColorVert::getNumAttributes());
-        } else if (type == VertexType::RenderVertex) {
-            mat->m_shader->m_attributes.add(RenderVert::getAttributes(),
-                    RenderVert::getNumAttributes());
-        }
-
-        mat->m_shader->m_parameters.add("MVP");
+    // Setup shader attributes and variables, the instance attributes follow the vertex ones
+    mat->m_shader->m_name = getVariantName(features);
+    if (type == VertexType::ColorVertex) {
+        mat->m_shader->m_attributes.add(ColorVert::getAttributes(), ColorVert::getNumAttributes());
+    } else {
+        mat->m_shader->m_attributes.add(RenderVert::getAttributes(), RenderVert::getNumAttributes());
+    }
+    if (features & InstancedFeature) {
+        mat->m_shader->m_attributes.add(InstanceVert::getAttributes(), InstanceVert::getNumAttributes());
+    }
+    mat->m_shader->m_parameters.add("MVP");
+    if (features & SkinnedFeature) {
+        mat->m_shader->m_attributes.add(getVertCompName(VertexAttribute::Indices));
+        mat->m_shader->m_attributes.add(getVertCompName(VertexAttribute::Weights));
+        mat->m_shader->m_parameters.add("Bones");
+    }
+}
+
+Material *MaterialBuilder::createVariantMaterial(const String &matName, ui32 features, VertexType type) {
+    if (matName.empty()) {
+        return nullptr;
+    }
+
+    Material *mat = s_materialCache->find(matName);
+    if (nullptr != mat) {
+        return mat;
+    }
+
+    if (!isVariantSupported(features, type)) {
+        return nullptr;
     }
 
+    mat = s_materialCache->create(matName, IO::Uri());
+    setupVariantShader(mat, features, type);
+
     return mat;
 }
 
+Material *MaterialBuilder::createBuildinMaterial(VertexType type) {
+    ui32 features(0);
+    if (type == VertexType::ColorVertex) {
+        features = VertexColorFeature;
+    } else if (type == VertexType::RenderVertex) {
+        features = TexturedFeature;
+    } else {
+        return nullptr;
+    }
+
+    return createVariantMaterial("buildinShaderMaterial_" + getVariantName(features), features, type);
+}
+
 Material *MaterialBuilder::createBuildinUiMaterial() {
-    Material *mat = s_materialCache->find("buildinUiShaderMaterial");
+    return createVariantMaterial("buildinUiShaderMaterial", VertexColorFeature, VertexType::RenderVertex);
+}
+
+Material *MaterialBuilder::createBuildinInstancedMaterial() {
+    return createVariantMaterial("buildinInstancedShaderMaterial", VertexColorFeature | InstancedFeature,
+            VertexType::RenderVertex);
+}
+
+Material *MaterialBuilder::createAtlasMaterial(const String &matName, Texture *atlasTexture, const TextureRegion &region) {
+    if (matName.empty() || nullptr == atlasTexture) {
+        return nullptr;
+    }
+
+    Material *mat = s_materialCache->find(matName);
     if (nullptr != mat) {
         return mat;
     }
 
-    mat = s_materialCache->create("buildinUiShaderMaterial", IO::Uri());
-    ShaderSourceArray arr;
-    arr[static_cast<ui32>(ShaderType::SH_VertexShaderType)] = GLSLVsSrcUI;
-    arr[static_cast<ui32>(ShaderType::SH_FragmentShaderType)] = GLSLFsSrcUI;
-    mat->createShader(arr);
-
-    // setup shader attributes and variables
-    if (nullptr != mat->m_shader) {
-        size_t numAttribs(RenderVert::getNumAttributes());
-        const String *attribs(RenderVert::getAttributes());
-        if (numAttribs > 0) {
-            mat->m_shader->m_attributes.add(attribs, numAttribs);
-            mat->m_shader->m_parameters.add("MVP");
-        }
+    if (TextureTargetType::Texture2DArray != atlasTexture->m_targetType) {
+        return nullptr;
     }
 
+    mat = s_materialCache->create(matName);
+    mat->m_numTextures = 1;
+    mat->m_textures = new Texture *[1];
+    mat->m_textures[0] = atlasTexture;
+    mat->m_region = region;
+    setupVariantShader(mat, TexturedFeature | TextureArrayFeature, VertexType::RenderVertex);
+
     return mat;
 }
 
@@ -364,6 +442,11 @@ RenderBackend::Material *MaterialBuilder::createTexturedMaterial(const String &m
         return mat;
     }
 
+    const ui32 features = type == VertexType::ColorVertex ? VertexColorFeature : TexturedFeature;
+    if (!isVariantSupported(features, type)) {
+        return nullptr;
+    }
+
     mat = s_materialCache->create(matName);
     mat->m_numTextures = texResArray.size();
     mat->m_textures = new Texture *[texResArray.size()];
@@ -373,36 +456,7 @@ RenderBackend::Material *MaterialBuilder::createTexturedMaterial(const String &m
         texRes->load(loader);
         mat->m_textures[i] = texRes->get();
     }
-
-    String vs, fs;
-    if (type == VertexType::ColorVertex) {
-        vs = GLSLVsSrc;
-        fs = GLSLFsSrc;
-    } else if (type == VertexType::RenderVertex) {
-        vs = GLSLVsSrcRV;
-        fs = GLSLFsSrcRV;
-    }
-
-    if (vs.empty() || fs.empty()) {
-        delete mat;
-        return nullptr;
-    }
-
-    ShaderSourceArray arr;
-    arr[static_cast<ui32>(ShaderType::SH_VertexShaderType)] = vs;
-    arr[static_cast<ui32>(ShaderType::SH_FragmentShaderType)] = fs;
-    mat->createShader(arr);
-
-    // Setup shader attributes and variables
-    if (nullptr != mat->m_shader) {
-        if (type == VertexType::ColorVertex) {
-            mat->m_shader->m_attributes.add(ColorVert::getAttributes(), ColorVert::getNumAttributes());
-        } else if (type == VertexType::RenderVertex) {
-            mat->m_shader->m_attributes.add(RenderVert::getAttributes(), RenderVert::getNumAttributes());
-        }
-
-        mat->m_shader->m_parameters.add("MVP");
-    }
+    setupVariantShader(mat, features, type);
 
     return mat;
 }
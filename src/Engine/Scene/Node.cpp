@@ -160,6 +160,11 @@ void Node::releaseChildren() {
 
 void Node::update(Time dt) {
     onUpdate(dt);
+    for (ui32 i = 0; i < m_children.size(); ++i) {
+        if (nullptr != m_children[i]) {
+            m_children[i]->update(dt);
+        }
+    }
 }
 
 void Node::render(RenderBackendService *renderBackendSrv) {
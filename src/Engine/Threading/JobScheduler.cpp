@@ -0,0 +1,334 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2015-2020 OSRE ( Open Source Render Engine ) by Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#include <osre/Threading/JobScheduler.h>
+#include <osre/Platform/CPUInfo.h>
+#include <osre/Platform/SystemUtils.h>
+#include <osre/Common/Logger.h>
+
+#include <sstream>
+
+namespace OSRE {
+namespace Threading {
+
+using namespace ::OSRE::Platform;
+
+static const c8 *Tag = "JobScheduler";
+
+// The number of failed fetch attempts before an idle thread starts to sleep
+static const ui32 SpinCount = 64;
+
+// The scheduler and worker index of the current thread, nullptr for non-worker threads
+static thread_local JobScheduler *s_currentScheduler = nullptr;
+static thread_local ui32 s_currentWorkerIdx = 0;
+
+//-------------------------------------------------------------------------------------------------
+///	@ingroup	Engine
+///
+///	@brief  A bounded job deque. The owner works at the bottom, thieves steal from the top.
+/// The critical section is only held for a couple of instructions.
+//-------------------------------------------------------------------------------------------------
+class JobDeque {
+public:
+    enum {
+        Capacity = 1024
+    };
+
+    JobDeque() :
+            m_lock(),
+            m_top(0),
+            m_bottom(0) {
+        // empty
+    }
+
+    ~JobDeque() {
+        // empty
+    }
+
+    bool push(const Job &job) {
+        m_lock.enter();
+        if (m_bottom - m_top >= Capacity) {
+            m_lock.leave();
+            return false;
+        }
+        m_jobs[m_bottom % Capacity] = job;
+        ++m_bottom;
+        m_lock.leave();
+
+        return true;
+    }
+
+    bool pop(Job &job) {
+        m_lock.enter();
+        if (m_bottom == m_top) {
+            m_lock.leave();
+            return false;
+        }
+        --m_bottom;
+        job = m_jobs[m_bottom % Capacity];
+        m_lock.leave();
+
+        return true;
+    }
+
+    bool steal(Job &job) {
+        if (!m_lock.tryEnter()) {
+            return false;
+        }
+        if (m_bottom == m_top) {
+            m_lock.leave();
+            return false;
+        }
+        job = m_jobs[m_top % Capacity];
+        ++m_top;
+        m_lock.leave();
+
+        return true;
+    }
+
+private:
+    CriticalSection m_lock;
+    Job m_jobs[Capacity];
+    ui32 m_top;
+    ui32 m_bottom;
+};
+
+//-------------------------------------------------------------------------------------------------
+///	@ingroup	Engine
+///
+///	@brief  The worker thread, runs jobs until the scheduler gets destroyed.
+//-------------------------------------------------------------------------------------------------
+class JobWorkerThread : public Thread {
+public:
+    enum {
+        StackSize = 4096
+    };
+
+    JobWorkerThread(const String &threadName, JobScheduler *scheduler, ui32 workerIdx) :
+            Thread(threadName, StackSize),
+            m_scheduler(scheduler),
+            m_workerIdx(workerIdx),
+            m_done(0) {
+        OSRE_ASSERT(nullptr != scheduler);
+    }
+
+    ~JobWorkerThread() {
+        // empty
+    }
+
+    bool isDone() {
+        return 0 != m_done.getValue();
+    }
+
+protected:
+    i32 run() override {
+        s_currentScheduler = m_scheduler;
+        s_currentWorkerIdx = m_workerIdx;
+
+        ui32 idleCount = 0;
+        Job job;
+        while (0 != m_scheduler->m_running.getValue()) {
+            if (m_scheduler->fetchJob(m_workerIdx, job)) {
+                m_scheduler->execute(job);
+                idleCount = 0;
+                continue;
+            }
+
+            ++idleCount;
+            if (idleCount > SpinCount) {
+                System::SystemUtils::sleep(1);
+            }
+        }
+
+        s_currentScheduler = nullptr;
+        m_done.inc();
+
+        return 0;
+    }
+
+private:
+    JobScheduler *m_scheduler;
+    ui32 m_workerIdx;
+    AtomicInt m_done;
+};
+
+JobScheduler::JobScheduler(ui32 numWorkers) :
+        m_numWorkers(numWorkers),
+        m_workers(),
+        m_deques(),
+        m_running(1),
+        m_numExecuted(0),
+        m_numStolen(0) {
+    OSRE_ASSERT(0 != numWorkers);
+
+    // One deque per worker plus the injection deque for all other threads
+    for (ui32 i = 0; i < m_numWorkers + 1; ++i) {
+        m_deques.add(new JobDeque);
+    }
+
+    // Workers stay away from the physical core reserved for the render thread
+    CPUInfo::init();
+    CPUInfo info;
+    const ui64 workerMask = info.getWorkerThreadMask();
+    for (ui32 i = 0; i < m_numWorkers; ++i) {
+        std::stringstream stream;
+        stream << "job.worker." << i;
+        JobWorkerThread *worker = new JobWorkerThread(stream.str(), this, i);
+        worker->setAffinity(workerMask);
+        if (!worker->start(nullptr)) {
+            osre_error(Tag, "Cannot start worker " + stream.str());
+        }
+        m_workers.add(worker);
+    }
+}
+
+JobScheduler::~JobScheduler() {
+    m_running.decValue(1);
+    for (ui32 i = 0; i < m_workers.size(); ++i) {
+        JobWorkerThread *worker = m_workers[i];
+        if (Thread::ThreadState::Running == worker->getCurrentState()) {
+            while (!worker->isDone()) {
+                System::SystemUtils::sleep(1);
+            }
+            worker->stop();
+        }
+        delete worker;
+    }
+    m_workers.clear();
+
+    // Pending jobs without any waiter are dropped
+    for (ui32 i = 0; i < m_deques.size(); ++i) {
+        delete m_deques[i];
+    }
+    m_deques.clear();
+}
+
+JobScheduler *JobScheduler::create(ui32 numWorkers) {
+    if (0 == numWorkers) {
+        CPUInfo::init();
+        CPUInfo info;
+        ui32 numCPUs = info.getNumCPUs();
+        const ui64 workerMask = info.getWorkerThreadMask();
+        if (0 != workerMask) {
+            numCPUs = 0;
+            for (ui32 cpu = 0; cpu < CPUInfo::MaxCPUs; ++cpu) {
+                if (0 != (workerMask & ((ui64)1 << cpu))) {
+                    ++numCPUs;
+                }
+            }
+        }
+
+        // The thread which waits for the jobs helps out, so keep one core for it
+        numWorkers = numCPUs > 1 ? numCPUs - 1 : 1;
+    }
+
+    return new JobScheduler(numWorkers);
+}
+
+void JobScheduler::run(JobFunc func, void *data, JobCounter *counter) {
+    Job job(func, data, counter);
+    run(&job, 1, counter);
+}
+
+void JobScheduler::run(const Job *jobs, ui32 numJobs, JobCounter *counter) {
+    if (nullptr == jobs || 0 == numJobs) {
+        return;
+    }
+
+    if (nullptr != counter) {
+        counter->m_pending.incValue(static_cast<i32>(numJobs));
+    }
+
+    const ui32 dequeIdx = (this == s_currentScheduler) ? s_currentWorkerIdx : m_numWorkers;
+    JobDeque *deque = m_deques[dequeIdx];
+    for (ui32 i = 0; i < numJobs; ++i) {
+        Job job = jobs[i];
+        job.m_counter = counter;
+        OSRE_ASSERT(nullptr != job.m_func);
+
+        // When the deque is full the job will be executed directly
+        if (!deque->push(job)) {
+            execute(job);
+        }
+    }
+}
+
+void JobScheduler::wait(JobCounter *counter) {
+    if (nullptr == counter) {
+        return;
+    }
+
+    ui32 idleCount = 0;
+    while (!counter->isDone()) {
+        if (executePendingJob()) {
+            idleCount = 0;
+            continue;
+        }
+
+        ++idleCount;
+        if (idleCount > SpinCount) {
+            System::SystemUtils::sleep(1);
+        }
+    }
+}
+
+bool JobScheduler::executePendingJob() {
+    const ui32 dequeIdx = (this == s_currentScheduler) ? s_currentWorkerIdx : m_numWorkers;
+    Job job;
+    if (!fetchJob(dequeIdx, job)) {
+        return false;
+    }
+    execute(job);
+
+    return true;
+}
+
+bool JobScheduler::fetchJob(ui32 workerIdx, Job &job) {
+    if (m_deques[workerIdx]->pop(job)) {
+        return true;
+    }
+
+    // Steal from the other workers and from the injection deque
+    const ui32 numDeques = m_numWorkers + 1;
+    for (ui32 i = 1; i < numDeques; ++i) {
+        const ui32 victimIdx = (workerIdx + i) % numDeques;
+        if (m_deques[victimIdx]->steal(job)) {
+            if (victimIdx != m_numWorkers) {
+                m_numStolen.inc();
+            }
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void JobScheduler::execute(const Job &job) {
+    job.m_func(job.m_data);
+    m_numExecuted.inc();
+    if (nullptr != job.m_counter) {
+        job.m_counter->m_pending.dec();
+    }
+}
+
+} // Namespace Threading
+} // Namespace OSRE
@@ -25,7 +25,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <osre/Debugging/osre_debugging.h>
 #include <osre/Platform/Threading.h>
 #include <osre/Threading/SystemTask.h>
-#include <osre/Threading/TAsyncQueue.h>
+#include <osre/Threading/TMPSCQueue.h>
 #include <osre/Threading/TaskJob.h>
 
 #include <sstream>
@@ -36,10 +36,6 @@ namespace Threading {
 using namespace ::OSRE::Common;
 using namespace ::OSRE::Platform;
 
-TaskJob *TaskJobAlloc(const Event *ev, const EventData *eventData) {
-    return new TaskJob(ev, eventData);
-}
-
 DECL_EVENT(OnStopSystemTaskEvent);
 
 struct OSRE_EXPORT StopSystemTaskEventData : public Common::EventData {
@@ -54,6 +50,9 @@ static const c8 *Tag = "SystemTaskThread";
 
 static bool DebugQueueSize = false;
 
+// The max. number of pending events per system task
+static const size_t QueueCapacity = 4096;
+
 //-------------------------------------------------------------------------------------------------
 ///	@ingroup	Engine
 ///
@@ -66,12 +65,13 @@ public:
         StackSize = 4096
     };
 
-    SystemTaskThread(const String &threadName, TAsyncQueue<const TaskJob *> *jobQueue) :
+    SystemTaskThread(const String &threadName, TMPSCQueue<TaskJob> *jobQueue) :
             Thread(threadName, StackSize),
             m_updateEvent(nullptr),
             m_stopEvent(nullptr),
             m_activeJobQueue(jobQueue),
-            m_eventHandler(nullptr) {
+            m_eventHandler(nullptr),
+            m_jobs() {
         OSRE_ASSERT(nullptr != jobQueue);
 
         m_updateEvent = new ThreadEvent();
@@ -111,11 +111,11 @@ public:
         return m_eventHandler;
     }
 
-    void setActiveJobQueue(Threading::TAsyncQueue<const TaskJob *> *pJobQueue) {
+    void setActiveJobQueue(Threading::TMPSCQueue<TaskJob> *pJobQueue) {
         m_activeJobQueue = pJobQueue;
     }
 
-    Threading::TAsyncQueue<const TaskJob *> *getActiveJobQueue() const {
+    Threading::TMPSCQueue<TaskJob> *getActiveJobQueue() const {
         return m_activeJobQueue;
     }
 
@@ -134,18 +134,20 @@ protected:
         osre_debug(Tag, "SystemThread::run");
         bool running = true;
         while (running) {
+            // Blocks only when the queue is empty, all pending jobs are fetched in one pass
             m_activeJobQueue->awaitEnqueuedItem();
-            while (!m_activeJobQueue->isEmpty()) {
-                // for debugging
-                if (DebugQueueSize) {
-                    size_t size = m_activeJobQueue->size();
-                    std::stringstream stream;
-                    stream << "queue size = " << size << std::endl;
-                    osre_debug(Tag, stream.str());
-                }
+            const size_t numJobs = m_activeJobQueue->dequeueAll(m_jobs);
+
+            // for debugging
+            if (DebugQueueSize) {
+                std::stringstream stream;
+                stream << "queue size = " << numJobs << std::endl;
+                osre_debug(Tag, stream.str());
+            }
 
-                const TaskJob *job = m_activeJobQueue->dequeue();
-                const Common::Event *ev = job->getEvent();
+            for (size_t i = 0; i < numJobs; ++i) {
+                const TaskJob &job = m_jobs[i];
+                const Common::Event *ev = job.getEvent();
                 if (nullptr == ev) {
                     running = false;
                     OSRE_ASSERT(nullptr != ev);
@@ -158,7 +160,7 @@ protected:
                 }
 
                 if (m_eventHandler) {
-                    m_eventHandler->onEvent(*ev, job->getEventData());
+                    m_eventHandler->onEvent(*ev, job.getEventData());
                 }
             }
 
@@ -177,8 +179,9 @@ protected:
 private:
     Platform::ThreadEvent *m_updateEvent;
     Platform::ThreadEvent *m_stopEvent;
-    Threading::TAsyncQueue<const TaskJob *> *m_activeJobQueue;
+    Threading::TMPSCQueue<TaskJob> *m_activeJobQueue;
     Common::AbstractEventHandler *m_eventHandler;
+    CPPCore::TArray<TaskJob> m_jobs;
 };
 
 SystemTask::SystemTask(const String &taskName) :
@@ -186,6 +189,8 @@ SystemTask::SystemTask(const String &taskName) :
         m_workingMode(Async),
         m_buffermode(SingleBuffer),
         m_taskThread(nullptr),
+        m_threadPrio(Thread::Priority::Normal),
+        m_threadAffinity(0),
         m_asyncQueue(nullptr) {
     // empty
 }
@@ -215,6 +220,16 @@ SystemTask::BufferMode SystemTask::getBufferMode() const {
     return m_buffermode;
 }
 
+void SystemTask::setThreadPlacement(Thread::Priority prio, ui64 affinityMask) {
+    if (isRunning()) {
+        osre_error(Tag, "The thread placement cannot be changed in a running task.");
+        return;
+    }
+
+    m_threadPrio = prio;
+    m_threadAffinity = affinityMask;
+}
+
 bool SystemTask::start(Thread *pThread) {
     // ensure task is not running
     if (nullptr != m_taskThread) {
@@ -225,12 +240,14 @@ bool SystemTask::start(Thread *pThread) {
     }
 
     // setup the thread context
-    m_asyncQueue = new Threading::TAsyncQueue<const TaskJob*>();
+    m_asyncQueue = new TaskQueue(QueueCapacity);
     if (!pThread) {
         m_taskThread = new SystemTaskThread(Object::getName() + ".thread", m_asyncQueue);
     } else {
         m_taskThread = reinterpret_cast<SystemTaskThread *>(pThread);
     }
+    m_taskThread->setPriority(m_threadPrio);
+    m_taskThread->setAffinity(m_threadAffinity);
 
     // start the system task
     return (m_taskThread->start(nullptr));
@@ -303,8 +320,8 @@ bool SystemTask::sendEvent(const Event *ev, const EventData *eventData) {
     OSRE_ASSERT(nullptr != m_asyncQueue);
     OSRE_ASSERT(nullptr != ev);
 
-    TaskJob *taskJob = TaskJobAlloc(ev, eventData);
-    m_asyncQueue->enqueue(taskJob);
+    // The job is copied into the queue ring, no allocation here
+    m_asyncQueue->enqueue(TaskJob(ev, eventData));
 
     return true;
 }
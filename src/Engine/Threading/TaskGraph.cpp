@@ -0,0 +1,360 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2015-2020 OSRE ( Open Source Render Engine ) by Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#include <osre/Threading/TaskGraph.h>
+#include <osre/Common/Logger.h>
+
+#include <atomic>
+#include <chrono>
+
+namespace OSRE {
+namespace Threading {
+
+using namespace ::CPPCore;
+
+static const c8 *Tag = "TaskGraph";
+
+static i64 getCurrentMicroSeconds() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+GraphTask::GraphTask(const String &taskName, JobFunc func, void *data) :
+        AbstractTask(taskName),
+        m_func(func),
+        m_data(data) {
+    // empty
+}
+
+GraphTask::~GraphTask() {
+    // empty
+}
+
+void GraphTask::setWorkingMode(WorkingMode) {
+    // empty, runs always in the context of the executing thread
+}
+
+AbstractTask::WorkingMode GraphTask::getWorkingMode() const {
+    return Sync;
+}
+
+void GraphTask::setBufferMode(BufferMode) {
+    // empty
+}
+
+AbstractTask::BufferMode GraphTask::getBufferMode() const {
+    return SingleBuffer;
+}
+
+bool GraphTask::execute() {
+    if (nullptr == m_func) {
+        return false;
+    }
+
+    m_func(m_data);
+
+    return true;
+}
+
+void GraphTask::setThreadInstance(Platform::Thread *) {
+    // empty
+}
+
+void GraphTask::onUpdate() {
+    execute();
+}
+
+void GraphTask::awaitUpdate() {
+    // empty
+}
+
+void GraphTask::awaitStop() {
+    // empty
+}
+
+struct TaskGraph::Node {
+    AbstractTask *m_task;
+    TaskGraph *m_graph;
+    TArray<Node *> m_predecessors;
+    TArray<Node *> m_successors;
+    std::atomic<i32> m_pending;
+    i64 m_start;
+    i64 m_end;
+    i64 m_pathTime;
+    Node *m_pathPredecessor;
+
+    Node(AbstractTask *task, TaskGraph *graph) :
+            m_task(task),
+            m_graph(graph),
+            m_predecessors(),
+            m_successors(),
+            m_pending(0),
+            m_start(0),
+            m_end(0),
+            m_pathTime(0),
+            m_pathPredecessor(nullptr) {
+        // empty
+    }
+
+    void addPredecessor(Node *predecessor) {
+        for (ui32 i = 0; i < m_predecessors.size(); ++i) {
+            if (predecessor == m_predecessors[i]) {
+                return;
+            }
+        }
+        m_predecessors.add(predecessor);
+        predecessor->m_successors.add(this);
+    }
+};
+
+TaskGraph::TaskGraph() :
+        m_nodes(),
+        m_sorted(),
+        m_criticalPath(),
+        m_scheduler(nullptr),
+        m_counter(nullptr),
+        m_executionTime(),
+        m_criticalPathTime(),
+        m_dirty(false) {
+    // empty
+}
+
+TaskGraph::~TaskGraph() {
+    clear();
+}
+
+bool TaskGraph::addTask(AbstractTask *task) {
+    if (nullptr == task) {
+        osre_debug(Tag, "Pointer to task is nullptr.");
+        return false;
+    }
+
+    if (-1 != findNode(task)) {
+        return false;
+    }
+
+    m_nodes.add(new Node(task, this));
+    m_dirty = true;
+
+    return true;
+}
+
+bool TaskGraph::addDependency(AbstractTask *task, AbstractTask *predecessor) {
+    if (nullptr == task || nullptr == predecessor || task == predecessor) {
+        osre_debug(Tag, "Invalid dependency.");
+        return false;
+    }
+
+    addTask(task);
+    addTask(predecessor);
+    m_nodes[findNode(task)]->addPredecessor(m_nodes[findNode(predecessor)]);
+    m_dirty = true;
+
+    return true;
+}
+
+bool TaskGraph::compile() {
+    // Child tasks enqueued by AbstractTask::enqueue must be done before their parent
+    for (ui32 i = 0; i < m_nodes.size(); ++i) {
+        AbstractTask *task = m_nodes[i]->m_task;
+        for (ui32 j = 0; j < task->getNumChildTasks(); ++j) {
+            AbstractTask *child = task->getChildTask(j);
+            if (nullptr == child) {
+                continue;
+            }
+            addTask(child);
+            m_nodes[i]->addPredecessor(m_nodes[findNode(child)]);
+        }
+    }
+
+    // Kahn's algorithm, m_pending is used as the in-degree
+    m_sorted.resize(0);
+    for (ui32 i = 0; i < m_nodes.size(); ++i) {
+        Node *node = m_nodes[i];
+        node->m_pending = static_cast<i32>(node->m_predecessors.size());
+        if (node->m_predecessors.isEmpty()) {
+            m_sorted.add(node);
+        }
+    }
+
+    for (ui32 i = 0; i < m_sorted.size(); ++i) {
+        Node *node = m_sorted[i];
+        for (ui32 j = 0; j < node->m_successors.size(); ++j) {
+            Node *successor = node->m_successors[j];
+            if (0 == --successor->m_pending) {
+                m_sorted.add(successor);
+            }
+        }
+    }
+
+    if (m_sorted.size() != m_nodes.size()) {
+        osre_error(Tag, "Task graph contains a cycle.");
+        m_sorted.resize(0);
+        return false;
+    }
+    m_dirty = false;
+
+    return true;
+}
+
+bool TaskGraph::execute(JobScheduler *scheduler) {
+    if (m_dirty && !compile()) {
+        return false;
+    }
+
+    TArray<Job> roots;
+    for (ui32 i = 0; i < m_nodes.size(); ++i) {
+        Node *node = m_nodes[i];
+        node->m_pending = static_cast<i32>(node->m_predecessors.size());
+        if (node->m_predecessors.isEmpty()) {
+            roots.add(Job(&TaskGraph::executeNode, node, nullptr));
+        }
+    }
+
+    const i64 start = getCurrentMicroSeconds();
+    if (nullptr == scheduler) {
+        for (ui32 i = 0; i < m_sorted.size(); ++i) {
+            runNode(m_sorted[i]);
+        }
+    } else if (!roots.isEmpty()) {
+        JobCounter counter;
+        m_scheduler = scheduler;
+        m_counter = &counter;
+        scheduler->run(&roots[0], static_cast<ui32>(roots.size()), &counter);
+        scheduler->wait(&counter);
+        m_scheduler = nullptr;
+        m_counter = nullptr;
+    }
+    m_executionTime = Time(getCurrentMicroSeconds() - start);
+
+    updateCriticalPath();
+
+    return true;
+}
+
+void TaskGraph::clear() {
+    for (ui32 i = 0; i < m_nodes.size(); ++i) {
+        delete m_nodes[i];
+    }
+    m_nodes.resize(0);
+    m_sorted.resize(0);
+    m_criticalPath.resize(0);
+    m_executionTime = Time();
+    m_criticalPathTime = Time();
+    m_dirty = false;
+}
+
+Time TaskGraph::getTaskTime(AbstractTask *task) const {
+    const i32 idx = findNode(task);
+    if (-1 == idx) {
+        return Time();
+    }
+
+    const Node *node = m_nodes[idx];
+    return Time(node->m_end - node->m_start);
+}
+
+i32 TaskGraph::findNode(AbstractTask *task) const {
+    for (ui32 i = 0; i < m_nodes.size(); ++i) {
+        if (task == m_nodes[i]->m_task) {
+            return static_cast<i32>(i);
+        }
+    }
+
+    return -1;
+}
+
+void TaskGraph::runNode(Node *node) {
+    node->m_start = getCurrentMicroSeconds();
+    AbstractTask *task = node->m_task;
+    if (task->preExecute()) {
+        task->execute();
+        task->postExecute();
+    }
+    node->m_end = getCurrentMicroSeconds();
+
+    if (nullptr == m_scheduler) {
+        return;
+    }
+
+    // The last finished predecessor starts the successor
+    for (ui32 i = 0; i < node->m_successors.size(); ++i) {
+        Node *successor = node->m_successors[i];
+        if (1 == successor->m_pending.fetch_sub(1)) {
+            m_scheduler->run(&TaskGraph::executeNode, successor, m_counter);
+        }
+    }
+}
+
+void TaskGraph::updateCriticalPath() {
+    m_criticalPath.resize(0);
+    m_criticalPathTime = Time();
+
+    // The sorted order guarantees that all predecessors were visited before
+    Node *last = nullptr;
+    for (ui32 i = 0; i < m_sorted.size(); ++i) {
+        Node *node = m_sorted[i];
+        node->m_pathPredecessor = nullptr;
+        i64 predecessorTime = 0;
+        for (ui32 j = 0; j < node->m_predecessors.size(); ++j) {
+            Node *predecessor = node->m_predecessors[j];
+            if (nullptr == node->m_pathPredecessor || predecessor->m_pathTime > predecessorTime) {
+                node->m_pathPredecessor = predecessor;
+                predecessorTime = predecessor->m_pathTime;
+            }
+        }
+        node->m_pathTime = predecessorTime + (node->m_end - node->m_start);
+
+        // A path always ends in a task without successors
+        if (!node->m_successors.isEmpty()) {
+            continue;
+        }
+        if (nullptr == last || node->m_pathTime > last->m_pathTime) {
+            last = node;
+        }
+    }
+
+    if (nullptr == last) {
+        return;
+    }
+    m_criticalPathTime = Time(last->m_pathTime);
+
+    for (Node *node = last; nullptr != node; node = node->m_pathPredecessor) {
+        m_criticalPath.add(node->m_task);
+    }
+
+    // Reverse to get the path in execution order
+    const size_t numTasks = m_criticalPath.size();
+    for (size_t i = 0; i < numTasks / 2; ++i) {
+        AbstractTask *tmp = m_criticalPath[i];
+        m_criticalPath[i] = m_criticalPath[numTasks - i - 1];
+        m_criticalPath[numTasks - i - 1] = tmp;
+    }
+}
+
+void TaskGraph::executeNode(void *data) {
+    Node *node = reinterpret_cast<Node *>(data);
+    node->m_graph->runNode(node);
+}
+
+} // Namespace Threading
+} // Namespace OSRE
@@ -0,0 +1,126 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2015-2020 OSRE ( Open Source Render Engine ) by Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#include <osre/Common/osre_common.h>
+#include <osre/RenderBackend/BlockCompressor.h>
+#include <osre/RenderBackend/TextureContainer.h>
+
+#include "SOIL.h"
+
+#include <cstdio>
+#include <cstring>
+
+using namespace ::OSRE;
+using namespace ::OSRE::RenderBackend;
+
+// Bakes an image file into a block compressed DDS file with a full mip chain, so the engine can
+// upload it without decoding and mip generation at runtime.
+static void showUsage() {
+    ::printf("Usage: TextureBaker [--bc1 | --bc3] [--no-mips] <input image> <output.dds>\n");
+    ::printf("    --bc1       Compress to BC1, the default for images without alpha.\n");
+    ::printf("    --bc3       Compress to BC3, the default for images with alpha.\n");
+    ::printf("    --no-mips   Store only the first level.\n");
+}
+
+static bool writeFile(const String &filename, const MemoryBuffer &content) {
+    FILE *file = ::fopen(filename.c_str(), "wb");
+    if (nullptr == file) {
+        return false;
+    }
+
+    const size_t written = ::fwrite(&content[0], 1, content.size(), file);
+    ::fclose(file);
+
+    return written == content.size();
+}
+
+int main(int argc, char *argv[]) {
+    TextureFormatType format = TextureFormatType::InvaliTextureType;
+    bool mips(true);
+    String input, output;
+    for (int i = 1; i < argc; ++i) {
+        if (0 == ::strcmp(argv[i], "--bc1")) {
+            format = TextureFormatType::BC1;
+        } else if (0 == ::strcmp(argv[i], "--bc3")) {
+            format = TextureFormatType::BC3;
+        } else if (0 == ::strcmp(argv[i], "--no-mips")) {
+            mips = false;
+        } else if (input.empty()) {
+            input = argv[i];
+        } else if (output.empty()) {
+            output = argv[i];
+        } else {
+            showUsage();
+            return 1;
+        }
+    }
+
+    if (input.empty() || output.empty()) {
+        showUsage();
+        return 1;
+    }
+
+    i32 width(0), height(0), channels(0);
+    uc8 *data = SOIL_load_image(input.c_str(), &width, &height, &channels, SOIL_LOAD_AUTO);
+    if (nullptr == data) {
+        ::printf("Cannot load %s: %s\n", input.c_str(), SOIL_last_result());
+        return 1;
+    }
+
+    if (TextureFormatType::InvaliTextureType == format) {
+        format = (2 == channels || 4 == channels) ? TextureFormatType::BC3 : TextureFormatType::BC1;
+    }
+
+    // GL expects the first row at the bottom, the same swap is done for decoded images at runtime
+    const size_t pitch = static_cast<size_t>(width) * channels;
+    MemoryBuffer level;
+    level.resize(pitch * height);
+    for (i32 y = 0; y < height; ++y) {
+        ::memcpy(&level[y * pitch], &data[(height - 1 - y) * pitch], pitch);
+    }
+    SOIL_free_image_data(data);
+
+    MemoryBuffer levels, next;
+    ui32 w = static_cast<ui32>(width), h = static_cast<ui32>(height), numLevels(0);
+    while (true) {
+        BlockCompressor::compress(format, reinterpret_cast<const uc8 *>(&level[0]), w, h, channels, levels);
+        ++numLevels;
+        if (!mips || (1 == w && 1 == h)) {
+            break;
+        }
+        BlockCompressor::downsample(reinterpret_cast<const uc8 *>(&level[0]), w, h, channels, next);
+        level = next;
+        w = w > 1 ? w / 2 : 1;
+        h = h > 1 ? h / 2 : 1;
+    }
+
+    MemoryBuffer content;
+    if (!TextureContainer::writeDDS(format, static_cast<ui32>(width), static_cast<ui32>(height), numLevels, reinterpret_cast<const uc8 *>(&levels[0]),
+                levels.size(), content) || !writeFile(output, content)) {
+        ::printf("Cannot write %s\n", output.c_str());
+        return 1;
+    }
+    ::printf("%s: %dx%d, %u levels, %u bytes\n", output.c_str(), width, height, numLevels,
+            static_cast<ui32>(content.size()));
+
+    return 0;
+}
@@ -0,0 +1,165 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2015-2020 OSRE ( Open Source Render Engine ) by Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#include "osre_testcommon.h"
+#include <osre/App/AbstractBehaviour.h>
+#include <osre/App/Entity.h>
+#include <osre/App/World.h>
+#include <osre/Scene/Node.h>
+#include <osre/Threading/JobScheduler.h>
+
+#include <atomic>
+
+namespace OSRE {
+namespace UnitTest {
+
+using namespace ::OSRE::App;
+using namespace ::OSRE::Threading;
+
+class WorldTest : public ::testing::Test {
+    // empty
+};
+
+class CountingBehaviour : public AbstractBehaviour {
+public:
+    CountingBehaviour(bool threadSafe) :
+            AbstractBehaviour(),
+            m_threadSafe(threadSafe),
+            m_numPreUpdates(0),
+            m_numUpdates(0),
+            m_numPostUpdates(0) {
+        // empty
+    }
+
+    bool isThreadSafe() const override {
+        return m_threadSafe;
+    }
+
+    bool m_threadSafe;
+    std::atomic<i32> m_numPreUpdates;
+    std::atomic<i32> m_numUpdates;
+    std::atomic<i32> m_numPostUpdates;
+
+protected:
+    bool onPreUpdate(Time) override {
+        // Every entity must be done with the pre-update before any update starts
+        EXPECT_EQ(0, m_numUpdates.load());
+        ++m_numPreUpdates;
+        return true;
+    }
+
+    bool onUpdate(Time) override {
+        ++m_numUpdates;
+        return true;
+    }
+
+    bool onPostUpdate(Time) override {
+        ++m_numPostUpdates;
+        return true;
+    }
+};
+
+static void updateWorld(JobScheduler *scheduler) {
+    static const ui32 NumEntities = 1000;
+    World world("test");
+    world.setJobScheduler(scheduler);
+    EXPECT_EQ(scheduler, world.getJobScheduler());
+
+    CountingBehaviour serialBehaviour(false), parallelBehaviour(true);
+    CPPCore::TArray<Entity *> entities;
+    for (ui32 i = 0; i < NumEntities; ++i) {
+        Entity *entity = new Entity("entity", world.getIds(), &world);
+        entity->setBehaviourControl(0 == i % 10 ? &serialBehaviour : &parallelBehaviour);
+        entities.add(entity);
+    }
+
+    Time dt;
+    world.update(dt);
+
+    EXPECT_EQ(100, serialBehaviour.m_numPreUpdates.load());
+    EXPECT_EQ(100, serialBehaviour.m_numUpdates.load());
+    EXPECT_EQ(100, serialBehaviour.m_numPostUpdates.load());
+    EXPECT_EQ(900, parallelBehaviour.m_numPreUpdates.load());
+    EXPECT_EQ(900, parallelBehaviour.m_numUpdates.load());
+    EXPECT_EQ(900, parallelBehaviour.m_numPostUpdates.load());
+
+    for (ui32 i = 0; i < entities.size(); ++i) {
+        delete entities[i];
+    }
+}
+
+TEST_F(WorldTest, serialUpdateTest) {
+    updateWorld(nullptr);
+}
+
+TEST_F(WorldTest, parallelUpdateTest) {
+    JobScheduler *scheduler = JobScheduler::create(4);
+    updateWorld(scheduler);
+    EXPECT_LT(0, scheduler->getNumExecutedJobs());
+    delete scheduler;
+}
+
+class CountingNode : public Scene::Node {
+public:
+    CountingNode(const String &name, Common::Ids &ids, Scene::Node *parent) :
+            Node(name, ids, parent),
+            m_numUpdates(0) {
+        // empty
+    }
+
+    i32 m_numUpdates;
+
+protected:
+    void onUpdate(Time) override {
+        ++m_numUpdates;
+    }
+};
+
+TEST_F(WorldTest, nodeHierarchyUpdateTest) {
+    World world("test");
+    Common::Ids ids;
+    CountingNode *parentNode = new CountingNode("parent", ids, nullptr);
+    CountingNode *childNode = new CountingNode("child", ids, parentNode);
+
+    // The node of the child entity is a child of the node of the parent entity
+    Entity *parent = new Entity("parent", world.getIds(), &world);
+    parent->setNode(parentNode);
+    Entity *child = new Entity("child", world.getIds(), &world);
+    child->setNode(childNode);
+
+    Time dt;
+    world.update(dt);
+    EXPECT_EQ(1, parentNode->m_numUpdates);
+    EXPECT_EQ(1, childNode->m_numUpdates);
+
+    world.update(dt);
+    EXPECT_EQ(2, parentNode->m_numUpdates);
+    EXPECT_EQ(2, childNode->m_numUpdates);
+
+    delete child;
+    delete parent;
+    parentNode->release();
+    childNode->release();
+}
+
+} // Namespace UnitTest
+} // Namespace OSRE
@@ -0,0 +1,69 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2015-2020 OSRE ( Open Source Render Engine ) by Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#include "osre_testcommon.h"
+#include <osre/IO/AsyncStream.h>
+#include <osre/IO/IOService.h>
+#include <osre/IO/Uri.h>
+
+#include <cstdio>
+
+namespace OSRE {
+namespace UnitTest {
+
+using namespace ::OSRE::IO;
+using namespace ::OSRE::Threading;
+
+class AsyncStreamTest : public ::testing::Test {
+    // empty
+};
+
+TEST_F(AsyncStreamTest, readFileTest) {
+    static const c8 *Filename = "asyncstreamtest.bin";
+    static const ui32 Size = 4096;
+    c8 data[Size];
+    for (ui32 i = 0; i < Size; ++i) {
+        data[i] = static_cast<c8>(i % 255);
+    }
+    FILE *file = ::fopen(Filename, "wb");
+    ASSERT_NE(nullptr, file);
+    ::fwrite(data, 1, Size, file);
+    ::fclose(file);
+
+    IOService *ioService = IOService::create();
+    JobScheduler *scheduler = JobScheduler::create(2);
+
+    TTask<MemoryBuffer> task = AsyncStream::readFile(scheduler, Uri(String("file://") + Filename));
+    const MemoryBuffer &content = task.get();
+    ASSERT_EQ(Size, content.size());
+    EXPECT_EQ(0, ::memcmp(data, &content[0], Size));
+
+    TTask<MemoryBuffer> invalidTask = AsyncStream::readFile(scheduler, Uri("file://nonexisting.bin"));
+    EXPECT_TRUE(invalidTask.get().isEmpty());
+
+    delete scheduler;
+    ioService->release();
+    ::remove(Filename);
+}
+
+} // Namespace UnitTest
+} // Namespace OSRE
@@ -23,6 +23,12 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "osre_testcommon.h"
 #include <osre/Platform/Threading.h>
 
+#include <chrono>
+#include <ctime>
+#include <iostream>
+#include <thread>
+#include <vector>
+
 namespace OSRE {
 namespace UnitTest {
 
@@ -137,5 +143,131 @@ TEST_F( AbstractThreadTest, accessStateTest ) {
     EXPECT_EQ( Thread::ThreadState::New, test_thread.getCurrentState() );
 }
 
+static const ui32 NumLockThreads = 4;
+static const ui32 NumLocksPerThread = 20000;
+
+// Runs the same contended workload with a given lock and reports wall and CPU time
+template <class TLock>
+static void runLockBenchmark(const c8 *name, TLock &lock, i32 &counter) {
+    const std::clock_t cpuStart = std::clock();
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (ui32 i = 0; i < NumLockThreads; ++i) {
+        threads.push_back(std::thread([&lock, &counter]() {
+            for (ui32 j = 0; j < NumLocksPerThread; ++j) {
+                lock.enter();
+                // Hold the lock for a while, so waiters have to decide between spinning and parking
+                for (volatile ui32 k = 0; k < 200; ++k) {
+                }
+                ++counter;
+                lock.leave();
+            }
+        }));
+    }
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+    const i64 wallUs = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+    const i64 cpuUs = static_cast<i64>(std::clock() - cpuStart) * 1000000 / CLOCKS_PER_SEC;
+    std::cout << name << ": wall " << wallUs << " us, cpu " << cpuUs << " us" << std::endl;
+}
+
+#ifndef OSRE_WINDOWS
+// The SDL versions as the baseline for the benchmarks
+struct SDLSpinLock {
+    SDL_SpinLock m_lock = 0;
+    void enter() { SDL_AtomicLock(&m_lock); }
+    void leave() { SDL_AtomicUnlock(&m_lock); }
+};
+
+struct SDLEvent {
+    SDL_mutex *m_mutex = SDL_CreateMutex();
+    SDL_cond *m_cond = SDL_CreateCond();
+    bool m_signaled = false;
+
+    ~SDLEvent() {
+        SDL_DestroyCond(m_cond);
+        SDL_DestroyMutex(m_mutex);
+    }
+
+    void signal() {
+        SDL_LockMutex(m_mutex);
+        m_signaled = true;
+        SDL_CondSignal(m_cond);
+        SDL_UnlockMutex(m_mutex);
+    }
+
+    void waitForOne() {
+        SDL_LockMutex(m_mutex);
+        while (!m_signaled) {
+            SDL_CondWait(m_cond, m_mutex);
+        }
+        m_signaled = false;
+        SDL_UnlockMutex(m_mutex);
+    }
+};
+#endif
+
+static const ui32 NumPingPongs = 10000;
+
+template <class TEvent>
+static void runPingPongBenchmark(const c8 *name, TEvent &ping, TEvent &pong) {
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    std::thread partner([&ping, &pong]() {
+        for (ui32 i = 0; i < NumPingPongs; ++i) {
+            ping.waitForOne();
+            pong.signal();
+        }
+    });
+    for (ui32 i = 0; i < NumPingPongs; ++i) {
+        ping.signal();
+        pong.waitForOne();
+    }
+    partner.join();
+    const i64 wallUs = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+    std::cout << name << ": " << NumPingPongs << " round trips in " << wallUs << " us" << std::endl;
+}
+
+TEST_F( AbstractThreadTest, criticalSectionContentionTest ) {
+    CriticalSection cs;
+    EXPECT_TRUE( cs.tryEnter() );
+    EXPECT_FALSE( cs.tryEnter() );
+    cs.leave();
+    EXPECT_EQ( 0u, cs.getNumContended() );
+
+    i32 counter( 0 );
+    runLockBenchmark( "CriticalSection", cs, counter );
+    EXPECT_EQ( static_cast<i32>( NumLockThreads * NumLocksPerThread ), counter );
+    std::cout << "CriticalSection: " << cs.getNumContended() << " contended, " << cs.getNumParked() << " parked" << std::endl;
+
+#ifndef OSRE_WINDOWS
+    SDLSpinLock spinLock;
+    counter = 0;
+    runLockBenchmark( "SDL_SpinLock", spinLock, counter );
+    EXPECT_EQ( static_cast<i32>( NumLockThreads * NumLocksPerThread ), counter );
+#endif
+}
+
+TEST_F( AbstractThreadTest, threadEventTest ) {
+    ThreadEvent event;
+
+    // A signal sent before the wait is not lost, the wait consumes it
+    event.signal();
+    event.waitForOne();
+
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    event.waitForTimeout( 20 );
+    const i64 waitedMs = std::chrono::duration_cast<std::chrono::milliseconds>( std::chrono::steady_clock::now() - start ).count();
+    EXPECT_LE( 15, waitedMs );
+
+    ThreadEvent ping, pong;
+    runPingPongBenchmark( "ThreadEvent", ping, pong );
+
+#ifndef OSRE_WINDOWS
+    SDLEvent sdlPing, sdlPong;
+    runPingPongBenchmark( "SDL mutex/cond", sdlPing, sdlPong );
+#endif
+}
+
 } // Namespace UnitTest
 } // Namespace OSRE
@@ -0,0 +1,168 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2015-2020 OSRE ( Open Source Render Engine ) by Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#include "osre_testcommon.h"
+#include <osre/Platform/CPUInfo.h>
+#include <osre/Platform/SystemInfo.h>
+#include <osre/Platform/Threading.h>
+
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <thread>
+
+#ifndef OSRE_WINDOWS
+#   include <sys/stat.h>
+#   include <unistd.h>
+#endif
+
+namespace OSRE {
+namespace UnitTest {
+
+using namespace ::OSRE::Platform;
+
+class CPUInfoTest : public ::testing::Test {
+    // empty
+};
+
+#ifndef OSRE_WINDOWS
+static void writeSysfsFile(const String &path, const String &value) {
+    std::ofstream file(path.c_str());
+    file << value << "\n";
+}
+#endif
+
+class PlacementThread : public Thread {
+public:
+    std::atomic<bool> m_done;
+
+    PlacementThread() :
+            Thread("placement.thread", 4096),
+            m_done(false) {
+        // empty
+    }
+
+protected:
+    i32 run() override {
+        m_done = true;
+        return 0;
+    }
+};
+
+TEST_F(CPUInfoTest, topologyTest) {
+    EXPECT_TRUE(CPUInfo::init());
+    CPUInfo info;
+    const ui32 numCPUs = info.getNumCPUs();
+    EXPECT_LT(0u, info.getNumPhysicalCores());
+    EXPECT_LE(info.getNumPhysicalCores(), numCPUs);
+    EXPECT_LT(0u, info.getNumCacheDomains());
+
+    ui64 allCores(0);
+    for (ui32 core = 0; core < info.getNumPhysicalCores(); ++core) {
+        const ui64 coreMask = info.getPhysicalCoreMask(core);
+        EXPECT_NE(0u, coreMask);
+        EXPECT_EQ(0u, allCores & coreMask);
+        allCores |= coreMask;
+    }
+
+    // The render thread never shares a physical core with the workers
+    EXPECT_EQ(0u, info.getRenderThreadMask() & info.getWorkerThreadMask());
+    if (info.getNumPhysicalCores() > 1) {
+        EXPECT_NE(0u, info.getRenderThreadMask());
+        EXPECT_NE(0u, info.getWorkerThreadMask());
+        EXPECT_EQ(allCores, info.getRenderThreadMask() | info.getWorkerThreadMask());
+    }
+}
+
+#ifndef OSRE_WINDOWS
+TEST_F(CPUInfoTest, sysfsTopologyTest) {
+    CPUInfo::init();
+    CPUInfo info;
+    const ui32 numCPUs = info.getNumCPUs() < CPUInfo::MaxCPUs ? info.getNumCPUs() : CPUInfo::MaxCPUs;
+
+    // Two SMT siblings per core, the first and the second half of the CPUs share a cache
+    char tmpl[] = "/tmp/osre_sysfsXXXXXX";
+    const String root(::mkdtemp(tmpl));
+    for (ui32 cpu = 0; cpu < numCPUs; ++cpu) {
+        const String cpuPath(root + "/cpu" + osre_to_string(cpu));
+        ::mkdir(cpuPath.c_str(), 0700);
+        ::mkdir((cpuPath + "/topology").c_str(), 0700);
+        ::mkdir((cpuPath + "/cache").c_str(), 0700);
+        ::mkdir((cpuPath + "/cache/index0").c_str(), 0700);
+        ::mkdir((cpuPath + "/cache/index1").c_str(), 0700);
+        writeSysfsFile(cpuPath + "/topology/core_id", osre_to_string(cpu / 2));
+        writeSysfsFile(cpuPath + "/topology/physical_package_id", "0");
+        writeSysfsFile(cpuPath + "/cache/index0/level", "1");
+        writeSysfsFile(cpuPath + "/cache/index0/shared_cpu_list", osre_to_string(cpu));
+        writeSysfsFile(cpuPath + "/cache/index1/level", "3");
+        writeSysfsFile(cpuPath + "/cache/index1/shared_cpu_list", cpu < numCPUs / 2 ? "low" : "high");
+    }
+
+    EXPECT_TRUE(CPUInfo::initTopology(root));
+    EXPECT_EQ((numCPUs + 1) / 2, info.getNumPhysicalCores());
+    EXPECT_EQ(numCPUs > 1 ? 2u : 1u, info.getNumCacheDomains());
+    EXPECT_EQ(info.getPhysicalCore(0), info.getPhysicalCore(1));
+    if (numCPUs > 3) {
+        EXPECT_EQ(info.getPhysicalCoreMask(info.getNumPhysicalCores() - 1), info.getRenderThreadMask());
+        EXPECT_EQ(0u, info.getWorkerThreadMask() & info.getRenderThreadMask());
+    }
+
+    // A missing tree falls back to one core per CPU
+    EXPECT_FALSE(CPUInfo::initTopology(root + "/missing"));
+    EXPECT_EQ(numCPUs, info.getNumPhysicalCores());
+
+    CPUInfo::initTopology("/sys/devices/system/cpu");
+}
+#endif
+
+TEST_F(CPUInfoTest, threadPlacementTest) {
+    CPUInfo::init();
+    CPUInfo info;
+    const ui64 mask = 0 != info.getWorkerThreadMask() ? info.getWorkerThreadMask() : 1;
+
+    PlacementThread thread;
+    thread.setPriority(Thread::Priority::Critical);
+    thread.setAffinity(mask);
+    EXPECT_EQ(mask, thread.getAffinity());
+    EXPECT_TRUE(thread.start(nullptr));
+
+    // A refused prio must not keep the thread from running
+    while (!thread.m_done) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    ThreadPlacement placement;
+    EXPECT_TRUE(SystemInfo::getThreadPlacement(thread.getThreadId(), placement));
+    EXPECT_EQ("placement.thread", placement.m_name);
+    EXPECT_EQ(Thread::Priority::Critical, placement.m_prio);
+#ifdef __linux__
+    EXPECT_EQ(mask, placement.m_affinityMask);
+#endif
+    EXPECT_NE(String::npos, SystemInfo::getPlacementInfo().find("placement.thread"));
+
+    const ThreadId id = thread.getThreadId();
+    thread.stop();
+    EXPECT_FALSE(SystemInfo::getThreadPlacement(id, placement));
+}
+
+} // Namespace UnitTest
+} // Namespace OSRE
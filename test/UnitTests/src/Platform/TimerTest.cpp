@@ -0,0 +1,86 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2015-2020 OSRE ( Open Source Render Engine ) by Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#include "osre_testcommon.h"
+#include <osre/Platform/AbstractTimer.h>
+
+namespace OSRE {
+namespace UnitTest {
+
+using namespace ::OSRE::Platform;
+
+// A timer with a manual clock
+class ManualTimer : public AbstractTimer {
+public:
+    i64 m_now;
+
+    ManualTimer() :
+            AbstractTimer("test/manualtimer"),
+            m_now(0) {
+        // empty
+    }
+
+    i64 getNanoCurrentSeconds() override {
+        return m_now;
+    }
+};
+
+class TimerTest : public ::testing::Test {
+    // empty
+};
+
+TEST_F(TimerTest, deltaTimeTest) {
+    ManualTimer timer;
+    EXPECT_EQ(0, timer.getDeltaTime().asMicroSeconds());
+
+    // A 2.5 ms render stage is measured exactly
+    timer.m_now += 2500 * NanoPerMicro;
+    EXPECT_EQ(2500, timer.getDeltaTime().asMicroSeconds());
+
+    // The nanosecond remainders are kept, so the deltas do not drift
+    i64 sum(0);
+    for (ui32 i = 0; i < 1000; ++i) {
+        timer.m_now += 1500;
+        sum += timer.getDeltaTime().asMicroSeconds();
+    }
+    EXPECT_EQ(1500, sum);
+
+    // A long gap, e.g. in the debugger, is replaced by the requested time-step
+    timer.m_now += 5000 * NanoPerMilli;
+    EXPECT_EQ(1000 / 60 * 1000, timer.getDeltaTime().asMicroSeconds());
+}
+
+TEST_F(TimerTest, timeDiffTest) {
+    ManualTimer timer;
+    EXPECT_EQ(0, timer.getTimeDiff());
+
+    i64 sum(0);
+    for (ui32 i = 0; i < 100; ++i) {
+        timer.m_now += 1500 * NanoPerMicro;
+        sum += timer.getTimeDiff();
+    }
+    EXPECT_EQ(150, sum);
+    EXPECT_EQ(150, timer.getMilliCurrentSeconds());
+}
+
+} // Namespace UnitTest
+} // Namespace OSRE
@@ -0,0 +1,122 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2015-2020 OSRE ( Open Source Render Engine ) by Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#include "osre_testcommon.h"
+#include <osre/RenderBackend/BlockCompressor.h>
+
+namespace OSRE {
+namespace UnitTest {
+
+using namespace ::OSRE::RenderBackend;
+
+class BlockCompressorTest : public ::testing::Test {
+    // empty
+};
+
+static ui32 getIndex( const uc8 *block, ui32 pixel ) {
+    const ui32 indices = block[ 4 ] | ( block[ 5 ] << 8 ) | ( block[ 6 ] << 16 ) | ( block[ 7 ] << 24 );
+    return ( indices >> ( 2 * pixel ) ) & 3;
+}
+
+TEST_F( BlockCompressorTest, solidBlockTest ) {
+    uc8 rgba[ 64 ];
+    for ( ui32 i = 0; i < 16; ++i ) {
+        rgba[ i * 4 + 0 ] = 255;
+        rgba[ i * 4 + 1 ] = 0;
+        rgba[ i * 4 + 2 ] = 0;
+        rgba[ i * 4 + 3 ] = 255;
+    }
+
+    uc8 block[ 8 ];
+    BlockCompressor::compressBlockBC1( rgba, block );
+    EXPECT_EQ( 0x00, block[ 0 ] );
+    EXPECT_EQ( 0xf8, block[ 1 ] );
+    EXPECT_EQ( block[ 0 ], block[ 2 ] );
+    EXPECT_EQ( block[ 1 ], block[ 3 ] );
+    for ( ui32 i = 0; i < 16; ++i ) {
+        EXPECT_EQ( 0u, getIndex( block, i ) );
+    }
+}
+
+TEST_F( BlockCompressorTest, twoColorBlockTest ) {
+    // The left half is white, the right one black
+    uc8 rgba[ 64 ];
+    for ( ui32 i = 0; i < 16; ++i ) {
+        const uc8 value = ( i % 4 ) < 2 ? 255 : 0;
+        rgba[ i * 4 + 0 ] = rgba[ i * 4 + 1 ] = rgba[ i * 4 + 2 ] = value;
+        rgba[ i * 4 + 3 ] = 255;
+    }
+
+    uc8 block[ 8 ];
+    BlockCompressor::compressBlockBC1( rgba, block );
+    const ui32 white = getIndex( block, 0 );
+    const ui32 black = getIndex( block, 3 );
+    EXPECT_NE( white, black );
+    for ( ui32 i = 0; i < 16; ++i ) {
+        EXPECT_EQ( ( i % 4 ) < 2 ? white : black, getIndex( block, i ) );
+    }
+}
+
+TEST_F( BlockCompressorTest, alphaBlockTest ) {
+    uc8 rgba[ 64 ] = { 0 };
+    for ( ui32 i = 0; i < 16; ++i ) {
+        rgba[ i * 4 + 3 ] = i < 8 ? 255 : 0;
+    }
+
+    uc8 block[ 16 ];
+    BlockCompressor::compressBlockBC3( rgba, block );
+    EXPECT_EQ( 255, block[ 0 ] );
+    EXPECT_EQ( 0, block[ 1 ] );
+
+    // Opaque pixels use the first endpoint, transparent ones the second
+    EXPECT_EQ( 0, block[ 2 ] );
+    EXPECT_EQ( 0, block[ 3 ] );
+    EXPECT_EQ( 0, block[ 4 ] );
+    EXPECT_EQ( 0x49, block[ 5 ] );
+    EXPECT_EQ( 0x92, block[ 6 ] );
+    EXPECT_EQ( 0x24, block[ 7 ] );
+}
+
+TEST_F( BlockCompressorTest, compressTest ) {
+    // 6x5 pixels need 2x2 blocks
+    uc8 pixels[ 6 * 5 * 3 ] = { 0 };
+    MemoryBuffer buffer;
+    EXPECT_TRUE( BlockCompressor::compress( TextureFormatType::BC1, pixels, 6, 5, 3, buffer ) );
+    EXPECT_EQ( 32u, buffer.size() );
+    EXPECT_TRUE( BlockCompressor::compress( TextureFormatType::BC3, pixels, 6, 5, 3, buffer ) );
+    EXPECT_EQ( 96u, buffer.size() );
+    EXPECT_FALSE( BlockCompressor::compress( TextureFormatType::BC7, pixels, 6, 5, 3, buffer ) );
+}
+
+TEST_F( BlockCompressorTest, downsampleTest ) {
+    const uc8 pixels[ 3 * 2 ] = { 0, 100, 200, 50, 150, 250 };
+    MemoryBuffer buffer;
+    BlockCompressor::downsample( pixels, 3, 2, 1, buffer );
+    ASSERT_EQ( 1u, buffer.size() );
+    EXPECT_EQ( 75, static_cast<uc8>( buffer[ 0 ] ) );
+
+    BlockCompressor::downsample( pixels, 1, 1, 1, buffer );
+    EXPECT_EQ( 1u, buffer.size() );
+}
+
+} // Namespace UnitTest
+} // Namespace OSRE
@@ -0,0 +1,137 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2015-2020 OSRE ( Open Source Render Engine ) by Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#include "osre_testcommon.h"
+#include <osre/RenderBackend/THWBufferManager.h>
+
+namespace OSRE {
+namespace UnitTest {
+
+using namespace ::OSRE::RenderBackend;
+
+class HWBufferManagerTest : public ::testing::Test {
+    // empty
+};
+
+struct TestBuffer {
+    size_t m_id;
+};
+
+struct TestVertexArray {
+    ui32 m_id;
+};
+
+TEST_F(HWBufferManagerTest, offsetAllocTest) {
+    OffsetAllocator allocator;
+    allocator.init(100);
+    EXPECT_EQ(100u, allocator.getCapacity());
+
+    EXPECT_EQ(0u, allocator.alloc(10));
+    // The padding in front of an aligned range stays free
+    EXPECT_EQ(12u, allocator.alloc(12, 12));
+    EXPECT_EQ(22u, allocator.getUsed());
+    EXPECT_EQ(2u, allocator.getNumFreeRanges());
+    EXPECT_EQ(10u, allocator.alloc(2));
+    EXPECT_EQ(1u, allocator.getNumFreeRanges());
+
+    EXPECT_EQ(OffsetAllocator::InvalidOffset, allocator.alloc(100));
+    EXPECT_EQ(OffsetAllocator::InvalidOffset, allocator.alloc(0));
+}
+
+TEST_F(HWBufferManagerTest, offsetReleaseTest) {
+    OffsetAllocator allocator;
+    allocator.init(30);
+    const size_t first = allocator.alloc(10);
+    const size_t second = allocator.alloc(10);
+    const size_t third = allocator.alloc(10);
+    EXPECT_EQ(0u, allocator.getNumFreeRanges());
+
+    allocator.release(first, 10);
+    allocator.release(third, 10);
+    EXPECT_EQ(2u, allocator.getNumFreeRanges());
+
+    // Releasing the middle range merges all of them
+    allocator.release(second, 10);
+    EXPECT_EQ(1u, allocator.getNumFreeRanges());
+    EXPECT_EQ(0u, allocator.getUsed());
+    EXPECT_EQ(0u, allocator.alloc(30));
+}
+
+TEST_F(HWBufferManagerTest, poolRangeTest) {
+    HWBufferManager<TestBuffer, TestVertexArray> manager;
+    HWBufferManager<TestBuffer, TestVertexArray>::Range range;
+    ui64 key(0), otherKey(0);
+    getBufferKey(VertexType::RenderVertex, IndexType::UnsignedShort, 1, key);
+    getBufferKey(VertexType::RenderVertex, IndexType::UnsignedInt, 1, otherKey);
+    EXPECT_NE(key, otherKey);
+    EXPECT_FALSE(manager.allocRange(1, key, 10, 10, 4, 2, range));
+
+    TestBuffer vb, ib;
+    TestVertexArray va;
+    manager.addPool(key, &vb, 100, &ib, 16, &va);
+    EXPECT_EQ(1u, manager.getNumPools());
+    EXPECT_FALSE(manager.allocRange(1, otherKey, 10, 10, 4, 2, range));
+
+    ASSERT_TRUE(manager.allocRange(1, key, 30, 10, 8, 2, range));
+    EXPECT_EQ(&va, range.m_pool->m_vertexArray);
+    EXPECT_EQ(0u, range.m_vertexOffset);
+    ASSERT_TRUE(manager.allocRange(2, key, 30, 10, 8, 2, range));
+    EXPECT_EQ(30u, range.m_vertexOffset);
+    EXPECT_EQ(8u, range.m_indexOffset);
+
+    // No index space left, the vertex range must not leak
+    EXPECT_FALSE(manager.allocRange(3, key, 30, 10, 8, 2, range));
+    EXPECT_EQ(60u, manager.getPoolAt(0)->m_vertexAllocator.getUsed());
+
+    ASSERT_NE(nullptr, manager.getRange(2));
+    manager.releaseRange(1);
+    EXPECT_EQ(nullptr, manager.getRange(1));
+    ASSERT_TRUE(manager.allocRange(3, key, 30, 10, 8, 2, range));
+    EXPECT_EQ(0u, range.m_vertexOffset);
+
+    manager.clearPools();
+    EXPECT_EQ(0u, manager.getNumPools());
+    EXPECT_EQ(nullptr, manager.getRange(3));
+}
+
+TEST_F(HWBufferManagerTest, poolKeyTest) {
+    // Programs are shared between vertex types, their meshes must not share a vertex array
+    ui64 colorKey(0), renderKey(0);
+    getBufferKey(VertexType::ColorVertex, IndexType::UnsignedShort, 1, colorKey);
+    getBufferKey(VertexType::RenderVertex, IndexType::UnsignedShort, 1, renderKey);
+    EXPECT_NE(colorKey, renderKey);
+
+    getBufferKey(VertexType::ColorVertex, IndexType::UnsignedShort, 3, colorKey);
+    getBufferKey(VertexType::RenderVertex, IndexType::UnsignedShort, 2, renderKey);
+    EXPECT_NE(colorKey, renderKey);
+
+    HWBufferManager<TestBuffer, TestVertexArray> manager;
+    HWBufferManager<TestBuffer, TestVertexArray>::Range range;
+    TestBuffer vb, ib;
+    TestVertexArray va;
+    manager.addPool(colorKey, &vb, 100, &ib, 16, &va);
+    EXPECT_FALSE(manager.allocRange(1, renderKey, 10, 10, 4, 2, range));
+    EXPECT_TRUE(manager.allocRange(1, colorKey, 10, 10, 4, 2, range));
+}
+
+} // Namespace UnitTest
+} // Namespace OSRE
@@ -48,6 +48,18 @@ TEST_F( OGLEnumTest, access_cullFace_success ) {
     EXPECT_EQ( GL_FRONT, OGLEnum::getOGLCullFace( state.m_cullFace ) );
 }
 
+TEST_F( OGLEnumTest, access_textureTarget_success ) {
+    EXPECT_EQ( GL_TEXTURE_2D, OGLEnum::getGLTextureTarget( TextureTargetType::Texture2D ) );
+    EXPECT_EQ( GL_TEXTURE_2D_ARRAY, OGLEnum::getGLTextureTarget( TextureTargetType::Texture2DArray ) );
+}
+
+TEST_F( OGLEnumTest, access_textureFormat_success ) {
+    EXPECT_EQ( GL_COMPRESSED_RGBA_S3TC_DXT1_EXT, OGLEnum::getGLTextureFormat( TextureFormatType::BC1 ) );
+    EXPECT_EQ( GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT, OGLEnum::getGLTextureFormat( TextureFormatType::BC1_SRGB ) );
+    EXPECT_EQ( GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT, OGLEnum::getGLTextureFormat( TextureFormatType::BC3_SRGB ) );
+    EXPECT_EQ( GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM, OGLEnum::getGLTextureFormat( TextureFormatType::BC7_SRGB ) );
+}
+
 } // Namespace UnitTest
 } // Namespace OSRE
 
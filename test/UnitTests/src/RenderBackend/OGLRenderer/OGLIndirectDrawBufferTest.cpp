@@ -0,0 +1,141 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2015-2020 OSRE ( Open Source Render Engine ) by Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#include "osre_testcommon.h"
+#include "src/Engine/RenderBackend/OGLRenderer/OGLIndirectDrawBuffer.h"
+
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+namespace OSRE {
+namespace UnitTest {
+
+using namespace ::OSRE::RenderBackend;
+
+class OGLIndirectDrawBufferTest : public ::testing::Test {
+    // empty
+};
+
+static OGLPrimGroup createPrimGroup(GLenum primitive, GLenum indexType, ui32 startIndex, size_t numIndices, GLint baseVertex) {
+    OGLPrimGroup grp;
+    grp.m_primitive = primitive;
+    grp.m_indexType = indexType;
+    grp.m_startIndex = startIndex;
+    grp.m_numIndices = numIndices;
+    grp.m_baseVertex = baseVertex;
+
+    return grp;
+}
+
+TEST_F(OGLIndirectDrawBufferTest, addDrawTest) {
+    OGLIndirectDrawBuffer draws;
+    glm::mat4 model(1.0f);
+    model[3] = glm::vec4(1, 2, 3, 1);
+
+    // The start of a group is a byte offset
+    EXPECT_TRUE(draws.addDraw(createPrimGroup(GL_TRIANGLES, GL_UNSIGNED_SHORT, 12, 6, 100), model));
+    EXPECT_TRUE(draws.addDraw(createPrimGroup(GL_TRIANGLES, GL_UNSIGNED_SHORT, 0, 3, 0), glm::mat4(1.0f)));
+    ASSERT_EQ(2u, draws.getNumDraws());
+    EXPECT_EQ(static_cast<GLenum>(GL_TRIANGLES), draws.getPrimitive());
+    EXPECT_EQ(static_cast<GLenum>(GL_UNSIGNED_SHORT), draws.getIndexType());
+
+    const DrawElementsIndirectCommand *cmds = draws.getCommands();
+    EXPECT_EQ(6u, cmds[0].m_count);
+    EXPECT_EQ(1u, cmds[0].m_instanceCount);
+    EXPECT_EQ(6u, cmds[0].m_firstIndex);
+    EXPECT_EQ(100, cmds[0].m_baseVertex);
+    EXPECT_EQ(3.0f, draws.getDrawData()[0].m_model[3][2]);
+
+    // A multi-draw shares the primitive and the index type
+    EXPECT_FALSE(draws.addDraw(createPrimGroup(GL_LINES, GL_UNSIGNED_SHORT, 0, 2, 0), model));
+    EXPECT_FALSE(draws.addDraw(createPrimGroup(GL_TRIANGLES, GL_UNSIGNED_INT, 0, 3, 0), model));
+    EXPECT_FALSE(draws.addDraw(createPrimGroup(GL_TRIANGLES, GL_UNSIGNED_SHORT, 3, 3, 0), model));
+    EXPECT_EQ(2u, draws.getNumDraws());
+
+    draws.setVisible(1, false);
+    EXPECT_EQ(0u, draws.getCommands()[1].m_instanceCount);
+    draws.setVisible(1, true);
+    EXPECT_EQ(1u, draws.getCommands()[1].m_instanceCount);
+
+    draws.resize(1);
+    EXPECT_EQ(1u, draws.getNumDraws());
+    draws.clear();
+    EXPECT_EQ(0u, draws.getNumDraws());
+    EXPECT_EQ(nullptr, draws.getCommands());
+}
+
+TEST_F(OGLIndirectDrawBufferTest, glslDeclarationTest) {
+    const String multiDraw = OGLIndirectDrawBuffer::getGLSLDeclaration(true);
+    EXPECT_NE(String::npos, multiDraw.find("gl_DrawIDARB"));
+    EXPECT_NE(String::npos, multiDraw.find(DrawDataBlockName));
+
+    const String singleDraws = OGLIndirectDrawBuffer::getGLSLDeclaration(false);
+    EXPECT_EQ(String::npos, singleDraws.find("gl_DrawIDARB"));
+    EXPECT_NE(String::npos, singleDraws.find(String("uniform int ") + DrawIndexName));
+    EXPECT_NE(String::npos, singleDraws.find(String("uniform int ") + DrawDataEnabledName));
+}
+
+TEST_F(OGLIndirectDrawBufferTest, injectDeclarationTest) {
+    const String src = String("#version 400 core\n") + DrawDataDefine + "void main() {}\n";
+    const String injected = OGLIndirectDrawBuffer::injectGLSLDeclaration(src, true, true);
+    const String::size_type definePos = injected.find(DrawDataDefine);
+    const String::size_type blockPos = injected.find(DrawDataBlockName);
+    ASSERT_NE(String::npos, blockPos);
+    EXPECT_LT(definePos, blockPos);
+    EXPECT_LT(blockPos, injected.find("void main"));
+
+    // Without storage buffers the shader falls back to its uniforms
+    const String unsupported = OGLIndirectDrawBuffer::injectGLSLDeclaration(src, true, false);
+    EXPECT_EQ(String::npos, unsupported.find(DrawDataBlockName));
+    EXPECT_NE(String::npos, unsupported.find("#undef DRAW_DATA"));
+
+    const String plain("#version 400 core\nvoid main() {}\n");
+    EXPECT_EQ(plain, OGLIndirectDrawBuffer::injectGLSLDeclaration(plain, true, true));
+}
+
+TEST_F(OGLIndirectDrawBufferTest, submissionBenchmarkTest) {
+    static const ui32 NumDraws = 20000;
+
+    std::vector<OGLPrimGroup> groups;
+    for (ui32 i = 0; i < NumDraws; ++i) {
+        groups.push_back(createPrimGroup(GL_TRIANGLES, GL_UNSIGNED_INT, (i % 64) * 36 * 4, 36, i * 24));
+    }
+
+    // Builds the commands and copies them like the upload into the stream buffer
+    OGLIndirectDrawBuffer draws;
+    std::vector<c8> upload(NumDraws * (sizeof(DrawElementsIndirectCommand) + sizeof(IndirectDrawData)));
+    const glm::mat4 model(1.0f);
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (ui32 i = 0; i < NumDraws; ++i) {
+        draws.addDraw(groups[i], model);
+    }
+    ::memcpy(&upload[0], draws.getCommands(), sizeof(DrawElementsIndirectCommand) * NumDraws);
+    ::memcpy(&upload[sizeof(DrawElementsIndirectCommand) * NumDraws], draws.getDrawData(), sizeof(IndirectDrawData) * NumDraws);
+    const i64 buildUs = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+    EXPECT_EQ(NumDraws, draws.getNumDraws());
+    std::cout << NumDraws << " indirect draws built and copied in " << buildUs << " us" << std::endl;
+}
+
+} // Namespace UnitTest
+} // Namespace OSRE
@@ -0,0 +1,96 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2015-2020 OSRE (Open Source Render Engine) by Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#include "osre_testcommon.h"
+#include "src/Engine/RenderBackend/OGLRenderer/OGLProgramCache.h"
+
+#include <cstring>
+
+namespace OSRE {
+namespace UnitTest {
+
+using namespace ::OSRE::RenderBackend;
+
+class OGLProgramCacheTest : public ::testing::Test {
+    // empty
+};
+
+TEST_F(OGLProgramCacheTest, computeKeyTest) {
+    String sources[2];
+    sources[0] = "#version 400 core\nvoid main() {}\n";
+    sources[1] = "#version 400 core\nout vec4 c;\nvoid main() { c = vec4(1); }\n";
+    const String driver("vendor|renderer|4.5");
+
+    const ui64 key = OGLProgramCache::computeKey(sources, 2, driver);
+    EXPECT_EQ(key, OGLProgramCache::computeKey(sources, 2, driver));
+
+    // Another driver invalidates the binary
+    EXPECT_NE(key, OGLProgramCache::computeKey(sources, 2, "vendor|renderer|4.6"));
+
+    // Defines are injected into the source, so they change the key as well
+    String withDefine[2];
+    withDefine[0] = "#version 400 core\n#define SKINNING 1\nvoid main() {}\n";
+    withDefine[1] = sources[1];
+    EXPECT_NE(key, OGLProgramCache::computeKey(withDefine, 2, driver));
+
+    // Moving code from one stage to another is a different program
+    String moved[2];
+    moved[0] = sources[0] + sources[1];
+    EXPECT_NE(key, OGLProgramCache::computeKey(moved, 2, driver));
+}
+
+TEST_F(OGLProgramCacheTest, encodeDecodeTest) {
+    const c8 binary[] = { 1, 2, 3, 4, 5, 6, 7 };
+    const ui64 key = 0x1234567890abcdefULL;
+    MemoryBuffer buffer;
+    OGLProgramCache::encode(key, 0x8741, binary, sizeof(binary), buffer);
+    EXPECT_EQ(sizeof(ProgramBinaryHeader) + sizeof(binary), buffer.size());
+
+    ProgramBinaryHeader header;
+    const c8 *data = OGLProgramCache::decode(&buffer[0], buffer.size(), key, header);
+    ASSERT_NE(nullptr, data);
+    EXPECT_EQ(0x8741u, header.m_format);
+    EXPECT_EQ(sizeof(binary), header.m_size);
+    EXPECT_EQ(0, ::memcmp(binary, data, sizeof(binary)));
+
+    // A file written for another key or a truncated file is a miss
+    EXPECT_EQ(nullptr, OGLProgramCache::decode(&buffer[0], buffer.size(), key + 1, header));
+    EXPECT_EQ(nullptr, OGLProgramCache::decode(&buffer[0], buffer.size() - 1, key, header));
+
+    // Files of an older layout are ignored
+    buffer[0] = 0;
+    EXPECT_EQ(nullptr, OGLProgramCache::decode(&buffer[0], buffer.size(), key, header));
+}
+
+TEST_F(OGLProgramCacheTest, disabledTest) {
+    OGLProgramCache cache;
+    EXPECT_FALSE(cache.isEnabled());
+    EXPECT_FALSE(cache.init("", "driver"));
+    EXPECT_FALSE(cache.isEnabled());
+    EXPECT_FALSE(cache.load(1, nullptr));
+    EXPECT_FALSE(cache.store(1, nullptr));
+    EXPECT_EQ(0u, cache.getNumHits());
+    EXPECT_EQ(0u, cache.getNumMisses());
+}
+
+} // Namespace UnitTest
+} // Namespace OSRE
@@ -0,0 +1,117 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2015-2020 OSRE ( Open Source Render Engine ) by Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#include "osre_testcommon.h"
+#include "src/Engine/RenderBackend/OGLRenderer/OGLStateCache.h"
+#include "src/Engine/RenderBackend/OGLRenderer/OGLCommon.h"
+
+#include <glm/glm.hpp>
+
+namespace OSRE {
+namespace UnitTest {
+
+using namespace ::OSRE::RenderBackend;
+
+class OGLStateCacheTest : public ::testing::Test {
+    // empty
+};
+
+TEST_F(OGLStateCacheTest, bindingTest) {
+    OGLStateCache cache;
+    EXPECT_TRUE(cache.useProgram(1));
+    EXPECT_FALSE(cache.useProgram(1));
+    EXPECT_TRUE(cache.useProgram(2));
+
+    EXPECT_TRUE(cache.bindBuffer(GL_ARRAY_BUFFER, 3));
+    EXPECT_TRUE(cache.bindBuffer(GL_ELEMENT_ARRAY_BUFFER, 3));
+    EXPECT_FALSE(cache.bindBuffer(GL_ARRAY_BUFFER, 3));
+    cache.invalidateBuffer(GL_ELEMENT_ARRAY_BUFFER);
+    EXPECT_TRUE(cache.bindBuffer(GL_ELEMENT_ARRAY_BUFFER, 3));
+
+    // Each unit and target has its own binding
+    EXPECT_TRUE(cache.bindTexture(GL_TEXTURE0, GL_TEXTURE_2D, 5));
+    EXPECT_TRUE(cache.bindTexture(GL_TEXTURE1, GL_TEXTURE_2D, 5));
+    EXPECT_TRUE(cache.bindTexture(GL_TEXTURE0, GL_TEXTURE_3D, 5));
+    EXPECT_FALSE(cache.bindTexture(GL_TEXTURE0, GL_TEXTURE_2D, 5));
+
+    EXPECT_TRUE(cache.setCapability(GL_BLEND, false));
+    EXPECT_FALSE(cache.setCapability(GL_BLEND, false));
+    EXPECT_TRUE(cache.setCapability(GL_BLEND, true));
+    EXPECT_TRUE(cache.setDepthMask(true));
+    EXPECT_FALSE(cache.setDepthMask(true));
+
+    cache.reset();
+    EXPECT_TRUE(cache.useProgram(2));
+    EXPECT_TRUE(cache.setCapability(GL_BLEND, true));
+}
+
+TEST_F(OGLStateCacheTest, deleteTest) {
+    OGLStateCache cache;
+    cache.bindBuffer(GL_ARRAY_BUFFER, 3);
+    cache.onBufferDeleted(3);
+    EXPECT_FALSE(cache.bindBuffer(GL_ARRAY_BUFFER, 0));
+    EXPECT_TRUE(cache.bindBuffer(GL_ARRAY_BUFFER, 3));
+
+    cache.bindTexture(GL_TEXTURE0, GL_TEXTURE_2D, 7);
+    cache.onTextureDeleted(7);
+    EXPECT_TRUE(cache.bindTexture(GL_TEXTURE0, GL_TEXTURE_2D, 7));
+
+    const f32 value = 1.0f;
+    cache.useProgram(4);
+    cache.setUniform(4, 0, &value, sizeof(f32));
+    cache.onProgramDeleted(4);
+    EXPECT_TRUE(cache.useProgram(4));
+    EXPECT_TRUE(cache.setUniform(4, 0, &value, sizeof(f32)));
+}
+
+TEST_F(OGLStateCacheTest, uniformTest) {
+    OGLStateCache cache;
+    glm::mat4 mvp(1.0f);
+    EXPECT_TRUE(cache.setUniform(1, 0, &mvp, sizeof(glm::mat4)));
+    EXPECT_FALSE(cache.setUniform(1, 0, &mvp, sizeof(glm::mat4)));
+
+    // Values are stored per program
+    EXPECT_TRUE(cache.setUniform(2, 0, &mvp, sizeof(glm::mat4)));
+
+    mvp[3][0] = 2.0f;
+    EXPECT_TRUE(cache.setUniform(1, 0, &mvp, sizeof(glm::mat4)));
+    EXPECT_FALSE(cache.setUniform(1, 0, &mvp, sizeof(glm::mat4)));
+}
+
+TEST_F(OGLStateCacheTest, counterTest) {
+    OGLStateCache cache;
+    // A frame of 100 draws sharing one program, vertex array and texture
+    for (ui32 i = 0; i < 100; ++i) {
+        cache.useProgram(1);
+        cache.bindVertexArray(2);
+        cache.bindTexture(GL_TEXTURE0, GL_TEXTURE_2D, 3);
+    }
+    EXPECT_EQ(3u, cache.getNumIssuedCalls());
+    EXPECT_EQ(297u, cache.getNumSkippedCalls());
+
+    cache.resetCounters();
+    EXPECT_EQ(0u, cache.getNumIssuedCalls());
+    EXPECT_EQ(0u, cache.getNumSkippedCalls());
+}
+
+} // Namespace UnitTest
+} // Namespace OSRE
@@ -0,0 +1,72 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2015-2020 OSRE ( Open Source Render Engine ) by Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#include "osre_testcommon.h"
+#include "src/Engine/RenderBackend/OGLRenderer/OGLStreamBuffer.h"
+
+namespace OSRE {
+namespace UnitTest {
+
+using namespace ::OSRE::RenderBackend;
+
+class OGLStreamBufferTest : public ::testing::Test {
+    // empty
+};
+
+TEST_F(OGLStreamBufferTest, ringAllocTest) {
+    StreamRingAllocator ring;
+    ring.init(1024, 3);
+
+    size_t offset(999);
+    EXPECT_FALSE(ring.alloc(0, 16, offset));
+    EXPECT_TRUE(ring.alloc(100, 16, offset));
+    EXPECT_EQ(0u, offset);
+    EXPECT_TRUE(ring.alloc(100, 256, offset));
+    EXPECT_EQ(256u, offset);
+
+    // The region of a frame does not spill into the next one
+    EXPECT_FALSE(ring.alloc(1024, 16, offset));
+    EXPECT_TRUE(ring.alloc(668, 1, offset));
+    EXPECT_FALSE(ring.alloc(1, 1, offset));
+}
+
+TEST_F(OGLStreamBufferTest, ringRegionTest) {
+    StreamRingAllocator ring;
+    ring.init(1024, 3);
+
+    size_t offset(0);
+    EXPECT_EQ(1u, ring.nextRegion());
+    EXPECT_TRUE(ring.alloc(16, 16, offset));
+    EXPECT_EQ(1024u, offset);
+
+    EXPECT_EQ(2u, ring.nextRegion());
+    EXPECT_TRUE(ring.alloc(16, 16, offset));
+    EXPECT_EQ(2048u, offset);
+
+    // Wraps around to the first region
+    EXPECT_EQ(0u, ring.nextRegion());
+    EXPECT_TRUE(ring.alloc(16, 16, offset));
+    EXPECT_EQ(0u, offset);
+}
+
+} // Namespace UnitTest
+} // Namespace OSRE
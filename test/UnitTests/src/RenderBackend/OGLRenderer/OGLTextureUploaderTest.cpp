@@ -0,0 +1,72 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2015-2020 OSRE ( Open Source Render Engine ) by Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#include "osre_testcommon.h"
+#include "src/Engine/RenderBackend/OGLRenderer/OGLTextureUploader.h"
+
+namespace OSRE {
+namespace UnitTest {
+
+using namespace ::OSRE::RenderBackend;
+
+class OGLTextureUploaderTest : public ::testing::Test {
+    // empty
+};
+
+TEST_F(OGLTextureUploaderTest, cursorRowsTest) {
+    TextureUploadCursor cursor;
+    cursor.init(100, 10, 3);
+    EXPECT_EQ(300u, cursor.getRowPitch());
+
+    // Only whole rows are uploaded
+    EXPECT_EQ(0u, cursor.nextRows(299));
+    EXPECT_EQ(1u, cursor.nextRows(300));
+    EXPECT_EQ(3u, cursor.nextRows(1000));
+    EXPECT_EQ(10u, cursor.nextRows(100000));
+}
+
+TEST_F(OGLTextureUploaderTest, cursorAdvanceTest) {
+    TextureUploadCursor cursor;
+    cursor.init(4, 5, 4);
+
+    // A budget of two rows needs three frames
+    ui32 frames(0);
+    while (!cursor.isDone()) {
+        const ui32 rows = cursor.nextRows(32);
+        ASSERT_NE(0u, rows);
+        cursor.advance(rows);
+        ++frames;
+    }
+    EXPECT_EQ(3u, frames);
+    EXPECT_EQ(5u, cursor.m_row);
+    EXPECT_EQ(0u, cursor.nextRows(1024));
+}
+
+TEST_F(OGLTextureUploaderTest, emptyImageTest) {
+    TextureUploadCursor cursor;
+    cursor.init(0, 0, 3);
+    EXPECT_TRUE(cursor.isDone());
+    EXPECT_EQ(0u, cursor.nextRows(1024));
+}
+
+} // Namespace UnitTest
+} // Namespace OSRE
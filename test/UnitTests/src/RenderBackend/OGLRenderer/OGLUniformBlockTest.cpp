@@ -0,0 +1,103 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2015-2020 OSRE ( Open Source Render Engine ) by Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#include "osre_testcommon.h"
+#include "src/Engine/RenderBackend/OGLRenderer/OGLUniformBlock.h"
+
+namespace OSRE {
+namespace UnitTest {
+
+using namespace ::OSRE::RenderBackend;
+
+class OGLUniformBlockTest : public ::testing::Test {
+    // empty
+};
+
+TEST_F(OGLUniformBlockTest, std140LayoutTest) {
+    UniformBlockLayout layout;
+    EXPECT_TRUE(layout.addMember("a", ParameterType::PT_Float, 1));
+    EXPECT_TRUE(layout.addMember("b", ParameterType::PT_Float3, 1));
+    EXPECT_TRUE(layout.addMember("c", ParameterType::PT_Float, 1));
+    EXPECT_TRUE(layout.addMember("d", ParameterType::PT_Float2, 1));
+    EXPECT_TRUE(layout.addMember("e", ParameterType::PT_FloatArray, 3));
+    EXPECT_TRUE(layout.addMember("f", ParameterType::PT_Mat4, 1));
+    EXPECT_FALSE(layout.addMember("g", ParameterType::PT_None, 1));
+
+    // vec3 is aligned to 16 bytes, a following float fills its padding
+    EXPECT_EQ(0u, layout.findMember("a")->m_offset);
+    EXPECT_EQ(16u, layout.findMember("b")->m_offset);
+    EXPECT_EQ(28u, layout.findMember("c")->m_offset);
+    EXPECT_EQ(32u, layout.findMember("d")->m_offset);
+
+    // Array items are padded to 16 bytes
+    const UniformBlockLayout::Member *e = layout.findMember("e");
+    EXPECT_EQ(48u, e->m_offset);
+    EXPECT_EQ(16u, e->m_stride);
+    EXPECT_EQ(96u, layout.findMember("f")->m_offset);
+    EXPECT_EQ(160u, layout.m_size);
+    EXPECT_EQ(nullptr, layout.findMember("g"));
+}
+
+TEST_F(OGLUniformBlockTest, buildTest) {
+    UniformVar *mvp = UniformVar::create("MVP", ParameterType::PT_Mat4);
+    UniformVar *scale = UniformVar::create("scale", ParameterType::PT_Float);
+    ::CPPCore::TArray<UniformVar *> vars;
+    vars.add(mvp);
+    vars.add(scale);
+
+    UniformBlockLayout layout;
+    layout.build(vars);
+    EXPECT_EQ(2u, layout.m_members.size());
+    EXPECT_EQ(64u, layout.findMember("scale")->m_offset);
+    EXPECT_EQ(80u, layout.m_size);
+
+    // The members can be found by the interned names of the variables
+    EXPECT_EQ(layout.findMember("scale"), layout.findMember(scale->m_hash));
+    EXPECT_EQ(layout.findMember("MVP"), layout.findMember(mvp->m_hash));
+
+    const String decl = layout.getGLSLDeclaration("BatchBlock");
+    EXPECT_EQ("layout(std140) uniform BatchBlock {\n    mat4 MVP;\n    float scale;\n};\n", decl);
+
+    UniformVar::destroy(mvp);
+    UniformVar::destroy(scale);
+}
+
+TEST_F(OGLUniformBlockTest, packTest) {
+    UniformBlockLayout layout;
+    layout.addMember("weights", ParameterType::PT_FloatArray, 3);
+    MemoryBuffer block;
+    block.resize(layout.m_size);
+    ::memset(&block[0], 0, layout.m_size);
+
+    const f32 weights[3] = { 1.0f, 2.0f, 3.0f };
+    const UniformBlockLayout::Member *member = layout.findMember("weights");
+    EXPECT_TRUE(layout.pack(*member, weights, sizeof(weights), &block[0]));
+    EXPECT_FALSE(layout.pack(*member, weights, sizeof(weights), &block[0]));
+
+    const f32 *packed = reinterpret_cast<const f32 *>(&block[0]);
+    EXPECT_FLOAT_EQ(1.0f, packed[0]);
+    EXPECT_FLOAT_EQ(2.0f, packed[4]);
+    EXPECT_FLOAT_EQ(3.0f, packed[8]);
+}
+
+} // Namespace UnitTest
+} // Namespace OSRE
@@ -0,0 +1,108 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2015-2020 OSRE ( Open Source Render Engine ) by Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#include "osre_testcommon.h"
+#include "src/Engine/RenderBackend/OGLRenderer/RenderSortKey.h"
+
+#include <chrono>
+#include <iostream>
+#include <random>
+
+namespace OSRE {
+namespace UnitTest {
+
+using namespace ::OSRE::RenderBackend;
+
+class RenderSortKeyTest : public ::testing::Test {
+    // empty
+};
+
+TEST_F(RenderSortKeyTest, encodeTest) {
+    const ui64 key = RenderSortKey::encode(3, 2, 100, 5000, 12345);
+    EXPECT_EQ(3u, RenderSortKey::getPass(key));
+    EXPECT_EQ(2u, RenderSortKey::getLayer(key));
+    EXPECT_EQ(100u, RenderSortKey::getShader(key));
+    EXPECT_EQ(5000u, RenderSortKey::getMaterial(key));
+    EXPECT_EQ(12345u, RenderSortKey::getDepth(key));
+
+    // The pass dominates all other fields
+    EXPECT_LT(RenderSortKey::encode(0, 63, 4095, 0xfffff, 0xfffff), RenderSortKey::encode(1, 0, 0, 0, 0));
+    EXPECT_EQ(RenderSortKey::MaxLayer, RenderSortKey::getLayer(RenderSortKey::encode(0, RenderSortKey::MaxLayer, 0, 0, 0)));
+    EXPECT_EQ(0u, RenderSortKey::getLayer(RenderSortKey::encode(0, RenderSortKey::MaxLayer + 1, 0, 0, 0)));
+
+    EXPECT_EQ(0u, RenderSortKey::quantizeDepth(-1.0f));
+    EXPECT_LT(RenderSortKey::quantizeDepth(0.5f), RenderSortKey::quantizeDepth(1.0f));
+    EXPECT_LT(RenderSortKey::quantizeDepth(1.0f), RenderSortKey::quantizeDepth(1000.0f));
+}
+
+TEST_F(RenderSortKeyTest, radixSortTest) {
+    CPPCore::TArray<DrawItem> items, scratch;
+    const ui64 keys[] = { 7, 0x0100000000000000ULL, 3, 7, 0x100, 1 };
+    for (ui32 i = 0; i < 6; ++i) {
+        DrawItem item;
+        item.m_key = keys[i];
+        item.m_firstCmd = i;
+        item.m_numCmds = 1;
+        items.add(item);
+    }
+
+    radixSortDrawItems(items, scratch);
+    for (ui32 i = 1; i < items.size(); ++i) {
+        EXPECT_LE(items[i - 1].m_key, items[i].m_key);
+    }
+
+    // Stable: equal keys keep their submission order
+    EXPECT_EQ(0u, items[2].m_firstCmd);
+    EXPECT_EQ(3u, items[3].m_firstCmd);
+}
+
+TEST_F(RenderSortKeyTest, mixedMaterialBenchmarkTest) {
+    static const ui32 NumDraws = 10000;
+    static const ui32 NumShaders = 8;
+    static const ui32 NumMaterials = 64;
+
+    std::mt19937 rng(42);
+    CPPCore::TArray<DrawItem> items, scratch;
+    for (ui32 i = 0; i < NumDraws; ++i) {
+        DrawItem item;
+        item.m_key = RenderSortKey::encode(0, 0, rng() % NumShaders, rng() % NumMaterials,
+                RenderSortKey::quantizeDepth(static_cast<f32>(rng() % 1000) + 1.0f));
+        item.m_firstCmd = i * 2;
+        item.m_numCmds = 2;
+        items.add(item);
+    }
+
+    const ui32 unsortedChanges = countStateChanges(items);
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    radixSortDrawItems(items, scratch);
+    const i64 sortUs = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+    const ui32 sortedChanges = countStateChanges(items);
+
+    // Each shader is bound once, each material at most once per shader
+    EXPECT_LE(sortedChanges, NumShaders + NumShaders * NumMaterials);
+    EXPECT_LT(sortedChanges, unsortedChanges);
+    std::cout << NumDraws << " draws sorted in " << sortUs << " us, state changes " << unsortedChanges
+              << " -> " << sortedChanges << ", saved " << unsortedChanges - sortedChanges << std::endl;
+}
+
+} // Namespace UnitTest
+} // Namespace OSRE
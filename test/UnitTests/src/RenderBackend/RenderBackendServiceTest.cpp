@@ -23,6 +23,8 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "osre_testcommon.h"
 #include <osre/RenderBackend/RenderBackendService.h>
 
+#include <thread>
+
 namespace OSRE {
 namespace UnitTest {
 
@@ -44,5 +46,42 @@ TEST_F(RenderBackendServiceTest, createTest) {
     EXPECT_TRUE(ok);
 }
 
+TEST_F(RenderBackendServiceTest, framesInFlightTest) {
+    RenderBackendService rbSrv;
+    EXPECT_EQ(1u, rbSrv.getFramesInFlight());
+
+    rbSrv.setFramesInFlight(2);
+    EXPECT_EQ(2u, rbSrv.getFramesInFlight());
+
+    rbSrv.setFramesInFlight(0);
+    EXPECT_EQ(1u, rbSrv.getFramesInFlight());
+
+    rbSrv.setFramesInFlight(RenderBackendService::MaxFramesInFlight + 1);
+    EXPECT_EQ(RenderBackendService::MaxFramesInFlight, rbSrv.getFramesInFlight());
+}
+
+TEST_F(RenderBackendServiceTest, resizeEventDataTest) {
+    ResizeEventData data(0, 0, 0, 0);
+    std::thread writer([&data]() {
+        for (ui32 i = 1; i <= 10000; ++i) {
+            data.set(i, i, i, i);
+        }
+    });
+
+    // A reader must never see a torn size
+    ui32 x(0), y(0), w(0), h(0);
+    for (ui32 i = 0; i < 10000; ++i) {
+        data.get(x, y, w, h);
+        EXPECT_EQ(x, y);
+        EXPECT_EQ(x, w);
+        EXPECT_EQ(x, h);
+    }
+    writer.join();
+
+    data.get(x, y, w, h);
+    EXPECT_EQ(10000u, x);
+    EXPECT_EQ(10000u, h);
+}
+
 } // Namespace UnitTest
 } // Namespace OSRE
@@ -21,11 +21,16 @@ IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
 CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 -----------------------------------------------------------------------------------------------*/
 #include "osre_testcommon.h"
+#include <osre/Common/StringUtils.h>
+#include <osre/IO/IOService.h>
 #include <osre/RenderBackend/RenderCommon.h>
 #include <osre/RenderBackend/Shader.h>
 #include <osre/RenderBackend/Mesh.h>
 #include <glm/gtc/matrix_transform.hpp>
 
+#include <chrono>
+#include <thread>
+
 namespace OSRE {
 namespace UnitTest {
 
@@ -246,6 +251,60 @@ TEST_F(RenderCommonTest, uniformBufferReadWriteTest) {
     EXPECT_TRUE(isEqual(buf_out, 2, 100) );
 }
 
+TEST_F(RenderCommonTest, uniformBufferVarTest) {
+    UniformBuffer buffer;
+    buffer.create(16);
+
+    UniformVar *var = UniformVar::create("color", ParameterType::PT_Float3);
+    const f32 color[3] = { 0.1f, 0.2f, 0.3f };
+    ::memcpy(var->m_data.getData(), color, sizeof(color));
+    buffer.writeVar(var);
+    buffer.writeVar(var);
+    EXPECT_EQ(2u, buffer.m_numvars);
+    EXPECT_LE(buffer.m_pos, buffer.getSize());
+
+    buffer.reset();
+    for (ui32 i = 0; i < 2; ++i) {
+        String name;
+        size_t size(0);
+        const c8 *data = buffer.readVar(name, size);
+        ASSERT_NE(nullptr, data);
+        EXPECT_EQ("color", name);
+        EXPECT_EQ(sizeof(color), size);
+        EXPECT_EQ(0, ::memcmp(color, data, size));
+    }
+    UniformVar::destroy(var);
+}
+
+TEST_F(RenderCommonTest, uniformBufferHashTest) {
+    UniformBuffer buffer;
+    buffer.create(16);
+
+    UniformVar *var = UniformVar::create("color", ParameterType::PT_Float3);
+    EXPECT_EQ(Common::StringUtils::hashName("color"), var->m_hash);
+    const f32 color[3] = { 0.1f, 0.2f, 0.3f };
+    ::memcpy(var->m_data.getData(), color, sizeof(color));
+    buffer.writeVar(var);
+    buffer.writeVar(var);
+
+    // Reading by hash skips the name
+    buffer.reset();
+    HashId hash(0);
+    size_t size(0);
+    const c8 *data = buffer.readVar(hash, size);
+    ASSERT_NE(nullptr, data);
+    EXPECT_EQ(var->m_hash, hash);
+    EXPECT_EQ(sizeof(color), size);
+    EXPECT_EQ(0, ::memcmp(color, data, size));
+
+    String name;
+    data = buffer.readVar(name, size);
+    ASSERT_NE(nullptr, data);
+    EXPECT_EQ("color", name);
+    EXPECT_EQ(nullptr, buffer.readVar(hash, size));
+    UniformVar::destroy(var);
+}
+
 TEST_F(RenderCommonTest, uniformBufferEncodeDecodeTest) {
     ui16 lenName = 10, lenName_out(0);
     ui16 lenData = 100, lenData_out(0);
@@ -255,6 +314,151 @@ TEST_F(RenderCommonTest, uniformBufferEncodeDecodeTest) {
     EXPECT_EQ(lenData, lenData_out);
 }
 
+TEST_F(RenderCommonTest, frameFenceTest) {
+    FrameFence fence;
+    EXPECT_FALSE(fence.isPending());
+
+    fence.submit();
+    EXPECT_TRUE(fence.isPending());
+
+    std::thread renderThread([&fence]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        fence.retire();
+    });
+    fence.wait();
+    EXPECT_FALSE(fence.isPending());
+    renderThread.join();
+}
+
+TEST_F(RenderCommonTest, frameArenaTest) {
+    FrameArena arena;
+    arena.create(64);
+    EXPECT_EQ(1u, arena.getNumBlocks());
+
+    c8 *first = arena.alloc(10);
+    c8 *second = arena.alloc(10);
+    ASSERT_NE(nullptr, first);
+    ASSERT_NE(nullptr, second);
+    EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(second) % FrameArena::DefaultAlign);
+    EXPECT_EQ(20u, arena.getUsed());
+
+    // Does not fit anymore, a block will be chained and the first allocations stay valid
+    ::memset(first, 1, 10);
+    c8 *large = arena.alloc(100);
+    ASSERT_NE(nullptr, large);
+    EXPECT_EQ(2u, arena.getNumBlocks());
+    EXPECT_EQ(1, first[9]);
+
+    // The reset merges the blocks, so the same allocations will fit into one block
+    const size_t capacity = arena.getCapacity();
+    arena.reset();
+    EXPECT_EQ(0u, arena.getUsed());
+    EXPECT_EQ(1u, arena.getNumBlocks());
+    EXPECT_EQ(capacity, arena.getCapacity());
+    arena.alloc(10);
+    arena.alloc(10);
+    arena.alloc(100);
+    EXPECT_EQ(1u, arena.getNumBlocks());
+
+    arena.destroy();
+    EXPECT_EQ(0u, arena.getCapacity());
+}
+
+TEST_F(RenderCommonTest, framePayloadTest) {
+    Frame frame;
+    FrameSubmitCmd *smallCmd = frame.enqueue();
+    c8 *smallPayload = frame.allocPayload(smallCmd, FrameSubmitCmd::InlineSize);
+    EXPECT_EQ(smallPayload, smallCmd->m_data);
+    EXPECT_TRUE(smallCmd->isInlined());
+    EXPECT_EQ(FrameSubmitCmd::InlineSize, smallCmd->m_size);
+    EXPECT_EQ(0u, frame.m_payloadArena.getUsed());
+
+    FrameSubmitCmd *largeCmd = frame.enqueue();
+    frame.allocPayload(largeCmd, sizeof(MatrixBuffer));
+    EXPECT_FALSE(largeCmd->isInlined());
+    EXPECT_EQ(sizeof(MatrixBuffer), frame.m_payloadArena.getUsed());
+
+    frame.m_inlinePayloads = false;
+    FrameSubmitCmd *arenaCmd = frame.enqueue();
+    frame.allocPayload(arenaCmd, 4);
+    EXPECT_FALSE(arenaCmd->isInlined());
+    EXPECT_EQ(3u, frame.m_submitCmds.size());
+
+    frame.releaseSubmitCmds();
+    EXPECT_EQ(0u, frame.m_submitCmds.size());
+    EXPECT_EQ(0u, frame.m_payloadArena.getUsed());
+}
+
+TEST_F(RenderCommonTest, instanceDataTest) {
+    glm::mat4 transform(1.0f);
+    transform = glm::translate(transform, glm::vec3(1, 2, 3));
+    transform = glm::scale(transform, glm::vec3(2, 2, 2));
+
+    InstanceVert vert;
+    vert.setTransform(transform);
+    EXPECT_EQ(glm::vec4(2, 0, 0, 1), vert.transform[0]);
+    EXPECT_EQ(glm::vec4(0, 2, 0, 2), vert.transform[1]);
+    EXPECT_EQ(glm::vec4(0, 0, 2, 3), vert.transform[2]);
+    glm::mat4 result;
+    vert.getTransform(result);
+    EXPECT_EQ(transform, result);
+    EXPECT_EQ(4u, InstanceVert::getNumAttributes());
+    EXPECT_EQ(getVertCompName(VertexAttribute::Instance0), InstanceVert::getAttributes()[0]);
+
+    GeoInstanceData instanceData;
+    instanceData.alloc(3, BufferAccessType::ReadOnly);
+    ASSERT_NE(nullptr, instanceData.m_data);
+    EXPECT_EQ(3u, instanceData.m_numInstances);
+    EXPECT_EQ(BufferType::InstanceBuffer, instanceData.m_data->getBufferType());
+    EXPECT_EQ(3 * sizeof(InstanceVert), instanceData.m_data->getSize());
+
+    instanceData.setInstance(1, transform, glm::vec4(1, 0, 0, 1));
+    const InstanceVert *instances = instanceData.getInstances();
+    EXPECT_EQ(glm::vec4(1, 1, 1, 1), instances[0].color0);
+    EXPECT_EQ(glm::vec4(1, 0, 0, 1), instances[1].color0);
+    EXPECT_EQ(vert.transform[2], instances[1].transform[2]);
+}
+
+TEST_F(RenderCommonTest, deferredTextureLoadTest) {
+    static const c8 *Filename = "deferredtexture.png";
+    static const ui32 Size = 16;
+    c8 data[Size] = {};
+    FILE *file = ::fopen(Filename, "wb");
+    ASSERT_NE(nullptr, file);
+    ::fwrite(data, 1, Size, file);
+    ::fclose(file);
+
+    // The image is not decoded, the backend streams it in from the located file
+    IO::IOService *ioService = IO::IOService::create();
+    TextureLoader::setDeferredDecoding(true);
+    Texture tex;
+    TextureLoader loader;
+    EXPECT_EQ(Size, loader.load(IO::Uri(String("file://") + Filename), &tex));
+    EXPECT_EQ(nullptr, tex.m_data);
+    EXPECT_NE(String::npos, tex.m_loc.getAbsPath().find(Filename));
+
+    Texture missing;
+    EXPECT_EQ(0u, loader.load(IO::Uri("file://nonexisting.png"), &missing));
+    TextureLoader::setDeferredDecoding(false);
+
+    ioService->release();
+    ::remove(Filename);
+}
+
+TEST_F(RenderCommonTest, textureRegionTest) {
+    TextureRegion region;
+    EXPECT_EQ(glm::vec2(0.25f, 0.75f), region.map(glm::vec2(0.25f, 0.75f)));
+
+    // The layer is stored in the integer part of u
+    region = TextureRegion(2, glm::vec4(0.5f, 0.25f, 0.25f, 0.5f));
+    RenderVert verts[2];
+    verts[0].tex0 = glm::vec2(0, 0);
+    verts[1].tex0 = glm::vec2(1, 1);
+    region.apply(verts, 2);
+    EXPECT_EQ(glm::vec2(2.5f, 0.25f), verts[0].tex0);
+    EXPECT_EQ(glm::vec2(2.75f, 0.75f), verts[1].tex0);
+}
+
 } // Namespace UnitTest
 } // Namespace OSRE
 
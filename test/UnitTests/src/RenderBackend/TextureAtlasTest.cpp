@@ -0,0 +1,162 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2015-2020 OSRE ( Open Source Render Engine ) by Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#include "osre_testcommon.h"
+#include <osre/RenderBackend/TextureAtlas.h>
+
+namespace OSRE {
+namespace UnitTest {
+
+using namespace ::OSRE::RenderBackend;
+
+class TextureAtlasTest : public ::testing::Test {
+    // empty
+};
+
+static void fillImage( uc8 *pixels, ui32 width, ui32 height, uc8 value ) {
+    for ( ui32 i = 0; i < width * height; ++i ) {
+        pixels[ i * 3 + 0 ] = value;
+        pixels[ i * 3 + 1 ] = 0;
+        pixels[ i * 3 + 2 ] = static_cast<uc8>( i );
+    }
+}
+
+TEST_F( TextureAtlasTest, createTest ) {
+    TextureAtlas atlas;
+    EXPECT_FALSE( atlas.create( 0, 64, 1 ) );
+    EXPECT_FALSE( atlas.create( 64, 64, 1, 32 ) );
+    EXPECT_TRUE( atlas.create( 64, 64, 2 ) );
+    EXPECT_FALSE( atlas.create( 64, 64, 2 ) );
+    EXPECT_EQ( 0u, atlas.getNumLayers() );
+    EXPECT_EQ( nullptr, atlas.createTexture( "atlas" ) );
+
+    // Without a border an image at the right edge would reach into the next layer
+    atlas.destroy();
+    EXPECT_FALSE( atlas.create( 32, 32, 1, 0 ) );
+    EXPECT_TRUE( atlas.create( 32, 32, 1, 1 ) );
+}
+
+TEST_F( TextureAtlasTest, mipLevelTest ) {
+    // The mip chain ends where the border shrinks to one pixel
+    TextureAtlas atlas;
+    ASSERT_TRUE( atlas.create( 64, 64, 1, 1 ) );
+    EXPECT_EQ( 0u, atlas.getMaxMipLevel() );
+    atlas.destroy();
+    ASSERT_TRUE( atlas.create( 64, 64, 1, 4 ) );
+    EXPECT_EQ( 2u, atlas.getMaxMipLevel() );
+    atlas.destroy();
+    ASSERT_TRUE( atlas.create( 64, 64, 1, 7 ) );
+    EXPECT_EQ( 2u, atlas.getMaxMipLevel() );
+
+    uc8 pixels[ 2 * 2 * 3 ];
+    fillImage( pixels, 2, 2, 1 );
+    TextureRegion region;
+    ASSERT_TRUE( atlas.add( "image", pixels, 2, 2, 3, region ) );
+    Texture *tex = atlas.createTexture( "atlas" );
+    ASSERT_NE( nullptr, tex );
+    EXPECT_EQ( 3u, tex->m_numMipLevels );
+    delete tex;
+}
+
+TEST_F( TextureAtlasTest, packTest ) {
+    TextureAtlas atlas;
+    ASSERT_TRUE( atlas.create( 64, 64, 1, 2 ) );
+
+    uc8 pixels[ 12 * 12 * 3 ];
+    fillImage( pixels, 12, 12, 1 );
+    TextureRegion first, second;
+    EXPECT_TRUE( atlas.add( "first", pixels, 12, 12, 3, first ) );
+    EXPECT_TRUE( atlas.add( "second", pixels, 12, 12, 3, second ) );
+    EXPECT_EQ( 1u, atlas.getNumLayers() );
+    EXPECT_EQ( 2u, atlas.getNumImages() );
+
+    // The images are placed side by side with their borders in between
+    EXPECT_FLOAT_EQ( 2.0f / 64.0f, first.m_uvRect.x );
+    EXPECT_FLOAT_EQ( 2.0f / 64.0f, first.m_uvRect.y );
+    EXPECT_FLOAT_EQ( 12.0f / 64.0f, first.m_uvRect.z );
+    EXPECT_FLOAT_EQ( 18.0f / 64.0f, second.m_uvRect.x );
+    EXPECT_FLOAT_EQ( first.m_uvRect.y, second.m_uvRect.y );
+
+    TextureRegion found;
+    EXPECT_TRUE( atlas.findRegion( "second", found ) );
+    EXPECT_EQ( second.m_uvRect, found.m_uvRect );
+    EXPECT_FALSE( atlas.findRegion( "third", found ) );
+
+    // Adding a known image does not use more space
+    EXPECT_TRUE( atlas.add( "first", pixels, 12, 12, 3, found ) );
+    EXPECT_EQ( first.m_uvRect, found.m_uvRect );
+    EXPECT_EQ( 2u, atlas.getNumImages() );
+}
+
+TEST_F( TextureAtlasTest, borderTest ) {
+    TextureAtlas atlas;
+    ASSERT_TRUE( atlas.create( 16, 16, 1, 2 ) );
+
+    uc8 pixels[ 2 * 2 * 3 ];
+    fillImage( pixels, 2, 2, 200 );
+    TextureRegion region;
+    ASSERT_TRUE( atlas.add( "image", pixels, 2, 2, 3, region ) );
+
+    // The border repeats the edge pixels, the corners repeat the corner pixels
+    const uc8 *layer = atlas.getLayerData( 0 );
+    ASSERT_NE( nullptr, layer );
+    const ui32 pitch = 16 * TextureAtlas::NumChannels;
+    EXPECT_EQ( 200, layer[ 0 ] );
+    EXPECT_EQ( 0, layer[ 2 ] );
+    EXPECT_EQ( 255, layer[ 3 ] );
+    EXPECT_EQ( 1, layer[ 5 * TextureAtlas::NumChannels + 2 ] );
+    EXPECT_EQ( 3, layer[ 5 * pitch + 5 * TextureAtlas::NumChannels + 2 ] );
+    EXPECT_EQ( 2, layer[ 3 * pitch + 2 ] );
+
+    // Pixels outside of the border are untouched
+    EXPECT_EQ( 0, layer[ 6 * TextureAtlas::NumChannels + 3 ] );
+    EXPECT_EQ( 0, layer[ 6 * pitch + 3 ] );
+}
+
+TEST_F( TextureAtlasTest, layerOverflowTest ) {
+    TextureAtlas atlas;
+    ASSERT_TRUE( atlas.create( 20, 20, 2, 1 ) );
+
+    uc8 pixels[ 18 * 18 * 3 ];
+    fillImage( pixels, 18, 18, 1 );
+    TextureRegion region;
+    EXPECT_FALSE( atlas.add( "tooLarge", pixels, 19, 1, 3, region ) );
+    EXPECT_TRUE( atlas.add( "layer0", pixels, 18, 18, 3, region ) );
+    EXPECT_EQ( 0u, region.m_layer );
+    EXPECT_TRUE( atlas.add( "layer1", pixels, 8, 8, 3, region ) );
+    EXPECT_EQ( 1u, region.m_layer );
+    EXPECT_TRUE( atlas.add( "layer1b", pixels, 8, 8, 3, region ) );
+    EXPECT_EQ( 1u, region.m_layer );
+    EXPECT_FLOAT_EQ( 11.0f / 20.0f, region.m_uvRect.x );
+    EXPECT_LT( region.m_uvRect.x + region.m_uvRect.z, 1.0f );
+    EXPECT_FALSE( atlas.add( "full", pixels, 18, 18, 3, region ) );
+
+    Texture *tex = atlas.createTexture( "atlas" );
+    ASSERT_NE( nullptr, tex );
+    EXPECT_EQ( TextureTargetType::Texture2DArray, tex->m_targetType );
+    EXPECT_EQ( 2u, tex->m_layers );
+    EXPECT_EQ( 20u * 20u * TextureAtlas::NumChannels * 2u, tex->m_size );
+    delete tex;
+}
+
+} // Namespace UnitTest
+} // Namespace OSRE
@@ -0,0 +1,139 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2015-2020 OSRE ( Open Source Render Engine ) by Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#include "osre_testcommon.h"
+#include <osre/RenderBackend/TextureContainer.h>
+
+#include <cstring>
+
+namespace OSRE {
+namespace UnitTest {
+
+using namespace ::OSRE::RenderBackend;
+
+class TextureContainerTest : public ::testing::Test {
+    // empty
+};
+
+TEST_F( TextureContainerTest, levelSizeTest ) {
+    EXPECT_EQ( 8u, TextureContainer::getLevelSize( TextureFormatType::BC1, 4, 4 ) );
+    EXPECT_EQ( 8u, TextureContainer::getLevelSize( TextureFormatType::BC1, 1, 1 ) );
+    EXPECT_EQ( 64u, TextureContainer::getLevelSize( TextureFormatType::BC3, 8, 6 ) );
+    EXPECT_EQ( 0u, TextureContainer::getLevelSize( TextureFormatType::R8G8B8, 4, 4 ) );
+    EXPECT_TRUE( TextureContainer::isCompressed( TextureFormatType::BC7 ) );
+    EXPECT_FALSE( TextureContainer::isCompressed( TextureFormatType::R8G8B8A8 ) );
+}
+
+TEST_F( TextureContainerTest, containerFileTest ) {
+    EXPECT_TRUE( TextureContainer::isContainerFile( "media/Textures/box.dds" ) );
+    EXPECT_TRUE( TextureContainer::isContainerFile( "box.KTX2" ) );
+    EXPECT_FALSE( TextureContainer::isContainerFile( "box.png" ) );
+    EXPECT_FALSE( TextureContainer::isContainerFile( "dds" ) );
+}
+
+TEST_F( TextureContainerTest, writeParseDDSTest ) {
+    // 8x8, 4x4, 2x2 and 1x1
+    const size_t size = 32 + 8 + 8 + 8;
+    uc8 levels[ size ];
+    for ( size_t i = 0; i < size; ++i ) {
+        levels[ i ] = static_cast<uc8>( i );
+    }
+
+    MemoryBuffer buffer;
+    EXPECT_FALSE( TextureContainer::writeDDS( TextureFormatType::BC1, 8, 8, 4, levels, size - 1, buffer ) );
+    ASSERT_TRUE( TextureContainer::writeDDS( TextureFormatType::BC1, 8, 8, 4, levels, size, buffer ) );
+
+    const uc8 *data = reinterpret_cast<const uc8 *>( &buffer[ 0 ] );
+    EXPECT_TRUE( TextureContainer::isContainer( data, buffer.size() ) );
+
+    TextureContainer container;
+    ASSERT_TRUE( container.parse( data, buffer.size() ) );
+    EXPECT_EQ( TextureFormatType::BC1, container.getFormat() );
+    EXPECT_EQ( 8u, container.getWidth() );
+    EXPECT_EQ( 8u, container.getHeight() );
+    ASSERT_EQ( 4u, container.getNumLevels() );
+    EXPECT_EQ( 32u, container.getLevel( 0 ).m_size );
+    EXPECT_EQ( 1u, container.getLevel( 3 ).m_width );
+    EXPECT_EQ( 8u, container.getLevel( 3 ).m_size );
+    EXPECT_EQ( 0, ::memcmp( levels, container.getLevelData( 0 ), size ) );
+
+    // A truncated file is rejected
+    EXPECT_FALSE( container.parse( data, buffer.size() - 1 ) );
+}
+
+TEST_F( TextureContainerTest, writeParseDX10Test ) {
+    uc8 levels[ 16 ] = { 0 };
+    MemoryBuffer buffer;
+    ASSERT_TRUE( TextureContainer::writeDDS( TextureFormatType::BC7, 4, 4, 1, levels, 16, buffer ) );
+
+    TextureContainer container;
+    ASSERT_TRUE( container.parse( reinterpret_cast<const uc8 *>( &buffer[ 0 ] ), buffer.size() ) );
+    EXPECT_EQ( TextureFormatType::BC7, container.getFormat() );
+    EXPECT_EQ( 1u, container.getNumLevels() );
+}
+
+TEST_F( TextureContainerTest, writeParseSRGBTest ) {
+    // The sRGB variants keep their own format across a DDS round trip
+    const TextureFormatType formats[ 4 ] = { TextureFormatType::BC1_SRGB, TextureFormatType::BC2_SRGB,
+        TextureFormatType::BC3_SRGB, TextureFormatType::BC7_SRGB };
+    uc8 levels[ 16 ] = { 0 };
+    for ( ui32 i = 0; i < 4; ++i ) {
+        const size_t size = TextureContainer::getLevelSize( formats[ i ], 4, 4 );
+        MemoryBuffer buffer;
+        ASSERT_TRUE( TextureContainer::writeDDS( formats[ i ], 4, 4, 1, levels, size, buffer ) );
+
+        TextureContainer container;
+        ASSERT_TRUE( container.parse( reinterpret_cast<const uc8 *>( &buffer[ 0 ] ), buffer.size() ) );
+        EXPECT_EQ( formats[ i ], container.getFormat() );
+        EXPECT_EQ( size, container.getLevel( 0 ).m_size );
+    }
+}
+
+TEST_F( TextureContainerTest, parseKTX2Test ) {
+    // Header, the index of two levels and the BC3 blocks of 8x4 and 4x2
+    const uc8 identifier[ 12 ] = { 0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n' };
+    const ui32 header[ 17 ] = { 137, 1, 8, 4, 0, 0, 1, 2, 0, 0, 0, 0, 0, 0, 0, 0, 0 };
+    const ui64 index[ 6 ] = { 128, 32, 32, 160, 16, 16 };
+    uc8 data[ 176 ] = { 0 };
+    ::memcpy( &data[ 0 ], identifier, sizeof( identifier ) );
+    ::memcpy( &data[ 12 ], header, sizeof( header ) );
+    ::memcpy( &data[ 80 ], index, sizeof( index ) );
+
+    TextureContainer container;
+    ASSERT_TRUE( container.parse( data, sizeof( data ) ) );
+    EXPECT_EQ( TextureFormatType::BC3, container.getFormat() );
+    ASSERT_EQ( 2u, container.getNumLevels() );
+    EXPECT_EQ( 128u, container.getLevel( 0 ).m_offset );
+    EXPECT_EQ( 4u, container.getLevel( 1 ).m_width );
+    EXPECT_EQ( 2u, container.getLevel( 1 ).m_height );
+
+    // Levels outside of the file are rejected
+    EXPECT_FALSE( container.parse( data, 170 ) );
+
+    // Supercompression is not supported
+    const ui32 zstd = 2;
+    ::memcpy( &data[ 44 ], &zstd, sizeof( ui32 ) );
+    EXPECT_FALSE( container.parse( data, sizeof( data ) ) );
+}
+
+} // Namespace UnitTest
+} // Namespace OSRE
@@ -0,0 +1,134 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2015-2020 OSRE ( Open Source Render Engine ) by Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#include "osre_testcommon.h"
+#include <osre/RenderBackend/Shader.h>
+#include <osre/Scene/MaterialBuilder.h>
+
+namespace OSRE {
+namespace UnitTest {
+
+using namespace ::OSRE::Scene;
+using namespace ::OSRE::RenderBackend;
+
+class MaterialBuilderTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        MaterialBuilder::create();
+    }
+
+    void TearDown() override {
+        MaterialBuilder::destroy();
+    }
+};
+
+TEST_F( MaterialBuilderTest, variantDefinesTest ) {
+    const ui32 features = static_cast<ui32>( ShaderFeatureType::Textured ) | static_cast<ui32>( ShaderFeatureType::Lit );
+    const String defines = MaterialBuilder::getVariantDefines( features );
+    EXPECT_NE( String::npos, defines.find( "#define TEXTURED" ) );
+    EXPECT_NE( String::npos, defines.find( "#define LIT" ) );
+    EXPECT_EQ( String::npos, defines.find( "#define INSTANCED" ) );
+    EXPECT_EQ( String::npos, defines.find( "#define SKINNED" ) );
+    EXPECT_NE( String::npos, defines.find( "#define DRAW_DATA" ) );
+
+    // Instances and bones are per draw already, their draws are not merged
+    const String instanced = MaterialBuilder::getVariantDefines( static_cast<ui32>( ShaderFeatureType::Instanced ) );
+    EXPECT_EQ( String::npos, instanced.find( "#define DRAW_DATA" ) );
+
+    ShaderSourceArray sources;
+    MaterialBuilder::getVariantSources( features, sources );
+    const String &vs = sources[ static_cast<size_t>( ShaderType::SH_VertexShaderType ) ];
+    EXPECT_EQ( 0u, vs.find( "#version" ) );
+    EXPECT_NE( String::npos, vs.find( "#define TEXTURED" ) );
+    EXPECT_NE( String::npos, sources[ static_cast<size_t>( ShaderType::SH_FragmentShaderType ) ].find( "#define LIT" ) );
+
+    EXPECT_NE( MaterialBuilder::getVariantName( features ), MaterialBuilder::getVariantName( 0 ) );
+}
+
+TEST_F( MaterialBuilderTest, shareVariantTest ) {
+    const ui32 features = static_cast<ui32>( ShaderFeatureType::VertexColor );
+    Material *mat1 = MaterialBuilder::createVariantMaterial( "mat1", features, VertexType::ColorVertex );
+    Material *mat2 = MaterialBuilder::createVariantMaterial( "mat2", features, VertexType::RenderVertex );
+    ASSERT_NE( nullptr, mat1 );
+    ASSERT_NE( nullptr, mat2 );
+    EXPECT_NE( mat1, mat2 );
+
+    // Both materials use the same program
+    ASSERT_NE( nullptr, mat1->m_shader );
+    ASSERT_NE( nullptr, mat2->m_shader );
+    EXPECT_EQ( mat1->m_shader->m_name, mat2->m_shader->m_name );
+
+    Material *uiMat = MaterialBuilder::createBuildinUiMaterial();
+    ASSERT_NE( nullptr, uiMat );
+    EXPECT_EQ( mat1->m_shader->m_name, uiMat->m_shader->m_name );
+
+    Material *texMat = MaterialBuilder::createBuildinMaterial( VertexType::RenderVertex );
+    ASSERT_NE( nullptr, texMat );
+    EXPECT_NE( mat1->m_shader->m_name, texMat->m_shader->m_name );
+}
+
+TEST_F( MaterialBuilderTest, skinnedVariantTest ) {
+    // The skin attributes use the names of the engine vertex components, they have fixed locations
+    const ui32 features = static_cast<ui32>( ShaderFeatureType::Skinned );
+    Material *mat = MaterialBuilder::createVariantMaterial( "skinned", features, VertexType::RenderVertex );
+    ASSERT_NE( nullptr, mat );
+    ASSERT_NE( nullptr, mat->m_shader );
+
+    bool hasIndices( false ), hasWeights( false );
+    for ( size_t i = 0; i < mat->m_shader->m_attributes.size(); ++i ) {
+        hasIndices |= mat->m_shader->m_attributes[ i ] == getVertCompName( VertexAttribute::Indices );
+        hasWeights |= mat->m_shader->m_attributes[ i ] == getVertCompName( VertexAttribute::Weights );
+    }
+    EXPECT_TRUE( hasIndices );
+    EXPECT_TRUE( hasWeights );
+}
+
+TEST_F( MaterialBuilderTest, unsupportedVariantTest ) {
+    // Color vertices have no texture coordinates
+    const ui32 features = static_cast<ui32>( ShaderFeatureType::Textured );
+    EXPECT_EQ( nullptr, MaterialBuilder::createVariantMaterial( "texColor", features, VertexType::ColorVertex ) );
+}
+
+TEST_F( MaterialBuilderTest, atlasMaterialTest ) {
+    Texture atlas;
+    atlas.m_textureName = "atlas";
+    EXPECT_EQ( nullptr, MaterialBuilder::createAtlasMaterial( "noArray", &atlas, TextureRegion() ) );
+
+    // Materials of different regions share the texture and the program, so they can be batched
+    atlas.m_targetType = TextureTargetType::Texture2DArray;
+    Material *mat1 = MaterialBuilder::createAtlasMaterial( "icon1", &atlas, TextureRegion( 0, glm::vec4( 0, 0, 0.5f, 0.5f ) ) );
+    Material *mat2 = MaterialBuilder::createAtlasMaterial( "icon2", &atlas, TextureRegion( 1, glm::vec4( 0.5f, 0, 0.5f, 0.5f ) ) );
+    ASSERT_NE( nullptr, mat1 );
+    ASSERT_NE( nullptr, mat2 );
+    EXPECT_EQ( mat1->m_textures[ 0 ], mat2->m_textures[ 0 ] );
+    EXPECT_EQ( mat1->m_shader->m_name, mat2->m_shader->m_name );
+    EXPECT_EQ( 1u, mat2->m_region.m_layer );
+
+    const String &fs = mat1->m_shader->m_src[ static_cast<size_t>( ShaderType::SH_FragmentShaderType ) ];
+    EXPECT_NE( String::npos, fs.find( "#define TEXTURE_ARRAY" ) );
+
+    const ui32 features = static_cast<ui32>( ShaderFeatureType::TextureArray );
+    EXPECT_EQ( nullptr, MaterialBuilder::createVariantMaterial( "noTexCoords", features, VertexType::RenderVertex ) );
+}
+
+} // Namespace UnitTest
+} // Namespace OSRE
@@ -32,6 +32,22 @@ namespace UnitTest {
 
 using namespace ::OSRE::Scene;
 
+class UpdateCountNode : public Node {
+public:
+    i64 m_elapsed;
+
+    UpdateCountNode( const String &name, Common::Ids &ids, Node *parent ) :
+            Node( name, ids, parent ),
+            m_elapsed( 0 ) {
+        // empty
+    }
+
+protected:
+    void onUpdate( Time dt ) override {
+        m_elapsed += dt.asMicroSeconds();
+    }
+};
+
 class NodeTest : public ::testing::Test {
 protected:
     Common::Ids *m_ids;
@@ -110,6 +126,17 @@ TEST_F( NodeTest, activeTest ) {
 TEST_F( NodeTest, onUpdateTest ) {
     Node *myNode = createNode( "parent", *m_ids, nullptr );
     EXPECT_NE(nullptr, myNode);
+
+    // Sub-millisecond steps reach the whole hierarchy without being truncated
+    UpdateCountNode *parent = new UpdateCountNode( "counter_parent", *m_ids, nullptr );
+    addNodeForRelease( parent );
+    UpdateCountNode *child = new UpdateCountNode( "counter_child", *m_ids, parent );
+    addNodeForRelease( child );
+    for ( ui32 i = 0; i < 4; ++i ) {
+        parent->update( Time( 250 ) );
+    }
+    EXPECT_EQ( 1000, parent->m_elapsed );
+    EXPECT_EQ( 1000, child->m_elapsed );
 }
 
 } // Namespace UnitTest
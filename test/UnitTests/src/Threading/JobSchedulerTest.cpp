@@ -0,0 +1,194 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2015-2020 OSRE ( Open Source Render Engine ) by Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#include "osre_testcommon.h"
+#include <osre/Threading/JobScheduler.h>
+#include <osre/Threading/SystemTask.h>
+#include <osre/Common/AbstractEventHandler.h>
+#include <osre/Common/Event.h>
+
+#include <chrono>
+#include <iostream>
+
+namespace OSRE {
+namespace UnitTest {
+
+using namespace ::OSRE::Common;
+using namespace ::OSRE::Threading;
+
+class JobSchedulerTest : public ::testing::Test {
+    // empty
+};
+
+static const ui32 NumBenchJobs = 10000;
+
+static void incJob(void *data) {
+    Platform::AtomicInt *value = reinterpret_cast<Platform::AtomicInt *>(data);
+    value->inc();
+}
+
+static void spawnJob(void *data) {
+    // Nested jobs started from a worker go to its own deque
+    JobScheduler *scheduler = reinterpret_cast<JobScheduler *>(data);
+    static Platform::AtomicInt dummy(0);
+    JobCounter counter;
+    for (ui32 i = 0; i < 8; ++i) {
+        scheduler->run(incJob, &dummy, &counter);
+    }
+    scheduler->wait(&counter);
+}
+
+DECL_EVENT(OnBenchEvent);
+
+class CountingEventHandler : public AbstractEventHandler {
+public:
+    CountingEventHandler() :
+            AbstractEventHandler(),
+            m_count(0) {
+        // empty
+    }
+
+    bool onEvent(const Event &ev, const EventData *) override {
+        if (OnBenchEvent == ev) {
+            m_count.inc();
+        }
+        return true;
+    }
+
+    Platform::AtomicInt m_count;
+
+protected:
+    bool onAttached(const EventData *) override {
+        return true;
+    }
+
+    bool onDetached(const EventData *) override {
+        return true;
+    }
+};
+
+TEST_F(JobSchedulerTest, createTest) {
+    JobScheduler *scheduler = JobScheduler::create(2);
+    ASSERT_NE(nullptr, scheduler);
+    EXPECT_EQ(2u, scheduler->getNumWorkers());
+    delete scheduler;
+
+    scheduler = JobScheduler::create();
+    ASSERT_NE(nullptr, scheduler);
+    EXPECT_LE(1u, scheduler->getNumWorkers());
+    delete scheduler;
+}
+
+TEST_F(JobSchedulerTest, counterTest) {
+    JobScheduler *scheduler = JobScheduler::create(2);
+    Platform::AtomicInt value(0);
+    JobCounter counter;
+    EXPECT_TRUE(counter.isDone());
+
+    for (ui32 i = 0; i < 100; ++i) {
+        scheduler->run(incJob, &value, &counter);
+    }
+    scheduler->wait(&counter);
+    EXPECT_TRUE(counter.isDone());
+    EXPECT_EQ(100, value.getValue());
+    EXPECT_EQ(100, scheduler->getNumExecutedJobs());
+
+    delete scheduler;
+}
+
+TEST_F(JobSchedulerTest, nestedJobsTest) {
+    JobScheduler *scheduler = JobScheduler::create(2);
+    JobCounter counter;
+    for (ui32 i = 0; i < 16; ++i) {
+        scheduler->run(spawnJob, scheduler, &counter);
+    }
+    scheduler->wait(&counter);
+    EXPECT_EQ(16 + 16 * 8, scheduler->getNumExecutedJobs());
+
+    delete scheduler;
+}
+
+TEST_F(JobSchedulerTest, parallelForTest) {
+    JobScheduler *scheduler = JobScheduler::create(3);
+    CPPCore::TArray<ui32> items;
+    for (ui32 i = 0; i < 1000; ++i) {
+        items.add(i);
+    }
+
+    scheduler->parallelFor(items, [](ui32 &item, ui32 idx) {
+        item = item + idx;
+    });
+    for (ui32 i = 0; i < items.size(); ++i) {
+        EXPECT_EQ(2 * i, items[i]);
+    }
+
+    // An odd chunk size must handle the remainder
+    scheduler->parallelFor(items, [](ui32 &item, ui32) {
+        item = 0;
+    }, 7);
+    for (ui32 i = 0; i < items.size(); ++i) {
+        EXPECT_EQ(0u, items[i]);
+    }
+
+    delete scheduler;
+}
+
+TEST_F(JobSchedulerTest, throughputVsSystemTaskTest) {
+    typedef std::chrono::high_resolution_clock Clock;
+
+    // The job scheduler path
+    JobScheduler *scheduler = JobScheduler::create();
+    Platform::AtomicInt value(0);
+    JobCounter counter;
+    Clock::time_point start = Clock::now();
+    for (ui32 i = 0; i < NumBenchJobs; ++i) {
+        scheduler->run(incJob, &value, &counter);
+    }
+    scheduler->wait(&counter);
+    const i64 schedulerUs = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count();
+    EXPECT_EQ(static_cast<i32>(NumBenchJobs), value.getValue());
+    delete scheduler;
+
+    // The system task path, one event per job
+    SystemTaskPtr task;
+    task.init(SystemTask::create("bench_task"));
+    ASSERT_TRUE(task->start(nullptr));
+    CountingEventHandler *handler = new CountingEventHandler;
+    task->attachEventHandler(handler);
+    start = Clock::now();
+    for (ui32 i = 0; i < NumBenchJobs; ++i) {
+        task->sendEvent(&OnBenchEvent, nullptr);
+    }
+    while (handler->m_count.getValue() < static_cast<i32>(NumBenchJobs)) {
+        // spin until the task thread has processed all events
+    }
+    const i64 taskUs = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count();
+    task->detachEventHandler();
+    task->stop();
+    delete handler;
+
+    std::cout << "JobScheduler: " << NumBenchJobs << " jobs in " << schedulerUs << " us" << std::endl;
+    std::cout << "SystemTask  : " << NumBenchJobs << " events in " << taskUs << " us" << std::endl;
+}
+
+} // Namespace UnitTest
+} // Namespace OSRE
@@ -0,0 +1,131 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2015-2020 OSRE ( Open Source Render Engine ) by Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#include "osre_testcommon.h"
+#include <osre/Threading/SystemTask.h>
+#include <osre/Common/AbstractEventHandler.h>
+#include <osre/Common/Event.h>
+
+namespace OSRE {
+namespace UnitTest {
+
+using namespace ::OSRE::Common;
+using namespace ::OSRE::Threading;
+
+class SystemTaskTest : public ::testing::Test {
+    // empty
+};
+
+DECL_EVENT(OnTestEvent);
+
+struct TestEventData : public EventData {
+    TestEventData() :
+            EventData(OnTestEvent, nullptr),
+            m_value(0) {
+        // empty
+    }
+
+    i32 m_value;
+};
+
+class SumEventHandler : public AbstractEventHandler {
+public:
+    SumEventHandler() :
+            AbstractEventHandler(),
+            m_numEvents(0),
+            m_sum(0) {
+        // empty
+    }
+
+    bool onEvent(const Event &ev, const EventData *eventData) override {
+        if (OnTestEvent == ev) {
+            const TestEventData *data = reinterpret_cast<const TestEventData *>(eventData);
+            m_sum.incValue(data->m_value);
+            m_numEvents.inc();
+        }
+        return true;
+    }
+
+    Platform::AtomicInt m_numEvents;
+    Platform::AtomicInt m_sum;
+
+protected:
+    bool onAttached(const EventData *) override {
+        return true;
+    }
+
+    bool onDetached(const EventData *) override {
+        return true;
+    }
+};
+
+static void sendAndWait(SystemTask *task, SumEventHandler *handler, TestEventData &data, i32 numEvents) {
+    const i32 expected = handler->m_numEvents.getValue() + numEvents;
+    for (i32 i = 0; i < numEvents; ++i) {
+        task->sendEvent(&OnTestEvent, &data);
+    }
+    while (handler->m_numEvents.getValue() < expected) {
+        // spin until the task thread has processed all events
+    }
+}
+
+TEST_F(SystemTaskTest, sendEventTest) {
+    SystemTaskPtr task;
+    task.init(SystemTask::create("test_task"));
+    ASSERT_TRUE(task->start(nullptr));
+    SumEventHandler *handler = new SumEventHandler;
+    task->attachEventHandler(handler);
+
+    TestEventData data;
+    data.m_value = 2;
+    sendAndWait(task.getPtr(), handler, data, 100);
+    EXPECT_EQ(100, handler->m_numEvents.getValue());
+    EXPECT_EQ(200, handler->m_sum.getValue());
+
+    task->detachEventHandler();
+    task->stop();
+    delete handler;
+}
+
+TEST_F(SystemTaskTest, sendEventWithoutAllocTest) {
+    SystemTaskPtr task;
+    task.init(SystemTask::create("test_task"));
+    ASSERT_TRUE(task->start(nullptr));
+    SumEventHandler *handler = new SumEventHandler;
+    task->attachEventHandler(handler);
+
+    // Warm up, lets the task thread reach its steady state
+    TestEventData data;
+    data.m_value = 1;
+    sendAndWait(task.getPtr(), handler, data, 1000);
+
+    const size_t numAllocs = MemoryStatistics::getNumAllocs();
+    sendAndWait(task.getPtr(), handler, data, 1000);
+    EXPECT_EQ(0u, MemoryStatistics::getNumAllocs() - numAllocs);
+
+    task->detachEventHandler();
+    task->stop();
+    delete handler;
+}
+
+} // Namespace UnitTest
+} // Namespace OSRE
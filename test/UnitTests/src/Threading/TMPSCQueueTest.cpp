@@ -0,0 +1,202 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2015-2020 OSRE ( Open Source Render Engine ) by Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#include "osre_testcommon.h"
+#include <osre/Threading/TMPSCQueue.h>
+#include <osre/Threading/TAsyncQueue.h>
+#include <osre/Platform/Threading.h>
+
+#include <chrono>
+#include <iostream>
+#include <sstream>
+
+namespace OSRE {
+namespace UnitTest {
+
+using namespace ::OSRE::Threading;
+using namespace ::OSRE::Platform;
+
+class TMPSCQueueTest : public ::testing::Test {
+    // empty
+};
+
+static const ui32 NumItemsPerProducer = 20000;
+
+template<class TQueue>
+class ProducerThread : public Thread {
+public:
+    ProducerThread(const String &name, TQueue *queue, ui32 numItems) :
+            Thread(name, 4096),
+            m_queue(queue),
+            m_numItems(numItems),
+            m_done(0) {
+        // empty
+    }
+
+    bool isDone() {
+        return 0 != m_done.getValue();
+    }
+
+protected:
+    i32 run() override {
+        for (ui32 i = 0; i < m_numItems; ++i) {
+            m_queue->enqueue(i + 1);
+        }
+        m_done.inc();
+
+        return 0;
+    }
+
+private:
+    TQueue *m_queue;
+    ui32 m_numItems;
+    AtomicInt m_done;
+};
+
+template<class TQueue>
+static void startProducers(TQueue &queue, ui32 numProducers, CPPCore::TArray<ProducerThread<TQueue> *> &producers) {
+    for (ui32 i = 0; i < numProducers; ++i) {
+        std::stringstream stream;
+        stream << "producer." << i;
+        ProducerThread<TQueue> *producer = new ProducerThread<TQueue>(stream.str(), &queue, NumItemsPerProducer);
+        producers.add(producer);
+        producer->start(nullptr);
+    }
+}
+
+template<class TQueue>
+static void joinProducers(CPPCore::TArray<ProducerThread<TQueue> *> &producers) {
+    for (ui32 i = 0; i < producers.size(); ++i) {
+        while (!producers[i]->isDone()) {
+            // spin until the producer is done
+        }
+        producers[i]->stop();
+        delete producers[i];
+    }
+    producers.clear();
+}
+
+static i64 runMPSCQueue(ui32 numProducers) {
+    typedef std::chrono::high_resolution_clock Clock;
+    TMPSCQueue<ui32> queue(4096);
+    CPPCore::TArray<ProducerThread<TMPSCQueue<ui32>> *> producers;
+    CPPCore::TArray<ui32> items;
+
+    const Clock::time_point start = Clock::now();
+    startProducers(queue, numProducers, producers);
+    ui64 sum = 0;
+    ui32 received = 0;
+    while (received < numProducers * NumItemsPerProducer) {
+        queue.awaitEnqueuedItem();
+        const size_t numItems = queue.dequeueAll(items);
+        for (size_t i = 0; i < numItems; ++i) {
+            sum += items[i];
+        }
+        received += static_cast<ui32>(numItems);
+    }
+    const i64 us = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count();
+    joinProducers(producers);
+
+    const ui64 expected = static_cast<ui64>(numProducers) * NumItemsPerProducer * (NumItemsPerProducer + 1) / 2;
+    EXPECT_EQ(expected, sum);
+
+    return us;
+}
+
+static i64 runAsyncQueue(ui32 numProducers) {
+    typedef std::chrono::high_resolution_clock Clock;
+    TAsyncQueue<ui32> queue;
+    CPPCore::TArray<ProducerThread<TAsyncQueue<ui32>> *> producers;
+
+    const Clock::time_point start = Clock::now();
+    startProducers(queue, numProducers, producers);
+    ui64 sum = 0;
+    ui32 received = 0;
+    while (received < numProducers * NumItemsPerProducer) {
+        queue.awaitEnqueuedItem();
+        while (!queue.isEmpty()) {
+            sum += queue.dequeue();
+            ++received;
+        }
+    }
+    const i64 us = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count();
+    joinProducers(producers);
+
+    const ui64 expected = static_cast<ui64>(numProducers) * NumItemsPerProducer * (NumItemsPerProducer + 1) / 2;
+    EXPECT_EQ(expected, sum);
+
+    return us;
+}
+
+TEST_F(TMPSCQueueTest, createTest) {
+    TMPSCQueue<ui32> queue(100);
+    EXPECT_EQ(128u, queue.capacity());
+    EXPECT_TRUE(queue.isEmpty());
+    EXPECT_EQ(0u, queue.size());
+}
+
+TEST_F(TMPSCQueueTest, enqueueDequeueTest) {
+    TMPSCQueue<ui32> queue(4);
+    ui32 item = 0;
+    EXPECT_FALSE(queue.tryDequeue(item));
+
+    EXPECT_TRUE(queue.tryEnqueue(1));
+    EXPECT_TRUE(queue.tryEnqueue(2));
+    EXPECT_EQ(2u, queue.size());
+    EXPECT_FALSE(queue.isEmpty());
+
+    EXPECT_TRUE(queue.tryDequeue(item));
+    EXPECT_EQ(1u, item);
+    EXPECT_TRUE(queue.tryDequeue(item));
+    EXPECT_EQ(2u, item);
+    EXPECT_TRUE(queue.isEmpty());
+}
+
+TEST_F(TMPSCQueueTest, fullAndWrapAroundTest) {
+    TMPSCQueue<ui32> queue(4);
+    for (ui32 round = 0; round < 3; ++round) {
+        for (ui32 i = 0; i < 4; ++i) {
+            EXPECT_TRUE(queue.tryEnqueue(i));
+        }
+        EXPECT_FALSE(queue.tryEnqueue(99));
+
+        CPPCore::TArray<ui32> items;
+        EXPECT_EQ(4u, queue.dequeueAll(items));
+        for (ui32 i = 0; i < 4; ++i) {
+            EXPECT_EQ(i, items[i]);
+        }
+        EXPECT_TRUE(queue.isEmpty());
+    }
+}
+
+TEST_F(TMPSCQueueTest, contentionTest) {
+    static const ui32 NumProducers[] = { 1, 2, 4, 8, 16 };
+    for (ui32 i = 0; i < sizeof(NumProducers) / sizeof(ui32); ++i) {
+        const i64 mpscUs = runMPSCQueue(NumProducers[i]);
+        const i64 asyncUs = runAsyncQueue(NumProducers[i]);
+        std::cout << NumProducers[i] << " producers, " << NumItemsPerProducer << " items each: "
+                  << "TMPSCQueue " << mpscUs << " us, TAsyncQueue " << asyncUs << " us" << std::endl;
+    }
+}
+
+} // Namespace UnitTest
+} // Namespace OSRE
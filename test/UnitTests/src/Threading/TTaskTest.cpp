@@ -0,0 +1,83 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2015-2020 OSRE ( Open Source Render Engine ) by Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#include "osre_testcommon.h"
+#include <osre/Threading/TTask.h>
+
+namespace OSRE {
+namespace UnitTest {
+
+using namespace ::OSRE::Threading;
+
+class TTaskTest : public ::testing::Test {
+    // empty
+};
+
+TEST_F(TTaskTest, createTest) {
+    TTask<i32> task;
+    EXPECT_FALSE(task.isValid());
+
+    task = TTask<i32>::fromValue(42);
+    EXPECT_TRUE(task.isValid());
+    EXPECT_TRUE(task.isReady());
+    EXPECT_EQ(42, task.get());
+}
+
+TEST_F(TTaskTest, runWithoutSchedulerTest) {
+    TTask<i32> task = TTask<i32>::run(nullptr, []() {
+        return 21;
+    });
+    EXPECT_TRUE(task.isReady());
+
+    TTask<i32> doubled = task.then([](const i32 &value) {
+        return value * 2;
+    });
+    EXPECT_TRUE(doubled.isReady());
+    EXPECT_EQ(42, doubled.get());
+}
+
+TEST_F(TTaskTest, continuationTest) {
+    JobScheduler *scheduler = JobScheduler::create(4);
+
+    static const ui32 NumTasks = 100;
+    CPPCore::TArray<TTask<String>> tasks;
+    for (ui32 i = 0; i < NumTasks; ++i) {
+        TTask<i32> task = TTask<i32>::run(scheduler, [i]() {
+            return static_cast<i32>(i);
+        });
+        tasks.add(task.then([](const i32 &value) {
+            return value * 2;
+        }).then([](const i32 &value) {
+            return std::to_string(value);
+        }));
+    }
+
+    for (ui32 i = 0; i < NumTasks; ++i) {
+        EXPECT_EQ(std::to_string(i * 2), tasks[i].get());
+        EXPECT_TRUE(tasks[i].isReady());
+    }
+
+    delete scheduler;
+}
+
+} // Namespace UnitTest
+} // Namespace OSRE
@@ -0,0 +1,141 @@
+/*-----------------------------------------------------------------------------------------------
+The MIT License (MIT)
+
+Copyright (c) 2015-2020 OSRE ( Open Source Render Engine ) by Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+-----------------------------------------------------------------------------------------------*/
+#include "osre_testcommon.h"
+#include <osre/Threading/TaskGraph.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+namespace OSRE {
+namespace UnitTest {
+
+using namespace ::OSRE::Threading;
+
+class TaskGraphTest : public ::testing::Test {
+    // empty
+};
+
+struct StageData {
+    std::atomic<i32> *m_clock;
+    i32 m_order;
+    ui32 m_sleepMs;
+
+    StageData(std::atomic<i32> *clock, ui32 sleepMs) :
+            m_clock(clock),
+            m_order(-1),
+            m_sleepMs(sleepMs) {
+        // empty
+    }
+};
+
+static void stageFunc(void *data) {
+    StageData *stage = reinterpret_cast<StageData *>(data);
+    if (0 != stage->m_sleepMs) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(stage->m_sleepMs));
+    }
+    stage->m_order = (*stage->m_clock)++;
+}
+
+TEST_F(TaskGraphTest, cycleTest) {
+    std::atomic<i32> clock(0);
+    StageData dataA(&clock, 0), dataB(&clock, 0);
+    GraphTask a("a", stageFunc, &dataA), b("b", stageFunc, &dataB);
+
+    TaskGraph graph;
+    EXPECT_TRUE(graph.addDependency(&b, &a));
+    EXPECT_TRUE(graph.compile());
+    EXPECT_TRUE(graph.addDependency(&a, &b));
+    EXPECT_FALSE(graph.compile());
+    EXPECT_FALSE(graph.execute(nullptr));
+}
+
+TEST_F(TaskGraphTest, childTaskTest) {
+    std::atomic<i32> clock(0);
+    StageData parentData(&clock, 0), childData(&clock, 0);
+    GraphTask parent("parent", stageFunc, &parentData), child("child", stageFunc, &childData);
+    parent.enqueue(&child);
+
+    TaskGraph graph;
+    EXPECT_TRUE(graph.addTask(&parent));
+    EXPECT_FALSE(graph.addTask(&parent));
+    EXPECT_TRUE(graph.execute(nullptr));
+    EXPECT_EQ(2u, graph.getNumTasks());
+    EXPECT_LT(childData.m_order, parentData.m_order);
+}
+
+static void executeFrameGraph(JobScheduler *scheduler) {
+    std::atomic<i32> clock(0);
+    StageData inputData(&clock, 0), updateData(&clock, 0), cullData(&clock, 20), audioData(&clock, 1),
+            recordData(&clock, 0), submitData(&clock, 0);
+    GraphTask input("input", stageFunc, &inputData);
+    GraphTask update("update", stageFunc, &updateData);
+    GraphTask cull("cull", stageFunc, &cullData);
+    GraphTask audio("audio", stageFunc, &audioData);
+    GraphTask record("record", stageFunc, &recordData);
+    GraphTask submit("submit", stageFunc, &submitData);
+
+    // input -> update -> cull -> record -> submit, audio runs beside the culling
+    TaskGraph graph;
+    graph.addDependency(&update, &input);
+    graph.addDependency(&cull, &update);
+    graph.addDependency(&audio, &update);
+    graph.addDependency(&record, &cull);
+    graph.addDependency(&submit, &record);
+    graph.addDependency(&submit, &audio);
+    EXPECT_TRUE(graph.compile());
+
+    // The graph will be reused for each frame
+    for (ui32 frame = 0; frame < 3; ++frame) {
+        clock = 0;
+        EXPECT_TRUE(graph.execute(scheduler));
+        EXPECT_EQ(6, clock.load());
+        EXPECT_EQ(0, inputData.m_order);
+        EXPECT_EQ(1, updateData.m_order);
+        EXPECT_LT(cullData.m_order, recordData.m_order);
+        EXPECT_LT(audioData.m_order, submitData.m_order);
+        EXPECT_EQ(5, submitData.m_order);
+
+        const CPPCore::TArray<AbstractTask *> &path = graph.getCriticalPath();
+        ASSERT_EQ(5u, path.size());
+        EXPECT_EQ(&input, path[0]);
+        EXPECT_EQ(&cull, path[2]);
+        EXPECT_EQ(&submit, path[4]);
+        EXPECT_GE(graph.getCriticalPathTime().asMicroSeconds(), graph.getTaskTime(&cull).asMicroSeconds());
+        EXPECT_GE(graph.getTaskTime(&cull).asMilliSeconds(), 20);
+        EXPECT_GE(graph.getExecutionTime().asMilliSeconds(), 20);
+    }
+}
+
+TEST_F(TaskGraphTest, serialFrameGraphTest) {
+    executeFrameGraph(nullptr);
+}
+
+TEST_F(TaskGraphTest, parallelFrameGraphTest) {
+    JobScheduler *scheduler = JobScheduler::create(4);
+    executeFrameGraph(scheduler);
+    delete scheduler;
+}
+
+} // Namespace UnitTest
+} // Namespace OSRE